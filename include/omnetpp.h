@@ -30,6 +30,7 @@
 #include "omnetpp/cabstracthistogram.h"
 #include "omnetpp/carray.h"
 #include "omnetpp/cboolparimpl.h"
+#include "omnetpp/ccalendarqueue.h"
 #include "omnetpp/ccanvas.h"
 #include "omnetpp/cchannel.h"
 #include "omnetpp/cclassdescriptor.h"
@@ -84,6 +85,7 @@
 #include "omnetpp/cpacket.h"
 #include "omnetpp/cpacketqueue.h"
 #include "omnetpp/cpar.h"
+#include "omnetpp/cphiloxrng.h"
 #include "omnetpp/cparimpl.h"
 #include "omnetpp/cparsimcomm.h"
 #include "omnetpp/cpatternmatcher.h"
@@ -0,0 +1,215 @@
+//==========================================================================
+//  CCALENDARQUEUE.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CCALENDARQUEUE_H
+#define __OMNETPP_CCALENDARQUEUE_H
+
+#include <vector>
+#include "cfutureeventset.h"
+
+namespace omnetpp {
+
+/**
+ * @brief Calendar queue based implementation of the future event set.
+ *
+ * The calendar queue (R. Brown, 1988) divides the time axis into "days"
+ * (buckets) of equal width, and maps them onto a circular array of buckets
+ * ("a year"). Events are stored in the bucket that corresponds to their
+ * arrival time, and inside a bucket they are kept sorted. Bucket width and
+ * bucket count are adapted to the contents of the FES as it grows and shrinks,
+ * so that insertion and removal of the first event take amortized O(1) time
+ * for most workloads. This makes cCalendarQueue a good choice for models with
+ * a very large number (10^5 and up) of pending events. For small FES sizes
+ * and for workloads with a highly skewed time distribution, the default
+ * cEventHeap is usually faster.
+ *
+ * Events are ordered exactly as in cEventHeap (by arrival time, then by
+ * scheduling priority, then by insertion order), so simulations produce
+ * identical results (and fingerprints) with both implementations.
+ *
+ * cCalendarQueue can be selected with the `futureeventset-class`
+ * configuration option:
+ *
+ * <pre>
+ * futureeventset-class = "omnetpp::cCalendarQueue"
+ * </pre>
+ *
+ * @ingroup SimCore
+ */
+class SIM_API cCalendarQueue : public cFutureEventSet
+{
+  private:
+    // one bucket ("day"): events sorted in scheduling order, from index 'head'
+    struct Bucket {
+        std::vector<cEvent*> events;
+        size_t head = 0;  // items before 'head' have already been removed
+        bool isEmpty() const {return head == events.size();}
+        size_t size() const {return events.size() - head;}
+        cEvent *front() const {return events[head];}
+    };
+
+    std::vector<Bucket> buckets;   // the "year"; size is always power of 2
+    int numBuckets = 0;            // == buckets.size()
+    int64_t bucketWidth = 1;       // in raw simtime units
+    int length = 0;                // number of events in the FES
+    eventnumber_t insertCount = 0; // counts insertions, to provide stable ordering among equal events
+    mutable int64_t currentDay = 0;  // lower bound of the days of all events in the FES
+    mutable int firstBucket = -1;    // cached index of the bucket containing the first event, or -1
+
+    // for get(k)
+    mutable std::vector<cEvent*> array; // flattened contents; only valid if !arrayDirty
+    mutable bool arrayDirty = true;
+
+  private:
+    void copy(const cCalendarQueue& other);
+    int64_t dayOf(const cEvent *event) const;
+    int bucketOf(int64_t day) const {return (int)(day & (numBuckets-1));}
+    int findFirst() const;
+    void bucketInsert(cEvent *event);
+    void bucketRemove(Bucket& bucket, size_t pos);
+    void resize(int newNumBuckets);
+    int64_t computeBucketWidth(std::vector<cEvent*>& events) const;
+    void updateArray() const;
+    void invalidate() {firstBucket = -1; arrayDirty = true;}
+
+  public:
+    // internal: utility function for checking data structure sanity
+    virtual void checkQueue();
+
+    // internal: returns the current number of buckets
+    int getNumBuckets() const {return numBuckets;}
+
+    // internal: returns the current bucket width (in raw simtime units)
+    int64_t getBucketWidth() const {return bucketWidth;}
+
+  public:
+    /** @name Constructors, destructor, assignment */
+    //@{
+
+    /**
+     * Copy constructor.
+     */
+    cCalendarQueue(const cCalendarQueue& other);
+
+    /**
+     * Constructor.
+     */
+    cCalendarQueue(const char *name=nullptr, int initialNumBuckets=16);
+
+    /**
+     * Destructor.
+     */
+    virtual ~cCalendarQueue();
+
+    /**
+     * Assignment operator. The name member is not copied;
+     * see cOwnedObject's operator=() for more details.
+     */
+    cCalendarQueue& operator=(const cCalendarQueue& other);
+    //@}
+
+    /** @name Redefined cObject member functions. */
+    //@{
+
+    /**
+     * Creates and returns an exact copy of this object.
+     * See cObject for more details.
+     */
+    virtual cCalendarQueue *dup() const override  {return new cCalendarQueue(*this);}
+
+    /**
+     * Produces a one-line description of the object's contents.
+     * See cObject for more details.
+     */
+    virtual std::string str() const override;
+
+    /**
+     * Calls v->visit(this) for each contained object.
+     * See cObject for more details.
+     */
+    virtual void forEachChild(cVisitor *v) override;
+
+    // no parsimPack() and parsimUnpack()
+    //@}
+
+    /** @name Simulation-related operations. */
+    //@{
+    /**
+     * Insert an event into the FES.
+     */
+    virtual void insert(cEvent *event) override;
+
+    /**
+     * Peek the first event in the FES (the one with the smallest timestamp.)
+     * If the FES is empty, it returns nullptr.
+     */
+    virtual cEvent *peekFirst() const override;
+
+    /**
+     * Removes and return the first event in the FES (the one with the
+     * smallest timestamp.) If the FES is empty, it returns nullptr.
+     */
+    virtual cEvent *removeFirst() override;
+
+    /**
+     * Undo for removeFirst(): it puts back an event to the front of the FES.
+     */
+    virtual void putBackFirst(cEvent *event) override;
+
+    /**
+     * Removes and returns the given event in the FES. If the event is
+     * not in the FES, returns nullptr.
+     */
+    virtual cEvent *remove(cEvent *event) override;
+
+    /**
+     * Returns true if the FES is empty.
+     */
+    virtual bool isEmpty() const override {return length == 0;}
+
+    /**
+     * Deletes all events in the FES.
+     */
+    virtual void clear() override;
+    //@}
+
+    /** @name Random access. */
+    //@{
+
+    /**
+     * Returns the number of events in the FES.
+     */
+    virtual int getLength() const override {return length;}
+
+    /**
+     * Returns the kth event in the FES if 0 <= k < getLength(), and nullptr
+     * otherwise. Note that iteration does not necessarily return events
+     * in increasing timestamp (getArrivalTime()) order unless you called
+     * sort() before.
+     */
+    virtual cEvent *get(int k) override;
+
+    /**
+     * Sorts the contents of the FES. This is only necessary if one wants
+     * to iterate through in the FES in strict timestamp order.
+     */
+    virtual void sort() override;
+};
+
+}  // namespace omnetpp
+
+
+#endif
+
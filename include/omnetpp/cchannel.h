@@ -52,7 +52,7 @@ class SIM_API cChannel : public cComponent //implies noncopyable
 
   public:
     // internal: called from cGate
-    void setSourceGate(cGate *g) {srcGate=g;}
+    void setSourceGate(cGate *g) {srcGate=g; invalidateDispatchCaches();}
 
     // internal: sets/gets nedConnectionElementId
     void setNedConnectionElementId(int id) {nedConnectionElementId = id;}
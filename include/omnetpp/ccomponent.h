@@ -115,6 +115,13 @@ class SIM_API cComponent : public cSoftOwner //implies noncopyable
 
     std::unordered_set<void**> *selfPointers = nullptr;
 
+    // per-component emit() dispatch cache (listener lists of this component
+    // and its ancestors, per signal); built on demand, see getDispatchEntry()
+    struct SignalDispatchCache;
+    struct SignalDispatchEntry;
+    mutable SignalDispatchCache *dispatchCache = nullptr;
+    static OPP_THREAD_LOCAL uint64_t dispatchCacheGeneration; // bumped on every invalidation, so that dispatch() can detect changes made by listeners
+
     // string-to-simsignal_t mapping (ALL THREADS)
     struct SignalRegistrations {
         std::map<std::string,simsignal_t> nameToId;
@@ -147,6 +154,11 @@ class SIM_API cComponent : public cSoftOwner //implies noncopyable
     void removeListenerList(simsignal_t signalID);
     void checkNotFiring(simsignal_t, cIListener **listenerList);
     template<typename T> void fire(cComponent *src, simsignal_t signalID, T x, cObject *details);
+    template<typename T> void notifyListeners(cIListener **listeners, cComponent *src, simsignal_t signalID, T x, cObject *details);
+    template<typename T> void dispatch(simsignal_t signalID, T x, cObject *details);
+    const SignalDispatchEntry *getDispatchEntry(simsignal_t signalID) const;
+    void invalidateDispatchCaches(simsignal_t signalID=SIMSIGNAL_NULL); // in this component and its descendants; SIMSIGNAL_NULL means all signals
+    void invalidateDispatchCachesRec(simsignal_t signalID);
     void fireFinish();
     void releaseLocalListeners();
     const SignalListenerList& getListenerList(int k) const {return (*signalTable)[k];} // for inspectors
@@ -19,7 +19,7 @@
 #include "platdep/platmisc.h"  // for <windows.h>
 #include "simkerneldefs.h"
 
-#if !defined(USE_WIN32_FIBERS) && !defined(USE_POSIX_COROUTINES) && !defined(USE_PORTABLE_COROUTINES)
+#if !defined(USE_WIN32_FIBERS) && !defined(USE_POSIX_COROUTINES) && !defined(USE_PORTABLE_COROUTINES) && !defined(USE_ASM_COROUTINES)
 #error "Coroutine library choice not specified"
 #endif
 
@@ -51,7 +51,15 @@ typedef void (*CoroutineFnp)( void * );
  *
  * On Windows, it uses the Win32 Fiber API.
  *
- * On Unix-like systems, it uses POSIX coroutines (setcontext()/switchcontext())
+ * On x86-64 and aarch64 Unix-like systems, it uses its own context switching
+ * code (USE_ASM_COROUTINES) unless configured otherwise. It only saves and
+ * restores the callee-saved registers, and does not involve system calls.
+ * Stacks are allocated with mmap() and have a guard page at the end, so a
+ * stack overflow results in a segmentation fault instead of silent memory
+ * corruption. The stacks of deleted coroutines are kept in a per-thread pool
+ * for reuse, which makes creating and deleting modules with activity() cheap.
+ *
+ * On other Unix-like systems, it uses POSIX coroutines (setcontext()/swapcontext())
  * if they are available.
  *
  * Otherwise, it uses a portable coroutine library first described
@@ -83,6 +91,17 @@ class SIM_API cCoroutine
     char *stackPtr = nullptr;
     ucontext_t context;
 #endif
+#ifdef USE_ASM_COROUTINES
+    static OPP_THREAD_LOCAL bool initialized;
+    static OPP_THREAD_LOCAL unsigned totalStackLimit;
+    static OPP_THREAD_LOCAL unsigned totalStackUsage;
+    static OPP_THREAD_LOCAL void *mainStackPointer;
+    static OPP_THREAD_LOCAL void **curStackPointerPtr;
+    unsigned stackSize = 0;
+    char *stackPtr = nullptr;   // lowest address of the usable area (above the guard page)
+    size_t stackAllocSize = 0;  // usable area, rounded up to whole pages
+    void *stackPointer = nullptr;  // saved stack pointer while the coroutine is not running
+#endif
 #ifdef USE_PORTABLE_COROUTINES
     static OPP_THREAD_LOCAL unsigned totalStack;
     static OPP_THREAD_LOCAL unsigned mainStack;
@@ -150,6 +169,9 @@ class SIM_API cCoroutine
      *
      * Windows/Fiber API, POSIX coroutines: Not implemented: always returns false.
      *
+     * Built-in (assembly) coroutines: always returns false, because the guard
+     * page at the end of the stack causes a segmentation fault on overflow.
+     *
      * Portable coroutines: it checks the intactness of a predefined byte pattern
      * (0xdeadbeef) at the stack boundary, and report stack overflow
      * if it was overwritten. The mechanism usually works fine, but occasionally
@@ -168,7 +190,8 @@ class SIM_API cCoroutine
     /**
      * Returns the amount of stack actually used by the coroutine.
      *
-     * Windows/Fiber API, POSIX coroutines: Not implemented, always returns 0.
+     * Windows/Fiber API, POSIX coroutines, built-in (assembly) coroutines:
+     * Not implemented, always returns 0.
      *
      * Portable coroutines: It works by checking the intactness of
      * predefined byte patterns (0xdeadbeef) placed in the stack.
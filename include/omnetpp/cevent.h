@@ -16,6 +16,7 @@
 #ifndef __OMNETPP_CEVENT_H
 #define __OMNETPP_CEVENT_H
 
+#include <new>
 #include "cownedobject.h"
 
 namespace omnetpp {
@@ -23,6 +24,7 @@ namespace omnetpp {
 class cMessage;
 class cPacket;
 class cEventHeap;
+class cCalendarQueue;
 
 /**
  * @brief Represents an event in the discrete event simulator.
@@ -47,11 +49,12 @@ class SIM_API cEvent : public cOwnedObject
 {
     friend class cMessage;     // getArrivalTime()
     friend class cEventHeap;   // heapIndex
+    friend class cCalendarQueue; // heapIndex
 
   private:
     simtime_t arrivalTime;  // time of delivery -- set internally
     short priority = 0;     // priority -- used for scheduling events with equal arrival times
-    int heapIndex = -1;     // used by cEventHeap (-1 if not on heap; all other values, including negative ones, means "on the heap")
+    int heapIndex = -1;     // used by the FES (-1 if not on heap; all other values, including negative ones, means "on the heap")
     eventnumber_t insertOrder = -1; // used by the FES to keep order of events with equal time and priority
     eventnumber_t previousEventNumber = -1; // most recent event number when envir was notified about this event object (e.g. creating/cloning/sending/scheduling/deleting of this event object)
 
@@ -104,6 +107,32 @@ class SIM_API cEvent : public cOwnedObject
     cEvent& operator=(const cEvent& event);
     //@}
 
+    /** @name Memory management. */
+    //@{
+    /**
+     * Allocation function for event objects, i.e. cEvent and all its subclasses
+     * (cMessage, cPacket, and message classes generated by the message compiler).
+     * If the active simulation has pooled allocation enabled (see the
+     * `message-pooling` configuration option), the memory is taken from the
+     * simulation's free lists, otherwise from the global allocator.
+     */
+    static void *operator new(size_t size);
+
+    /**
+     * Deallocation function for event objects; see operator new().
+     */
+    static void operator delete(void *p, size_t size);
+
+    /**
+     * Placement and nothrow forms. They are declared because the class-specific
+     * operator new() would hide them otherwise; they forward to the global ones.
+     */
+    static void *operator new(size_t size, void *ptr) noexcept {return ::operator new(size, ptr);}
+    static void *operator new(size_t size, const std::nothrow_t& tag) noexcept {return ::operator new(size, tag);}
+    static void operator delete(void *p, void *ptr) noexcept {::operator delete(p, ptr);}
+    static void operator delete(void *p, const std::nothrow_t& tag) noexcept {::operator delete(p, tag);}
+    //@}
+
     /** @name Redefined cObject member functions. */
     //@{
     /**
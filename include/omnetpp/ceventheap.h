@@ -21,22 +21,37 @@
 namespace omnetpp {
 
 /**
- * @brief The default, binary heap based implementation of the future event set.
+ * @brief The default, heap based implementation of the future event set.
  *
- * Using binary heap as the underlying data structure provides reliable
- * performance for most workloads. A worst case for heap is insertion at the
- * front (i.e. for the current simulation time), which is actually quite common,
- * due to the abundance of zero-delay links in models. This case is optimized
- * by employing an additional circular buffer specifically for storing events
- * inserted scheduled for the current simulation time.
+ * Using a heap as the underlying data structure provides reliable performance
+ * for most workloads. The heap is a 4-ary heap (which is shallower than a binary
+ * heap, and the children of a node are adjacent in memory), and it stores the
+ * sort keys (arrival time, scheduling priority, insertion order) inline next
+ * to the event pointers. This way, heap operations do not need to access
+ * the event objects themselves, which greatly reduces cache misses with
+ * large heaps.
+ *
+ * A worst case for heap is insertion at the front (i.e. for the current
+ * simulation time), which is actually quite common, due to the abundance of
+ * zero-delay links in models. This case is optimized by employing an additional
+ * circular buffer specifically for storing events inserted scheduled for the
+ * current simulation time.
  *
  * @ingroup SimCore
  */
 class SIM_API cEventHeap : public cFutureEventSet
 {
   private:
+    // heap element: event pointer with the sort keys stored inline
+    struct HeapEntry {
+        int64_t arrivalTime;        // raw simtime
+        eventnumber_t insertOrder;
+        short priority;
+        cEvent *event;
+    };
+
     // heap data structure
-    cEvent **heap = nullptr;       // heap array  (heap[0] always empty)
+    HeapEntry *heap = nullptr;     // heap array (0-based)
     int heapLength = 0;            // number of elements on the heap
     int heapCapacity = 0;          // allocated size of the heap[] array
     eventnumber_t insertCount = 0; // counts insertions; needed because heap's insert is not stable (does not keep order)
@@ -50,8 +65,9 @@ class SIM_API cEventHeap : public cFutureEventSet
   private:
     void copy(const cEventHeap& other);
 
-    // internal: restore heap
-    void shiftup(int from=1);
+    // internal: move entry up/down from the given position to restore heap
+    void siftUp(int pos, const HeapEntry& entry);
+    void siftDown(int pos, const HeapEntry& entry);
 
     int cblength() const  {return (cbtail-cbhead) & (cbsize-1);}
     cEvent *cbget(int k)  {return cb[(cbhead+k) & (cbsize-1)];}
@@ -134,6 +134,13 @@ class SIM_API cMessage : public cEvent
     // internal: create an exact clone (including msgid) that doesn't show up in the statistics
     cMessage *privateDup() const;
 
+    // internal: used when messages are handed over to another thread, e.g. by cSharedMemoryCommunications.
+    // The copies made for the handover are taken back from the IDs and statistics of the sending thread
+    // with uncountCopies(), and each message gets a new ID in the receiving thread with handedOver().
+    static void adjustLiveMessageCount(int64_t delta) {liveMsgCount += delta;}
+    static void uncountCopies(int n) {nextMessageId -= n; totalMsgCount -= n; liveMsgCount -= n;}
+    void handedOver();
+
     // internal: called by the simulation kernel as part of the send(),
     // scheduleAt() calls to set the values returned by the
     // getSenderModuleId(), getSenderGate(), getSendingTime() methods.
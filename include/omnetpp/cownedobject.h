@@ -134,6 +134,9 @@ class SIM_API cOwnedObject : public cNamedObject
     // internal
     static void setOwningContext(cSoftOwner *list);
 
+    // internal: used when objects are handed over to another thread, e.g. by cSharedMemoryCommunications
+    static void adjustObjectCounts(long totalDelta, long liveDelta) {totalObjectCount += totalDelta; liveObjectCount += liveDelta;}
+
   public:
     /** @name Constructors, destructor, assignment. */
     //@{
@@ -0,0 +1,109 @@
+//==========================================================================
+//  CPHILOXRNG.H - part of
+//                 OMNeT++/OMNEST
+//              Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2002-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CPHILOXRNG_H
+#define __OMNETPP_CPHILOXRNG_H
+
+#include "simkerneldefs.h"
+#include "globals.h"
+#include "crng.h"
+#include "cconfiguration.h"
+
+namespace omnetpp {
+
+
+/**
+ * @brief Implements the Philox4x32-10 counter-based random number generator
+ * by Salmon, Moraes, Dror and Shaw.
+ *
+ *    - Period length:      2^66 numbers (2^64 blocks) per stream
+ *    - Method:             10 rounds of a multiply-xor bijection on a
+ *                          128-bit counter, keyed with a 64-bit key
+ *    - State:              key, counter and 8 pre-generated 128-bit blocks
+ *
+ * The n-th block of random bits is a function of the key and the counter n,
+ * so the RNG needs no large state, and it is seeded instantly. The key is
+ * derived from the seed set (or the `seed-k-philox` configuration option),
+ * and the upper half of the counter identifies the stream: the RNG index,
+ * and with parallel simulation the partition, unless `philox-partition-independent`
+ * is set. Note that by default, the numbers of a parallel run therefore depend
+ * on the partitioning. Streams belong to RNGs, not modules; results only become
+ * partition-independent if `philox-partition-independent` is set and every RNG
+ * is used by the modules of a single partition.
+ *
+ * fillDoubleRand() generates many blocks at once, in a form that compilers
+ * can vectorize; it returns the same numbers as repeated doubleRand() calls.
+ *
+ * Source: J. K. Salmon, M. A. Moraes, R. O. Dror, D. E. Shaw: Parallel
+ * Random Numbers: As Easy as 1, 2, 3. SC'11, 2011.
+ */
+class SIM_API cPhiloxRNG : public cRNG
+{
+  protected:
+    uint32_t key[2] = {0, 0};
+    uint32_t stream[2] = {0, 0};  // upper half of the counter
+    uint64_t blockIndex = 0;      // lower half of the counter: the next block to generate
+
+    // generated words; blocks are generated 8 at a time, because that is faster
+    static const int BUFFER_SIZE = 32;
+    uint32_t buffer[BUFFER_SIZE];
+    int bufferPos = BUFFER_SIZE;  // the next unused word in buffer
+
+  protected:
+    void generateBlocks(uint64_t firstBlockIndex, int numBlocks, uint32_t *words) const;
+    uint32_t nextWord();
+    static double toDouble(uint32_t a, uint32_t b);
+
+  public:
+    cPhiloxRNG() {}
+    virtual ~cPhiloxRNG() {}
+
+    /** Sets up the RNG. */
+    virtual void configure(int seedSet, int rngId, int numRngs,
+                            int parsimProcId, int parsimNumPartitions,
+                            cConfiguration *cfg) override;
+
+    /** Sets the key and the stream directly, and rewinds the counter. */
+    void setSeed(uint64_t seed, uint32_t stream0, uint32_t stream1);
+
+    /** Tests correctness of the RNG */
+    virtual void selfTest() override;
+
+    /** Random integer in the range [0,intRandMax()] */
+    virtual uint32_t intRand() override;
+
+    /** Maximum value that can be returned by intRand() */
+    virtual uint32_t intRandMax() override;
+
+    /** Random integer in [0,n), n < intRandMax() */
+    virtual uint32_t intRand(uint32_t n) override;
+
+    /** Random double on the [0,1) interval, with 53 bits of randomness */
+    virtual double doubleRand() override;
+
+    /** Random double on the (0,1) interval */
+    virtual double doubleRandNonz() override;
+
+    /** Random double on the [0,1] interval */
+    virtual double doubleRandIncl1() override;
+
+    /** Fills the array with random doubles on the [0,1) interval */
+    virtual void fillDoubleRand(double *values, size_t n) override;
+};
+
+}  // namespace omnetpp
+
+
+#endif
@@ -28,7 +28,7 @@ class cConfiguration;
  * @brief Abstract interface for random number generator classes.
  *
  * Some known implementations are <tt>cMersenneTwister</tt>,
- * <tt>cLCG32</tt> and <tt>cAkaroaRNG</tt>. The actual RNG class
+ * <tt>cLCG32</tt>, <tt>cPhiloxRNG</tt> and <tt>cAkaroaRNG</tt>. The actual RNG class
  * to be used in simulations can be configured (a feature of the
  * Envir library).
  *
@@ -110,6 +110,13 @@ class SIM_API cRNG : public cObject
      * Random double on the (0,1] interval
      */
     double doubleRandNonzIncl1() {return 1-doubleRand();}
+
+    /**
+     * Fills the array with n random doubles on the [0,1) interval. The
+     * result is the same as that of n doubleRand() calls, but subclasses
+     * may redefine this method to generate the numbers more efficiently.
+     */
+    virtual void fillDoubleRand(double *values, size_t n) {for (size_t i = 0; i < n; i++) values[i] = doubleRand();}
 };
 
 }  // namespace omnetpp
@@ -55,6 +55,7 @@ class cIEventLoopRunner;
 
 namespace internal {
 class Stopwatch;
+class MemoryPool;
 }
 
 SIM_API extern OPP_THREAD_LOCAL cSoftOwner globalOwningContext; // also in globals.h
@@ -152,6 +153,7 @@ class SIM_API cSimulation : public cNamedObject, noncopyable
     simtime_t simTimeLimit = 0;         // simulation time limit (0 -> no limit)
     cEvent *endSimulationEvent = nullptr; // only present if simulation time limit is set
     internal::Stopwatch *stopwatch;        // elapsed time, CPU usage time, and related time limits
+    internal::MemoryPool *eventPool = nullptr; // for recycling the memory of event objects; nullptr if pooling is disabled
 
     State state = SIM_NONETWORK;        // simulation state
     Stage stage = STAGE_NONE;           // what the simulation is currently doing
@@ -223,6 +225,7 @@ class SIM_API cSimulation : public cNamedObject, noncopyable
     bool getParameterMutabilityCheck() const {return parameterMutabilityCheck;}
     void setUniqueNumberRange(uint64_t start, uint64_t end) {nextUniqueNumber = start; uniqueNumbersEnd = end;}
     void printUnusedConfigEntriesIfAny(std::ostream& out);
+    internal::MemoryPool *getEventPool() const {return eventPool;}
 
 #ifdef WITH_PYTHON
     // internal
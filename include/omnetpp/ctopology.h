@@ -17,6 +17,7 @@
 #define __OMNETPP_CTOPOLOGY_H
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "cownedobject.h"
 #include "csimulation.h"
@@ -343,6 +344,58 @@ class SIM_API cTopology : public cOwnedObject
         virtual bool matches(cModule *module) = 0;
     };
 
+    /**
+     * @brief Shortest paths from all nodes towards a set of target nodes,
+     * as computed by cTopology::calculateShortestPathTrees().
+     *
+     * For each (target, node) pair, only the index of the next outgoing link
+     * and the distance are stored, in flat arrays. The Node and Link pointers
+     * returned are only valid while the topology is not modified or deleted.
+     */
+    class SIM_API ShortestPathTrees
+    {
+        friend class cTopology;
+
+      private:
+        int numNodes = 0;
+        std::vector<Node*> nodes;  // copy of cTopology::nodes at the time of the calculation
+        std::unordered_map<const Node*,int> nodeIndices;
+        std::vector<Node*> targets;
+        std::unordered_map<const Node*,int> targetIndices;
+        std::vector<int> outLinkIndices;  // [targetIndex*numNodes+nodeIndex]: index into the node's outLinks[], or -1
+        std::vector<double> distances;  // [targetIndex*numNodes+nodeIndex]
+
+        int getIndex(const Node *node, const Node *target) const;
+
+      public:
+        /**
+         * Returns the number of target nodes.
+         */
+        int getNumTargets() const  {return targets.size();}
+
+        /**
+         * Returns the ith target node.
+         */
+        Node *getTarget(int i) const;
+
+        /**
+         * Returns true if paths towards the given node were calculated.
+         */
+        bool containsTarget(const Node *target) const  {return targetIndices.find(target) != targetIndices.end();}
+
+        /**
+         * Returns the distance of the given node to the target node, or
+         * INFINITY if the target is not reachable.
+         */
+        double getDistanceToTarget(const Node *node, const Node *target) const;
+
+        /**
+         * Returns the next link on the shortest path from the given node
+         * towards the target node, or nullptr if there is none.
+         */
+        LinkOut *getPathToTarget(const Node *node, const Node *target) const;
+    };
+
   protected:
     std::vector<Node*> nodes;
     Node *target = nullptr;
@@ -571,6 +624,17 @@ class SIM_API cTopology : public cOwnedObject
      * shortest path finding function.
      */
     virtual Node *getTargetNode() const {return target;}
+
+    /**
+     * Calculates the shortest paths towards each of the given target nodes
+     * (or all nodes if the vector is empty), on multiple threads. The result
+     * is the same as calling calculateWeightedSingleShortestPathsTo() (if
+     * weighted is true) or calculateUnweightedSingleShortestPathsTo() for
+     * each target in turn, but the paths are returned instead of being
+     * stored in the nodes. numThreads=0 means the number of CPU cores.
+     * The topology must not be modified while this method runs.
+     */
+    virtual ShortestPathTrees calculateShortestPathTrees(const std::vector<Node*>& targets, bool weighted, int numThreads=0) const;
     //@}
 
   protected:
@@ -110,7 +110,8 @@ namespace omnetpp {
  *    - cEvent represents a simulation event, but it is mostly intended for
  *      internal use (models should use cMessage)
  *    - cFutureEventSet represents the future events set (FES) of the simulation,
- *      and cEventHeap is its default, heap-based implementation
+ *      and cEventHeap is its default, heap-based implementation; cCalendarQueue
+ *      is an alternative suited for very large FES sizes
  *    - cScheduler is the interface for simulation event schedulers, and
  *      cSequentialScheduler and cRealTimeScheduler are its two built-in
  *      implementations
@@ -64,9 +64,18 @@
 #endif
 
 // choose coroutine library if unspecified
-#if !defined(USE_WIN32_FIBERS) && !defined(USE_POSIX_COROUTINES) && !defined(USE_PORTABLE_COROUTINES)
+#if defined(__SANITIZE_ADDRESS__)
+#  define _OPP_ASAN 1
+#elif defined(__has_feature)
+#  if __has_feature(address_sanitizer)
+#    define _OPP_ASAN 1
+#  endif
+#endif
+#if !defined(USE_WIN32_FIBERS) && !defined(USE_POSIX_COROUTINES) && !defined(USE_PORTABLE_COROUTINES) && !defined(USE_ASM_COROUTINES)
 #  if defined _WIN32
 #    define USE_WIN32_FIBERS
+#  elif PREFER_ASM_COROUTINES && (defined(__x86_64__) || defined(__aarch64__)) && !defined(_OPP_ASAN)  // AddressSanitizer only understands ucontext stack switches
+#    define USE_ASM_COROUTINES
 #  elif HAVE_SWAPCONTEXT
 #    define USE_POSIX_COROUTINES
 #  else
@@ -77,10 +86,13 @@
 // When building a shared library on Windows, some static thread_local variables would be exported with __declspec(dllexport)
 // which is not allowed by Windows. We do NOT support multithreaded execution of the simulation on Windows when the
 // simulation libarary is built as a shared lib.
+// OPP_HAS_THREAD_LOCAL tells whether OPP_THREAD_LOCAL variables are really thread-local.
 #if defined(_WIN32) && defined(WITH_SHARED_LIBS)
 #  define OPP_THREAD_LOCAL  /**/
+#  define OPP_HAS_THREAD_LOCAL  0
 #else
 #  define OPP_THREAD_LOCAL  thread_local
+#  define OPP_HAS_THREAD_LOCAL  1
 #endif
 
 #endif
@@ -23,23 +23,22 @@ def _load_files_into(rfm : sb.ResultFileManager, input_patterns : Union[str, Lis
     if type(input_patterns) == str:
         input_patterns = [ input_patterns ]
 
-    input_patterns = list(set(input_patterns))  # make unique
+    input_patterns = list(dict.fromkeys(input_patterns))  # make unique, keeping the order
 
     load_flags = sb.LoadFlags.LOADFLAGS_DEFAULTS
     # load_flags = RFM::NEVER_RELOAD | (indexingAllowed ? RFM::ALLOW_INDEXING : RFM::ALLOW_LOADING_WITHOUT_INDEX) | RFM::SKIP_IF_LOCKED | (verbose ? RFM::VERBOSE : 0);
 
+    files_to_load = []
     for file_arg in input_patterns:
-        files_to_load = []
-
         if os.path.isdir(file_arg):
             matching_files = glob.glob("*.sca", root_dir=file_arg, recursive=True)
             matching_files += glob.glob("*.vec", root_dir=file_arg, recursive=True)
-            files_to_load = [os.path.join(file_arg, gr) for gr in matching_files]
+            files_to_load += [os.path.join(file_arg, gr) for gr in matching_files]
         else: # even if it does not look like a glob pattern, nonexistent files shouldn't cause an error
-            files_to_load = glob.glob(file_arg, recursive=True)
+            files_to_load += glob.glob(file_arg, recursive=True)
 
-        for file_name in files_to_load:
-            rfm.loadFile(file_name, file_name, load_flags)
+    # the files are parsed on multiple threads, and added to rfm in this order
+    rfm.loadFiles(files_to_load, files_to_load, load_flags)
 
 
 def set_inputs(input_patterns : Union[str, List[str]]) -> None:
@@ -103,15 +102,10 @@ def _collect_results(rfm : sb.ResultFileManager, filter_expression : str, includ
             # TODO: memory limit? interrupt flag? precise X? event numbers?
             arrays = sb.readVectorsIntoArrays(rfm, sb.IDList(r), False, False, simTimeStart = vector_start_time, simTimeEnd = vector_end_time)
             array = arrays[0]
-            l = array.length()
-
-            times = np.empty(l, dtype=np.float64)
-            values = np.empty(l, dtype=np.float64)
-
-            sb.xyArrayToNumpyArrays(array, times, values)
 
-            row["vectime"] = times
-            row["vecvalue"] = values
+            # the data is handed over to NumPy without copying
+            row["vectime"] = array.takeX()
+            row["vecvalue"] = array.takeY()
         elif result_type == sb.ItemType.STATISTICS or result_type == sb.ItemType.HISTOGRAM:
             if result_type == sb.ItemType.HISTOGRAM:
                 row["type"] = "histogram"
@@ -381,13 +375,10 @@ def get_vectors(filter_expression, include_attrs, include_runattrs, include_iter
 
         array = arrays[i]
 
-        times = np.empty(array.length(), dtype=np.float64)
-        values = np.empty(array.length(), dtype=np.float64)
-
-        sb.xyArrayToNumpyArrays(array, times, values)
-
-        vectimes[i] = times
-        vecvalues[i] = values
+        # the data is handed over to NumPy without copying
+        vectimes[i] = array.takeX()
+        vecvalues[i] = array.takeY()
+        arrays[i] = None  # free the emptied XYArray
 
     df = pd.DataFrame({"runID" : runIDs, "module": modules, "name": names, "vectime": vectimes, "vecvalue": vecvalues})
 
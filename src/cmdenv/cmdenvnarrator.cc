@@ -34,6 +34,12 @@ void CmdenvNarrator::usingThreads(int numThreads)
         out << "Running simulations on " << numThreads << " threads\n";
 }
 
+void CmdenvNarrator::usingProcesses(int numProcesses)
+{
+    if (verbose)
+        out << "Running simulations in " << numProcesses << " worker processes\n";
+}
+
 void CmdenvNarrator::preparing(const char *configName, int runNumber)
 {
     if (verbose)
@@ -52,6 +52,7 @@ class ICmdenvNarrator
     virtual void setUseStderr(bool useStderr) {this->useStderr = useStderr;}
 
     virtual void usingThreads(int numThreads) = 0;
+    virtual void usingProcesses(int numProcesses) = 0;
     virtual void preparing(const char *configName, int runNumber) = 0;
     virtual void summary(int numRuns, int runsTried, int numErrors) = 0;
     virtual void beforeRedirecting(cConfiguration *cfg) = 0;
@@ -69,6 +70,7 @@ class CmdenvNarrator : public ICmdenvNarrator
   public:
     CmdenvNarrator(std::ostream& out) : ICmdenvNarrator(out) {}
     virtual void usingThreads(int numThreads) override;
+    virtual void usingProcesses(int numProcesses) override;
     virtual void preparing(const char *configName, int runNumber) override;
     virtual void summary(int numRuns, int runsTried, int numErrors) override;
     virtual void beforeRedirecting(cConfiguration *cfg) override;
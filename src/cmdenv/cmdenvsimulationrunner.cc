@@ -15,14 +15,24 @@
 *--------------------------------------------------------------*/
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <csignal>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
+#include <mutex>
 #include <sstream>
 #include <thread>
 
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #include "cmddefs.h"
 #include "cmdenvapp.h"
 #include "common/fileutil.h"
@@ -31,12 +41,16 @@
 #include "envir/genericenvir.h"
 #include "envir/genericeventlooprunner.h"
 #include "envir/inifilecontents.h"
+#include "envir/networkpartitioner.h"
 #include "envir/resultfileutils.h"
 #include "omnetpp/ccomponenttype.h"
 #include "omnetpp/cconfigoption.h"
 #include "omnetpp/checkandcast.h"
 #include "omnetpp/ceventlooprunner.h"
 #include "sim/netbuilder/cnedloader.h"
+#ifdef WITH_PARSIM
+#include "sim/parsim/csharedmemorycomm.h"
+#endif
 #include "cmdenvsimulationrunner.h"
 #include "cmdenvnarrator.h"
 #include "cmdenvenvir.h"
@@ -57,7 +71,10 @@ namespace cmdenv {
 Register_GlobalConfigOption(CFGID_CMDENV_CONFIG_NAME, "cmdenv-config-name", CFG_STRING, nullptr, "Specifies the name of the configuration to be run (for a value `Foo`, section `[Config Foo]` will be used from the ini file). See also `cmdenv-runs-to-execute`. The `-c` command line option overrides this setting.")
 Register_GlobalConfigOption(CFGID_CMDENV_RUNS_TO_EXECUTE, "cmdenv-runs-to-execute", CFG_STRING, nullptr, "Specifies which runs to execute from the selected configuration (see `cmdenv-config-name` option). It accepts a filter expression of iteration variables such as `$numHosts>10 && $iatime==1s`, or a comma-separated list of run numbers or run number ranges, e.g. `1,3..4,7..9`. If the value is missing, CmdenvCore executes all runs in the selected configuration. The `-r` command line option overrides this setting.")
 Register_GlobalConfigOption(CFGID_CMDENV_STOP_BATCH_ON_ERROR, "cmdenv-stop-batch-on-error", CFG_BOOL, "true", "Decides whether CmdenvCore should skip the rest of the runs when an error occurs during the execution of one run.")
-Register_GlobalConfigOption(CFGID_CMDENV_NUM_THREADS, "cmdenv-num-threads", CFG_INT, "1", "Specifies the number of threads to use when running multiple simulations is requested. (Each simulation will still run sequentially in its thread.) When -1 is given, the number of concurrent threads supported by the hardware will be used.");
+Register_GlobalConfigOption(CFGID_CMDENV_NUM_THREADS, "cmdenv-num-threads", CFG_INT, "1", "Specifies the number of threads to use when running multiple simulations is requested. (Each simulation will still run sequentially in its thread.) Threads take the next run from a shared queue whenever they become free. When -1 is given, the number of concurrent threads supported by the hardware will be used.");
+Register_GlobalConfigOption(CFGID_CMDENV_NUM_PROCESSES, "cmdenv-num-processes", CFG_INT, "1", "Specifies the number of worker processes to use when running multiple simulations is requested. The worker processes are forked from Cmdenv after the NED files have been loaded, and take the next run from Cmdenv whenever they become free. This is an alternative to `cmdenv-num-threads` for models that are not thread-safe. When -1 is given, the number of concurrent threads supported by the hardware will be used. Not supported on Windows.");
+Register_GlobalConfigOption(CFGID_CMDENV_FORK_PER_RUN, "cmdenv-fork-per-run", CFG_BOOL, "false", "When set, each run is executed in a new process forked from Cmdenv after the run-independent setup (configuration, libraries, NED files) has been done. The shared setup is thus only done once and shared copy-on-write, while no state (static variables, ID counters, caches) is carried over from one run to the next, so results are identical to those of separate Cmdenv invocations. May be combined with `cmdenv-num-processes` to set the number of concurrent runs. Not supported on Windows.");
+Register_GlobalConfigOption(CFGID_CMDENV_RUN_DURATIONS_FILE, "cmdenv-run-durations-file", CFG_FILENAME, nullptr, "Name of a file where Cmdenv records the wall-clock duration of each run. If the file already exists when a batch is started, runs are started in decreasing order of their recorded durations (runs not found in the file go first), which helps utilizing all threads or processes until the end of the batch. The value is taken from the first run of the batch.");
 
 Register_GlobalConfigOption(CFGID_CMDENV_OUTPUT_FILE, "cmdenv-output-file", CFG_FILENAME, "${resultdir}/${configname}-${iterationvarsf}#${repetition}.out", "When `cmdenv-record-output=true`: file name to redirect standard output to. See also `fname-append-host`.")
 Register_GlobalConfigOption(CFGID_CMDENV_REDIRECT_OUTPUT, "cmdenv-redirect-output", CFG_BOOL, "false", "Causes Cmdenv to redirect standard output of simulation runs to a file or separate files per run. This option can be useful with running simulation campaigns (e.g. using opp_runall), and also with parallel simulation. See also: `cmdenv-output-file`, `fname-append-host`.");
@@ -67,6 +84,10 @@ Register_GlobalConfigOption(CFGID_CMDENV_EVENT_BANNERS, "cmdenv-event-banners",
 Register_GlobalConfigOption(CFGID_CMDENV_EVENT_BANNER_DETAILS, "cmdenv-event-banner-details", CFG_BOOL, "false", "When `cmdenv-express-mode=false`: print extra information after event banners.")
 Register_GlobalConfigOptionU(CFGID_CMDENV_STATUS_FREQUENCY, "cmdenv-status-frequency", "s", "2s", "When `cmdenv-express-mode=true`: print status update every n seconds.")
 Register_GlobalConfigOption(CFGID_CMDENV_PERFORMANCE_DISPLAY, "cmdenv-performance-display", CFG_BOOL, "true", "When `cmdenv-express-mode=true`: print detailed performance information. Turning it on results in a 3-line entry printed on each update, containing ev/sec, simsec/sec, ev/simsec, number of messages created/still present/currently scheduled in FES.")
+Register_GlobalConfigOption(CFGID_CMDENV_PARTITIONING_NUM_PARTITIONS, "cmdenv-partitioning-num-partitions", CFG_INT, "0", "When nonzero, Cmdenv does not run the simulation, but computes a partitioning of the network into the given number of partitions for parallel simulation, and prints it as `partition-id` lines that can be included in an ini file. The submodules of the network are assigned to partitions so that the minimum delay of the links between partitions (the lookahead) is maximized while the partitions are balanced, and the number of links (or messages) between partitions is small. Requires `parallel-simulation=false`. See also `cmdenv-partitioning-measure-load`, `cmdenv-partitioning-imbalance-tolerance`, `cmdenv-partitioning-output-file`.");
+Register_GlobalConfigOption(CFGID_CMDENV_PARTITIONING_MEASURE_LOAD, "cmdenv-partitioning-measure-load", CFG_BOOL, "false", "When `cmdenv-partitioning-num-partitions` is set: run the simulation before computing the partitioning, and balance the partitions by the measured number of events instead of the number of simple modules, and minimize the measured number of messages between partitions instead of the number of links. A `sim-time-limit` should be set to make the measurement finish.");
+Register_GlobalConfigOption(CFGID_CMDENV_PARTITIONING_IMBALANCE_TOLERANCE, "cmdenv-partitioning-imbalance-tolerance", CFG_DOUBLE, "0.1", "When `cmdenv-partitioning-num-partitions` is set: the allowed imbalance of the partitions, as a fraction of the average load. For example, 0.1 allows the largest partition to be 10% above the average. A larger tolerance allows a larger lookahead.");
+Register_GlobalConfigOption(CFGID_CMDENV_PARTITIONING_OUTPUT_FILE, "cmdenv-partitioning-output-file", CFG_FILENAME, nullptr, "When `cmdenv-partitioning-num-partitions` is set: the file to write the partitioning into. When not set, the partitioning is printed on the standard output.");
 
 // Used for graceful exit when Ctrl-C is hit during simulation. We want to finish the
 // current event, then normally exit via callFinish() so that simulation results are not lost.
@@ -120,25 +141,40 @@ CmdenvSimulationRunner::BatchResult CmdenvSimulationRunner::runParameterStudy(In
 
     cConfiguration *masterCfg = ini->extractConfig(configName, runNumbers[0]);
     int numThreads = masterCfg->getAsInt(CFGID_CMDENV_NUM_THREADS);
+    int numProcesses = masterCfg->getAsInt(CFGID_CMDENV_NUM_PROCESSES);
+    bool forkPerRun = masterCfg->getAsBool(CFGID_CMDENV_FORK_PER_RUN);
+    std::string durationsFile = masterCfg->getAsFilename(CFGID_CMDENV_RUN_DURATIONS_FILE);
     delete masterCfg;
 
     bool threaded = numThreads != 1;
+    bool multiProcess = numProcesses != 1 || forkPerRun;
+
+    if (threaded && multiProcess)
+        throw cRuntimeError("Options %s and %s cannot be used together", CFGID_CMDENV_NUM_THREADS->getName(), (forkPerRun ? CFGID_CMDENV_FORK_PER_RUN : CFGID_CMDENV_NUM_PROCESSES)->getName());
 
 #if defined(_WIN32) && defined(WITH_SHARED_LIBS)
     if (threaded)
         throw cRuntimeError("Multi-threaded execution is not supported on Windows when the simulation library is built as a DLL.");
 #endif
 
+    if (!durationsFile.empty())
+        orderRunsByDuration(runNumbers, configName, durationsFile.c_str());
+
     BatchResult result;
     result.numRuns = (int)runNumbers.size();
 
-    if (!threaded)
-        result = runSimulations(ini, configName, runNumbers); // does not throw
-    else
+    if (multiProcess)
+        result = runSimulationsInProcesses(ini, configName, runNumbers, numProcesses, forkPerRun); // does not throw
+    else if (threaded)
         result = runSimulationsInThreads(ini, configName, runNumbers, numThreads); // does not throw
+    else
+        result = runSimulations(ini, configName, runNumbers); // does not throw
 
     narrator->summary(result.numRuns, result.runsTried, result.numErrors);
 
+    if (!durationsFile.empty())
+        writeRunDurations(configName, durationsFile.c_str(), result.runDurations);
+
     return result;
 }
 
@@ -172,24 +208,23 @@ CmdenvSimulationRunner::BatchResult CmdenvSimulationRunner::runSimulationsInThre
     ensureNedLoader(firstCfg);
     delete firstCfg;
 
-    // statically assign jobs to threads
-    std::vector<std::vector<int>> runListPerThread(numThreads);
-    for (int i = 0; i < runNumbers.size(); i++)
-        runListPerThread[i % numThreads].push_back(runNumbers[i]);
+    // threads take jobs from a shared queue, so that none of them runs out of work while there are runs left
+    RunQueue queue(runNumbers);
 
     narrator->usingThreads(numThreads);
 
     BatchState state;
+    state.numRuns = (int)runNumbers.size();
 
     Py_BEGIN_ALLOW_THREADS
 
     // create and launch threads
     std::vector<std::thread> threads;
     for (int i = 0; i < numThreads; i++) {
-        auto fn = [this](BatchState *state, InifileContents *ini, std::string configName, std::vector<int> runNumbers) {
-            doRunSimulations(*state, ini, configName.c_str(), runNumbers);
+        auto fn = [this](BatchState *state, InifileContents *ini, std::string configName, RunQueue *queue) {
+            doRunSimulations(*state, ini, configName.c_str(), *queue);
         };
-        threads.push_back(std::thread(fn, &state, ini, configName, runListPerThread[i]));
+        threads.push_back(std::thread(fn, &state, ini, configName, &queue));
     }
 
     // wait for them to finish
@@ -201,6 +236,254 @@ CmdenvSimulationRunner::BatchResult CmdenvSimulationRunner::runSimulationsInThre
     return extractResult(state);
 }
 
+#ifndef _WIN32
+
+namespace {
+
+// message sent by worker processes after each run
+struct WorkerReport {
+    int runNumber;
+    bool completed;
+    bool stopBatchOnError;
+    double duration;
+};
+
+struct Worker {
+    pid_t pid = -1;
+    int writeFd = -1;  // for sending run numbers to the worker
+    int readFd = -1;   // for receiving reports
+    int runNumber = -1;  // the run being executed, or -1 if idle
+};
+
+bool readFully(int fd, void *data, size_t size)
+{
+    char *p = (char *)data;
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool writeFully(int fd, const void *data, size_t size)
+{
+    const char *p = (const char *)data;
+    while (size > 0) {
+        ssize_t n = write(fd, p, size);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+void closeFd(int& fd)
+{
+    if (fd != -1)
+        close(fd);
+    fd = -1;
+}
+
+}  // namespace
+
+#endif
+
+CmdenvSimulationRunner::BatchResult CmdenvSimulationRunner::runSimulationsInProcesses(InifileContents *ini, const char *configName, const std::vector<int>& runNumbers, int numProcesses, bool forkPerRun)
+{
+#ifdef _WIN32
+    throw cRuntimeError("Running simulations in multiple processes is not supported on Windows");
+#else
+    if (numProcesses <= 0) {
+        numProcesses = std::thread::hardware_concurrency();
+        if (numProcesses <= 0)
+            numProcesses = 1;
+    }
+    numProcesses = std::min(numProcesses, (int)runNumbers.size());
+
+    // load NED files before forking, so that workers inherit them
+    cConfiguration *firstCfg = ini->extractConfig(configName, runNumbers[0]);
+    ensureNedLoader(firstCfg);
+    bool stopBatchOnError = firstCfg->getAsBool(CFGID_CMDENV_STOP_BATCH_ON_ERROR);
+    delete firstCfg;
+
+    narrator->usingProcesses(numProcesses);
+
+    BatchState state;
+    state.numRuns = (int)runNumbers.size();
+    state.stopBatchOnError = stopBatchOnError;  // updated from the reports of the workers
+    RunQueue queue(runNumbers);
+    std::vector<Worker> workers(numProcesses);
+
+    auto startWorker = [&](Worker& worker) {
+        int toWorker[2], fromWorker[2];
+        if (pipe(toWorker) != 0)
+            throw cRuntimeError("Cannot create pipe: %s", strerror(errno));
+        if (pipe(fromWorker) != 0) {
+            close(toWorker[0]); close(toWorker[1]);
+            throw cRuntimeError("Cannot create pipe: %s", strerror(errno));
+        }
+
+        // avoid printing buffered output twice
+        out.flush();
+        fflush(stdout);
+
+        pid_t pid = fork();
+        if (pid < 0)
+            throw cRuntimeError("Cannot create worker process: %s", strerror(errno));
+        if (pid == 0) {
+            // child: close the pipes of other workers, so that they see EOF when Cmdenv closes them
+            for (Worker& other : workers) {
+                closeFd(other.writeFd);
+                closeFd(other.readFd);
+            }
+            close(toWorker[1]);
+            close(fromWorker[0]);
+            runWorkerProcess(toWorker[0], fromWorker[1], ini, configName);
+            out.flush();
+            fflush(stdout);
+            _exit(0);
+        }
+        close(toWorker[0]);
+        close(fromWorker[1]);
+        worker.pid = pid;
+        worker.writeFd = toWorker[1];
+        worker.readFd = fromWorker[0];
+        worker.runNumber = -1;
+    };
+
+    auto retireWorker = [&](Worker& worker) {
+        closeFd(worker.writeFd);
+        closeFd(worker.readFd);
+        waitpid(worker.pid, nullptr, 0);
+        worker.pid = -1;
+        worker.runNumber = -1;
+    };
+
+    // sends the next run to the worker (starting it if needed), or tells it to exit if there is nothing more to do
+    auto dispatch = [&](Worker& worker) {
+        int runNumber;
+        bool stopping = sigintReceived || (state.stopBatchOnError && state.numErrors > 0);
+        if (!stopping && queue.takeNext(runNumber)) {
+            if (worker.pid == -1)
+                startWorker(worker);
+            state.runsTried++;
+            worker.runNumber = runNumber;
+            if (writeFully(worker.writeFd, &runNumber, sizeof(runNumber))) {
+                if (forkPerRun)
+                    closeFd(worker.writeFd);  // no further runs for this process
+                return;
+            }
+            worker.runNumber = -1;
+            cRuntimeError e("Cannot send run #%d to worker process %d", runNumber, (int)worker.pid);
+            narrator->displayException(e);
+            state.numErrors++;
+        }
+        closeFd(worker.writeFd);  // the worker exits when it sees EOF
+    };
+
+    try {
+        for (Worker& worker : workers)
+            dispatch(worker);
+
+        // collect reports and hand out further runs until all workers are idle
+        while (true) {
+            std::vector<pollfd> fds;
+            std::vector<Worker*> busyWorkers;
+            for (Worker& worker : workers) {
+                if (worker.runNumber != -1) {
+                    fds.push_back({worker.readFd, POLLIN, 0});
+                    busyWorkers.push_back(&worker);
+                }
+            }
+            if (fds.empty())
+                break;
+
+            int n = poll(fds.data(), fds.size(), -1);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;  // probably SIGINT; workers will report back after finishing the current run
+                throw cRuntimeError("poll() failed: %s", strerror(errno));
+            }
+
+            for (size_t i = 0; i < fds.size(); i++) {
+                if (fds[i].revents == 0)
+                    continue;
+                Worker& worker = *busyWorkers[i];
+                WorkerReport report;
+                if (readFully(worker.readFd, &report, sizeof(report))) {
+                    if (report.completed)
+                        state.numCompleted++;
+                    else {
+                        state.numErrors++;
+                        state.stopBatchOnError = report.stopBatchOnError;
+                    }
+                    state.runDurations[report.runNumber] = report.duration;
+                    worker.runNumber = -1;
+                    if (forkPerRun)
+                        retireWorker(worker);  // the next run gets a fresh process
+                    dispatch(worker);
+                }
+                else {
+                    // worker died (e.g. crashed) during the run; replace it with a new one
+                    cRuntimeError e("Worker process %d terminated unexpectedly during run #%d", (int)worker.pid, worker.runNumber);
+                    narrator->displayException(e);
+                    state.numErrors++;
+                    retireWorker(worker);
+                    dispatch(worker);
+                }
+            }
+        }
+    }
+    catch (std::exception& e) {
+        narrator->displayException(e);
+        state.numErrors++;
+    }
+
+    // wait for the workers to exit
+    for (Worker& worker : workers) {
+        closeFd(worker.writeFd);
+        closeFd(worker.readFd);
+        if (worker.pid > 0)
+            waitpid(worker.pid, nullptr, 0);
+    }
+
+    return extractResult(state);
+#endif
+}
+
+void CmdenvSimulationRunner::runWorkerProcess(int readFd, int writeFd, InifileContents *ini, const char *configName)
+{
+#ifndef _WIN32
+    // run what Cmdenv sends us, until it closes the pipe
+    int runNumber;
+    while (readFully(readFd, &runNumber, sizeof(runNumber))) {
+        BatchState state;
+        state.numRuns = 1;
+        doRunSimulationInBatch(state, ini, configName, runNumber);
+        out.flush();
+        fflush(stdout);
+
+        WorkerReport report;
+        report.runNumber = runNumber;
+        report.completed = state.numCompleted > 0;
+        report.stopBatchOnError = state.stopBatchOnError;
+        report.duration = state.runDurations[runNumber];
+        if (!writeFully(writeFd, &report, sizeof(report)))
+            break;
+    }
+    close(readFd);
+    close(writeFd);
+#endif
+}
+
 CmdenvSimulationRunner::BatchResult CmdenvSimulationRunner::runSimulations(InifileContents *ini, const char *configName, const std::vector<int>& runNumbers)
 {
     BatchState state;
@@ -211,23 +494,61 @@ CmdenvSimulationRunner::BatchResult CmdenvSimulationRunner::runSimulations(Inifi
 void CmdenvSimulationRunner::doRunSimulations(BatchState& state, InifileContents *ini, const char *configName, const std::vector<int>& runNumbers)
 {
     state.numRuns = (int)runNumbers.size();
-    for (int runNumber : runNumbers) {
-        try {
-            state.runsTried++;
-            doRunSimulation(state, ini, configName, runNumber);
-            state.numCompleted++;
-        }
-        catch (std::exception& e) {
-            narrator->displayException(e);  // note: must take care not to print again if it was already printed
-            state.numErrors++;
-            if (state.stopBatchOnError)
-                break;
-        }
+    for (int runNumber : runNumbers)
+        if (!doRunSimulationInBatch(state, ini, configName, runNumber))
+            break;
+}
 
-        // skip further runs if signal was caught
-        if (sigintReceived)
+void CmdenvSimulationRunner::doRunSimulations(BatchState& state, InifileContents *ini, const char *configName, RunQueue& queue)
+{
+    int runNumber;
+    while (queue.takeNext(runNumber))
+        if (!doRunSimulationInBatch(state, ini, configName, runNumber))
             break;
+}
+
+bool CmdenvSimulationRunner::doRunSimulationInBatch(BatchState& state, InifileContents *ini, const char *configName, int runNumber)
+{
+    // stop if another thread has already stopped the batch
+    if ((state.stopBatchOnError && state.numErrors > 0) || sigintReceived)
+        return false;
+
+    auto startTime = std::chrono::steady_clock::now();
+    bool ok = true;
+    try {
+        state.runsTried++;
+        doRunSimulation(state, ini, configName, runNumber);
+        state.numCompleted++;
     }
+    catch (std::exception& e) {
+        narrator->displayException(e);  // note: must take care not to print again if it was already printed
+        state.numErrors++;
+        ok = false;
+    }
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - startTime;
+
+    {
+        std::lock_guard<std::mutex> lock(state.durationsMutex);
+        state.runDurations[runNumber] = duration.count();
+    }
+
+    if (!ok && state.stopBatchOnError)
+        return false;
+
+    // skip further runs if signal was caught
+    if (sigintReceived)
+        return false;
+    return true;
+}
+
+bool CmdenvSimulationRunner::RunQueue::takeNext(int& runNumber)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (runNumbers.empty())
+        return false;
+    runNumber = runNumbers.front();
+    runNumbers.pop_front();
+    return true;
 }
 
 void CmdenvSimulationRunner::runSimulation(InifileContents *ini, const char *configName, int runNumber)
@@ -241,10 +562,68 @@ void CmdenvSimulationRunner::doRunSimulation(BatchState& state, InifileContents
     narrator->preparing(configName, runNumber);
 
     std::unique_ptr<cConfiguration> cfg(ini->extractConfig(configName, runNumber));
+
+#ifdef WITH_PARSIM
+    int numPartitionThreads = cSharedMemoryCommunications::getNumPartitionThreads(cfg.get());
+    if (numPartitionThreads > 0) {
+        runPartitionsInThreads(state, ini, configName, runNumber, numPartitionThreads);
+        return;
+    }
+#endif
+
     cTerminationException *reason = setupAndRunSimulation(state, cfg.get());
     delete reason;
 }
 
+void CmdenvSimulationRunner::runPartitionsInThreads(BatchState& state, InifileContents *ini, const char *configName, int runNumber, int numPartitions)
+{
+    // the partitions share the NED loader, so load the NED files before launching the threads
+    std::unique_ptr<cConfiguration> firstCfg(ini->extractConfig(configName, runNumber));
+    ensureNedLoader(firstCfg.get());
+
+    // the first error is the original one, other partitions only report what they received from it
+    std::exception_ptr firstError;
+    std::mutex errorMutex;
+
+    // set when a partition fails, so that the others stop waiting for it
+    std::atomic<bool> aborted(false);
+
+    Py_BEGIN_ALLOW_THREADS
+
+    // create and launch threads, one for each partition
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numPartitions; i++) {
+        auto fn = [this, &firstError, &errorMutex, &aborted](BatchState *state, InifileContents *ini, std::string configName, int runNumber, int procId) {
+            try {
+#ifdef WITH_PARSIM
+                // also makes the redirected output file names of the partitions different
+                cSharedMemoryCommunications::setThreadProcId(procId);
+                cSharedMemoryCommunications::setThreadAbortFlag(&aborted);
+#endif
+                std::unique_ptr<cConfiguration> cfg(ini->extractConfig(configName.c_str(), runNumber));
+                cTerminationException *reason = setupAndRunSimulation(*state, cfg.get());
+                delete reason;
+            }
+            catch (std::exception& e) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!firstError)
+                    firstError = std::current_exception();
+                aborted = true;
+            }
+        };
+        threads.push_back(std::thread(fn, &state, ini, configName, runNumber, i));
+    }
+
+    // wait for them to finish
+    for (int i = 0; i < numPartitions; i++)
+        threads[i].join();
+
+    Py_END_ALLOW_THREADS
+
+    if (firstError)
+        std::rethrow_exception(firstError);
+}
+
 cTerminationException *CmdenvSimulationRunner::setupAndRunSimulation(BatchState& state, cConfiguration *cfg)
 {
     state.stopBatchOnError = cfg->getAsBool(CFGID_CMDENV_STOP_BATCH_ON_ERROR);
@@ -285,6 +664,13 @@ cTerminationException *CmdenvSimulationRunner::setupAndRunSimulation(BatchState&
     try {
         simulation->setupNetwork(cfg);
 
+        int numPartitions = cfg->getAsInt(CFGID_CMDENV_PARTITIONING_NUM_PARTITIONS);
+        if (numPartitions > 0) {
+            computePartitioning(simulation, cfg, simout, numPartitions);
+            simulation->deleteNetwork();
+            return nullptr;
+        }
+
         bool isTerminated = !simulation->run(runner, true);
         if (!isTerminated)
             throw cRuntimeError("Simulation paused before running to completion");
@@ -312,6 +698,36 @@ cTerminationException *CmdenvSimulationRunner::setupAndRunSimulation(BatchState&
     }
 }
 
+void CmdenvSimulationRunner::computePartitioning(cSimulation *simulation, cConfiguration *cfg, std::ostream& simout, int numPartitions)
+{
+    if (simulation->isParsimEnabled())
+        throw cRuntimeError("Option %s cannot be used with parallel simulation, set parallel-simulation=false", CFGID_CMDENV_PARTITIONING_NUM_PARTITIONS->getName());
+
+    NetworkPartitioner partitioner(simulation);
+    partitioner.buildGraph();
+
+    if (cfg->getAsBool(CFGID_CMDENV_PARTITIONING_MEASURE_LOAD)) {
+        LoadMeasuringEventLoopRunner runner(simulation, &partitioner, sigintReceived);
+        bool isTerminated = !simulation->run(&runner, true);
+        if (!isTerminated)
+            throw cRuntimeError("Simulation paused before running to completion");
+    }
+
+    partitioner.partition(numPartitions, cfg->getAsDouble(CFGID_CMDENV_PARTITIONING_IMBALANCE_TOLERANCE));
+
+    std::string fileName = cfg->getAsFilename(CFGID_CMDENV_PARTITIONING_OUTPUT_FILE);
+    if (fileName.empty())
+        partitioner.print(simout);
+    else {
+        mkPath(directoryOf(fileName.c_str()).c_str());
+        std::ofstream fout(fileName);
+        if (!fout.is_open())
+            throw cRuntimeError("Cannot open file '%s' for write", fileName.c_str());
+        partitioner.print(fout);
+        simout << "Partitioning written to '" << fileName << "'" << std::endl;
+    }
+}
+
 cSimulation *CmdenvSimulationRunner::createSimulation(std::ostream& simout)
 {
     CmdenvEnvir *envir = new CmdenvEnvir(simout, sigintReceived);
@@ -342,9 +758,71 @@ CmdenvSimulationRunner::BatchResult CmdenvSimulationRunner::extractResult(const
     result.numCompleted = state.numCompleted;
     result.numInterrupted = state.numInterrupted;
     result.numErrors = state.numErrors;
+    result.runDurations = state.runDurations;
+    return result;
+}
+
+void CmdenvSimulationRunner::orderRunsByDuration(std::vector<int>& runNumbers, const char *configName, const char *durationsFile)
+{
+    // longest first; runs with unknown duration are assumed to be long
+    std::map<int,double> durations = readRunDurations(configName, durationsFile);
+    auto durationOf = [&](int runNumber) {
+        auto it = durations.find(runNumber);
+        return it == durations.end() ? INFINITY : it->second;
+    };
+    std::stable_sort(runNumbers.begin(), runNumbers.end(), [&](int a, int b) {return durationOf(a) > durationOf(b);});
+}
+
+std::map<int,double> CmdenvSimulationRunner::readRunDurations(const char *configName, const char *durationsFile)
+{
+    // file format: one "<configName> <runNumber> <seconds>" line per run
+    std::map<int,double> result;
+    std::ifstream in(durationsFile);
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream is(line);
+        std::string config;
+        int runNumber;
+        double duration;
+        if (is >> config >> runNumber >> duration && config == configName)
+            result[runNumber] = duration;
+    }
     return result;
 }
 
+void CmdenvSimulationRunner::writeRunDurations(const char *configName, const char *durationsFile, const std::map<int,double>& runDurations)
+{
+    if (runDurations.empty())
+        return;
+
+    // keep the entries of other configs and of the runs not executed now
+    std::map<std::pair<std::string,int>,double> entries;
+    {
+        std::ifstream in(durationsFile);
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream is(line);
+            std::string config;
+            int runNumber;
+            double duration;
+            if (is >> config >> runNumber >> duration)
+                entries[std::make_pair(config, runNumber)] = duration;
+        }
+    }
+    for (const auto& pair : runDurations)
+        entries[std::make_pair(std::string(configName), pair.first)] = pair.second;
+
+    mkPath(directoryOf(durationsFile).c_str());
+    std::ofstream outFile(durationsFile);
+    if (!outFile.is_open()) {
+        cRuntimeError e("Cannot open file '%s' for write", durationsFile);
+        narrator->displayException(e);
+        return;
+    }
+    for (const auto& entry : entries)
+        outFile << entry.first.first << " " << entry.first.second << " " << entry.second << "\n";
+}
+
 
 void CmdenvSimulationRunner::sigintHandler(int signum)
 {
@@ -18,6 +18,8 @@
 
 #include <map>
 #include <atomic>
+#include <deque>
+#include <mutex>
 #include <thread>
 #include "envir/args.h"
 #include "omnetpp/csimulation.h"
@@ -41,6 +43,7 @@ class CMDENV_API CmdenvSimulationRunner
          int numCompleted;
          int numInterrupted;
          int numErrors;
+         std::map<int,double> runDurations; // runNumber -> wall-clock seconds
     };
 
    protected:
@@ -59,6 +62,18 @@ class CMDENV_API CmdenvSimulationRunner
           std::atomic_int numInterrupted{0};
           std::atomic_int numErrors{0};
           std::atomic_bool stopBatchOnError{0};
+          std::mutex durationsMutex;
+          std::map<int,double> runDurations; // runNumber -> wall-clock seconds
+     };
+
+     // runs not yet started; threads/processes take the next one when they become free
+     class RunQueue {
+        private:
+          std::mutex mutex;
+          std::deque<int> runNumbers;
+        public:
+          RunQueue(const std::vector<int>& runNumbers) : runNumbers(runNumbers.begin(), runNumbers.end()) {}
+          bool takeNext(int& runNumber);
      };
 
    protected:
@@ -70,9 +85,17 @@ class CMDENV_API CmdenvSimulationRunner
      // internal
      virtual void ensureNedLoader(cConfiguration *cfg);
      virtual void doRunSimulations(BatchState& state, InifileContents *ini, const char *configName, const std::vector<int>& runNumbers);
+     virtual void doRunSimulations(BatchState& state, InifileContents *ini, const char *configName, RunQueue& queue);
+     virtual bool doRunSimulationInBatch(BatchState& state, InifileContents *ini, const char *configName, int runNumber); // returns false if the batch should be stopped
+     virtual void runWorkerProcess(int readFd, int writeFd, InifileContents *ini, const char *configName);
      virtual void doRunSimulation(BatchState& state, InifileContents *ini, const char *configName, int runNumber); // note: throws on error
+     virtual void runPartitionsInThreads(BatchState& state, InifileContents *ini, const char *configName, int runNumber, int numPartitions); // note: throws on error
      virtual BatchResult extractResult(const BatchState& state);
+     virtual void orderRunsByDuration(std::vector<int>& runNumbers, const char *configName, const char *durationsFile);
+     virtual std::map<int,double> readRunDurations(const char *configName, const char *durationsFile);
+     virtual void writeRunDurations(const char *configName, const char *durationsFile, const std::map<int,double>& runDurations);
      virtual cTerminationException *setupAndRunSimulation(BatchState& state, cConfiguration *cfg);
+     virtual void computePartitioning(cSimulation *simulation, cConfiguration *cfg, std::ostream& simout, int numPartitions);
      static void sigintHandler(int signum);
 
    public:
@@ -89,6 +112,7 @@ class CMDENV_API CmdenvSimulationRunner
      virtual BatchResult runParameterStudy(InifileContents *ini, const char *configName, const char *runFilter);
      virtual BatchResult runSimulations(InifileContents *ini, const char *configName, const std::vector<int>& runNumbers);
      virtual BatchResult runSimulationsInThreads(InifileContents *ini, const char *configName, const std::vector<int>& runNumbers, int numThreads=-1);
+     virtual BatchResult runSimulationsInProcesses(InifileContents *ini, const char *configName, const std::vector<int>& runNumbers, int numProcesses=-1, bool forkPerRun=false);
      virtual void runSimulation(InifileContents *ini, const char *configName, int runNumber); // note: throws on error
 };
 
@@ -0,0 +1,101 @@
+//==========================================================================
+//  BACKGROUNDWRITER.CC - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include "backgroundwriter.h"
+
+namespace omnetpp {
+namespace common {
+
+BackgroundWriter::BackgroundWriter(size_t costLimit) : costLimit(costLimit)
+{
+    thread = std::thread(&BackgroundWriter::run, this);
+}
+
+BackgroundWriter::~BackgroundWriter()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobsChanged.notify_all();
+    thread.join();
+}
+
+void BackgroundWriter::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        jobsChanged.wait(lock, [this] {return stopping || !jobs.empty();});
+        if (jobs.empty())
+            break;  // stopping, and nothing left to do
+
+        Entry entry = std::move(jobs.front());
+        jobs.pop_front();
+        busy = true;
+        if (!error) {
+            lock.unlock();
+            try {
+                entry.job();
+            }
+            catch (...) {
+                lock.lock();
+                error = std::current_exception();
+                lock.unlock();
+            }
+            entry.job = nullptr;  // release captured data outside the lock
+            lock.lock();
+        }
+        busy = false;
+        pendingCost -= entry.cost;
+        jobsChanged.notify_all();
+    }
+}
+
+void BackgroundWriter::submit(Job job, size_t cost)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (costLimit != 0)
+        jobsChanged.wait(lock, [this,cost] {return error || pendingCost == 0 || pendingCost + cost <= costLimit;});
+    if (error)
+        std::rethrow_exception(error);
+    jobs.push_back(Entry{std::move(job), cost});
+    pendingCost += cost;
+    lock.unlock();
+    jobsChanged.notify_all();
+}
+
+void BackgroundWriter::drain()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    jobsChanged.wait(lock, [this] {return jobs.empty() && !busy;});
+    if (error)
+        std::rethrow_exception(error);
+}
+
+bool BackgroundWriter::hasError()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    return error != nullptr;
+}
+
+void BackgroundWriter::checkError()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (error)
+        std::rethrow_exception(error);
+}
+
+}  // namespace common
+}  // namespace omnetpp
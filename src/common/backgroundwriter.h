@@ -0,0 +1,102 @@
+//==========================================================================
+//  BACKGROUNDWRITER.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_COMMON_BACKGROUNDWRITER_H
+#define __OMNETPP_COMMON_BACKGROUNDWRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "commondefs.h"
+
+namespace omnetpp {
+namespace common {
+
+/**
+ * A dedicated I/O thread that executes jobs (typically formatting and
+ * writing out a block of buffered data) in submission order. Result file
+ * writers use it to take file I/O off the simulation thread.
+ *
+ * Each job has a cost (e.g. the number of samples it holds). submit() blocks
+ * while the total cost of pending jobs would exceed the limit, which bounds
+ * memory usage and provides backpressure when the disk cannot keep up.
+ *
+ * If a job throws, subsequent jobs are discarded, and the exception is
+ * rethrown in the submitting thread by the next submit() or drain() call.
+ */
+class COMMON_API BackgroundWriter
+{
+  public:
+    typedef std::function<void()> Job;
+
+  private:
+    struct Entry {
+        Job job;
+        size_t cost;
+    };
+
+    std::mutex mutex;
+    std::condition_variable jobsChanged;
+    std::deque<Entry> jobs;
+    size_t pendingCost = 0;   // total cost of queued jobs and the one being executed
+    size_t costLimit;         // 0 = unlimited
+    bool busy = false;        // whether a job is being executed
+    bool stopping = false;
+    std::exception_ptr error;
+    std::thread thread;
+
+  private:
+    void run();
+
+  public:
+    /**
+     * Starts the thread. costLimit=0 means no limit.
+     */
+    explicit BackgroundWriter(size_t costLimit);
+
+    /**
+     * Executes pending jobs and stops the thread. Errors are ignored.
+     */
+    ~BackgroundWriter();
+
+    /**
+     * Adds a job to the queue. Blocks while the cost limit would be exceeded
+     * (a single job is accepted regardless of its cost when the queue is empty).
+     */
+    void submit(Job job, size_t cost=0);
+
+    /**
+     * Waits until all submitted jobs have been executed.
+     */
+    void drain();
+
+    /**
+     * Returns true if a job has thrown an exception.
+     */
+    bool hasError();
+
+    /**
+     * Rethrows the exception thrown by a job, if there was one.
+     */
+    void checkError();
+};
+
+}  // namespace common
+}  // namespace omnetpp
+
+#endif
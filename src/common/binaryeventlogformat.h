@@ -0,0 +1,106 @@
+//==========================================================================
+//  BINARYEVENTLOGFORMAT.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_COMMON_BINARYEVENTLOGFORMAT_H
+#define __OMNETPP_COMMON_BINARYEVENTLOGFORMAT_H
+
+#include <cstdint>
+#include <string>
+
+namespace omnetpp {
+namespace common {
+
+/*
+ * Layout of binary eventlog files.
+ *
+ * The binary format carries exactly the same entries as the line-oriented
+ * text format (see eventlogentries.txt), and can be decoded into it without
+ * loss. The file starts with BINARY_EVENTLOG_FILE_MAGIC (8 bytes), followed
+ * by the format version (varint) and the scale exponent of simulation times
+ * (zigzag varint). The rest of the file is a sequence of records, each
+ * starting with a varint tag:
+ *
+ *  - BINLOG_EMPTYLINE: an empty line (separates events)
+ *  - BINLOG_LOGLINE: a log line: prefix (string), text (string)
+ *  - BINLOG_ENTRYTYPE: declares an entry type, before its first use:
+ *    type index, entry code (string), number of fields, then for each field
+ *    its code (string), its kind (BINLOG_FIELD_xxx) and whether it is
+ *    optional (varint 0/1)
+ *  - BINLOG_FIRSTENTRY + typeIndex: an entry of a declared type. If the type
+ *    has optional fields, a varint bitmask of the present optional fields
+ *    follows (bit i = i-th optional field), then the values of the present
+ *    fields in declaration order.
+ *
+ * Field values are encoded according to their kind. Integers are zigzag
+ * varints; event numbers, message ids, module ids and simulation times are
+ * delta-coded against the previous value of the same kind anywhere in the
+ * file (so decoding can only start where the decoder state is known, see
+ * BinaryEventLogReader). Strings start
+ * with a varint: 0 means null, 1 an inline string that is not added to the
+ * string table, 2 an inline string that is appended to the string table,
+ * and n >= 3 refers to the (n-3)th string in the table. Inline strings are
+ * a varint length followed by the bytes. File offsets (e.g. the ones in
+ * snapshot and index entries) refer to positions in the binary file.
+ */
+
+#define BINARY_EVENTLOG_FILE_MAGIC    "OPPBELG\n"
+#define BINARY_EVENTLOG_FILE_VERSION  1
+
+enum {
+    BINLOG_EMPTYLINE = 0,
+    BINLOG_LOGLINE = 1,
+    BINLOG_ENTRYTYPE = 2,
+    BINLOG_FIRSTENTRY = 16
+};
+
+enum {
+    BINLOG_FIELD_BOOL = 0,
+    BINLOG_FIELD_INT = 1,
+    BINLOG_FIELD_MODULEID = 2,
+    BINLOG_FIELD_EVENTNUMBER = 3,
+    BINLOG_FIELD_MESSAGEID = 4,
+    BINLOG_FIELD_SIMTIME = 5,
+    BINLOG_FIELD_FILEOFFSET = 6,
+    BINLOG_FIELD_STRING = 7
+};
+
+enum {
+    BINLOG_STRING_NULL = 0,
+    BINLOG_STRING_INLINE = 1,
+    BINLOG_STRING_NEW = 2,
+    BINLOG_STRING_FIRSTINDEX = 3
+};
+
+inline uint64_t zigzagEncode(int64_t value) {return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);}
+inline int64_t zigzagDecode(uint64_t value) {return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);}
+
+inline void appendVarint(std::string& buffer, uint64_t value)
+{
+    char bytes[10];
+    int n = 0;
+    while (value >= 0x80) {
+        bytes[n++] = (char)(value | 0x80);
+        value >>= 7;
+    }
+    bytes[n++] = (char)value;
+    buffer.append(bytes, n);
+}
+
+inline void appendZigzagVarint(std::string& buffer, int64_t value) {appendVarint(buffer, zigzagEncode(value));}
+
+}  // namespace common
+}  // namespace omnetpp
+
+#endif
@@ -0,0 +1,67 @@
+//==========================================================================
+//  BINARYVECTORFILEFORMAT.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_COMMON_BINARYVECTORFILEFORMAT_H
+#define __OMNETPP_COMMON_BINARYVECTORFILEFORMAT_H
+
+#include <cstdint>
+
+namespace omnetpp {
+namespace common {
+
+/*
+ * Layout of binary output vector files.
+ *
+ * The file starts with a BinaryVectorFileHeader, followed by data blocks.
+ * Each block holds consecutive samples of one vector: a BinaryVectorBlockHeader,
+ * followed by `count` event numbers (int64, only if the BINVEC_EVENTNUMBERS flag
+ * is set), `count` raw simulation times (int64, to be scaled by 10^simtimeScaleExp),
+ * and `count` values (IEEE double). All numbers are in the byte order of the
+ * writer's host, and all columns are 8-byte aligned relative to the file start,
+ * so they can be used in place when the file is memory-mapped.
+ *
+ * Run and vector metadata and the block index are stored in a text index
+ * file (.vci) that has the same format as the index of text vector files,
+ * the block offsets and sizes referring to the binary file.
+ */
+
+#define BINARY_VECTOR_FILE_MAGIC       "OPPBVEC\n"
+#define BINARY_VECTOR_FILE_VERSION     1
+#define BINARY_VECTOR_FILE_BYTEORDER   0x01020304
+
+struct BinaryVectorFileHeader {
+    char magic[8];          // BINARY_VECTOR_FILE_MAGIC, without the terminating zero
+    int32_t version;        // BINARY_VECTOR_FILE_VERSION
+    int32_t byteOrderMark;  // BINARY_VECTOR_FILE_BYTEORDER, as written by the host
+};
+
+enum {
+    BINVEC_EVENTNUMBERS = 1  // block contains an event number column
+};
+
+struct BinaryVectorBlockHeader {
+    int32_t vectorId;
+    int16_t flags;            // BINVEC_xxx flags
+    int16_t simtimeScaleExp;  // scale exponent of the raw simulation times
+    int64_t count;            // number of samples in the block
+};
+
+static_assert(sizeof(BinaryVectorFileHeader) == 16, "unexpected padding in BinaryVectorFileHeader");
+static_assert(sizeof(BinaryVectorBlockHeader) == 16, "unexpected padding in BinaryVectorBlockHeader");
+
+}  // namespace common
+}  // namespace omnetpp
+
+#endif
@@ -0,0 +1,278 @@
+//==========================================================================
+//  BINARYVECTORFILEWRITER.CC - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstring>
+#include "commonutil.h"
+#include "stringutil.h"
+#include "binaryvectorfilewriter.h"
+
+namespace omnetpp {
+namespace common {
+
+#define INDEX_FILE_VERSION     3
+
+BinaryVectorFileWriter::~BinaryVectorFileWriter()
+{
+    cleanup(); // not close() because it throws; also, close() must have been called already if there was no error
+}
+
+void BinaryVectorFileWriter::check(bool ok)
+{
+    if (!ok) {
+        close();
+        throw opp_runtime_error("Cannot write output vector file '%s'", fname.c_str());
+    }
+}
+
+void BinaryVectorFileWriter::checki(int fprintfResult)
+{
+    if (fprintfResult < 0) {
+        close();
+        throw opp_runtime_error("Cannot write output vector index file '%s'", ifname.c_str());
+    }
+}
+
+void BinaryVectorFileWriter::open(const char *filename)
+{
+    // open file
+    fname = filename;
+    f = fopen(fname.c_str(), "wb");  // we only support overwrite but not append
+    if (f == nullptr)
+        throw opp_runtime_error("Cannot open output vector file '%s'", fname.c_str());
+
+    BinaryVectorFileHeader header;
+    memcpy(header.magic, BINARY_VECTOR_FILE_MAGIC, sizeof(header.magic));
+    header.version = BINARY_VECTOR_FILE_VERSION;
+    header.byteOrderMark = BINARY_VECTOR_FILE_BYTEORDER;
+    check(fwrite(&header, sizeof(header), 1, f) == 1);
+
+    // open index file
+    ifname = opp_substringbeforelast(fname, ".") + ".vci";
+    fi = fopen(ifname.c_str(), "w");
+    if (fi == nullptr)
+        throw opp_runtime_error("Cannot open index file '%s'", ifname.c_str());
+
+    fprintf(fi, "%64s\n", "");  // leave blank space for "fingerprint" (size and modification date of the vector file)
+    checki(fprintf(fi, "version %d\n", INDEX_FILE_VERSION));
+}
+
+void BinaryVectorFileWriter::close()
+{
+    if (f) {
+        fclose(f);
+        f = nullptr;
+    }
+
+    if (fi) {
+        // write out fingerprint (size and modification date of the vector file)
+        struct opp_stat_t s;
+        if (opp_stat(fname.c_str(), &s) == 0) {
+            opp_fseek(fi, 0, SEEK_SET);
+            fprintf(fi, "file %" PRId64 " %" PRId64, (int64_t)s.st_size, (int64_t)s.st_mtime);
+        }
+
+        fclose(fi);
+        fi = nullptr;
+    }
+}
+
+void BinaryVectorFileWriter::cleanup()  // MUST NOT THROW
+{
+    if (f)
+        fclose(f);
+    if (fi)
+        fclose(fi);
+}
+
+void BinaryVectorFileWriter::beginRecordingForRun(const std::string& runName, const StringMap& attributes, const StringMap& itervars, const OrderedKeyValueList& configEntries)
+{
+    Assert(vectors.size() == 0);
+    bufferedSamples = 0;
+    Assert(isOpen());
+
+    // note: metadata only goes into the index file
+    checki(fprintf(fi, "run %s\n", QUOTE(runName.c_str())));
+    for (auto& pair : attributes)
+        checki(fprintf(fi, "attr %s %s\n", QUOTE(pair.first.c_str()), QUOTE(pair.second.c_str())));
+    for (auto& pair : itervars)
+        checki(fprintf(fi, "itervar %s %s\n", QUOTE(pair.first.c_str()), QUOTE(pair.second.c_str())));
+    for (auto& pair : configEntries)
+        checki(fprintf(fi, "config %s %s\n", QUOTE(pair.first.c_str()), QUOTE(pair.second.c_str())));
+    checki(fprintf(fi, "\n"));
+}
+
+void BinaryVectorFileWriter::finalizeVector(VectorData *vp)
+{
+    Assert(isOpen());
+    if (!vp->values.empty())
+        writeBlock(vp);
+}
+
+void BinaryVectorFileWriter::endRecordingForRun()
+{
+    Assert(isOpen());
+    for (VectorData *vp : vectors) {
+        finalizeVector(vp);
+        delete vp;
+    }
+    vectors.clear();
+
+    checki(fprintf(fi, "\n"));
+
+    bufferedSamples = 0;
+    nextVectorId = 0;
+}
+
+void *BinaryVectorFileWriter::registerVector(const std::string& componentFullPath, const std::string& name, const StringMap& attributes, size_t bufferSize, bool recordEventNumbers)
+{
+    VectorData *vp = new VectorData();
+    vp->id = nextVectorId++;
+    vp->recordEventNumbers = recordEventNumbers;
+    vp->bufferedSamplesLimit = bufferSize / SAMPLE_SIZE;
+    if (vp->bufferedSamplesLimit > 0) {
+        if (vp->recordEventNumbers)
+            vp->eventNumbers.reserve(vp->bufferedSamplesLimit);
+        vp->times.reserve(vp->bufferedSamplesLimit);
+        vp->values.reserve(vp->bufferedSamplesLimit);
+    }
+    vectors.push_back(vp);
+
+    const char *columns = vp->recordEventNumbers ? "ETV" : "TV";
+    checki(fprintf(fi, "vector %d %s %s %s\n", vp->id, QUOTE(componentFullPath.c_str()), QUOTE(name.c_str()), columns));
+    for (auto pair : attributes)
+        checki(fprintf(fi, "attr %s %s\n", QUOTE(pair.first.c_str()), QUOTE(pair.second.c_str())));
+
+    return vp;
+}
+
+void BinaryVectorFileWriter::deregisterVector(void *vectorhandle)
+{
+    Assert(f != nullptr && vectorhandle != nullptr);
+    VectorData *vp = (VectorData *)vectorhandle;
+    Vectors::iterator newEnd = std::remove(vectors.begin(), vectors.end(), vp);
+    vectors.erase(newEnd, vectors.end());
+    finalizeVector(vp);
+    delete vp;
+}
+
+void BinaryVectorFileWriter::recordInVector(void *vectorhandle, eventnumber_t eventNumber, rawsimtime_t t, int simtimeScaleExp, double value)
+{
+    Assert(f != nullptr && vectorhandle != nullptr);
+    VectorData *vp = (VectorData *)vectorhandle;
+
+    // a block may only contain times of the same scale
+    if (!vp->values.empty() && simtimeScaleExp != vp->simtimeScaleExp)
+        writeBlock(vp);
+
+    // store value
+    if (vp->recordEventNumbers)
+        vp->eventNumbers.push_back(eventNumber);
+    vp->times.push_back(t);
+    vp->values.push_back(value);
+    vp->simtimeScaleExp = simtimeScaleExp;
+    this->bufferedSamples++;
+
+    // update vector statistics
+    if (vp->currentBlock.statistics.getCount() == 0) {
+        vp->currentBlock.startEventNum = eventNumber;
+        vp->currentBlock.startTime = t;
+    }
+    vp->currentBlock.endEventNum = eventNumber;
+    vp->currentBlock.endTime = t;
+
+    vp->currentBlock.statistics.collect(value);
+
+    // write out block if necessary
+    if (vp->bufferedSamplesLimit > 0 && (int)vp->values.size() >= vp->bufferedSamplesLimit)
+        writeBlock(vp);
+    else if (bufferedSamplesLimit > 0 && bufferedSamples >= bufferedSamplesLimit)
+        writeRecords();
+}
+
+void BinaryVectorFileWriter::writeRecords()
+{
+    for (auto vp : vectors)
+        if (!vp->values.empty())
+            writeBlock(vp);
+}
+
+void BinaryVectorFileWriter::writeColumn(const void *data, size_t size)
+{
+    check(fwrite(data, 1, size, f) == size);
+}
+
+void BinaryVectorFileWriter::writeBlock(VectorData *vp)
+{
+    Assert(f != nullptr);
+    Assert(fi != nullptr);
+    Assert(vp != nullptr);
+    Assert(!vp->values.empty());
+
+    Block& block = vp->currentBlock;
+    block.offset = opp_ftell(f);
+
+    size_t count = vp->values.size();
+    BinaryVectorBlockHeader header;
+    header.vectorId = vp->id;
+    header.flags = vp->recordEventNumbers ? BINVEC_EVENTNUMBERS : 0;
+    header.simtimeScaleExp = vp->simtimeScaleExp;
+    header.count = count;
+    writeColumn(&header, sizeof(header));
+    if (vp->recordEventNumbers)
+        writeColumn(vp->eventNumbers.data(), count * sizeof(eventnumber_t));
+    writeColumn(vp->times.data(), count * sizeof(rawsimtime_t));
+    writeColumn(vp->values.data(), count * sizeof(double));
+
+    block.size = opp_ftell(f) - block.offset;
+
+    // make sure that the offsets referred by the index file are exists in the vector file
+    // so the index can be used to access the vector file while it is being written
+    fflush(f);
+
+    char buf[64], buf2[64], *endp;
+    const char *startTime = opp_ttoa(buf, block.startTime, vp->simtimeScaleExp, endp);
+    const char *endTime = opp_ttoa(buf2, block.endTime, vp->simtimeScaleExp, endp);
+    Statistics& stats = block.statistics;
+
+    if (vp->recordEventNumbers) {
+        checki(fprintf(fi, "%d\t%" PRId64 " %" PRId64 " %" PRId64 " %" PRId64 " %s %s %" PRId64 " %.*g %.*g %.*g %.*g\n",
+                vp->id, (int64_t)block.offset, (int64_t)block.size,
+                block.startEventNum, block.endEventNum, startTime, endTime,
+                stats.getCount(), prec, stats.getMin(), prec, stats.getMax(), prec, stats.getSum(), prec, stats.getSumSqr()));
+    }
+    else {
+        checki(fprintf(fi, "%d\t%" PRId64 " %" PRId64 " %s %s %" PRId64 " %.*g %.*g %.*g %.*g\n",
+                vp->id, (int64_t)block.offset, (int64_t)block.size, startTime, endTime,
+                stats.getCount(), prec, stats.getMin(), prec, stats.getMax(), prec, stats.getSum(), prec, stats.getSumSqr()));
+    }
+
+    fflush(fi);
+    block.reset();
+
+    bufferedSamples -= count;
+    vp->eventNumbers.clear();
+    vp->times.clear();
+    vp->values.clear();
+}
+
+void BinaryVectorFileWriter::flush()
+{
+    Assert(isOpen());
+    writeRecords();  // flushes both files
+}
+
+}  // namespace common
+}  // namespace omnetpp
@@ -0,0 +1,121 @@
+//==========================================================================
+//  BINARYVECTORFILEWRITER.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_COMMON_BINARYVECTORFILEWRITER_H
+#define __OMNETPP_COMMON_BINARYVECTORFILEWRITER_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include "commondefs.h"
+#include "statistics.h"
+#include "binaryvectorfileformat.h"
+#include "omnetpp/platdep/platmisc.h"  // file_offset_t
+
+namespace omnetpp {
+namespace common {
+
+/**
+ * Class for writing binary output vector files. Samples are written in
+ * blocks of fixed-width columns (see binaryvectorfileformat.h); run and
+ * vector metadata and the block index go into a text index file (.vci)
+ * that is compatible with the index of text-based vector files.
+ * The interface is the same as that of OmnetppVectorFileWriter.
+ */
+class COMMON_API BinaryVectorFileWriter
+{
+  public:
+    typedef std::map<std::string, std::string> StringMap;
+    typedef std::vector<std::pair<std::string, std::string>> OrderedKeyValueList;
+    typedef int64_t eventnumber_t;
+    typedef int64_t rawsimtime_t;
+
+  protected:
+    struct Block {
+      file_offset_t offset;        // file offset of the block
+      file_offset_t size;          // size of the block, including the block header
+      eventnumber_t startEventNum; // event number of the first sample in the block
+      eventnumber_t endEventNum;   // event number of the last sample in the block
+      rawsimtime_t startTime;      // simulation time of the first sample in the block
+      rawsimtime_t endTime;        // simulation time of the last sample in the block
+      Statistics statistics;       // statistics of the samples in the block
+
+      Block() { reset(); }
+      void reset() { offset=-1; size=0; statistics.clear(); }
+    };
+
+    struct VectorData {
+       int id;                    // vector ID
+       std::vector<eventnumber_t> eventNumbers; // buffered columns not yet written to the file
+       std::vector<rawsimtime_t> times;
+       std::vector<double> values;
+       int simtimeScaleExp = 0;   // scale exponent of the buffered times
+       long bufferedSamplesLimit; // maximum number of samples gathered in the buffer before writing out (0=no limit)
+       bool recordEventNumbers;   // record the current event number for each sample
+       Block currentBlock;
+    };
+
+    typedef std::vector<VectorData*> Vectors;
+
+    // buffer space taken by one sample
+    static constexpr size_t SAMPLE_SIZE = sizeof(eventnumber_t) + sizeof(rawsimtime_t) + sizeof(double);
+
+    std::string fname;     // output file name
+    FILE *f = nullptr;     // file ptr of output file
+    int prec = 14;         // number of significant digits when writing doubles into the index
+    int nextVectorId = 0;  // holds next free ID for output vectors
+
+    std::string ifname;  // index file name
+    FILE *fi = nullptr;  // file ptr of index file
+
+    Vectors vectors;               // registered output vectors
+    int bufferedSamples = 0;       // currently total buffered samples
+    int bufferedSamplesLimit = 0;  // limit of total buffered samples (0=no limit)
+
+  protected:
+    void cleanup();  // MUST NOT THROW
+    void check(bool ok);
+    void checki(int fprintfResult);
+    void writeColumn(const void *data, size_t size);
+    virtual void writeRecords();
+    virtual void writeBlock(VectorData *vp);
+    virtual void finalizeVector(VectorData *vp);
+
+  public:
+    BinaryVectorFileWriter() {}
+    virtual ~BinaryVectorFileWriter();
+
+    void open(const char *filename); // overwrite if file exists (append not supported)
+    void close();
+    bool isOpen() const {return f != nullptr;} // IMPORTANT: file will be closed when an error occurs
+
+    void setPrecision(int p) {prec = p;}
+    int getPrecision() const {return prec;}
+    void setOverallMemoryLimit(size_t limit) {bufferedSamplesLimit = limit / SAMPLE_SIZE;}
+    size_t getOverallMemoryLimit() const {return bufferedSamplesLimit * SAMPLE_SIZE;}
+
+    void beginRecordingForRun(const std::string& runName, const StringMap& attributes, const StringMap& itervars, const OrderedKeyValueList& paramAssignments);
+    void endRecordingForRun();
+    void *registerVector(const std::string& componentFullPath, const std::string& name, const StringMap& attributes, size_t bufferSize, bool recordEventNumbers);
+    void deregisterVector(void *vechandle);
+    void recordInVector(void *vectorhandle, eventnumber_t eventNumber, rawsimtime_t t, int simtimeScaleExp, double value);
+
+    void flush();
+};
+
+}  // namespace common
+}  // namespace omnetpp
+
+#endif
@@ -99,12 +99,17 @@ void FileReader::ensureFileOpenInternal()
 size_t FileReader::readFileEnd(file_offset_t fileSize, size_t size, const char *dataPointer)
 {
     FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_SHARED, enableFileLocking);
+    return readFileData(std::max((file_offset_t)0, (file_offset_t)(fileSize - size)), (char *)dataPointer, std::min((int64_t)size, fileSize));
+}
+
+size_t FileReader::readFileData(file_offset_t fileOffset, char *dataPointer, size_t size)
+{
     if (!file)
         throw opp_runtime_error("File is not open '%s'", fileName.c_str());
-    opp_fseek(file, std::max((file_offset_t)0, (file_offset_t)(fileSize - size)), SEEK_SET);
+    opp_fseek(file, fileOffset, SEEK_SET);
     if (ferror(file))
         throw opp_runtime_error("Cannot seek in file '%s', error code %d", fileName.c_str(), ferror(file));
-    int bytesRead = fread((char *)dataPointer, 1, std::min((int64_t)size, fileSize), file);
+    size_t bytesRead = fread(dataPointer, 1, size, file);
     if (ferror(file))
         throw opp_runtime_error("Read error in file '%s', error code %d", fileName.c_str(), ferror(file));
     return bytesRead;
@@ -285,15 +290,8 @@ void FileReader::fillBuffer(bool forward)
         }
 
         file_offset_t fileOffset = pointerToFileOffset(dataPointer);
-        if (!file)
-            throw opp_runtime_error("File is not open '%s'", fileName.c_str());
-        opp_fseek(file, fileOffset, SEEK_SET);
-        if (ferror(file))
-            throw opp_runtime_error("Cannot seek in file '%s', error code %d", fileName.c_str(), ferror(file));
         dataLength = std::min((int64_t)dataLength, lastFileSize - fileOffset);
-        int bytesRead = fread(dataPointer, 1, dataLength, file);
-        if (ferror(file))
-            throw opp_runtime_error("Read error in file '%s', error code %d", fileName.c_str(), ferror(file));
+        int bytesRead = readFileData(fileOffset, dataPointer, dataLength);
         if (bytesRead != dataLength)
             throw opp_runtime_error("Cannot read %d bytes (got %d) from file '%s'", dataLength, bytesRead, fileName.c_str());
 
@@ -336,15 +334,8 @@ bool FileReader::isLineStart(char *s)
         else { // slow path
             FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_SHARED, enableFileLocking);
             file_offset_t fileOffset = pointerToFileOffset(s) - 1;
-            if (!file)
-                throw opp_runtime_error("File is not open '%s'", fileName.c_str());
-            opp_fseek(file, fileOffset, SEEK_SET);
-            if (ferror(file))
-                throw opp_runtime_error("Cannot seek in file '%s', error code %d", fileName.c_str(), ferror(file));
             char previousChar;
-            int bytesRead = fread(&previousChar, 1, 1, file);
-            if (ferror(file))
-                throw opp_runtime_error("Read error in file '%s', error code %d", fileName.c_str(), ferror(file));
+            int bytesRead = readFileData(fileOffset, &previousChar, 1);
             if (bytesRead != 1)
                 throw opp_runtime_error("Cannot read 1 bytes (got %d) from file '%s'", bytesRead, fileName.c_str());
             return previousChar == '\n';
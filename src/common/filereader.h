@@ -113,7 +113,6 @@ class COMMON_API FileReader
     void fillBuffer(bool forward);
     size_t readFileEnd(file_offset_t fileSize, size_t size, const char *dataPointer);
     void ensureFileOpenInternal();
-    void getFileInformation(int64_t& size, time_t& lastModificationTime);
     void processFileChange(FileChange change);
     void checkConsistency(bool checkDataPointer = false) const;
 
@@ -134,6 +133,20 @@ class COMMON_API FileReader
 
     const char *getLine(const char *line, std::string& buffer) { buffer = std::string(line, getCurrentLineLength()); return line ? buffer.c_str() : nullptr; }
 
+  protected:
+    /**
+     * Reads at most size bytes of the content starting at the given offset,
+     * and returns the number of bytes read. The file is open when this gets
+     * called. Subclasses may redefine it (together with getFileInformation())
+     * to present content other than the raw bytes of the file.
+     */
+    virtual size_t readFileData(file_offset_t fileOffset, char *dataPointer, size_t size);
+
+    /**
+     * Returns the size of the content and the modification time of the file.
+     */
+    virtual void getFileInformation(int64_t& size, time_t& lastModificationTime);
+
   public:
     /**
      * Creates a tokenizer object for the given file, with the given buffer size.
@@ -39,7 +39,8 @@ OmnetppVectorFileWriter::~OmnetppVectorFileWriter()
 void OmnetppVectorFileWriter::check(int fprintfResult)
 {
     if (fprintfResult < 0) {
-        close();
+        if (!backgroundWriter)
+            close();  // otherwise the file is closed when the error is reported via execute()
         throw opp_runtime_error("Cannot write output vector file '%s'", fname.c_str());
     }
 }
@@ -47,7 +48,8 @@ void OmnetppVectorFileWriter::check(int fprintfResult)
 void OmnetppVectorFileWriter::checki(int fprintfResult)
 {
     if (fprintfResult < 0) {
-        close();
+        if (!backgroundWriter)
+            close();  // otherwise the file is closed when the error is reported via execute()
         throw opp_runtime_error("Cannot write output vector index file '%s'", ifname.c_str());
     }
 }
@@ -69,10 +71,40 @@ void OmnetppVectorFileWriter::open(const char *filename)
 
     fprintf(fi, "%64s\n", "");  // leave blank space for "fingerprint" (size and modification date of the vector file)
     check(fprintf(fi, "version %d\n", INDEX_FILE_VERSION));
+
+    if (backgroundWriting)
+        backgroundWriter = new BackgroundWriter(bufferedSamplesLimit);
+}
+
+void OmnetppVectorFileWriter::execute(BackgroundWriter::Job job, size_t cost)
+{
+    if (!backgroundWriter)
+        job();
+    else {
+        try {
+            backgroundWriter->submit(job, cost);
+        }
+        catch (std::exception&) {
+            cleanup();  // a previous job failed
+            throw;
+        }
+    }
 }
 
 void OmnetppVectorFileWriter::close()
 {
+    if (backgroundWriter) {
+        try {
+            backgroundWriter->drain();
+        }
+        catch (std::exception&) {
+            cleanup();
+            throw;
+        }
+        delete backgroundWriter;
+        backgroundWriter = nullptr;
+    }
+
     if (f) {
         fclose(f);
         f = nullptr;
@@ -94,10 +126,13 @@ void OmnetppVectorFileWriter::close()
 
 void OmnetppVectorFileWriter::cleanup()  // MUST NOT THROW
 {
+    delete backgroundWriter;  // completes or discards pending jobs
+    backgroundWriter = nullptr;
     if (f)
         fclose(f);
     if (fi)
         fclose(fi);
+    f = fi = nullptr;
 }
 
 void OmnetppVectorFileWriter::beginRecordingForRun(const std::string& runName, const StringMap& attributes, const StringMap& itervars, const OrderedKeyValueList& configEntries)
@@ -106,32 +141,34 @@ void OmnetppVectorFileWriter::beginRecordingForRun(const std::string& runName, c
     bufferedSamples = 0;
     Assert(isOpen());
 
-    // note: we write everything twice, once in .vec and once in .vci
+    execute([=]() {
+        // note: we write everything twice, once in .vec and once in .vci
 
-    // save run
-    check(fprintf(f, "run %s\n", QUOTE(runName.c_str())));
-    checki(fprintf(fi, "run %s\n", QUOTE(runName.c_str())));
+        // save run
+        check(fprintf(f, "run %s\n", QUOTE(runName.c_str())));
+        checki(fprintf(fi, "run %s\n", QUOTE(runName.c_str())));
 
-    // save run attributes
-    for (auto& pair : attributes) {
-        check(fprintf(f, "attr %s %s\n", QUOTE(pair.first.c_str()), QUOTE(pair.second.c_str())));
-        checki(fprintf(fi, "attr %s %s\n", QUOTE(pair.first.c_str()), QUOTE(pair.second.c_str())));
-    }
+        // save run attributes
+        for (auto& pair : attributes) {
+            check(fprintf(f, "attr %s %s\n", QUOTE(pair.first.c_str()), QUOTE(pair.second.c_str())));
+            checki(fprintf(fi, "attr %s %s\n", QUOTE(pair.first.c_str()), QUOTE(pair.second.c_str())));
+        }
 
-    // save itervars
-    for (auto& pair : itervars) {
-        check(fprintf(f, "itervar %s %s\n", QUOTE(pair.first.c_str()), QUOTE(pair.second.c_str())));
-        checki(fprintf(fi, "itervar %s %s\n", QUOTE(pair.first.c_str()), QUOTE(pair.second.c_str())));
-    }
+        // save itervars
+        for (auto& pair : itervars) {
+            check(fprintf(f, "itervar %s %s\n", QUOTE(pair.first.c_str()), QUOTE(pair.second.c_str())));
+            checki(fprintf(fi, "itervar %s %s\n", QUOTE(pair.first.c_str()), QUOTE(pair.second.c_str())));
+        }
 
-    // save config entries
-    for (auto& pair : configEntries) {
-        check(fprintf(f, "config %s %s\n", QUOTE(pair.first.c_str()), QUOTE(pair.second.c_str())));
-        checki(fprintf(fi, "config %s %s\n", QUOTE(pair.first.c_str()), QUOTE(pair.second.c_str())));
-    }
+        // save config entries
+        for (auto& pair : configEntries) {
+            check(fprintf(f, "config %s %s\n", QUOTE(pair.first.c_str()), QUOTE(pair.second.c_str())));
+            checki(fprintf(fi, "config %s %s\n", QUOTE(pair.first.c_str()), QUOTE(pair.second.c_str())));
+        }
 
-    check(fprintf(f, "\n"));
-    checki(fprintf(fi, "\n"));
+        check(fprintf(f, "\n"));
+        checki(fprintf(fi, "\n"));
+    });
 }
 
 void OmnetppVectorFileWriter::finalizeVector(VectorData *vp)
@@ -150,8 +187,10 @@ void OmnetppVectorFileWriter::endRecordingForRun()
     }
     vectors.clear();
 
-    check(fprintf(f, "\n"));
-    check(fprintf(fi, "\n"));
+    execute([this]() {
+        check(fprintf(f, "\n"));
+        check(fprintf(fi, "\n"));
+    });
 
     bufferedSamples = 0;
     nextVectorId = 0;
@@ -169,14 +208,17 @@ void *OmnetppVectorFileWriter::registerVector(const std::string& componentFullPa
 
 
     const char *columns = vp->recordEventNumbers ? "ETV" : "TV";
-    check(fprintf(f, "vector %d %s %s %s\n", vp->id, QUOTE(componentFullPath.c_str()), QUOTE(name.c_str()), columns));
-    for (auto pair : attributes)
-        check(fprintf(f, "attr %s %s\n", QUOTE(pair.first.c_str()), QUOTE(pair.second.c_str())));
-
-    // write vector declaration and vector attributes to the index file too
-    checki(fprintf(fi, "vector %d %s %s %s\n", vp->id, QUOTE(componentFullPath.c_str()), QUOTE(name.c_str()), columns));
-    for (auto pair : attributes)
-        checki(fprintf(fi, "attr %s %s\n", QUOTE(pair.first.c_str()), QUOTE(pair.second.c_str())));
+    int id = vp->id;
+    execute([=]() {
+        check(fprintf(f, "vector %d %s %s %s\n", id, QUOTE(componentFullPath.c_str()), QUOTE(name.c_str()), columns));
+        for (auto pair : attributes)
+            check(fprintf(f, "attr %s %s\n", QUOTE(pair.first.c_str()), QUOTE(pair.second.c_str())));
+
+        // write vector declaration and vector attributes to the index file too
+        checki(fprintf(fi, "vector %d %s %s %s\n", id, QUOTE(componentFullPath.c_str()), QUOTE(name.c_str()), columns));
+        for (auto pair : attributes)
+            checki(fprintf(fi, "attr %s %s\n", QUOTE(pair.first.c_str()), QUOTE(pair.second.c_str())));
+    });
 
     return vp;
 }
@@ -233,48 +275,65 @@ void OmnetppVectorFileWriter::writeBlock(VectorData *vp)
     Assert(vp != nullptr);
     Assert(!vp->buffer.empty());
 
+    size_t count = vp->buffer.size();
+    if (!backgroundWriter)
+        writeSamples(vp->id, vp->recordEventNumbers, vp->buffer, vp->currentBlock);
+    else {
+        // hand over the buffer to the background thread, and continue with an empty one
+        int id = vp->id;
+        bool recordEventNumbers = vp->recordEventNumbers;
+        auto job = [this, id, recordEventNumbers, samples = std::move(vp->buffer), block = vp->currentBlock]() mutable {
+            writeSamples(id, recordEventNumbers, samples, block);
+        };
+        vp->buffer = Samples();
+        if (vp->bufferedSamplesLimit > 0)
+            vp->buffer.reserve(vp->bufferedSamplesLimit);
+        execute(std::move(job), count);
+    }
+
+    vp->currentBlock.reset();
+    bufferedSamples -= count;
+    vp->buffer.clear();
+}
+
+void OmnetppVectorFileWriter::writeSamples(int vectorId, bool recordEventNumbers, const Samples& samples, Block& block)
+{
     char buf[64], buf2[64];
 
-    Block& currentBlock = vp->currentBlock;
-    currentBlock.offset = opp_ftell(f);
+    block.offset = opp_ftell(f);
 
-    if (vp->recordEventNumbers) {
-        for (auto sample : vp->buffer)
-            check(fprintf(f, "%d\t%" PRId64 "\t%s\t%.*g\n", vp->id, sample.eventNumber, sample.time.ttoa(buf), prec, sample.value));
+    if (recordEventNumbers) {
+        for (auto sample : samples)
+            check(fprintf(f, "%d\t%" PRId64 "\t%s\t%.*g\n", vectorId, sample.eventNumber, sample.time.ttoa(buf), prec, sample.value));
     }
     else {
-        for (auto sample : vp->buffer)
-            check(fprintf(f, "%d\t%s\t%.*g\n", vp->id, sample.time.ttoa(buf), prec, sample.value));
+        for (auto sample : samples)
+            check(fprintf(f, "%d\t%s\t%.*g\n", vectorId, sample.time.ttoa(buf), prec, sample.value));
     }
 
-    currentBlock.size = opp_ftell(f) - currentBlock.offset;
+    block.size = opp_ftell(f) - block.offset;
 
-    Block& block = vp->currentBlock;
     Statistics& stats = block.statistics;
 
     // make sure that the offsets referred by the index file are exists in the vector file
     // so the index can be used to access the vector file while it is being written
     fflush(f);
 
-    if (vp->recordEventNumbers) {
+    if (recordEventNumbers) {
         checki(fprintf(fi, "%d\t%" PRId64 " %" PRId64 " %" PRId64 " %" PRId64 " %s %s %" PRId64 " %.*g %.*g %.*g %.*g\n",
-                vp->id, block.offset, block.size,
+                vectorId, block.offset, block.size,
                 block.startEventNum, block.endEventNum,
                 block.startTime.ttoa(buf), block.endTime.ttoa(buf2),
                 stats.getCount(), prec, stats.getMin(), prec, stats.getMax(), prec, stats.getSum(), prec, stats.getSumSqr()));
     }
     else {
         checki(fprintf(fi, "%d\t%" PRId64 " %" PRId64 " %s %s %" PRId64 " %.*g %.*g %.*g %.*g\n",
-                vp->id, block.offset, block.size,
+                vectorId, block.offset, block.size,
                 block.startTime.ttoa(buf), block.endTime.ttoa(buf2),
                 stats.getCount(), prec, stats.getMin(), prec, stats.getMax(), prec, stats.getSum(), prec, stats.getSumSqr()));
     }
 
     fflush(fi);
-    block.reset();
-
-    bufferedSamples -= vp->buffer.size();
-    vp->buffer.clear();
 }
 
 void OmnetppVectorFileWriter::flush()
@@ -23,6 +23,7 @@
 #include <vector>
 #include "commondefs.h"
 #include "statistics.h"
+#include "backgroundwriter.h"
 #include "omnetpp/platdep/platmisc.h"  // file_offset_t
 
 namespace omnetpp {
@@ -31,6 +32,10 @@ namespace common {
 
 /**
  * Class for writing text-based output vector files.
+ *
+ * In background writing mode, all file I/O (including the formatting of
+ * samples) is done by a BackgroundWriter thread; full sample buffers are
+ * handed over to it, and recording continues with a fresh buffer.
  */
 class COMMON_API OmnetppVectorFileWriter
 {
@@ -94,12 +99,17 @@ class COMMON_API OmnetppVectorFileWriter
     int bufferedSamples = 0;       // currently total buffered samples
     int bufferedSamplesLimit = 0;  // limit of total buffered samples (0=no limit)
 
+    bool backgroundWriting = false;  // whether to write in a background thread
+    BackgroundWriter *backgroundWriter = nullptr; // non-nullptr while the file is open in background writing mode
+
   protected:
     void cleanup();  // MUST NOT THROW
     void check(int fprintfResult);
     void checki(int fprintfResult);
+    void execute(BackgroundWriter::Job job, size_t cost=0);
     virtual void writeRecords();
     virtual void writeBlock(VectorData *vp);
+    virtual void writeSamples(int vectorId, bool recordEventNumbers, const Samples& samples, Block& block);
     virtual void finalizeVector(VectorData *vp);
 
   public:
@@ -114,6 +124,8 @@ class COMMON_API OmnetppVectorFileWriter
     int getPrecision() const {return prec;}
     void setOverallMemoryLimit(size_t limit) {bufferedSamplesLimit = limit / sizeof(Sample);}
     size_t getOverallMemoryLimit() const {return bufferedSamplesLimit * sizeof(Sample);}
+    void setBackgroundWriting(bool b) {backgroundWriting = b;} // takes effect on open()
+    bool getBackgroundWriting() const {return backgroundWriting;}
 
     void beginRecordingForRun(const std::string& runName, const StringMap& attributes, const StringMap& itervars, const OrderedKeyValueList& paramAssignments);
     void endRecordingForRun();
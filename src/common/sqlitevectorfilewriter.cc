@@ -53,7 +53,8 @@ void SqliteVectorFileWriter::error(const char *errmsg)
     std::string msg = errmsg ? errmsg : "unknown error";
     if (db == nullptr) msg = "Database not open (db=nullptr), or " + msg; // sqlite's own error message is usually 'out of memory' (?)
     std::string fname = this->fname; // cleanup may clear it
-    cleanup();
+    if (!backgroundWriter)
+        cleanup();  // otherwise the file is closed when the error is reported via execute() or sync()
     throw opp_runtime_error("SQLite error '%s' on file '%s'", msg.c_str(), fname.c_str());
 }
 
@@ -68,10 +69,48 @@ void SqliteVectorFileWriter::open(const char *filename)
     prepareStatements();
     //NOTE: this line is only present in the scalar writer:
     //checkOK(sqlite3_exec(db, "BEGIN IMMEDIATE TRANSACTION;", nullptr, 0, nullptr));
+
+    // from now on, the database is only accessed from the background thread
+    if (backgroundWriting)
+        backgroundWriter = new BackgroundWriter(bufferedSamplesLimit);
+}
+
+void SqliteVectorFileWriter::execute(BackgroundWriter::Job job, size_t cost)
+{
+    if (!backgroundWriter)
+        job();
+    else {
+        try {
+            backgroundWriter->submit(job, cost);
+        }
+        catch (std::exception&) {
+            cleanup();  // a previous job failed
+            throw;
+        }
+    }
+}
+
+void SqliteVectorFileWriter::sync()
+{
+    if (backgroundWriter) {
+        try {
+            backgroundWriter->drain();
+        }
+        catch (std::exception&) {
+            cleanup();
+            throw;
+        }
+    }
 }
 
 void SqliteVectorFileWriter::close()
 {
+    if (backgroundWriter) {
+        sync();
+        delete backgroundWriter;
+        backgroundWriter = nullptr;
+    }
+
     if (db) {
         finalizeStatement(stmt);
         finalizeStatement(add_vector_stmt);
@@ -92,6 +131,9 @@ void SqliteVectorFileWriter::close()
 
 void SqliteVectorFileWriter::cleanup()  // MUST NOT THROW
 {
+    delete backgroundWriter;  // completes or discards pending jobs
+    backgroundWriter = nullptr;
+
     if (db) {
         finalizeStatement(stmt);
         finalizeStatement(add_vector_stmt);
@@ -114,7 +156,10 @@ void SqliteVectorFileWriter::cleanup()  // MUST NOT THROW
 
 void SqliteVectorFileWriter::createVectorIndex()
 {
-    executeSql("CREATE INDEX IF NOT EXISTS vectorData_idx ON vectorData (vectorId);");
+    execute([this]() {
+        executeSql("CREATE INDEX IF NOT EXISTS vectorData_idx ON vectorData (vectorId);");
+    });
+    sync();  // wait for completion, as it may take long
 }
 
 void SqliteVectorFileWriter::executeSql(const char *sql)
@@ -145,52 +190,54 @@ void SqliteVectorFileWriter::beginRecordingForRun(const std::string& runName, in
     Assert(vectors.size() == 0);
     bufferedSamples = 0;
 
-    // save run
-    prepareStatement(stmt, "INSERT INTO run (runName, simTimeExp) VALUES (?, ?);");
-    checkOK(sqlite3_bind_text(stmt, 1, runName.c_str(), runName.size(), SQLITE_STATIC));
-    checkOK(sqlite3_bind_int(stmt, 2, simtimeScaleExp));
-    checkDone(sqlite3_step(stmt));
-    checkOK(sqlite3_clear_bindings(stmt));
-    runId = sqlite3_last_insert_rowid(db);
-    finalizeStatement(stmt);
-
-    // save run attributes
-    prepareStatement(stmt, "INSERT INTO runAttr (runId, attrName, attrValue) VALUES (?, ?, ?);");
-    for (auto& p : attributes) {
-        checkOK(sqlite3_reset(stmt));
-        checkOK(sqlite3_bind_int64(stmt, 1, runId));
-        checkOK(sqlite3_bind_text(stmt, 2, p.first.c_str(), p.first.size(), SQLITE_STATIC));
-        checkOK(sqlite3_bind_text(stmt, 3, p.second.c_str(), p.second.size(), SQLITE_STATIC));
-        checkDone(sqlite3_step(stmt));
-        checkOK(sqlite3_clear_bindings(stmt));
-    }
-    finalizeStatement(stmt);
-
-    // save itervars
-    prepareStatement(stmt, "INSERT INTO runItervar (runId, itervarName, itervarValue) VALUES (?, ?, ?);");
-    for (auto& p : itervars) {
-        checkOK(sqlite3_reset(stmt));
-        checkOK(sqlite3_bind_int64(stmt, 1, runId));
-        checkOK(sqlite3_bind_text(stmt, 2, p.first.c_str(), p.first.size(), SQLITE_STATIC));
-        checkOK(sqlite3_bind_text(stmt, 3, p.second.c_str(), p.second.size(), SQLITE_STATIC));
+    execute([=]() {
+        // save run
+        prepareStatement(stmt, "INSERT INTO run (runName, simTimeExp) VALUES (?, ?);");
+        checkOK(sqlite3_bind_text(stmt, 1, runName.c_str(), runName.size(), SQLITE_STATIC));
+        checkOK(sqlite3_bind_int(stmt, 2, simtimeScaleExp));
         checkDone(sqlite3_step(stmt));
         checkOK(sqlite3_clear_bindings(stmt));
-    }
-    finalizeStatement(stmt);
-
-    // save config entries
-    prepareStatement(stmt, "INSERT INTO runConfig (runId, configKey, configValue, configOrder) VALUES (?, ?, ?, ?);");
-    int i = 0;
-    for (auto& p : configEntries) {
-        checkOK(sqlite3_reset(stmt));
-        checkOK(sqlite3_bind_int64(stmt, 1, runId));
-        checkOK(sqlite3_bind_text(stmt, 2, p.first.c_str(), p.first.size(), SQLITE_STATIC));
-        checkOK(sqlite3_bind_text(stmt, 3, p.second.c_str(), p.second.size(), SQLITE_STATIC));
-        checkOK(sqlite3_bind_int(stmt, 4, i++));
-        checkDone(sqlite3_step(stmt));
-        checkOK(sqlite3_clear_bindings(stmt));
-    }
-    finalizeStatement(stmt);
+        runId = sqlite3_last_insert_rowid(db);
+        finalizeStatement(stmt);
+
+        // save run attributes
+        prepareStatement(stmt, "INSERT INTO runAttr (runId, attrName, attrValue) VALUES (?, ?, ?);");
+        for (auto& p : attributes) {
+            checkOK(sqlite3_reset(stmt));
+            checkOK(sqlite3_bind_int64(stmt, 1, runId));
+            checkOK(sqlite3_bind_text(stmt, 2, p.first.c_str(), p.first.size(), SQLITE_STATIC));
+            checkOK(sqlite3_bind_text(stmt, 3, p.second.c_str(), p.second.size(), SQLITE_STATIC));
+            checkDone(sqlite3_step(stmt));
+            checkOK(sqlite3_clear_bindings(stmt));
+        }
+        finalizeStatement(stmt);
+
+        // save itervars
+        prepareStatement(stmt, "INSERT INTO runItervar (runId, itervarName, itervarValue) VALUES (?, ?, ?);");
+        for (auto& p : itervars) {
+            checkOK(sqlite3_reset(stmt));
+            checkOK(sqlite3_bind_int64(stmt, 1, runId));
+            checkOK(sqlite3_bind_text(stmt, 2, p.first.c_str(), p.first.size(), SQLITE_STATIC));
+            checkOK(sqlite3_bind_text(stmt, 3, p.second.c_str(), p.second.size(), SQLITE_STATIC));
+            checkDone(sqlite3_step(stmt));
+            checkOK(sqlite3_clear_bindings(stmt));
+        }
+        finalizeStatement(stmt);
+
+        // save config entries
+        prepareStatement(stmt, "INSERT INTO runConfig (runId, configKey, configValue, configOrder) VALUES (?, ?, ?, ?);");
+        int i = 0;
+        for (auto& p : configEntries) {
+            checkOK(sqlite3_reset(stmt));
+            checkOK(sqlite3_bind_int64(stmt, 1, runId));
+            checkOK(sqlite3_bind_text(stmt, 2, p.first.c_str(), p.first.size(), SQLITE_STATIC));
+            checkOK(sqlite3_bind_text(stmt, 3, p.second.c_str(), p.second.size(), SQLITE_STATIC));
+            checkOK(sqlite3_bind_int(stmt, 4, i++));
+            checkDone(sqlite3_step(stmt));
+            checkOK(sqlite3_clear_bindings(stmt));
+        }
+        finalizeStatement(stmt);
+    });
 }
 
 void SqliteVectorFileWriter::finalizeVector(VectorData *vp)
@@ -198,6 +245,14 @@ void SqliteVectorFileWriter::finalizeVector(VectorData *vp)
     if (!vp->buffer.empty())
         writeOneBlock(vp);
 
+    // note: vp must not be deleted before the job completes, see deregisterVector() and endRecordingForRun()
+    execute([this, vp]() {
+        writeVectorStatistics(vp);
+    });
+}
+
+void SqliteVectorFileWriter::writeVectorStatistics(const VectorData *vp)
+{
     Assert(db != nullptr);
 
     // record vector statistics
@@ -231,6 +286,7 @@ void SqliteVectorFileWriter::endRecordingForRun()
     try {
         for (VectorData *vp : vectors)
             finalizeVector(vp); //TODO currently these all go in separate transactions
+        sync();
         clearVectors();
         runId = -1;
     }
@@ -259,22 +315,25 @@ void *SqliteVectorFileWriter::registerVector(const std::string& componentFullPat
         vp->buffer.reserve(vp->bufferedSamplesLimit);
     vectors.push_back(vp);
 
-    checkOK(sqlite3_reset(add_vector_stmt));
-    checkOK(sqlite3_bind_int64(add_vector_stmt, 1, runId));
-    checkOK(sqlite3_bind_text(add_vector_stmt, 2, componentFullPath.c_str(), componentFullPath.size(), SQLITE_STATIC));
-    checkOK(sqlite3_bind_text(add_vector_stmt, 3, name.c_str(), name.size(), SQLITE_STATIC));
-    checkDone(sqlite3_step(add_vector_stmt));
-    checkOK(sqlite3_clear_bindings(add_vector_stmt));
-    vp->id = sqlite3_last_insert_rowid(db);
-
-    for (auto pair : attributes) {
-        checkOK(sqlite3_reset(add_vector_attr_stmt));
-        checkOK(sqlite3_bind_int64(add_vector_attr_stmt, 1, vp->id));
-        checkOK(sqlite3_bind_text(add_vector_attr_stmt, 2, pair.first.c_str(), pair.first.size(), SQLITE_STATIC));
-        checkOK(sqlite3_bind_text(add_vector_attr_stmt, 3, pair.second.c_str(), pair.second.size(), SQLITE_STATIC));
-        checkDone(sqlite3_step(add_vector_attr_stmt));
-        checkOK(sqlite3_clear_bindings(add_vector_attr_stmt));
-    }
+    // note: vp->id is only accessed from jobs
+    execute([=]() {
+        checkOK(sqlite3_reset(add_vector_stmt));
+        checkOK(sqlite3_bind_int64(add_vector_stmt, 1, runId));
+        checkOK(sqlite3_bind_text(add_vector_stmt, 2, componentFullPath.c_str(), componentFullPath.size(), SQLITE_STATIC));
+        checkOK(sqlite3_bind_text(add_vector_stmt, 3, name.c_str(), name.size(), SQLITE_STATIC));
+        checkDone(sqlite3_step(add_vector_stmt));
+        checkOK(sqlite3_clear_bindings(add_vector_stmt));
+        vp->id = sqlite3_last_insert_rowid(db);
+
+        for (auto pair : attributes) {
+            checkOK(sqlite3_reset(add_vector_attr_stmt));
+            checkOK(sqlite3_bind_int64(add_vector_attr_stmt, 1, vp->id));
+            checkOK(sqlite3_bind_text(add_vector_attr_stmt, 2, pair.first.c_str(), pair.first.size(), SQLITE_STATIC));
+            checkOK(sqlite3_bind_text(add_vector_attr_stmt, 3, pair.second.c_str(), pair.second.size(), SQLITE_STATIC));
+            checkDone(sqlite3_step(add_vector_attr_stmt));
+            checkOK(sqlite3_clear_bindings(add_vector_attr_stmt));
+        }
+    });
 
     return vp;
 }
@@ -286,7 +345,10 @@ void SqliteVectorFileWriter::deregisterVector(void *vectorhandle)
     Vectors::iterator newEnd = std::remove(vectors.begin(), vectors.end(), vp);
     vectors.erase(newEnd, vectors.end());
     finalizeVector(vp);
-    delete vp;
+    if (!backgroundWriter)
+        delete vp;
+    else
+        execute([vp]() { delete vp; });
 }
 
 void SqliteVectorFileWriter::recordInVector(void *vectorhandle, eventnumber_t eventNumber, rawsimtime_t t, double value)
@@ -317,28 +379,68 @@ void SqliteVectorFileWriter::recordInVector(void *vectorhandle, eventnumber_t ev
 
 void SqliteVectorFileWriter::writeRecords()
 {
-    executeSql("BEGIN IMMEDIATE TRANSACTION;");
+    std::vector<Block> blocks;
     for (auto vp : vectors)
         if (!vp->buffer.empty())
-            writeBlock(vp);
-    executeSql("COMMIT TRANSACTION;");
+            blocks.push_back(takeBlock(vp));
+    writeBlocks(std::move(blocks));
 }
 
 void SqliteVectorFileWriter::writeOneBlock(VectorData *vp)
 {
-    executeSql("BEGIN IMMEDIATE TRANSACTION;");
-    writeBlock(vp);
-    executeSql("COMMIT TRANSACTION;");
+    std::vector<Block> blocks;
+    blocks.push_back(takeBlock(vp));
+    writeBlocks(std::move(blocks));
 }
 
-void SqliteVectorFileWriter::writeBlock(VectorData *vp)
+SqliteVectorFileWriter::Block SqliteVectorFileWriter::takeBlock(VectorData *vp)
 {
     Assert(vp != nullptr);
     Assert(!vp->buffer.empty());
 
+    Block block;
+    block.vp = vp;
+    block.samples.swap(vp->buffer);
+    bufferedSamples -= block.samples.size();
+    return block;
+}
+
+void SqliteVectorFileWriter::writeBlocks(std::vector<Block>&& blocks)
+{
+    if (!backgroundWriter) {
+        executeSql("BEGIN IMMEDIATE TRANSACTION;");
+        for (const Block& block : blocks)
+            writeSamples(block.vp, block.samples);
+        executeSql("COMMIT TRANSACTION;");
+
+        // give back the buffers for reuse
+        for (Block& block : blocks) {
+            block.samples.clear();
+            block.vp->buffer.swap(block.samples);
+        }
+    }
+    else {
+        // hand over the buffers to the background thread; vectors continue with empty ones
+        size_t count = 0;
+        for (const Block& block : blocks) {
+            count += block.samples.size();
+            if (block.vp->bufferedSamplesLimit > 0)
+                block.vp->buffer.reserve(block.vp->bufferedSamplesLimit);
+        }
+        execute([this, blocks = std::move(blocks)]() {
+            executeSql("BEGIN IMMEDIATE TRANSACTION;");
+            for (const Block& block : blocks)
+                writeSamples(block.vp, block.samples);
+            executeSql("COMMIT TRANSACTION;");
+        }, count);
+    }
+}
+
+void SqliteVectorFileWriter::writeSamples(const VectorData *vp, const std::vector<Sample>& samples)
+{
     Assert(db != nullptr);
 
-    for (const Sample& sample : vp->buffer) {
+    for (const Sample& sample : samples) {
         checkOK(sqlite3_reset(add_vector_data_stmt));
         checkOK(sqlite3_bind_int64(add_vector_data_stmt, 1, vp->id));
         checkOK(sqlite3_bind_int64(add_vector_data_stmt, 2, sample.eventNumber));
@@ -346,8 +448,6 @@ void SqliteVectorFileWriter::writeBlock(VectorData *vp)
         checkOK(sqlite3_bind_double(add_vector_data_stmt, 4, sample.value));
         checkDone(sqlite3_step(add_vector_data_stmt));
     }
-    bufferedSamples -= vp->buffer.size();
-    vp->buffer.clear();
 }
 
 void SqliteVectorFileWriter::flush()
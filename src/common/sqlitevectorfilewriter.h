@@ -22,6 +22,7 @@
 #include "sqlite3.h"
 #include "commondefs.h"
 #include "statistics.h"
+#include "backgroundwriter.h"
 
 namespace omnetpp {
 namespace common {
@@ -29,6 +30,10 @@ namespace common {
 
 /**
  * Class for writing SQLite-based output vector files.
+ *
+ * In background writing mode, all database operations are done by a
+ * BackgroundWriter thread; full sample buffers are handed over to it,
+ * and recording continues with a fresh buffer.
  */
 class COMMON_API SqliteVectorFileWriter
 {
@@ -62,6 +67,11 @@ class COMMON_API SqliteVectorFileWriter
 
     typedef std::vector<VectorData*> Vectors;
 
+    struct Block {
+        VectorData *vp;
+        std::vector<Sample> samples;
+    };
+
     std::string fname;        // output file name
     sqlite_int64 runId = -1;  // runId in sqlite database
     sqlite3 *db = nullptr;    // sqlite database, nullptr before initialization and after error
@@ -76,14 +86,22 @@ class COMMON_API SqliteVectorFileWriter
     Vectors vectors;               // registered output vectors
     int bufferedSamples = 0;       // currently total buffered samples
 
+    bool backgroundWriting = false;  // whether to write in a background thread
+    BackgroundWriter *backgroundWriter = nullptr; // non-nullptr while the file is open in background writing mode
+
   protected:
     void prepareStatements();
     void cleanup();  // MUST NOT THROW
     void clearVectors();  // ditto
+    void execute(BackgroundWriter::Job job, size_t cost=0);
+    void sync();
     virtual void writeRecords();
     virtual void writeOneBlock(VectorData *vp);
-    virtual void writeBlock(VectorData *vp);
+    virtual Block takeBlock(VectorData *vp);
+    virtual void writeBlocks(std::vector<Block>&& blocks);
+    virtual void writeSamples(const VectorData *vp, const std::vector<Sample>& samples);
     virtual void finalizeVector(VectorData *vp);
+    virtual void writeVectorStatistics(const VectorData *vp);
     void executeSql(const char *sql);
 
     void prepareStatement(sqlite3_stmt *&stmt, const char *sql);
@@ -102,6 +120,8 @@ class COMMON_API SqliteVectorFileWriter
 
     void setOverallMemoryLimit(size_t limit) {bufferedSamplesLimit = limit / sizeof(Sample);}
     size_t getOverallMemoryLimit() const {return bufferedSamplesLimit * sizeof(Sample);}
+    void setBackgroundWriting(bool b) {backgroundWriting = b;} // takes effect on open()
+    bool getBackgroundWriting() const {return backgroundWriting;}
 
     void beginRecordingForRun(const std::string& runName, int simtimeScaleExp, const StringMap& attributes, const StringMap& itervars, const OrderedKeyValueList& paramAssignments);
     void endRecordingForRun();
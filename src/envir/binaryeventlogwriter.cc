@@ -0,0 +1,130 @@
+//==========================================================================
+//  BINARYEVENTLOGWRITER.CC - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cstring>
+#include "omnetpp/simtime.h"
+#include "omnetpp/cexception.h"
+#include "binaryeventlogwriter.h"
+
+using namespace omnetpp::common;
+
+namespace omnetpp {
+namespace envir {
+
+BinaryEventLogWriter::BinaryEventLogWriter(FILE *f, size_t bufferSize, size_t maxPendingSize) :
+    f(f), bufferSize(bufferSize), backgroundWriter(maxPendingSize)
+{
+    buffer.reserve(bufferSize + bufferSize/8);
+    buffer.append(BINARY_EVENTLOG_FILE_MAGIC, 8);
+    appendVarint(buffer, BINARY_EVENTLOG_FILE_VERSION);
+    appendZigzagVarint(buffer, SimTime::getScaleExp());
+}
+
+BinaryEventLogWriter::~BinaryEventLogWriter()
+{
+    try {
+        if (!backgroundWriter.hasError())
+            submitBuffer(true);
+    }
+    catch (std::exception&) {
+        // ignore
+    }
+    // BackgroundWriter's destructor executes the pending jobs
+}
+
+void BinaryEventLogWriter::submitBuffer(bool flushFile)
+{
+    std::string data;
+    data.reserve(bufferSize + bufferSize/8);
+    data.swap(buffer);
+    submittedSize += data.size();
+    FILE *f = this->f;
+    size_t cost = data.size();
+    backgroundWriter.submit([f, flushFile, data = std::move(data)]() {
+        if (!data.empty() && fwrite(data.data(), 1, data.size(), f) != data.size())
+            throw cRuntimeError("Cannot write eventlog file, disk full?");
+        if (flushFile)
+            fflush(f);
+    }, cost);
+}
+
+void BinaryEventLogWriter::drain()
+{
+    submitBuffer(true);
+    backgroundWriter.drain();
+}
+
+void BinaryEventLogWriter::declareType(const EntryType& type)
+{
+    if (type.index >= (int)declaredTypes.size())
+        declaredTypes.resize(type.index + 1);
+    declaredTypes[type.index] = true;
+    appendVarint(buffer, BINLOG_ENTRYTYPE);
+    appendVarint(buffer, type.index);
+    appendString(type.code, strlen(type.code));
+    appendVarint(buffer, type.numFields);
+    for (int i = 0; i < type.numFields; i++) {
+        const Field& field = type.fields[i];
+        appendString(field.code, strlen(field.code));
+        appendVarint(buffer, field.kind);
+        appendVarint(buffer, field.isOptional ? 1 : 0);
+    }
+}
+
+void BinaryEventLogWriter::appendString(const char *s, size_t length)
+{
+    appendVarint(buffer, length);
+    buffer.append(s, length);
+}
+
+void BinaryEventLogWriter::writeString(const char *s)
+{
+    if (!s) {
+        appendVarint(buffer, BINLOG_STRING_NULL);
+        return;
+    }
+    size_t length = strlen(s);
+    if (length > MAX_TABLE_STRING_LENGTH) {
+        // long strings (e.g. message details) rarely repeat
+        appendVarint(buffer, BINLOG_STRING_INLINE);
+        appendString(s, length);
+        return;
+    }
+    auto it = stringTable.find(std::string(s, length));
+    if (it != stringTable.end())
+        appendVarint(buffer, BINLOG_STRING_FIRSTINDEX + it->second);
+    else if (stringTable.size() < MAX_TABLE_SIZE) {
+        int index = stringTable.size();
+        stringTable[std::string(s, length)] = index;
+        appendVarint(buffer, BINLOG_STRING_NEW);
+        appendString(s, length);
+    }
+    else {
+        appendVarint(buffer, BINLOG_STRING_INLINE);
+        appendString(s, length);
+    }
+}
+
+void BinaryEventLogWriter::writeLogLine(const char *prefix, const char *line, int lineLength)
+{
+    appendVarint(buffer, BINLOG_LOGLINE);
+    appendString(prefix, strlen(prefix));
+    appendString(line, lineLength);
+    if (buffer.size() >= bufferSize)
+        submitBuffer(false);
+}
+
+}  // namespace envir
+}  // namespace omnetpp
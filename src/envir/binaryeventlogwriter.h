@@ -0,0 +1,140 @@
+//==========================================================================
+//  BINARYEVENTLOGWRITER.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_ENVIR_BINARYEVENTLOGWRITER_H
+#define __OMNETPP_ENVIR_BINARYEVENTLOGWRITER_H
+
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "common/backgroundwriter.h"
+#include "common/binaryeventlogformat.h"
+#include "omnetpp/platdep/platmisc.h"  // file_offset_t
+#include "omnetpp/simtime_t.h"
+#include "envirdefs.h"
+
+namespace omnetpp {
+namespace envir {
+
+/**
+ * Encodes eventlog entries in the binary eventlog format (see
+ * common/binaryeventlogformat.h). Entries are encoded into an in-memory
+ * buffer; full buffers are handed over to a background thread which writes
+ * them to the file, so the simulation only blocks on I/O when the amount of
+ * data in transit exceeds the limit given in the constructor.
+ *
+ * Entries are written via the generated EventLogWriter methods, which call
+ * beginEntry(), the writeXxx() method of each present field in declaration
+ * order, then endEntry().
+ */
+class ENVIR_API BinaryEventLogWriter
+{
+  public:
+    struct Field {
+        const char *code;
+        int kind;  // BINLOG_FIELD_xxx
+        bool isOptional;
+    };
+
+    struct EntryType {
+        int index;  // unique, small integer
+        const char *code;
+        int numFields;
+        const Field *fields;
+        bool hasOptionalFields;
+    };
+
+  private:
+    enum { MAX_TABLE_STRING_LENGTH = 64, MAX_TABLE_SIZE = 1 << 16 };
+
+    FILE *f;
+    size_t bufferSize;
+    std::string buffer;
+    file_offset_t submittedSize = 0;  // bytes handed over to the background thread
+    std::vector<bool> declaredTypes;
+    std::unordered_map<std::string,int> stringTable;
+    int64_t lastEventNumber = 0;
+    int64_t lastMessageId = 0;
+    int64_t lastModuleId = 0;
+    int64_t lastSimTime = 0;
+    common::BackgroundWriter backgroundWriter;
+
+  private:
+    void declareType(const EntryType& type);
+    void appendString(const char *s, size_t length);
+    void writeDelta(int64_t value, int64_t& last) {common::appendVarint(buffer, common::zigzagEncode((int64_t)((uint64_t)value - (uint64_t)last))); last = value;}
+    void submitBuffer(bool flushFile);
+
+  public:
+    /**
+     * Writes the file header into the buffer. The file must be open for
+     * writing, and it must stay open until the writer is deleted. Buffers of
+     * about bufferSize bytes are submitted to the background thread, at most
+     * maxPendingSize bytes in total.
+     */
+    BinaryEventLogWriter(FILE *f, size_t bufferSize, size_t maxPendingSize);
+
+    /**
+     * Writes out buffered data, waiting for the background thread. Errors
+     * are ignored; call drain() before to detect them.
+     */
+    ~BinaryEventLogWriter();
+
+    /**
+     * Returns the file offset where the next record will be written.
+     */
+    file_offset_t getOffset() const {return submittedSize + buffer.size();}
+
+    /**
+     * Submits the buffered data to the background thread, and asks it to
+     * flush the file afterwards. Does not wait for the writing to complete.
+     */
+    void flush() {submitBuffer(true);}
+
+    /**
+     * Submits the buffered data, and waits until everything is written and
+     * flushed. Throws an exception if writing has failed.
+     */
+    void drain();
+
+    void writeEmptyLine() {common::appendVarint(buffer, common::BINLOG_EMPTYLINE);}
+    void writeLogLine(const char *prefix, const char *line, int lineLength);
+
+    /** @name Writing entries, used by the generated EventLogWriter methods */
+    //@{
+    void beginEntry(const EntryType& type, uint64_t optionalFieldMask) {
+        if (type.index >= (int)declaredTypes.size() || !declaredTypes[type.index])
+            declareType(type);
+        common::appendVarint(buffer, common::BINLOG_FIRSTENTRY + type.index);
+        if (type.hasOptionalFields)
+            common::appendVarint(buffer, optionalFieldMask);
+    }
+    void writeBool(bool value) {buffer += value ? '\1' : '\0';}
+    void writeInt(int64_t value) {common::appendZigzagVarint(buffer, value);}
+    void writeModuleId(int value) {writeDelta(value, lastModuleId);}
+    void writeEventNumber(int64_t value) {writeDelta(value, lastEventNumber);}
+    void writeMessageId(int64_t value) {writeDelta(value, lastMessageId);}
+    void writeSimTime(simtime_t value) {writeDelta(value.raw(), lastSimTime);}
+    void writeFileOffset(int64_t value) {common::appendZigzagVarint(buffer, value);}
+    void writeString(const char *s);
+    void endEntry() {if (buffer.size() >= bufferSize) submitBuffer(false);}
+    //@}
+};
+
+}  // namespace envir
+}  // namespace omnetpp
+
+#endif
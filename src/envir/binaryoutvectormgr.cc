@@ -0,0 +1,196 @@
+//==========================================================================
+//  BINARYOUTVECTORMGR.CC - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include "common/stringutil.h"
+#include "common/fileutil.h"
+#include "omnetpp/cconfigoption.h"
+#include "omnetpp/csimulation.h"
+#include "omnetpp/cmodule.h"
+#include "omnetpp/ccomponenttype.h"
+#include "omnetpp/platdep/platmisc.h"
+#include "resultfileutils.h"
+#include "binaryoutvectormgr.h"
+
+#include "genericenvir.h"
+#include "resultfileutils.h"
+
+using namespace omnetpp::common;
+
+namespace omnetpp {
+namespace envir {
+
+typedef std::map<std::string, std::string> StringMap;
+
+Register_Class(BinaryOutputVectorManager);
+
+// global options
+extern omnetpp::cConfigOption *CFGID_OUTPUT_VECTOR_FILE;
+extern omnetpp::cConfigOption *CFGID_OUTPUT_VECTOR_FILE_APPEND;
+extern omnetpp::cConfigOption *CFGID_OUTPUT_VECTOR_PRECISION;
+extern omnetpp::cConfigOption *CFGID_OUTPUTVECTOR_MEMORY_LIMIT;
+
+// per-vector options
+extern omnetpp::cConfigOption *CFGID_VECTOR_RECORDING;
+extern omnetpp::cConfigOption *CFGID_VECTOR_RECORD_EVENTNUMBERS;
+extern omnetpp::cConfigOption *CFGID_VECTOR_RECORDING_INTERVALS;
+extern omnetpp::cConfigOption *CFGID_VECTOR_BUFFER;
+
+void BinaryOutputVectorManager::configure(cSimulation *simulation, cConfiguration *cfg)
+{
+    this->cfg = cfg;
+    ResultFileUtils::setConfiguration(cfg);
+    simulation->addLifecycleListener(this);
+
+    fname = cfg->getAsFilename(CFGID_OUTPUT_VECTOR_FILE).c_str();
+    fname = augmentFileName(fname);
+
+    shouldAppend = cfg->getAsBool(CFGID_OUTPUT_VECTOR_FILE_APPEND);
+
+    int prec = cfg->getAsInt(CFGID_OUTPUT_VECTOR_PRECISION);
+    writer.setPrecision(prec);
+
+    size_t memoryLimit = (size_t) cfg->getAsDouble(CFGID_OUTPUTVECTOR_MEMORY_LIMIT);
+    writer.setOverallMemoryLimit(memoryLimit);
+}
+
+void BinaryOutputVectorManager::startRun()
+{
+    // prevent reuse of object for multiple runs
+    Assert(state == NEW);
+    state = STARTED;
+
+    // read configuration
+    if (shouldAppend)
+        throw cRuntimeError("%s does not support append mode", getClassName());
+
+    removeFile(fname.c_str(), "old output vector file");
+
+}
+
+void BinaryOutputVectorManager::endRun()
+{
+    Assert(state == NEW || state == STARTED || state == OPENED);
+    state = ENDED;
+    if (writer.isOpen()) {
+        writer.endRecordingForRun();
+        closeFile();
+        vectors.clear();
+    }
+}
+
+void BinaryOutputVectorManager::openFileForRun()
+{
+    // ensure startRun() has been invoked
+    Assert(state == STARTED);
+    state = OPENED;
+
+    // open file
+    mkPath(directoryOf(fname.c_str()).c_str());
+    writer.open(fname.c_str());
+
+    // write run data
+    writer.beginRecordingForRun(getRunId().c_str(), getRunAttributes(), getIterationVariables(), getSelectedConfigEntries());
+}
+
+void BinaryOutputVectorManager::closeFile()
+{
+    writer.close();
+}
+
+void *BinaryOutputVectorManager::registerVector(const char *modulename, const char *vectorname)
+{
+    Assert(state == NEW || state == STARTED || state == OPENED); // note: NEW needs to be allowed for now
+
+    VectorData *vp = new VectorData();
+    vp->handleInWriter = nullptr;
+    vp->moduleName = modulename;
+    vp->vectorName = vectorname;
+
+    std::string vectorfullpath = std::string(modulename) + "." + vectorname;
+    vp->enabled = cfg->getAsBool(vectorfullpath.c_str(), CFGID_VECTOR_RECORDING);
+
+    // get interval string
+    const char *text = cfg->getAsCustom(vectorfullpath.c_str(), CFGID_VECTOR_RECORDING_INTERVALS);
+    if (text)
+        vp->intervals.parse(text);
+
+    vectors.push_back(vp);
+    return vp;
+}
+
+void BinaryOutputVectorManager::deregisterVector(void *vectorhandle)
+{
+    ASSERT(vectorhandle != nullptr);
+    VectorData *vp = (VectorData *)vectorhandle;
+    if (writer.isOpen() && vp->handleInWriter != nullptr)
+        writer.deregisterVector(vp->handleInWriter);
+
+    Vectors::iterator newEnd = std::remove(vectors.begin(), vectors.end(), vp);
+    vectors.erase(newEnd, vectors.end());
+    delete vp;
+}
+
+void BinaryOutputVectorManager::setVectorAttribute(void *vectorhandle, const char *name, const char *value)
+{
+    ASSERT(vectorhandle != nullptr);
+    VectorData *vp = (VectorData *)vectorhandle;
+    ASSERT(vp->handleInWriter == nullptr); // otherwise it's too late
+    vp->attributes[name] = value;
+}
+
+bool BinaryOutputVectorManager::record(void *vectorhandle, simtime_t t, double value)
+{
+    if (state == ENDED)
+        return false;    // ignore writes during network teardown
+
+    Assert(state == STARTED || state == OPENED);
+
+    ASSERT(vectorhandle != nullptr);
+    VectorData *vp = (VectorData *)vectorhandle;
+
+    if (!vp->enabled || !vp->intervals.contains(t))
+        return false;
+
+    if (state != OPENED)
+        openFileForRun();
+
+    if (isBad())
+        return false;
+
+    if (vp->handleInWriter == nullptr) {
+        std::string vectorFullPath = vp->moduleName.str() + "." + vp->vectorName.c_str();
+        size_t bufferSize = (size_t) cfg->getAsDouble(vectorFullPath.c_str(), CFGID_VECTOR_BUFFER);
+        bool recordEventNumbers = cfg->getAsBool(vectorFullPath.c_str(), CFGID_VECTOR_RECORD_EVENTNUMBERS);
+        vp->handleInWriter = writer.registerVector(vp->moduleName.c_str(), vp->vectorName.c_str(), convertMap(&vp->attributes), bufferSize, recordEventNumbers);
+    }
+
+    eventnumber_t eventNumber = getSimulation()->getEventNumber();
+    writer.recordInVector(vp->handleInWriter, eventNumber, t.raw(), t.getScaleExp(), value);
+    return true;
+}
+
+void BinaryOutputVectorManager::flush()
+{
+    if (writer.isOpen())
+        writer.flush();
+}
+
+}  // namespace envir
+}  // namespace omnetpp
+
@@ -0,0 +1,134 @@
+//==========================================================================
+//  BINARYOUTVECTORMGR.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2015 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_ENVIR_BINARYOUTVECTORMGR_H
+#define __OMNETPP_ENVIR_BINARYOUTVECTORMGR_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "omnetpp/envirext.h"
+#include "omnetpp/opp_string.h"
+#include "omnetpp/platdep/platdefs.h"
+#include "omnetpp/simtime_t.h"
+#include "intervals.h"
+#include "common/binaryvectorfilewriter.h"
+
+namespace omnetpp {
+namespace envir {
+
+using omnetpp::common::BinaryVectorFileWriter;
+
+/**
+ * A cIOutputVectorManager that writes binary output vector files (fixed-width
+ * columns, see common/binaryvectorfileformat.h) with a text index file.
+ *
+ * @ingroup Envir
+ */
+class BinaryOutputVectorManager : public cIOutputVectorManager, private ResultFileUtils
+{
+  protected:
+    struct VectorData {
+        void *handleInWriter;      // nullptr until vector is registered in the writer
+        opp_string moduleName;     // full path of component the vector belongs to
+        opp_string vectorName;     // vector name
+        opp_string_map attributes; // vector attributes
+        bool enabled;              // write to the output file can be enabled/disabled
+        Intervals intervals;       // recording intervals
+    };
+
+    typedef std::vector<VectorData*> Vectors;
+
+    cConfiguration *cfg = nullptr;
+    enum State {NEW, STARTED, OPENED, ENDED} state = NEW;
+    std::string fname;
+    bool shouldAppend = false;
+    BinaryVectorFileWriter writer;
+    Vectors vectors; // registered output vectors
+
+  protected:
+    virtual void openFileForRun();
+    virtual void closeFile();
+    bool isBad() {return state==OPENED && !writer.isOpen();}
+
+  public:
+    /** @name Constructors, destructor */
+    //@{
+
+    /**
+     * Constructor.
+     */
+    BinaryOutputVectorManager() {}
+
+    /**
+     * Destructor. Closes the output file if it is still open.
+     */
+    virtual ~BinaryOutputVectorManager() {closeFile();}
+    //@}
+
+    /** @name Redefined cIOutputVectorManager member functions. */
+    //@{
+    /**
+     * Sets the configuration database to use for configuring this object.
+     */
+    virtual void configure(cSimulation *simulation, cConfiguration *cfg) override;
+
+    /**
+     * Deletes output vector file if exists (left over from previous runs).
+     * The file is not yet opened, it is done inside registerVector() on demand.
+     */
+    virtual void startRun() override;
+
+    /**
+     * Closes the output file.
+     */
+    virtual void endRun() override;
+
+    /**
+     * Registers a vector and returns a handle.
+     */
+    virtual void *registerVector(const char *modulename, const char *vectorname) override;
+
+    /**
+     * Deregisters the output vector.
+     */
+    virtual void deregisterVector(void *vechandle) override;
+
+    /**
+     * Sets an attribute of an output vector.
+     */
+    virtual void setVectorAttribute(void *vechandle, const char *name, const char *value) override;
+
+    /**
+     * Writes the (time, value) pair into the output file.
+     */
+    virtual bool record(void *vectorhandle, simtime_t t, double value) override;
+
+    /**
+     * Returns the file name.
+     */
+    const char *getFileName() const override {return fname.c_str();}
+
+    /**
+     * Calls fflush().
+     */
+    virtual void flush() override;
+    //@}
+};
+
+}  // namespace envir
+}  // namespace omnetpp
+
+#endif
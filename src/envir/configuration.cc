@@ -43,7 +43,8 @@ Configuration::MatchableEntry::MatchableEntry(const MatchableEntry& e) :
     Entry(e),
     ownerPattern(e.ownerPattern ? new PatternMatcher(*e.ownerPattern) : nullptr),
     suffixPattern(e.suffixPattern ? new PatternMatcher(*e.suffixPattern) : nullptr),
-    fullPathPattern(e.fullPathPattern ? new PatternMatcher(*e.fullPathPattern) : nullptr)
+    fullPathPattern(e.fullPathPattern ? new PatternMatcher(*e.fullPathPattern) : nullptr),
+    ownerPatternId(e.ownerPatternId)
 {
 }
 
@@ -250,8 +251,10 @@ void Configuration::addEntry(const InifileContents::Entry& iniEntry)
         bool suffixContainsWildcards = PatternMatcher::containsWildcards(suffix.c_str());
 
         MatchableEntry *entry = new MatchableEntry(iniEntry);
-        if (!ownerName.empty())
+        if (!ownerName.empty()) {
             entry->ownerPattern = new PatternMatcher(ownerName.c_str(), true, true, true);
+            entry->ownerPatternId = ownerPatternIndex.addPattern(ownerName.c_str());
+        }
         else
             entry->fullPathPattern = new PatternMatcher(key, true, true, true);
         entry->suffixPattern = suffixContainsWildcards ? new PatternMatcher(suffix.c_str(), true, true, true) : nullptr;
@@ -371,6 +374,7 @@ const cConfiguration::KeyValue& Configuration::getParameterEntry(const char *mod
     const SuffixBin *bin = it == suffixBins.end() ? &wildcardSuffixBin : &it->second;
 
     // find first match in the bin
+    ownerPatternIndex.setPath(moduleFullPath);
     for (const auto & entry : bin->entries) {
         if (entryMatches(entry, moduleFullPath, paramName))
             if (hasDefaultValue || !opp_streq(entry->getValue(), "default"))
@@ -379,11 +383,11 @@ const cConfiguration::KeyValue& Configuration::getParameterEntry(const char *mod
     return nullEntry;
 }
 
-bool Configuration::entryMatches(const MatchableEntry *entry, const char *moduleFullPath, const char *paramName)
+bool Configuration::entryMatches(const MatchableEntry *entry, const char *moduleFullPath, const char *paramName) const
 {
     if (!entry->fullPathPattern) {
-        // typical
-        return entry->ownerPattern->matches(moduleFullPath) && (entry->suffixPattern == nullptr || entry->suffixPattern->matches(paramName));
+        // typical; note: the caller must have called ownerPatternIndex.setPath(moduleFullPath)
+        return ownerPatternIndex.matches(entry->ownerPatternId) && (entry->suffixPattern == nullptr || entry->suffixPattern->matches(paramName));
     }
     else {
         // less efficient, but very rare
@@ -457,6 +461,7 @@ const cConfiguration::KeyValue& Configuration::getPerObjectConfigEntry(const cha
     const SuffixBin *suffixBin = &it->second;
 
     // find first match in the bin
+    ownerPatternIndex.setPath(objectFullPath);
     for (const auto & entry : suffixBin->entries) {
         if (entryMatches(entry, objectFullPath, keySuffix))
             return entry->markAccessed();  // found value
@@ -24,6 +24,7 @@
 #include "omnetpp/cconfiguration.h"
 #include "envirdefs.h"
 #include "inifilecontents.h"
+#include "pathpatternindex.h"
 
 namespace omnetpp {
 
@@ -67,6 +68,7 @@ class ENVIR_API Configuration : public cConfiguration  //TODO rename Configurati
         PatternMatcher *ownerPattern = nullptr; // key without the suffix
         PatternMatcher *suffixPattern = nullptr; // only filled in when this is a wildcard bin
         PatternMatcher *fullPathPattern = nullptr; // when present, match against this instead of ownerPattern & suffixPattern
+        int ownerPatternId = -1; // ownerPattern's ID in ownerPatternIndex
 
         MatchableEntry(const Entry& e) : Entry(e) {}
         MatchableEntry(const MatchableEntry& e);   // apparently only used for std::vector storage
@@ -115,6 +117,12 @@ class ENVIR_API Configuration : public cConfiguration  //TODO rename Configurati
     //   **.tcp.eedVector.record-interval ==> goes into the "record-interval" bin; ownerPattern="**.tcp.eedVector"
     //   **.tcp.eedVector.record-*"       ==> goes into the wildcard bin; ownerPattern="**.tcp.eedVector", suffixPattern="record-*"
     //
+    // Matching the owner patterns of a bin's entries one by one would still
+    // be slow for large networks (each parameter of each module would be
+    // matched against all entries of its bin), so owner patterns are also
+    // registered in a PathPatternIndex which matches a path against all of
+    // them at once, and memoizes partial results for the parent path.
+    //
     struct SuffixBin {
         std::vector<MatchableEntry*> entries;
     };
@@ -124,6 +132,7 @@ class ENVIR_API Configuration : public cConfiguration  //TODO rename Configurati
     std::map<std::string,Entry*> config; // config entries (i.e. keys not containing a dot or wildcard)
     std::map<std::string,SuffixBin> suffixBins;  // bins for each non-wildcard suffix
     SuffixBin wildcardSuffixBin; // bin for entries that contain wildcards
+    mutable PathPatternIndex ownerPatternIndex; // for matching entries' ownerPattern
 
     // predefined variables (${configname} etc) and iteration variables
     StringMap predefinedVariables;
@@ -139,7 +148,7 @@ class ENVIR_API Configuration : public cConfiguration  //TODO rename Configurati
     void addToBin(SuffixBin& bin, MatchableEntry *entry);
     static void parseVariable(const char *txt, std::string& outVarname, std::string& outValue, std::string& outParVar, const char *&outEndPtr);
     static void splitKey(const char *key, std::string& outOwnerName, std::string& outBinName);
-    static bool entryMatches(const MatchableEntry *entry, const char *moduleFullPath, const char *paramName);
+    bool entryMatches(const MatchableEntry *entry, const char *moduleFullPath, const char *paramName) const;
     static bool isPredefinedVariable(const char *varname);
     virtual bool isEssentialOption(const char *key) const;
     virtual std::string substituteVariables(const char *text, const StringMap& variables) const;
@@ -14,6 +14,7 @@
 *--------------------------------------------------------------*/
 
 #include <algorithm>
+#include <exception>
 #include "common/opp_ctype.h"
 #include "common/commonutil.h"  // vsnprintf
 #include "common/fileutil.h"
@@ -35,6 +36,7 @@
 #include "omnetpp/checkandcast.h"
 #include "eventlogfilemgr.h"
 #include "eventlogwriter.h"
+#include "binaryeventlogwriter.h"
 #include "genericenvir.h"
 #include "resultfileutils.h"
 
@@ -46,6 +48,7 @@ namespace envir {
 Register_Class(EventlogFileManager)
 
 Register_GlobalConfigOption(CFGID_EVENTLOG_FILE, "eventlog-file", CFG_FILENAME, "${resultdir}/${configname}-${iterationvarsf}#${repetition}.elog", "Name of the eventlog file to generate.");
+Register_GlobalConfigOption(CFGID_EVENTLOG_FILE_FORMAT, "eventlog-file-format", CFG_STRING, "text", "Format of the eventlog file. `text`: the line-oriented text format; `binary`: a compact binary encoding of the same entries, with delta-coded event numbers, simulation times and ids, and a string table. Binary eventlogs are written by a background thread, and can be read with opp_eventlogtool and the Sequence Chart, which decode them on the fly. Note that `eventlog-max-size` is not enforced for binary eventlogs.");
 Register_GlobalConfigOptionU(CFGID_EVENTLOG_MAX_SIZE, "eventlog-max-size", "B", "10 GiB", "Specify the maximum size of the eventlog file in bytes. The eventlog file is automatically truncated when this limit is reached.");
 Register_GlobalConfigOptionU(CFGID_EVENTLOG_MIN_TRUNCATED_SIZE, "eventlog-min-truncated-size", "B", "1 GiB", "Specify the minimum size of the eventlog file in bytes after the file is truncated. Truncation means older events are discarded while newer ones are kept.");
 Register_GlobalConfigOptionU(CFGID_EVENTLOG_SNAPSHOT_FREQUENCY, "eventlog-snapshot-frequency", "B", "100 MiB", "The eventlog file contains snapshots periodically. Each one describes the complete simulation state at a specific event. Snapshots help various tools to handle large eventlog files more efficiently. Specifying greater value means less help, while smaller value means bigger eventlog files.");
@@ -74,6 +77,13 @@ Register_PerObjectConfigOption(CFGID_MODULE_EVENTLOG_RECORDING, "module-eventlog
 
 extern cConfigOption *CFGID_RECORD_EVENTLOG;
 
+// buffering of binary eventlogs: size of the blocks handed over to the I/O thread, and the limit of data in transit
+#define BINARY_EVENTLOG_BUFFER_SIZE       (1024*1024)
+#define BINARY_EVENTLOG_MAX_PENDING_SIZE  (16*1024*1024)
+
+// records an entry with the EventLogWriter method of the file format being written
+#define EVENTLOG_RECORD(method, ...)  (binaryWriter ? EventLogWriter::method(binaryWriter, __VA_ARGS__) : EventLogWriter::method(feventlog, __VA_ARGS__))
+
 static bool compareMessageEventNumbers(cMessage *message1, cMessage *message2)
 {
     return message1->getPreviousEventNumber() < message2->getPreviousEventNumber();
@@ -116,6 +126,8 @@ EventlogFileManager::~EventlogFileManager()
     messageDetailPrinter = nullptr;
     delete recordingIntervals;
     recordingIntervals = nullptr;
+    delete binaryWriter;
+    binaryWriter = nullptr;
     delete fileLock;
     fileLock = nullptr;
 }
@@ -157,6 +169,14 @@ void EventlogFileManager::configure(cSimulation *simulation, cConfiguration *cfg
 
     recordEventLog = cfg->getAsBool(CFGID_RECORD_EVENTLOG);
 
+    std::string format = cfg->getAsString(CFGID_EVENTLOG_FILE_FORMAT);
+    if (format == "text")
+        isBinaryFormat = false;
+    else if (format == "binary")
+        isBinaryFormat = true;
+    else
+        throw opp_runtime_error("Unknown eventlog-file-format '%s', expected 'text' or 'binary'", format.c_str());
+
     // setup eventlog object printer
     delete messageDetailPrinter;
     messageDetailPrinter = nullptr;
@@ -239,17 +259,32 @@ void EventlogFileManager::open()
         throw opp_runtime_error("Cannot open eventlog file `%s' for write", filename.c_str());
     printf("Recording eventlog to file `%s'...\n", filename.c_str());
     fileLock = new FileLock(feventlog, filename.c_str());
+    if (isBinaryFormat)
+        binaryWriter = new BinaryEventLogWriter(feventlog, BINARY_EVENTLOG_BUFFER_SIZE, BINARY_EVENTLOG_MAX_PENDING_SIZE);
     clearInternalState();
 }
 
 void EventlogFileManager::close()
 {
     ASSERT(feventlog);
+    std::exception_ptr error;
+    if (binaryWriter) {
+        try {
+            binaryWriter->drain();
+        }
+        catch (std::exception&) {
+            error = std::current_exception();
+        }
+        delete binaryWriter;
+        binaryWriter = nullptr;
+    }
     fclose(feventlog);
     feventlog = nullptr;
     isEventRecordingEnabled = false;
     delete fileLock;
     fileLock = nullptr;
+    if (error)
+        std::rethrow_exception(error);
 }
 
 void EventlogFileManager::remove()
@@ -295,7 +330,7 @@ void EventlogFileManager::truncate()
         opp_fseek(feventlog, 0, SEEK_SET);
         if (ferror(feventlog))
             throw opp_runtime_error("Cannot seek in file '%s', error code %d", filename.c_str(), ferror(feventlog));
-        EventLogWriter::recordSimulationBeginEntry_ov_ev_rid(feventlog, OMNETPP_VERSION, EVENTLOG_VERSION, runId);
+        EventLogWriter::recordSimulationBeginEntry_ov_ev_rid(feventlog, OMNETPP_VERSION, EVENTLOG_VERSION, runId);  // truncation is only done in text format
         file_offset_t copyToOffset = opp_ftell(feventlog);
         beginningFileOffset -= copyToOffset;
         // copy the trailing content of the eventlog file backwards
@@ -383,7 +418,32 @@ void EventlogFileManager::clearRecordingIntervals()
 
 void EventlogFileManager::flush()
 {
-    if (isEventRecordingEnabled)
+    if (isEventRecordingEnabled) {
+        if (binaryWriter)
+            binaryWriter->drain();
+        else
+            fflush(feventlog);
+    }
+}
+
+void EventlogFileManager::recordEmptyLine()
+{
+    if (binaryWriter)
+        binaryWriter->writeEmptyLine();
+    else
+        fprintf(feventlog, "\n");
+}
+
+file_offset_t EventlogFileManager::getFileOffset()
+{
+    return binaryWriter ? binaryWriter->getOffset() : opp_ftell(feventlog);
+}
+
+void EventlogFileManager::flushFile()
+{
+    if (binaryWriter)
+        binaryWriter->flush();  // asynchronous
+    else
         fflush(feventlog);
 }
 
@@ -398,7 +458,7 @@ void EventlogFileManager::simulationEvent(cEvent *event)
         eventNumber = getSimulation()->getEventNumber();
         simulationTime = getSimulation()->getSimTime();
         FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_EXCLUSIVE);
-        file_offset_t fileOffset = opp_ftell(feventlog);
+        file_offset_t fileOffset = getFileOffset();
         if (lastChunk != INDEX && fileOffset - toRealFileOffset(previousIndexFileOffset) > indexFrequency)
             recordIndex();
         if (lastChunk != SNAPSHOT && fileOffset - toRealFileOffset(previousSnapshotFileOffset) > snapshotFrequency) {
@@ -406,13 +466,13 @@ void EventlogFileManager::simulationEvent(cEvent *event)
                 recordIndex();
             recordSnapshot();
         }
-        fileOffset = opp_ftell(feventlog);
-        if (fileOffset > maxSize)
+        fileOffset = getFileOffset();
+        if (!binaryWriter && fileOffset > maxSize)
             truncate();
-        fprintf(feventlog, "\n");
+        recordEmptyLine();
         auto fingerprintCalculator = getSimulation()->getFingerprintCalculator();
         if (msg)
-            EventLogWriter::recordEventEntry_e_t_m_ce_msg_f(feventlog, eventNumber, getSimulation()->getSimTime(), mod->getId(), msg->getPreviousEventNumber(), msg->getId(), (fingerprintCalculator ? fingerprintCalculator->str().c_str() : nullptr));
+            EVENTLOG_RECORD(recordEventEntry_e_t_m_ce_msg_f, eventNumber, getSimulation()->getSimTime(), mod->getId(), msg->getPreviousEventNumber(), msg->getId(), (fingerprintCalculator ? fingerprintCalculator->str().c_str() : nullptr));
         else
             ; // TODO: record non message handling events
         entryIndex = 0;
@@ -433,7 +493,7 @@ void EventlogFileManager::bubble(cComponent *component, const char *text)
         if (dynamic_cast<cModule *>(component)) {
             FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_EXCLUSIVE);
             cModule *mod = (cModule *)component;
-            EventLogWriter::recordBubbleEntry_id_txt(feventlog, mod->getId(), text);
+            EVENTLOG_RECORD(recordBubbleEntry_id_txt, mod->getId(), text);
             entryIndex++;
         }
         else if (cChannel *channel = dynamic_cast<cChannel *>(component)) {
@@ -451,7 +511,7 @@ void EventlogFileManager::beginSend(cMessage *msg, const SendOptions& options)
         bool isScheduled = msg->isScheduled();
         bool isPacket = msg->isPacket();
         cPacket *pkt = isPacket ? (cPacket *)msg : nullptr; // note: simply `(cPacket *)msg` would cause sanitizer to complain about illegal cast
-        EventLogWriter::recordBeginSendEntry_id_tid_eid_etid_c_n_k_p_l_er_m_sm_sg_st_am_ag_at_d_pe_sd_up_tx(feventlog,
+        EVENTLOG_RECORD(recordBeginSendEntry_id_tid_eid_etid_c_n_k_p_l_er_m_sm_sg_st_am_ag_at_d_pe_sd_up_tx,
             msg->getId(), msg->getTreeId(), isPacket ? pkt->getEncapsulationId() : msg->getId(), isPacket ? pkt->getEncapsulationTreeId() : msg->getTreeId(),
             msg->getClassName(), msg->getFullName(),
             msg->getKind(), msg->getSchedulingPriority(), isPacket ? pkt->getBitLength() : 0, isPacket ? pkt->hasBitError() : false,
@@ -485,7 +545,7 @@ void EventlogFileManager::messageCancelled(cMessage *msg)
         bool isScheduled = msg->isScheduled();
         bool isPacket = msg->isPacket();
         cPacket *pkt = isPacket ? (cPacket *)msg : nullptr;
-        EventLogWriter::recordCancelEventEntry_id_tid_eid_etid_c_n_k_p_l_er_m_sm_sg_st_am_ag_at_d_pe(feventlog,
+        EVENTLOG_RECORD(recordCancelEventEntry_id_tid_eid_etid_c_n_k_p_l_er_m_sm_sg_st_am_ag_at_d_pe,
             msg->getId(), msg->getTreeId(), isPacket ? pkt->getEncapsulationId() : msg->getId(), isPacket ? pkt->getEncapsulationTreeId() : msg->getTreeId(),
             msg->getClassName(), msg->getFullName(),
             msg->getKind(), msg->getSchedulingPriority(), isPacket ? pkt->getBitLength() : 0, isPacket ? pkt->hasBitError() : false,
@@ -506,7 +566,7 @@ void EventlogFileManager::messageSendDirect(cMessage *msg, cGate *toGate, const
     if (isEventRecordingEnabled && isMessageRecordingEnabled) {
         FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_EXCLUSIVE);
         ASSERT(result.remainingDuration >= 0);
-        EventLogWriter::recordSendDirectEntry_sm_dm_dg_pd_td_rd(feventlog, msg->getSenderModuleId(), toGate->getOwnerModule()->getId(), toGate->getId(), result.delay, result.duration, result.remainingDuration);
+        EVENTLOG_RECORD(recordSendDirectEntry_sm_dm_dg_pd_td_rd, msg->getSenderModuleId(), toGate->getOwnerModule()->getId(), toGate->getId(), result.delay, result.duration, result.remainingDuration);
         entryIndex++;
     }
 }
@@ -516,7 +576,7 @@ void EventlogFileManager::messageSendHop(cMessage *msg, cGate *srcGate)
     // TODO: store this related the message, so that we can repeat it in snapshots
     if (isEventRecordingEnabled && isMessageRecordingEnabled) {
         FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_EXCLUSIVE);
-        EventLogWriter::recordSendHopEntry_sm_sg(feventlog, srcGate->getOwnerModule()->getId(), srcGate->getId());
+        EVENTLOG_RECORD(recordSendHopEntry_sm_sg, srcGate->getOwnerModule()->getId(), srcGate->getId());
         entryIndex++;
     }
 }
@@ -527,7 +587,7 @@ void EventlogFileManager::messageSendHop(cMessage *msg, cGate *srcGate, const Ch
     if (isEventRecordingEnabled && isMessageRecordingEnabled) {
         FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_EXCLUSIVE);
         ASSERT(result.remainingDuration >= 0);
-        EventLogWriter::recordSendHopEntry_sm_sg_pd_td_rd_d(feventlog, srcGate->getOwnerModule()->getId(), srcGate->getId(), result.delay, result.duration, result.remainingDuration, result.discard);
+        EVENTLOG_RECORD(recordSendHopEntry_sm_sg_pd_td_rd_d, srcGate->getOwnerModule()->getId(), srcGate->getId(), result.delay, result.duration, result.remainingDuration, result.discard);
         entryIndex++;
     }
 }
@@ -541,7 +601,7 @@ void EventlogFileManager::endSend(cMessage *msg)
         bool isScheduled = msg->isScheduled();
         bool isPacket = msg->isPacket();
         cPacket *pkt = isPacket ? (cPacket *)msg : nullptr;
-        EventLogWriter::recordEndSendEntry_id_tid_eid_etid_c_n_k_p_l_er_m_sm_sg_st_am_ag_at_d_pe_i(feventlog,
+        EVENTLOG_RECORD(recordEndSendEntry_id_tid_eid_etid_c_n_k_p_l_er_m_sm_sg_st_am_ag_at_d_pe_i,
             msg->getId(), msg->getTreeId(), isPacket ? pkt->getEncapsulationId() : msg->getId(), isPacket ? pkt->getEncapsulationTreeId() : msg->getTreeId(),
             msg->getClassName(), msg->getFullName(),
             msg->getKind(), msg->getSchedulingPriority(), isPacket ? pkt->getBitLength() : 0, isPacket ? pkt->hasBitError() : false,
@@ -561,7 +621,7 @@ void EventlogFileManager::messageCreated(cMessage *msg)
         FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_EXCLUSIVE);
         bool isPacket = msg->isPacket();
         cPacket *pkt = isPacket ? (cPacket *)msg : nullptr;
-        EventLogWriter::recordCreateMessageEntry_id_tid_eid_etid_c_n_k_p_l_er_m_sm_sg_st_am_ag_at_d_pe(feventlog,
+        EVENTLOG_RECORD(recordCreateMessageEntry_id_tid_eid_etid_c_n_k_p_l_er_m_sm_sg_st_am_ag_at_d_pe,
             msg->getId(), msg->getTreeId(), isPacket ? pkt->getEncapsulationId() : msg->getId(), isPacket ? pkt->getEncapsulationTreeId() : msg->getTreeId(),
             msg->getClassName(), msg->getFullName(),
             msg->getKind(), msg->getSchedulingPriority(), isPacket ? pkt->getBitLength() : 0, isPacket ? pkt->hasBitError() : false,
@@ -581,7 +641,7 @@ void EventlogFileManager::messageCloned(cMessage *msg, cMessage *clone)
         bool isScheduled = clone->isScheduled();
         bool isPacket = clone->isPacket();
         cPacket *pkt = isPacket ? (cPacket *)msg : nullptr;
-        EventLogWriter::recordCloneMessageEntry_id_tid_eid_etid_c_n_k_p_l_er_m_sm_sg_st_am_ag_at_d_pe_cid(feventlog,
+        EVENTLOG_RECORD(recordCloneMessageEntry_id_tid_eid_etid_c_n_k_p_l_er_m_sm_sg_st_am_ag_at_d_pe_cid,
             clone->getId(), clone->getTreeId(), isPacket ? pkt->getEncapsulationId() : clone->getId(), isPacket ? pkt->getEncapsulationTreeId() : clone->getTreeId(),
             clone->getClassName(), clone->getFullName(),
             clone->getKind(), clone->getSchedulingPriority(), isPacket ? pkt->getBitLength() : 0, isPacket ? pkt->hasBitError() : false,
@@ -604,7 +664,7 @@ void EventlogFileManager::messageDeleted(cMessage *msg)
         cModule *ownerModule = dynamic_cast<cModule *>(msg->getOwner());
         bool isPacket = msg->isPacket();
         cPacket *pkt = isPacket ? (cPacket *)msg : nullptr;
-        EventLogWriter::recordDeleteMessageEntry_id_tid_eid_etid_c_n_k_p_l_er_m_sm_sg_st_am_ag_at_d_pe(feventlog,
+        EVENTLOG_RECORD(recordDeleteMessageEntry_id_tid_eid_etid_c_n_k_p_l_er_m_sm_sg_st_am_ag_at_d_pe,
             msg->getId(), msg->getTreeId(), isPacket ? pkt->getEncapsulationId() : msg->getId(), isPacket ? pkt->getEncapsulationTreeId() : msg->getTreeId(),
             msg->getClassName(), msg->getFullName(),
             msg->getKind(), msg->getSchedulingPriority(), isPacket ? pkt->getBitLength() : 0, isPacket ? pkt->hasBitError() : false,
@@ -629,7 +689,7 @@ void EventlogFileManager::componentMethodBegin(cComponent *from, cComponent *to,
                 methodTextBuf[MAX_METHODCALL-1] = '\0';
                 methodText = methodTextBuf;
             }
-            EventLogWriter::recordComponentMethodBeginEntry_sm_tm_m(feventlog, ((cModule *)from)->getId(), ((cModule *)to)->getId(), methodText);
+            EVENTLOG_RECORD(recordComponentMethodBeginEntry_sm_tm_m, ((cModule *)from)->getId(), ((cModule *)to)->getId(), methodText);
             entryIndex++;
         }
     }
@@ -641,7 +701,10 @@ void EventlogFileManager::componentMethodEnd()
         FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_EXCLUSIVE);
         // TODO: problem when channel method is called: we'll emit an "End" entry but no "Begin"
         // TODO: same problem when the caller is not a module or is nullptr
-        EventLogWriter::recordComponentMethodEndEntry(feventlog);
+        if (binaryWriter)
+            EventLogWriter::recordComponentMethodEndEntry(binaryWriter);
+        else
+            EventLogWriter::recordComponentMethodEndEntry(feventlog);
         entryIndex++;
     }
 }
@@ -654,7 +717,7 @@ void EventlogFileManager::moduleCreated(cModule *module)
         FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_EXCLUSIVE);
         bool isCompoundModule = module->hasSubmodules() || !dynamic_cast<cSimpleModule *>(module);
         // FIXME: size() is missing
-        EventLogWriter::recordModuleCreatedEntry_id_c_t_pid_n_cm(feventlog, module->getId(), module->getClassName(), module->getNedTypeName(), module->getParentModule() ? module->getParentModule()->getId() : -1, module->getFullName(), isCompoundModule);
+        EVENTLOG_RECORD(recordModuleCreatedEntry_id_c_t_pid_n_cm, module->getId(), module->getClassName(), module->getNedTypeName(), module->getParentModule() ? module->getParentModule()->getId() : -1, module->getFullName(), isCompoundModule);
         entryIndex++;
         addIndexEventLogEntry(eventNumber, entryIndex);
         moduleToModuleCreatedEntryReferenceMap[module] = EventLogEntryReference(eventNumber, entryIndex);
@@ -665,7 +728,7 @@ void EventlogFileManager::moduleDeleted(cModule *module)
 {
     if (isEventRecordingEnabled && isModuleRecordingEnabled) {
         FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_EXCLUSIVE);
-        EventLogWriter::recordModuleDeletedEntry_id(feventlog, module->getId());
+        EVENTLOG_RECORD(recordModuleDeletedEntry_id, module->getId());
         entryIndex++;
         removeIndexEventLogEntry(moduleToModuleCreatedEntryReferenceMap[module]);
         moduleToModuleCreatedEntryReferenceMap.erase(module);
@@ -680,7 +743,7 @@ void EventlogFileManager::gateCreated(cGate *gate)
 {
     if (isEventRecordingEnabled && isModuleRecordingEnabled) {
         FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_EXCLUSIVE);
-        EventLogWriter::recordGateCreatedEntry_m_g_n_i_o(feventlog, gate->getOwnerModule()->getId(), gate->getId(), gate->getName(), gate->isVector() ? gate->getIndex() : -1, gate->getType() == cGate::OUTPUT);
+        EVENTLOG_RECORD(recordGateCreatedEntry_m_g_n_i_o, gate->getOwnerModule()->getId(), gate->getId(), gate->getName(), gate->isVector() ? gate->getIndex() : -1, gate->getType() == cGate::OUTPUT);
         entryIndex++;
         addIndexEventLogEntry(eventNumber, entryIndex);
         gateToGateCreatedEntryReferenceMap[gate] = EventLogEntryReference(eventNumber, entryIndex);
@@ -691,7 +754,7 @@ void EventlogFileManager::gateDeleted(cGate *gate)
 {
     if (isEventRecordingEnabled && isModuleRecordingEnabled) {
         FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_EXCLUSIVE);
-        EventLogWriter::recordGateDeletedEntry_m_g(feventlog, gate->getOwnerModule()->getId(), gate->getId());
+        EVENTLOG_RECORD(recordGateDeletedEntry_m_g, gate->getOwnerModule()->getId(), gate->getId());
         entryIndex++;
         removeIndexEventLogEntry(gateToGateCreatedEntryReferenceMap[gate]);
         gateToGateCreatedEntryReferenceMap.erase(gate);
@@ -704,7 +767,7 @@ void EventlogFileManager::connectionCreated(cGate *srcgate)
         FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_EXCLUSIVE);
         cGate *destgate = srcgate->getNextGate();
         // TODO: channel, channel attributes, etc
-        EventLogWriter::recordConnectionCreatedEntry_sm_sg_dm_dg(feventlog, srcgate->getOwnerModule()->getId(), srcgate->getId(), destgate->getOwnerModule()->getId(), destgate->getId());
+        EVENTLOG_RECORD(recordConnectionCreatedEntry_sm_sg_dm_dg, srcgate->getOwnerModule()->getId(), srcgate->getId(), destgate->getOwnerModule()->getId(), destgate->getId());
         entryIndex++;
         addIndexEventLogEntry(eventNumber, entryIndex);
         channelToConnectionCreatedEntryReferenceMap[srcgate] = EventLogEntryReference(eventNumber, entryIndex);
@@ -719,7 +782,7 @@ void EventlogFileManager::connectionDeleted(cGate *srcgate)
 {
     if (isEventRecordingEnabled && isModuleRecordingEnabled) {
         FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_EXCLUSIVE);
-        EventLogWriter::recordConnectionDeletedEntry_sm_sg(feventlog, srcgate->getOwnerModule()->getId(), srcgate->getId());
+        EVENTLOG_RECORD(recordConnectionDeletedEntry_sm_sg, srcgate->getOwnerModule()->getId(), srcgate->getId());
         entryIndex++;
         removeIndexEventLogEntry(channelToConnectionCreatedEntryReferenceMap[srcgate]);
         channelToConnectionCreatedEntryReferenceMap.erase(srcgate);
@@ -732,7 +795,7 @@ void EventlogFileManager::displayStringChanged(cComponent *component)
         if (dynamic_cast<cModule *>(component)) {
             FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_EXCLUSIVE);
             cModule *module = (cModule *)component;
-            EventLogWriter::recordModuleDisplayStringChangedEntry_id_d(feventlog, module->getId(), module->getDisplayString().str());
+            EVENTLOG_RECORD(recordModuleDisplayStringChangedEntry_id_d, module->getId(), module->getDisplayString().str());
             entryIndex++;
             addIndexEventLogEntry(eventNumber, entryIndex);
             std::map<cModule *, EventLogEntryReference>::iterator it = moduleToModuleDisplayStringChangedEntryReferenceMap.find(module);
@@ -744,7 +807,7 @@ void EventlogFileManager::displayStringChanged(cComponent *component)
             FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_EXCLUSIVE);
             cChannel *channel = (cChannel *)component;
             cGate *gate = channel->getSourceGate();
-            EventLogWriter::recordConnectionDisplayStringChangedEntry_sm_sg_d(feventlog, gate->getOwnerModule()->getId(), gate->getId(), channel->getDisplayString().str());
+            EVENTLOG_RECORD(recordConnectionDisplayStringChangedEntry_sm_sg_d, gate->getOwnerModule()->getId(), gate->getId(), channel->getDisplayString().str());
             entryIndex++;
             addIndexEventLogEntry(eventNumber, entryIndex);
             std::map<cGate *, EventLogEntryReference>::iterator it = channelToConnectionDisplayStringChangedEntryReferenceMap.find(gate);
@@ -765,11 +828,15 @@ void EventlogFileManager::logLine(const char *prefix, const char *text, int leng
             char *lineEnd = line;
             while (lineEnd != textEnd && *lineEnd != '\n')
                 lineEnd++;
-            EventLogWriter::recordLogLine(feventlog, prefix, line, lineEnd - line);
-            // TODO: write the escaped new lines into the eventlog file and handle this from the gui
-//            if (*lineEnd == '\n')
-//                fprintf(feventlog, "\\n");
-            fprintf(feventlog, "\n");
+            if (binaryWriter)
+                binaryWriter->writeLogLine(prefix, line, lineEnd - line);
+            else {
+                EventLogWriter::recordLogLine(feventlog, prefix, line, lineEnd - line);
+                // TODO: write the escaped new lines into the eventlog file and handle this from the gui
+//                if (*lineEnd == '\n')
+//                    fprintf(feventlog, "\\n");
+                fprintf(feventlog, "\n");
+            }
             line = lineEnd + 1;
             entryIndex++;
         }
@@ -877,43 +944,43 @@ void EventlogFileManager::recordSimulationBegin()
     FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_EXCLUSIVE);
     beginningFileOffset = 0;
     const char *runId = cfg->getVariable(CFGVAR_RUNID);
-    EventLogWriter::recordSimulationBeginEntry_ov_ev_rid(feventlog, OMNETPP_VERSION, EVENTLOG_VERSION, runId);
+    EVENTLOG_RECORD(recordSimulationBeginEntry_ov_ev_rid, OMNETPP_VERSION, EVENTLOG_VERSION, runId);
     eventNumber = -1;
     entryIndex = 0;
     lastChunk = BEGIN;
-    fflush(feventlog);
+    flushFile();
 }
 
 void EventlogFileManager::recordSimulationEnd(bool isError, int resultCode, const char *message)
 {
     FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_EXCLUSIVE);
-    fprintf(feventlog, "\n");
-    EventLogWriter::recordSimulationEndEntry_e_c_m(feventlog, isError, resultCode, message);
+    recordEmptyLine();
+    EVENTLOG_RECORD(recordSimulationEndEntry_e_c_m, isError, resultCode, message);
     eventNumber = -1;
     entryIndex = 0;
     lastChunk = END;
-    fflush(feventlog);
+    flushFile();
 }
 
 void EventlogFileManager::recordInitialize()
 {
     FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_EXCLUSIVE);
-    fprintf(feventlog, "\n");
+    recordEmptyLine();
     // we can't use getSimulation()->getEventNumber() and getSimulation()->getSimTime(), because when we start a new run
     // these numbers are still set from the previous run (i.e. not zero)
-    EventLogWriter::recordEventEntry_e_t_m_ce_msg(feventlog, 0, 0, 1, -1, -1);
+    EVENTLOG_RECORD(recordEventEntry_e_t_m_ce_msg, 0, 0, 1, -1, -1);
     eventNumber = 0;
     entryIndex = 0;
-    fflush(feventlog);
+    flushFile();
 }
 
 void EventlogFileManager::recordSnapshot()
 {
     // TODO: shouldn't we clear the index here?
     FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_EXCLUSIVE);
-    fprintf(feventlog, "\n");
-    file_offset_t snapshotFileOffset = toVirtualFileOffset(opp_ftell(feventlog));
-    EventLogWriter::recordSnapshotEntry_f_e_t(feventlog, toVirtualFileOffset(opp_ftell(feventlog)), eventNumber, simulationTime);
+    recordEmptyLine();
+    file_offset_t snapshotFileOffset = toVirtualFileOffset(getFileOffset());
+    EVENTLOG_RECORD(recordSnapshotEntry_f_e_t, toVirtualFileOffset(getFileOffset()), eventNumber, simulationTime);
     entryIndex = 0;
     previousSnapshotFileOffset = snapshotFileOffset;
     cModule *systemModule = getSimulation()->getSystemModule();
@@ -928,10 +995,10 @@ void EventlogFileManager::recordSnapshot()
     for (std::map<eventnumber_t, std::vector<EventLogEntryRange> >::iterator it = eventNumberToSnapshotEventLogEntryRanges.begin(); it != eventNumberToSnapshotEventLogEntryRanges.end(); it++) {
         std::vector<EventLogEntryRange> &ranges = it->second;
         for (std::vector<EventLogEntryRange>::iterator jt = ranges.begin(); jt != ranges.end(); jt++)
-            EventLogWriter::recordReferenceFoundEntry_e_b_e(feventlog, jt->eventNumber, jt->beginEntryIndex, jt->endEntryIndex);
+            EVENTLOG_RECORD(recordReferenceFoundEntry_e_b_e, jt->eventNumber, jt->beginEntryIndex, jt->endEntryIndex);
     }
     lastChunk = SNAPSHOT;
-    fflush(feventlog);
+    flushFile();
 }
 
 void EventlogFileManager::recordModules(cModule *module)
@@ -943,16 +1010,16 @@ void EventlogFileManager::recordModules(cModule *module)
     bool isCompoundModule = module->hasSubmodules() || !dynamic_cast<cSimpleModule *>(module);
     // FIXME: size() is missing
     std::map<cModule *, EventLogEntryReference>::iterator mit = moduleToModuleCreatedEntryReferenceMap.find(module);
-    EventLogWriter::recordModuleFoundEntry_id_c_t_pid_n_cm_e_ei(feventlog, module->getId(), module->getClassName(), module->getNedTypeName(), parentModule ? parentModule->getId() : -1, module->getFullName(), isCompoundModule, mit->second.eventNumber, mit->second.entryIndex);
+    EVENTLOG_RECORD(recordModuleFoundEntry_id_c_t_pid_n_cm_e_ei, module->getId(), module->getClassName(), module->getNedTypeName(), parentModule ? parentModule->getId() : -1, module->getFullName(), isCompoundModule, mit->second.eventNumber, mit->second.entryIndex);
     entryIndex++;
     for (cModule::GateIterator it(module); !it.end(); it++) {
         cGate *gate = *it;
         std::map<cGate *, EventLogEntryReference>::iterator git = gateToGateCreatedEntryReferenceMap.find(gate);
-        EventLogWriter::recordGateFoundEntry_m_g_n_i_o_e_ei(feventlog, gate->getOwnerModule()->getId(), gate->getId(), gate->getName(), gate->isVector() ? gate->getIndex() : -1, gate->getType() == cGate::OUTPUT, git->second.eventNumber, git->second.entryIndex);
+        EVENTLOG_RECORD(recordGateFoundEntry_m_g_n_i_o_e_ei, gate->getOwnerModule()->getId(), gate->getId(), gate->getName(), gate->isVector() ? gate->getIndex() : -1, gate->getType() == cGate::OUTPUT, git->second.eventNumber, git->second.entryIndex);
         entryIndex++;
     }
     std::map<cModule *, EventLogEntryReference>::iterator dit = moduleToModuleDisplayStringChangedEntryReferenceMap.find(module);
-    EventLogWriter::recordModuleDisplayStringFoundEntry_id_d_e_ei(feventlog, module->getId(), module->getDisplayString().str(), dit->second.eventNumber, dit->second.entryIndex);
+    EVENTLOG_RECORD(recordModuleDisplayStringFoundEntry_id_d_e_ei, module->getId(), module->getDisplayString().str(), dit->second.eventNumber, dit->second.entryIndex);
     entryIndex++;
     for (cModule::SubmoduleIterator it(module); !it.end(); it++)
         recordModules(*it);
@@ -967,12 +1034,12 @@ void EventlogFileManager::recordConnections(cModule *module)
         if (srcgate->getNextGate()) {
             cGate *destgate = srcgate->getNextGate();
             std::map<cGate *, EventLogEntryReference>::iterator cit = channelToConnectionCreatedEntryReferenceMap.find(srcgate);
-            EventLogWriter::recordConnectionFoundEntry_sm_sg_dm_dg_e_ei(feventlog, srcgate->getOwnerModule()->getId(), srcgate->getId(), destgate->getOwnerModule()->getId(), destgate->getId(), cit->second.eventNumber, cit->second.entryIndex);
+            EVENTLOG_RECORD(recordConnectionFoundEntry_sm_sg_dm_dg_e_ei, srcgate->getOwnerModule()->getId(), srcgate->getId(), destgate->getOwnerModule()->getId(), destgate->getId(), cit->second.eventNumber, cit->second.entryIndex);
             entryIndex++;
         }
         if (channel) {
             std::map<cGate *, EventLogEntryReference>::iterator dit = channelToConnectionDisplayStringChangedEntryReferenceMap.find(srcgate);
-            EventLogWriter::recordConnectionDisplayStringFoundEntry_sm_sg_d_e_ei(feventlog, srcgate->getOwnerModule()->getId(), srcgate->getId(), channel->getDisplayString().str(), dit->second.eventNumber, dit->second.entryIndex);
+            EVENTLOG_RECORD(recordConnectionDisplayStringFoundEntry_sm_sg_d_e_ei, srcgate->getOwnerModule()->getId(), srcgate->getId(), channel->getDisplayString().str(), dit->second.eventNumber, dit->second.entryIndex);
             entryIndex++;
         }
     }
@@ -1009,7 +1076,7 @@ void EventlogFileManager::recordMessage(cMessage *msg)
     bool isScheduled = msg->isScheduled();
     bool isPacket = msg->isPacket();
     cPacket *pkt = isPacket ? (cPacket *)msg : nullptr;
-    EventLogWriter::recordMessageFoundEntry_id_tid_eid_etid_c_n_k_p_l_er_m_sm_sg_st_am_ag_at_d_pe(feventlog,
+    EVENTLOG_RECORD(recordMessageFoundEntry_id_tid_eid_etid_c_n_k_p_l_er_m_sm_sg_st_am_ag_at_d_pe,
         msg->getId(), msg->getTreeId(), isPacket ? pkt->getEncapsulationId() : msg->getId(), isPacket ? pkt->getEncapsulationTreeId() : msg->getTreeId(),
         msg->getClassName(), msg->getFullName(),
         msg->getKind(), msg->getSchedulingPriority(), isPacket ? pkt->getBitLength() : 0, isPacket ? pkt->hasBitError() : false,
@@ -1024,21 +1091,21 @@ void EventlogFileManager::recordMessage(cMessage *msg)
 void EventlogFileManager::recordIndex()
 {
     FileLockAcquirer fileLockAcquirer(fileLock, FILE_LOCK_EXCLUSIVE);
-    fprintf(feventlog, "\n");
-    file_offset_t indexFileOffset = toVirtualFileOffset(opp_ftell(feventlog));
-    EventLogWriter::recordIndexEntry_f_i_s_e_t(feventlog, indexFileOffset, previousIndexFileOffset, previousSnapshotFileOffset, eventNumber, simulationTime);
+    recordEmptyLine();
+    file_offset_t indexFileOffset = toVirtualFileOffset(getFileOffset());
+    EVENTLOG_RECORD(recordIndexEntry_f_i_s_e_t, indexFileOffset, previousIndexFileOffset, previousSnapshotFileOffset, eventNumber, simulationTime);
     entryIndex = 0;
     for (std::map<eventnumber_t, std::vector<EventLogEntryRange> >::iterator it = eventNumberToRemovedIndexEventLogEntryRanges.begin(); it != eventNumberToRemovedIndexEventLogEntryRanges.end(); it++) {
         std::vector<EventLogEntryRange> &ranges = it->second;
         for (std::vector<EventLogEntryRange>::iterator jt = ranges.begin(); jt != ranges.end(); jt++) {
-            EventLogWriter::recordReferenceRemovedEntry_e_b_e(feventlog, jt->eventNumber, jt->beginEntryIndex, jt->endEntryIndex);
+            EVENTLOG_RECORD(recordReferenceRemovedEntry_e_b_e, jt->eventNumber, jt->beginEntryIndex, jt->endEntryIndex);
             entryIndex++;
         }
     }
     for (std::map<eventnumber_t, std::vector<EventLogEntryRange> >::iterator it = eventNumberToAddedIndexEventLogEntryRanges.begin(); it != eventNumberToAddedIndexEventLogEntryRanges.end(); it++) {
         std::vector<EventLogEntryRange> &ranges = it->second;
         for (std::vector<EventLogEntryRange>::iterator jt = ranges.begin(); jt != ranges.end(); jt++) {
-            EventLogWriter::recordReferenceAddedEntry_e_b_e(feventlog, jt->eventNumber, jt->beginEntryIndex, jt->endEntryIndex);
+            EVENTLOG_RECORD(recordReferenceAddedEntry_e_b_e, jt->eventNumber, jt->beginEntryIndex, jt->endEntryIndex);
             entryIndex++;
         }
     }
@@ -1046,7 +1113,7 @@ void EventlogFileManager::recordIndex()
     eventNumberToRemovedIndexEventLogEntryRanges.clear();
     previousIndexFileOffset = indexFileOffset;
     lastChunk = INDEX;
-    fflush(feventlog);
+    flushFile();
 }
 
 }  // namespace envir
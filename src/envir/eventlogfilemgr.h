@@ -38,10 +38,14 @@ class cSimulation;
 
 namespace envir {
 
+class BinaryEventLogWriter;
+
 /**
  * Responsible for writing the eventlog file. The file format is line oriented,
  * each line contains exactly one eventlog entry. Snapshots and index entries
  * are written periodically to be able to read large eventlog files efficiently.
+ * Optionally, the same entries are written in a compact binary encoding
+ * (see BinaryEventLogWriter).
  */
 class ENVIR_API EventlogFileManager : public cIEventlogManager
 {
@@ -102,6 +106,7 @@ class ENVIR_API EventlogFileManager : public cIEventlogManager
 
     // configuration that does not change over time
     bool recordEventLog = false;  // value of the CFGID_RECORD_EVENTLOG config option
+    bool isBinaryFormat = false;  // value of the CFGID_EVENTLOG_FILE_FORMAT config option
     int64_t maxSize = -1;
     int64_t minTruncatedSize = -1;
     int64_t snapshotFrequency = -1;
@@ -110,6 +115,7 @@ class ENVIR_API EventlogFileManager : public cIEventlogManager
 
     // internal state
     FILE *feventlog = nullptr;
+    BinaryEventLogWriter *binaryWriter = nullptr;  // only in binary format
     common::FileLock *fileLock = nullptr;
     Intervals *recordingIntervals = nullptr;
 
@@ -272,6 +278,9 @@ class ENVIR_API EventlogFileManager : public cIEventlogManager
 
   private:
     void clearInternalState();
+    void recordEmptyLine();
+    file_offset_t getFileOffset();
+    void flushFile();
 
     /** @name Record functions */
     //@{
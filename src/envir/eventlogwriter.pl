@@ -157,6 +157,8 @@ print H
 namespace omnetpp {
 namespace envir {
 
+class BinaryEventLogWriter;
+
 class EventLogWriter
 {
   public:
@@ -165,8 +167,16 @@ class EventLogWriter
 
 foreach $class (@classes)
 {
-   print H "    static void " . makeMethodDecl($class,0) . ";\n";
-   print H "    static void " . makeMethodDecl($class,1) . ";\n" if (getEffectiveHasOpt($class));
+   print H "    static void " . makeMethodDecl($class,0,"FILE *f") . ";\n";
+   print H "    static void " . makeMethodDecl($class,1,"FILE *f") . ";\n" if (getEffectiveHasOpt($class));
+}
+
+print H "\n    // binary eventlog format\n";
+foreach $class (@classes)
+{
+   next if ($class->{CODE} eq "abstract");
+   print H "    static void " . makeMethodDecl($class,0,"BinaryEventLogWriter *w") . ";\n";
+   print H "    static void " . makeMethodDecl($class,1,"BinaryEventLogWriter *w") . ";\n" if (getEffectiveHasOpt($class));
 }
 
 print H "};
@@ -190,6 +200,7 @@ open(CC, ">eventlogwriter.cc");
 print CC makeFileBanner("eventlogwriter.cc");
 print CC "
 #include \"eventlogwriter.h\"
+#include \"binaryeventlogwriter.h\"
 #include \"common/stringutil.h\"
 #include \"omnetpp/cconfigoption.h\"
 #include \"omnetpp/csimulation.h\"
@@ -220,6 +231,15 @@ foreach $class (@classes)
    print CC makeMethodImpl($class,1) if (getEffectiveHasOpt($class));
 }
 
+$typeIndex = 0;
+foreach $class (@classes)
+{
+   next if ($class->{CODE} eq "abstract");
+   print CC makeBinaryEntryType($class,$typeIndex++);
+   print CC makeBinaryMethodImpl($class,0);
+   print CC makeBinaryMethodImpl($class,1) if (getEffectiveHasOpt($class));
+}
+
 print CC "
 } // namespace envir\n
 }  // namespace omnetpp
@@ -232,7 +252,7 @@ sub makeMethodImpl ()
    my $class = shift;
    my $wantOptFields = shift;
 
-   my $txt = "void EventLogWriter::" . makeMethodDecl($class,$wantOptFields) . "\n{\n";
+   my $txt = "void EventLogWriter::" . makeMethodDecl($class,$wantOptFields,"FILE *f") . "\n{\n";
    $txt .= "    ASSERT(f!=nullptr);\n";
 
    # class code goes into initial fprintf
@@ -267,10 +287,110 @@ sub makeMethodImpl ()
    $txt;
 }
 
+sub makeBinaryEntryType ()
+{
+   my $class = shift;
+   my $typeIndex = shift;
+   my @fields = getEffectiveFields($class);
+
+   my $txt = "";
+   my $fieldsVar = "nullptr";
+   if (@fields)
+   {
+      $fieldsVar = "$class->{NAME}Fields";
+      $txt .= "static const BinaryEventLogWriter::Field $fieldsVar\[] = {\n";
+      foreach $field (@fields)
+      {
+         my $isOptional = ($field->{DEFAULTVALUE} ne "") ? "true" : "false";
+         $txt .= "    {\"$field->{CODE}\", " . getBinaryFieldKind($field) . ", $isOptional},\n";
+      }
+      $txt .= "};\n";
+   }
+   my $hasOpt = getEffectiveHasOpt($class) ? "true" : "false";
+   my $numFields = scalar(@fields);
+   $txt .= "static const BinaryEventLogWriter::EntryType $class->{NAME}Type = {$typeIndex, \"$class->{CODE}\", $numFields, $fieldsVar, $hasOpt};\n\n";
+   $txt;
+}
+
+sub makeBinaryMethodImpl ()
+{
+   my $class = shift;
+   my $wantOptFields = shift;
+
+   my $txt = "void EventLogWriter::" . makeMethodDecl($class,$wantOptFields,"BinaryEventLogWriter *w") . "\n{\n";
+   $txt .= "    ASSERT(w!=nullptr);\n";
+
+   # compute the mask of present optional fields
+   my $mask = "0";
+   if ($wantOptFields)
+   {
+      $mask = "optionalFields";
+      $txt .= "    uint64_t optionalFields = 0;\n";
+      my $bit = 0;
+      foreach $field ( getEffectiveFields($class) )
+      {
+         next if ($field->{DEFAULTVALUE} eq "");
+         $txt .= "    if ($field->{NAME}!=$field->{DEFAULTVALUE})\n";
+         $txt .= "        optionalFields |= (uint64_t)1 << $bit;\n";
+         $bit++;
+      }
+   }
+   $txt .= "    w->beginEntry($class->{NAME}Type, $mask);\n";
+
+   my $bit = 0;
+   foreach $field ( getEffectiveFields($class) )
+   {
+      my $write = "w->" . getBinaryWriteMethod($field) . "($field->{NAME});\n";
+      if ($field->{DEFAULTVALUE} eq "")
+      {
+         $txt .= "    $write";
+      }
+      else
+      {
+         $txt .= "    if (optionalFields & ((uint64_t)1 << $bit))\n        $write" if ($wantOptFields);
+         $bit++;
+      }
+   }
+   $txt .= "    w->endEntry();\n";
+   $txt .= "}\n\n";
+   $txt;
+}
+
+sub getBinaryFieldKind ()
+{
+   my $field = shift;
+   my $type = $field->{TYPE};
+   my $name = $field->{NAME};
+
+   return "BINLOG_FIELD_STRING" if ($type eq "string");
+   return "BINLOG_FIELD_BOOL" if ($type eq "bool");
+   return "BINLOG_FIELD_SIMTIME" if ($type eq "simtime_t");
+   return "BINLOG_FIELD_EVENTNUMBER" if ($type eq "eventnumber_t");
+   return "BINLOG_FIELD_MESSAGEID" if ($type eq "msgid_t" || $type eq "txid_t");
+   return "BINLOG_FIELD_MODULEID" if ($type eq "int" && $name =~ /([mM]oduleId|ComponentId)$/);
+   return "BINLOG_FIELD_FILEOFFSET" if ($type eq "int64_t" && $name =~ /[fF]ileOffset$/);
+   return "BINLOG_FIELD_INT";
+}
+
+sub getBinaryWriteMethod ()
+{
+   my $kind = &getBinaryFieldKind(shift);
+
+   return "writeString" if ($kind eq "BINLOG_FIELD_STRING");
+   return "writeBool" if ($kind eq "BINLOG_FIELD_BOOL");
+   return "writeSimTime" if ($kind eq "BINLOG_FIELD_SIMTIME");
+   return "writeEventNumber" if ($kind eq "BINLOG_FIELD_EVENTNUMBER");
+   return "writeMessageId" if ($kind eq "BINLOG_FIELD_MESSAGEID");
+   return "writeModuleId" if ($kind eq "BINLOG_FIELD_MODULEID");
+   return "writeFileOffset" if ($kind eq "BINLOG_FIELD_FILEOFFSET");
+   return "writeInt";
+}
+
 sub makeMethodDecl ()
 {
    my $class = shift;
    my $wantOptFields = shift;
+   my $target = shift;
 
    my $txt = "record$class->{NAME}";
    foreach $field ( getEffectiveFields($class) )
@@ -278,7 +398,7 @@ sub makeMethodDecl ()
       my $code = ($field->{CODE} eq "#") ? "e" : $field->{CODE};
       $txt .= "_$code" if ($wantOptFields || $field->{DEFAULTVALUE} eq "");
    }
-   $txt .= "(FILE *f";
+   $txt .= "($target";
    foreach $field ( getEffectiveFields($class) )
    {
       $txt .= ", $field->{CTYPE} $field->{NAME}" if ($wantOptFields || $field->{DEFAULTVALUE} eq "");
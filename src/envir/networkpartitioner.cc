@@ -0,0 +1,357 @@
+//==========================================================================
+//  NETWORKPARTITIONER.CC - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include <numeric>
+#include "omnetpp/cevent.h"
+#include "omnetpp/cmessage.h"
+#include "omnetpp/cmodule.h"
+#include "omnetpp/cgate.h"
+#include "omnetpp/cchannel.h"
+#include "omnetpp/cpar.h"
+#include "omnetpp/csimulation.h"
+#include "omnetpp/cexception.h"
+#include "networkpartitioner.h"
+
+namespace omnetpp {
+namespace envir {
+
+NetworkPartitioner::NetworkPartitioner(cSimulation *simulation) : simulation(simulation)
+{
+}
+
+int NetworkPartitioner::getUnitOf(int moduleId)
+{
+    if (moduleId >= 0 && moduleId < (int)unitOfModule.size() && unitOfModule[moduleId] != -1)
+        return unitOfModule[moduleId];
+    cModule *module = simulation->getModule(moduleId);
+    return module ? getUnitOf(module) : -1;
+}
+
+int NetworkPartitioner::getUnitOf(cModule *module)
+{
+    int id = module->getId();
+    if (id >= (int)unitOfModule.size())
+        unitOfModule.resize(simulation->getLastComponentId() + 1, -1);
+    if (unitOfModule[id] == -1) {
+        cModule *parent = module->getParentModule();
+        if (parent == nullptr)
+            return -1;  // the system module is not part of any unit
+        unitOfModule[id] = getUnitOf(parent);
+    }
+    return unitOfModule[id];
+}
+
+simtime_t NetworkPartitioner::collectPathDelay(cGate *g)
+{
+    // like cLinkDelayLookahead, but walking forward from the path start gate
+    simtime_t sum = 0;
+    for (; g->getNextGate(); g = g->getNextGate()) {
+        cChannel *chan = g->getChannel();
+        if (chan && chan->hasPar("delay"))
+            sum += chan->par("delay").doubleValue();
+    }
+    return sum;
+}
+
+void NetworkPartitioner::buildGraph()
+{
+    cModule *systemModule = simulation->getSystemModule();
+    if (!systemModule)
+        throw cRuntimeError("NetworkPartitioner: No network set up");
+
+    units.clear();
+    edges.clear();
+    unitOfModule.assign(simulation->getLastComponentId() + 1, -1);
+    for (cModule::SubmoduleIterator it(systemModule); !it.end(); ++it) {
+        cModule *unit = *it;
+        unitOfModule[unit->getId()] = units.size();
+        units.push_back(unit);
+    }
+    numSimpleModules.assign(units.size(), 0);
+    numEvents.assign(units.size(), 0);
+    loadMeasured = false;
+
+    for (int id = 0; id <= simulation->getLastComponentId(); id++) {
+        cModule *module = simulation->getModule(id);
+        if (!module || !module->isSimple())
+            continue;
+        int unit = getUnitOf(module);
+        if (unit == -1)
+            continue;
+        numSimpleModules[unit]++;
+
+        for (cModule::GateIterator it(module); !it.end(); ++it) {
+            cGate *gate = *it;
+            if (gate->getType() != cGate::OUTPUT || !gate->getNextGate())
+                continue;
+            int otherUnit = getUnitOf(gate->getPathEndGate()->getOwnerModule());
+            if (otherUnit == -1 || otherUnit == unit)
+                continue;
+            Edge& edge = edges[std::make_pair(std::min(unit, otherUnit), std::max(unit, otherUnit))];
+            edge.minDelay = std::min(edge.minDelay, collectPathDelay(gate));
+            edge.numConnections++;
+        }
+    }
+}
+
+void NetworkPartitioner::recordEvent(cEvent *event)
+{
+    loadMeasured = true;
+    if (!event->isMessage())
+        return;
+    cMessage *msg = static_cast<cMessage *>(event);
+    int unit = getUnitOf(msg->getArrivalModuleId());
+    if (unit == -1)
+        return;
+    numEvents[unit]++;
+
+    if (msg->isSelfMessage())
+        return;
+    int senderUnit = getUnitOf(msg->getSenderModuleId());
+    if (senderUnit == -1 || senderUnit == unit)
+        return;
+    auto it = edges.find(std::make_pair(std::min(unit, senderUnit), std::max(unit, senderUnit)));
+    if (it != edges.end())  // note: sendDirect() between units has no edge, and it is not supported by parsim anyway
+        it->second.numMessages++;
+}
+
+static int findRoot(std::vector<int>& parent, int i)
+{
+    while (parent[i] != i)
+        i = parent[i] = parent[parent[i]];
+    return i;
+}
+
+bool NetworkPartitioner::assignGroups(const std::vector<int>& groupOfUnit, int numGroups, double maxLoad)
+{
+    const std::vector<double>& weights = getUnitWeights();
+    std::vector<double> groupWeights(numGroups, 0);
+    for (int i = 0; i < (int)units.size(); i++)
+        groupWeights[groupOfUnit[i]] += weights[i];
+
+    // longest processing time first; ties are broken by the number of groups,
+    // so that every partition gets at least one group
+    std::vector<int> order(numGroups);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {return groupWeights[a] > groupWeights[b];});
+
+    std::vector<double> loads(numPartitions, 0);
+    std::vector<int> counts(numPartitions, 0);
+    std::vector<int> partitionOfGroup(numGroups);
+    for (int group : order) {
+        int best = 0;
+        for (int p = 1; p < numPartitions; p++)
+            if (loads[p] < loads[best] || (loads[p] == loads[best] && counts[p] < counts[best]))
+                best = p;
+        partitionOfGroup[group] = best;
+        loads[best] += groupWeights[group];
+        counts[best]++;
+    }
+
+    partitionOfUnit.resize(units.size());
+    for (int i = 0; i < (int)units.size(); i++)
+        partitionOfUnit[i] = partitionOfGroup[groupOfUnit[i]];
+    return *std::max_element(loads.begin(), loads.end()) <= maxLoad;
+}
+
+void NetworkPartitioner::refine(const std::vector<int>& groupOfUnit, int numGroups, double maxLoad)
+{
+    const std::vector<double>& weights = getUnitWeights();
+    std::vector<double> groupWeights(numGroups, 0);
+    std::vector<int> partitionOfGroup(numGroups);
+    for (int i = 0; i < (int)units.size(); i++) {
+        groupWeights[groupOfUnit[i]] += weights[i];
+        partitionOfGroup[groupOfUnit[i]] = partitionOfUnit[i];
+    }
+
+    std::vector<std::map<int,double>> neighbors(numGroups);  // group -> traffic to other groups
+    for (auto& entry : edges) {
+        int a = groupOfUnit[entry.first.first], b = groupOfUnit[entry.first.second];
+        if (a != b) {
+            double traffic = getEdgeTraffic(entry.second);
+            neighbors[a][b] += traffic;
+            neighbors[b][a] += traffic;
+        }
+    }
+
+    std::vector<double> loads(numPartitions, 0);
+    std::vector<int> counts(numPartitions, 0);
+    for (int g = 0; g < numGroups; g++) {
+        loads[partitionOfGroup[g]] += groupWeights[g];
+        counts[partitionOfGroup[g]]++;
+    }
+
+    // greedy moves of single groups, as long as they decrease the cut traffic
+    const int maxPasses = 10;
+    std::vector<double> trafficTo(numPartitions);
+    for (int pass = 0; pass < maxPasses; pass++) {
+        bool improved = false;
+        for (int g = 0; g < numGroups; g++) {
+            int from = partitionOfGroup[g];
+            if (counts[from] == 1)
+                continue;
+            std::fill(trafficTo.begin(), trafficTo.end(), 0.0);
+            for (auto& neighbor : neighbors[g])
+                trafficTo[partitionOfGroup[neighbor.first]] += neighbor.second;
+            int best = from;
+            for (int p = 0; p < numPartitions; p++)
+                if (trafficTo[p] > trafficTo[best] && loads[p] + groupWeights[g] <= maxLoad)
+                    best = p;
+            if (best != from) {
+                partitionOfGroup[g] = best;
+                loads[from] -= groupWeights[g];
+                loads[best] += groupWeights[g];
+                counts[from]--;
+                counts[best]++;
+                improved = true;
+            }
+        }
+        if (!improved)
+            break;
+    }
+
+    for (int i = 0; i < (int)units.size(); i++)
+        partitionOfUnit[i] = partitionOfGroup[groupOfUnit[i]];
+}
+
+void NetworkPartitioner::partition(int numPartitions, double imbalanceTolerance)
+{
+    if (numPartitions < 1)
+        throw cRuntimeError("NetworkPartitioner: Invalid number of partitions %d", numPartitions);
+    if ((int)units.size() < numPartitions)
+        throw cRuntimeError("NetworkPartitioner: Cannot split network into %d partitions, it only has %d submodules", numPartitions, (int)units.size());
+    this->numPartitions = numPartitions;
+
+    const std::vector<double>& weights = getUnitWeights();
+    double totalWeight = std::accumulate(weights.begin(), weights.end(), 0.0);
+    double maxLoad = (1 + imbalanceTolerance) * totalWeight / numPartitions;
+
+    // candidate lookaheads: the positive link delays, and "infinity" (no cut edges)
+    std::vector<simtime_t> thresholds;
+    for (auto& entry : edges)
+        if (entry.second.minDelay > SIMTIME_ZERO)
+            thresholds.push_back(entry.second.minDelay);
+    thresholds.push_back(SIMTIME_MAX);
+    std::sort(thresholds.begin(), thresholds.end());
+    thresholds.erase(std::unique(thresholds.begin(), thresholds.end()), thresholds.end());
+
+    // groups units connected by edges shorter than the threshold; returns the number of groups
+    std::vector<int> groupOfUnit(units.size());
+    auto contract = [&](simtime_t threshold) {
+        std::vector<int> parent(units.size());
+        std::iota(parent.begin(), parent.end(), 0);
+        for (auto& entry : edges)
+            if (entry.second.minDelay < threshold)
+                parent[findRoot(parent, entry.first.first)] = findRoot(parent, entry.first.second);
+        std::vector<int> groupOfRoot(units.size(), -1);
+        int numGroups = 0;
+        for (int i = 0; i < (int)units.size(); i++) {
+            int& group = groupOfRoot[findRoot(parent, i)];
+            if (group == -1)
+                group = numGroups++;
+            groupOfUnit[i] = group;
+        }
+        return numGroups;
+    };
+    auto isFeasible = [&](int index) {
+        int numGroups = contract(thresholds[index]);
+        return numGroups >= numPartitions && assignGroups(groupOfUnit, numGroups, maxLoad);
+    };
+
+    // binary search for the largest feasible threshold: a larger threshold
+    // contracts more edges, which makes the groups fewer and larger
+    int lo = 0, hi = thresholds.size() - 1;
+    if (!isFeasible(lo)) {
+        // balance cannot be achieved, only keep zero-delay links inside partitions
+        int numGroups = contract(thresholds[0]);
+        if (numGroups < numPartitions)
+            throw cRuntimeError("NetworkPartitioner: Cannot split network into %d partitions, "
+                                "submodules only form %d groups connected with nonzero delay links", numPartitions, numGroups);
+        assignGroups(groupOfUnit, numGroups, maxLoad);
+        std::vector<double> loads(numPartitions, 0);
+        for (int i = 0; i < (int)units.size(); i++)
+            loads[partitionOfUnit[i]] += weights[i];
+        maxLoad = *std::max_element(loads.begin(), loads.end());
+    }
+    else {
+        while (lo < hi) {
+            int mid = (lo + hi + 1) / 2;
+            if (isFeasible(mid))
+                lo = mid;
+            else
+                hi = mid - 1;
+        }
+        isFeasible(lo);  // recompute the assignment for the chosen threshold
+    }
+    refine(groupOfUnit, contract(thresholds[lo]), maxLoad);
+
+    minLookahead = SIMTIME_MAX;
+    for (auto& entry : edges)
+        if (partitionOfUnit[entry.first.first] != partitionOfUnit[entry.first.second])
+            minLookahead = std::min(minLookahead, entry.second.minDelay);
+}
+
+void NetworkPartitioner::print(std::ostream& out)
+{
+    const std::vector<double>& weights = getUnitWeights();
+    std::vector<double> loads(numPartitions, 0);
+    std::vector<int> counts(numPartitions, 0);
+    for (int i = 0; i < (int)units.size(); i++) {
+        loads[partitionOfUnit[i]] += weights[i];
+        counts[partitionOfUnit[i]]++;
+    }
+    int numCutConnections = 0;
+    int64_t numCutMessages = 0;
+    for (auto& entry : edges) {
+        if (partitionOfUnit[entry.first.first] != partitionOfUnit[entry.first.second]) {
+            numCutConnections += entry.second.numConnections;
+            numCutMessages += entry.second.numMessages;
+        }
+    }
+
+    out << "# Partitioning of network " << simulation->getSystemModule()->getFullName() << " into " << numPartitions << " partitions\n";
+    out << "# Minimum lookahead: ";
+    if (minLookahead == SIMTIME_MAX)
+        out << "unlimited (partitions are not connected)\n";
+    else
+        out << minLookahead << "s\n";
+    out << "# Connections between partitions: " << numCutConnections;
+    if (loadMeasured)
+        out << ", messages between partitions: " << numCutMessages;
+    out << "\n";
+    for (int p = 0; p < numPartitions; p++)
+        out << "# Partition " << p << ": " << counts[p] << " submodules, " << loads[p] << (loadMeasured ? " events" : " simple modules") << "\n";
+    for (int i = 0; i < (int)units.size(); i++)
+        out << units[i]->getFullPath() << ".partition-id = " << partitionOfUnit[i] << "\n";
+}
+
+void LoadMeasuringEventLoopRunner::runEventLoop()
+{
+    while (true) {
+        cEvent *event = simulation->takeNextEvent();
+        if (!event)
+            throw cTerminationException("Scheduler interrupted while waiting");
+
+        partitioner->recordEvent(event);
+        simulation->executeEvent(event);
+
+        if (sigintReceived)
+            throw cTerminationException("SIGINT or SIGTERM received, exiting");
+    }
+}
+
+}  // namespace envir
+}  // namespace omnetpp
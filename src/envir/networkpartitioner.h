@@ -0,0 +1,144 @@
+//==========================================================================
+//  NETWORKPARTITIONER.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_ENVIR_NETWORKPARTITIONER_H
+#define __OMNETPP_ENVIR_NETWORKPARTITIONER_H
+
+#include <map>
+#include <ostream>
+#include <vector>
+#include "omnetpp/ceventlooprunner.h"
+#include "omnetpp/simtime_t.h"
+#include "envirdefs.h"
+
+namespace omnetpp {
+
+class cModule;
+class cGate;
+class cEvent;
+class cSimulation;
+
+namespace envir {
+
+/**
+ * Computes a partitioning of a network for parallel simulation, and prints
+ * it as `partition-id` lines ready to be included in an ini file.
+ *
+ * The units of partitioning are the submodules of the system module. The
+ * graph nodes are the units, weighted by the number of simple modules they
+ * contain or by their measured event counts (see LoadMeasuringEventLoopRunner).
+ * The edges are the connections between simple modules in different units,
+ * labeled with the delay of the connection path (which gives the lookahead if
+ * the edge is cut) and with the number of connections or the measured number
+ * of messages (which is the traffic across the partitions if the edge is cut).
+ *
+ * The partitioning maximizes the minimum lookahead, i.e. the smallest delay of
+ * the cut edges, subject to the partitions being balanced within the given
+ * tolerance. Edges with a smaller delay than the chosen lookahead are
+ * contracted, and the resulting groups of units are assigned to partitions
+ * with the longest-processing-time-first heuristic. Then groups are moved
+ * between partitions as long as that decreases the cut traffic without
+ * violating the balance. Zero-delay connections are never cut.
+ */
+class ENVIR_API NetworkPartitioner
+{
+  public:
+    struct Edge {
+        simtime_t minDelay = SIMTIME_MAX;  // smallest path delay of the connections
+        int numConnections = 0;
+        int64_t numMessages = 0;  // measured, in both directions
+    };
+
+  protected:
+    cSimulation *simulation;
+    std::vector<cModule *> units;  // submodules of the system module
+    std::vector<int> unitOfModule; // indexed by module ID, -1 for none; built lazily
+    std::vector<double> numSimpleModules;
+    std::vector<double> numEvents;
+    std::map<std::pair<int,int>,Edge> edges;  // key: unit indices, first < second
+    bool loadMeasured = false;
+
+    // result
+    int numPartitions = 0;
+    std::vector<int> partitionOfUnit;
+    simtime_t minLookahead;
+
+  protected:
+    int getUnitOf(cModule *module);
+    int getUnitOf(int moduleId);
+    static simtime_t collectPathDelay(cGate *outputGate);
+    const std::vector<double>& getUnitWeights() const {return loadMeasured ? numEvents : numSimpleModules;}
+    double getEdgeTraffic(const Edge& edge) const {return loadMeasured ? edge.numMessages : edge.numConnections;}
+    bool assignGroups(const std::vector<int>& groupOfUnit, int numGroups, double maxLoad);
+    void refine(const std::vector<int>& groupOfUnit, int numGroups, double maxLoad);
+
+  public:
+    /**
+     * The network must already be set up in the simulation, without
+     * parallel simulation.
+     */
+    NetworkPartitioner(cSimulation *simulation);
+    virtual ~NetworkPartitioner() {}
+
+    /**
+     * Collects the units and the connections between them.
+     */
+    virtual void buildGraph();
+
+    /**
+     * Records the given event for the load measurement: an event in the
+     * target module's unit, and a message between the sender and arrival
+     * units if they are different. Call before the event is executed.
+     */
+    virtual void recordEvent(cEvent *event);
+
+    /**
+     * Computes the partitioning. The load of the largest partition may exceed
+     * the average by the given fraction (e.g. 0.1 for 10%). Throws an error if
+     * the network cannot be split into the given number of partitions.
+     */
+    virtual void partition(int numPartitions, double imbalanceTolerance);
+
+    /**
+     * Prints the result as ini file lines, preceded by a summary in comments.
+     */
+    virtual void print(std::ostream& out);
+
+    int getNumUnits() const {return units.size();}
+    int getPartitionOf(int unit) const {return partitionOfUnit.at(unit);}
+    simtime_t getMinLookahead() const {return minLookahead;}
+};
+
+/**
+ * An event loop runner that executes the simulation, and records each event
+ * in a NetworkPartitioner for measuring the load.
+ */
+class ENVIR_API LoadMeasuringEventLoopRunner : public cIEventLoopRunner
+{
+  protected:
+    NetworkPartitioner *partitioner; // not owned
+    bool& sigintReceived;
+
+  public:
+    LoadMeasuringEventLoopRunner(cSimulation *simulation, NetworkPartitioner *partitioner, bool& sigintReceived) :
+        cIEventLoopRunner(simulation), partitioner(partitioner), sigintReceived(sigintReceived) {}
+    virtual void configure(cConfiguration *cfg) override {}
+    virtual void runEventLoop() override;
+};
+
+}  // namespace envir
+}  // namespace omnetpp
+
+#endif
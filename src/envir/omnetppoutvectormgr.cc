@@ -48,6 +48,7 @@ Register_GlobalConfigOption(CFGID_OUTPUT_VECTOR_FILE, "output-vector-file", CFG_
 Register_GlobalConfigOption(CFGID_OUTPUT_VECTOR_FILE_APPEND, "output-vector-file-append", CFG_BOOL, "false", "What to do when the output vector file already exists: append to it, or delete it and begin a new file (default). Note: `cIndexedFileOutputVectorManager` currently does not support appending.");
 Register_GlobalConfigOption(CFGID_OUTPUT_VECTOR_PRECISION, "output-vector-precision", CFG_INT, DEFAULT_OUTPUT_VECTOR_PRECISION, "The number of significant digits for recording data into the output vector file. The maximum value is ~15 (IEEE double precision). This setting has no effect on SQLite recording (it stores values as 8-byte IEEE floating point numbers), and for the \"time\" column which is represented as fixed-point numbers and always get recorded precisely.");
 Register_GlobalConfigOptionU(CFGID_OUTPUTVECTOR_MEMORY_LIMIT, "output-vectors-memory-limit", "B", DEFAULT_OUTPUT_VECTOR_MEMORY_LIMIT, "Total memory that can be used for buffering output vectors. Larger values produce less fragmented vector files (i.e. cause vector data to be grouped into larger chunks), and therefore allow more efficient processing later. There is also a per-vector limit, see `**.vector-buffer`.");
+Register_GlobalConfigOption(CFGID_OUTPUT_VECTOR_BACKGROUND_WRITING, "output-vector-background-writing", CFG_BOOL, "false", "Whether to write output vector data from a dedicated I/O thread. When enabled, full sample buffers are handed over to the I/O thread which formats and writes them while the simulation continues. The amount of data in transit is limited by `output-vectors-memory-limit`; when it is reached, recording waits for the I/O thread to catch up. Supported by the default text-based and by the SQLite output vector managers.");
 
 // per-vector options
 Register_PerObjectConfigOption(CFGID_VECTOR_RECORDING, "vector-recording", KIND_VECTOR, CFG_BOOL, "true", "Whether data written into an output vector should be recorded.\nUsage: `<module-full-path>.<vector-name>.vector-recording=true/false`. To control vector recording from a `@statistic`, use `<statistic-name>:vector for <vector-name>`. Example: `**.ping.roundTripTime:vector.vector-recording=false`");
@@ -71,6 +72,8 @@ void OmnetppOutputVectorManager::configure(cSimulation *simulation, cConfigurati
 
     size_t memoryLimit = (size_t) cfg->getAsDouble(CFGID_OUTPUTVECTOR_MEMORY_LIMIT);
     writer.setOverallMemoryLimit(memoryLimit);
+
+    writer.setBackgroundWriting(cfg->getAsBool(CFGID_OUTPUT_VECTOR_BACKGROUND_WRITING));
 }
 
 void OmnetppOutputVectorManager::startRun()
@@ -0,0 +1,215 @@
+//==========================================================================
+//  PATHPATTERNINDEX.CC - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cstring>
+#include "common/opp_ctype.h"
+#include "pathpatternindex.h"
+
+using namespace omnetpp::common;
+
+namespace omnetpp {
+namespace envir {
+
+// if s points to a "{n..m}" or "[n..m]" numeric range, returns the pointer to the
+// closing bracket (cf. PatternMatcher::parseNumRange()), otherwise nullptr
+static const char *findNumRangeEnd(const char *s, char closingChar)
+{
+    s++;
+    while (opp_isdigit(*s))
+        s++;
+    if (*s != '.' || *(s+1) != '.')
+        return nullptr;
+    s += 2;
+    while (opp_isdigit(*s))
+        s++;
+    return *s == closingChar ? s : nullptr;
+}
+
+bool PathPatternIndex::splitIntoSegments(const char *pattern, std::vector<std::string>& segments)
+{
+    segments.clear();
+    std::string segment;
+    for (const char *s = pattern; *s; s++) {
+        if (*s == '.') {
+            segments.push_back(segment);
+            segment.clear();
+        }
+        else if (*s == '\\') {
+            return false;  // escapes are rare, leave them to PatternMatcher
+        }
+        else if (*s == '{' || *s == '[') {
+            const char *end = findNumRangeEnd(s, *s == '{' ? '}' : ']');
+            if (end) {
+                if (*s == '[' && segment.empty())
+                    return false;  // would be parsed differently when standing at the start of a segment
+                segment.append(s, end-s+1);
+                s = end;
+            }
+            else if (*s == '{') {
+                // character set: must not be able to match a dot
+                end = strchr(s+1, '}');
+                if (!end || end == s+1 || *(s+1) == '^' || memchr(s+1, '.', end-s-1))
+                    return false;
+                segment.append(s, end-s+1);
+                s = end;
+            }
+            else {
+                segment += *s;  // literal '['
+            }
+        }
+        else {
+            segment += *s;
+        }
+    }
+    segments.push_back(segment);
+
+    // "**" is only accepted as a segment on its own
+    for (const std::string& segment : segments)
+        if (segment != "**" && segment.find("**") != std::string::npos)
+            return false;
+    return true;
+}
+
+int PathPatternIndex::getOrCreateSegmentPattern(const std::string& segment)
+{
+    auto it = segmentPatternIds.find(segment);
+    if (it != segmentPatternIds.end())
+        return it->second;
+
+    int id = segmentPatterns.size();
+    segmentPatternIds[segment] = id;
+    segmentPatterns.emplace_back();
+    SegmentPattern& segmentPattern = segmentPatterns.back();
+    if (PatternMatcher::containsWildcards(segment.c_str()))
+        segmentPattern.matcher.reset(new PatternMatcher(segment.c_str(), true, true, true));
+    else
+        segmentPattern.literal = segment;
+    return id;
+}
+
+int PathPatternIndex::addPattern(const char *pattern)
+{
+    auto it = patternIds.find(pattern);
+    if (it != patternIds.end())
+        return it->second;
+
+    int id = patterns.size();
+    patternIds[pattern] = id;
+    patterns.emplace_back();
+
+    std::vector<std::string> segments;
+    if (!splitIntoSegments(pattern, segments))
+        patterns.back().fallback.reset(new PatternMatcher(pattern, true, true, true));
+    else {
+        initialStates.push_back(states.size());
+        for (const std::string& segment : segments)
+            states.push_back(State{id, segment == "**" ? ANYSEGMENTS : getOrCreateSegmentPattern(segment)});
+        states.push_back(State{id, FINAL});
+    }
+
+    // invalidate memoized states and results
+    path.clear();
+    levels.clear();
+    ++pathCounter;
+    return id;
+}
+
+void PathPatternIndex::step(const Level& from, Level& to)
+{
+    ++stepCounter;
+    to.states.clear();
+    const char *segment = to.segment.c_str();
+    auto addState = [this,&to](int stateIndex) {
+        State& state = states[stateIndex];
+        if (state.stamp != stepCounter) {
+            state.stamp = stepCounter;
+            to.states.push_back(stateIndex);
+        }
+    };
+    for (int stateIndex : from.states) {
+        int segmentId = states[stateIndex].segmentId;
+        if (segmentId == ANYSEGMENTS) {
+            addState(stateIndex);  // "**" may consume further segments
+            addState(stateIndex+1);
+        }
+        else if (segmentId != FINAL) {
+            const SegmentPattern& segmentPattern = segmentPatterns[segmentId];
+            if (segmentPattern.stamp != stepCounter) {
+                segmentPattern.stamp = stepCounter;
+                segmentPattern.result = segmentPattern.matcher ? segmentPattern.matcher->matches(segment) : segmentPattern.literal == to.segment;
+            }
+            if (segmentPattern.result)
+                addState(stateIndex+1);
+        }
+    }
+}
+
+void PathPatternIndex::setPath(const char *newPath)
+{
+    if (!levels.empty() && path == newPath)
+        return;
+
+    if (levels.empty()) {
+        levels.emplace_back();
+        levels[0].states = initialStates;
+    }
+
+    // keep the levels of the common prefix (segment-wise), recompute the rest
+    size_t depth = 0;
+    const char *s = newPath;
+    while (true) {
+        const char *dot = strchr(s, '.');
+        size_t len = dot ? dot - s : strlen(s);
+        depth++;
+        if (depth >= levels.size() || levels[depth].segment.compare(0, std::string::npos, s, len) != 0) {
+            levels.resize(depth+1);
+            levels[depth].segment.assign(s, len);
+            step(levels[depth-1], levels[depth]);
+        }
+        if (!dot)
+            break;
+        s = dot + 1;
+    }
+    levels.resize(depth+1);
+    path = newPath;
+
+    updateMatches();
+}
+
+void PathPatternIndex::updateMatches()
+{
+    ++pathCounter;
+    for (int stateIndex : levels.back().states) {
+        const State& state = states[stateIndex];
+        if (state.segmentId == FINAL) {
+            Pattern& pattern = patterns[state.patternId];
+            pattern.stamp = pathCounter;
+            pattern.result = true;
+        }
+    }
+}
+
+bool PathPatternIndex::matches(int patternId)
+{
+    Pattern& pattern = patterns[patternId];
+    if (pattern.stamp != pathCounter) {
+        pattern.stamp = pathCounter;
+        pattern.result = pattern.fallback ? pattern.fallback->matches(path.c_str()) : false;
+    }
+    return pattern.result;
+}
+
+}  // namespace envir
+}  // namespace omnetpp
@@ -0,0 +1,135 @@
+//==========================================================================
+//  PATHPATTERNINDEX.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_ENVIR_PATHPATTERNINDEX_H
+#define __OMNETPP_ENVIR_PATHPATTERNINDEX_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "common/patternmatcher.h"
+#include "envirdefs.h"
+
+namespace omnetpp {
+namespace envir {
+
+/**
+ * Matches a dotted path (e.g. a module full path) against a set of
+ * dottedpath-mode patterns (see PatternMatcher) at once.
+ *
+ * Most patterns are compiled into a sequence of segment patterns, where "**"
+ * standing alone as a segment matches one or more path segments, and the
+ * segments of all patterns together form a nondeterministic automaton that
+ * consumes the path one segment at a time. The set of active states is
+ * memoized for each prefix of the most recently set path, so setting the
+ * path of a sibling or child module only costs processing the segments that
+ * differ. This makes the cost of matching a path against all patterns
+ * proportional to the path length (and the number of live states), instead
+ * of the number of patterns. Each distinct segment pattern is evaluated at
+ * most once per segment.
+ *
+ * Patterns that cannot be decomposed into segments (e.g. "**" inside a
+ * segment as in "net.**foo", or sets that may match a dot) fall back to
+ * PatternMatcher, evaluated lazily and cached until the path changes.
+ *
+ * Usage: add the patterns with addPattern(), then call setPath() and query
+ * the individual patterns with matches().
+ */
+class ENVIR_API PathPatternIndex
+{
+  private:
+    typedef omnetpp::common::PatternMatcher PatternMatcher;
+
+    enum { ANYSEGMENTS = -1, FINAL = -2 };  // special values of State::segmentId
+
+    struct SegmentPattern {
+        std::string literal;  // if not a wildcard pattern
+        std::unique_ptr<PatternMatcher> matcher;  // if wildcard pattern
+        mutable unsigned stamp = 0;  // == stepCounter if 'result' is valid
+        mutable bool result = false;
+    };
+
+    struct State {
+        int patternId;
+        int segmentId;  // next segment pattern to match, or ANYSEGMENTS/FINAL
+        unsigned stamp = 0;  // used for deduplication in step()
+    };
+
+    struct Pattern {
+        std::unique_ptr<PatternMatcher> fallback;  // only if the pattern could not be compiled into segments
+        unsigned stamp = 0;  // == pathCounter if 'result' is valid
+        bool result = false;
+    };
+
+    struct Level {
+        std::string segment;  // the path segment consumed to get here (empty for the root)
+        std::vector<int> states;  // active states
+    };
+
+    std::map<std::string,int> patternIds;
+    std::vector<Pattern> patterns;
+    std::map<std::string,int> segmentPatternIds;
+    std::vector<SegmentPattern> segmentPatterns;
+    std::vector<State> states;
+    std::vector<int> initialStates;
+
+    std::string path;  // the current path
+    std::vector<Level> levels;  // levels[i]: after consuming the first i segments of 'path'
+    unsigned pathCounter = 0;
+    unsigned stepCounter = 0;
+
+  private:
+    static bool splitIntoSegments(const char *pattern, std::vector<std::string>& segments);
+    int getOrCreateSegmentPattern(const std::string& segment);
+    void step(const Level& from, Level& to);
+    void updateMatches();
+
+  public:
+    PathPatternIndex() {}
+    PathPatternIndex(const PathPatternIndex&) = delete;
+    PathPatternIndex& operator=(const PathPatternIndex&) = delete;
+
+    /**
+     * Adds a pattern (if not already added), and returns its ID.
+     */
+    int addPattern(const char *pattern);
+
+    /**
+     * Returns the number of distinct patterns added.
+     */
+    int getNumPatterns() const {return patterns.size();}
+
+    /**
+     * Sets the path that subsequent matches() calls refer to.
+     */
+    void setPath(const char *path);
+
+    /**
+     * Returns the path set via setPath().
+     */
+    const char *getPath() const {return path.c_str();}
+
+    /**
+     * Returns true if the given pattern matches the path set via setPath().
+     */
+    bool matches(int patternId);
+};
+
+}  // namespace envir
+}  // namespace omnetpp
+
+
+#endif
@@ -27,6 +27,10 @@
 #include "omnetpp/cproperty.h"
 #include "omnetpp/opp_string.h"
 #include "omnetpp/platdep/platmisc.h"
+#ifdef WITH_PARSIM
+#include "sim/parsim/cparsimpartition.h"
+#include "sim/parsim/csharedmemorycomm.h"
+#endif
 
 using namespace omnetpp::common;
 using namespace omnetpp::internal;
@@ -138,11 +142,22 @@ std::string ResultFileUtils::augmentFileName(const std::string& fname)
     bool parsim = cfg->getAsBool(CFGID_PARALLEL_SIMULATION, false);
     bool fnameAppendHost = cfg->getAsBool(CFGID_FNAME_APPEND_HOST, parsim);
 
-    if (!fnameAppendHost)
+    // partitions running as threads of the same process always need the partition ID,
+    // otherwise they would write the same files
+    int threadPartitionId = -1;
+#ifdef WITH_PARSIM
+    // note: the thread's partition ID is also known before the simulation is set up (for the Cmdenv output file)
+    threadPartitionId = cSharedMemoryCommunications::getThreadProcId();
+    cSimulation *simulation = cSimulation::getActiveSimulation();
+    cParsimPartition *partition = simulation ? simulation->getParsimPartition() : nullptr;
+    if (threadPartitionId == -1 && partition && dynamic_cast<cSharedMemoryCommunications *>(partition->getCommunications()))
+        threadPartitionId = partition->getProcId();
+#endif
+
+    if (!fnameAppendHost && threadPartitionId == -1)
         return fname;
 
     // insert ".<hostname>.<pid>" if requested before file extension
-    // (note: parsimProcId cannot be appended because of initialization order)
     std::string result = fname;
     std::string extension = "";
     std::string::size_type index = fname.rfind('.');
@@ -151,12 +166,19 @@ std::string ResultFileUtils::augmentFileName(const std::string& fname)
         result = fname.substr(0,index);
     }
 
-    const char *hostname = opp_gethostname();
-    if (!hostname)
-        throw cRuntimeError("Cannot append hostname to file name '%s': no host name configured, and no HOST, HOSTNAME "
-                "or COMPUTERNAME (Windows) environment variable set", fname.c_str());
-    int pid = getpid();
-    return result + "." + hostname + "." + std::to_string(pid) + extension;
+    if (fnameAppendHost) {
+        const char *hostname = opp_gethostname();
+        if (!hostname)
+            throw cRuntimeError("Cannot append hostname to file name '%s': no host name configured, and no HOST, HOSTNAME "
+                    "or COMPUTERNAME (Windows) environment variable set", fname.c_str());
+        int pid = getpid();
+        result += std::string(".") + hostname + "." + std::to_string(pid);
+    }
+
+    if (threadPartitionId != -1)
+        result += "." + std::to_string(threadPartitionId);
+
+    return result + extension;
 }
 
 
@@ -44,6 +44,7 @@ Register_Class(SqliteOutputVectorManager);
 extern omnetpp::cConfigOption *CFGID_OUTPUT_VECTOR_FILE_APPEND;
 extern omnetpp::cConfigOption *CFGID_OUTPUT_VECTOR_FILE;
 extern omnetpp::cConfigOption *CFGID_OUTPUTVECTOR_MEMORY_LIMIT;
+extern omnetpp::cConfigOption *CFGID_OUTPUT_VECTOR_BACKGROUND_WRITING;
 
 // per-vector options
 extern omnetpp::cConfigOption *CFGID_VECTOR_RECORDING;
@@ -66,6 +67,8 @@ void SqliteOutputVectorManager::configure(cSimulation *simulation, cConfiguratio
     size_t memoryLimit = (size_t) cfg->getAsDouble(CFGID_OUTPUTVECTOR_MEMORY_LIMIT);
     writer.setOverallMemoryLimit(memoryLimit);
 
+    writer.setBackgroundWriting(cfg->getAsBool(CFGID_OUTPUT_VECTOR_BACKGROUND_WRITING));
+
     std::string indexModeStr = cfg->getAsCustom(CFGID_OUTPUT_VECTOR_DB_INDEXING);
     if (indexModeStr == "skip")
         indexingMode = INDEX_NONE;
@@ -0,0 +1,568 @@
+//=========================================================================
+//  BINARYEVENTLOGDECODER.CC - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cinttypes>
+#include <map>
+#include <vector>
+#include "common/binaryeventlogformat.h"
+#include "common/exception.h"
+#include "common/stringutil.h"
+#include "omnetpp/platdep/platmisc.h"
+#include "eventoffsettable.h"
+#include "binaryeventlogdecoder.h"
+
+using namespace omnetpp::common;
+
+namespace omnetpp {
+namespace eventlog {
+
+namespace {
+
+struct EndOfInput {};  // thrown when the input ends in the middle of a record
+
+class Input
+{
+    private:
+        FILE *f;
+        std::vector<char> buffer;
+        size_t pos = 0;
+        size_t end = 0;
+        file_offset_t bufferOffset = 0;  // file offset of buffer[0]
+
+    private:
+        bool fill() {
+            bufferOffset += end;
+            pos = 0;
+            end = fread(buffer.data(), 1, buffer.size(), f);
+            if (ferror(f))
+                throw opp_runtime_error("Read error");
+            return end != 0;
+        }
+
+    public:
+        Input(FILE *f, size_t bufferSize) : f(f), buffer(bufferSize) {}
+        void seek(file_offset_t offset) {
+            opp_fseek(f, offset, SEEK_SET);
+            if (ferror(f))
+                throw opp_runtime_error("Cannot seek");
+            bufferOffset = offset;
+            pos = end = 0;
+        }
+        bool atEnd() {return pos == end && !fill();}
+        file_offset_t getOffset() const {return bufferOffset + pos;}
+        unsigned char readByte() {
+            if (pos == end && !fill())
+                throw EndOfInput();
+            return buffer[pos++];
+        }
+        uint64_t readVarint() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                unsigned char byte = readByte();
+                value |= (uint64_t)(byte & 0x7f) << shift;
+                if (!(byte & 0x80))
+                    return value;
+            }
+            throw opp_runtime_error("Malformed varint");
+        }
+        int64_t readZigzagVarint() {return zigzagDecode(readVarint());}
+        void readBytes(std::string& s, uint64_t length) {
+            s.clear();
+            while (length > 0) {
+                if (pos == end && !fill())
+                    throw EndOfInput();
+                size_t n = std::min((uint64_t)(end - pos), length);
+                s.append(buffer.data() + pos, n);
+                pos += n;
+                length -= n;
+            }
+        }
+        void readString(std::string& s) {readBytes(s, readVarint());}
+};
+
+struct FieldType {
+    std::string code;
+    int kind;
+    bool isOptional;
+};
+
+struct EntryType {
+    std::string code;
+    std::vector<FieldType> fields;
+    bool hasOptionalFields = false;
+};
+
+}  // namespace
+
+// Decodes records into text lines. The tables (entry type declarations,
+// strings, translated file offsets) are filled while indexing, i.e. when
+// the file is decoded sequentially for the first time; afterwards, decoding
+// can start at any checkpoint, and only looks up the tables.
+class BinaryEventLogReader::Decoder
+{
+    private:
+        Input in;
+        bool isIndexing = false;
+        int simtimeScaleExp = 0;
+        Position position;
+        std::vector<int> entryTypes;  // index into declarations, -1 for undeclared
+        std::vector<EntryType> declarations;
+        std::map<file_offset_t, int> declarationAtOffset;  // binary offset of declaration record -> index
+        std::vector<std::string> strings;
+        std::map<file_offset_t, file_offset_t> offsetMap;  // binary -> text offsets of snapshot and index entries
+        std::string str;  // temporary
+
+        // the event number and simulation time of the last record, if it was an event entry
+        bool isEventEntry = false;
+        int64_t eventNumber = 0;
+        int64_t eventSimTime = 0;
+
+    private:
+        int64_t readDelta(int64_t& last) {last = (int64_t)((uint64_t)last + (uint64_t)in.readZigzagVarint()); return last;}
+        static void appendInt(std::string& line, int64_t value) {char buf[32]; snprintf(buf, sizeof(buf), "%" PRId64, value); line += buf;}
+        void readEntryType(file_offset_t declarationOffset);
+        void readEntry(int typeIndex, std::string& line);
+        void readField(const FieldType& field, std::string& line);
+
+    public:
+        Decoder(FILE *f) : in(f, 64 * 1024) {}
+        void readHeader();
+        void setIndexing(bool value) {isIndexing = value;}
+        bool readRecord(std::string& line);
+        void truncateTables(size_t numDeclarations, size_t numStrings);
+        size_t getNumDeclarations() const {return declarations.size();}
+        size_t getNumStrings() const {return strings.size();}
+        const Position& getPosition() const {return position;}
+        void setPosition(const Position& position) {this->position = position; in.seek(position.binaryOffset);}
+        Checkpoint getCheckpoint() const {return Checkpoint{position, entryTypes};}
+        void setCheckpoint(const Checkpoint& checkpoint) {setPosition(checkpoint.position); entryTypes = checkpoint.entryTypes;}
+        bool isAtCheckpoint() const {return !position.isAfterTypeDeclaration;}
+        bool wasEventEntry() const {return isEventEntry;}
+        eventnumber_t getEventNumber() const {return eventNumber;}
+        simtime_t getEventSimulationTime() const {return BigDecimal(eventSimTime, simtimeScaleExp);}
+};
+
+void BinaryEventLogReader::Decoder::readHeader()
+{
+    in.seek(0);
+    std::string magic;
+    in.readBytes(magic, 8);
+    if (magic != std::string(BINARY_EVENTLOG_FILE_MAGIC, 8))
+        throw opp_runtime_error("Not a binary eventlog file");
+    uint64_t version = in.readVarint();
+    if (version != BINARY_EVENTLOG_FILE_VERSION)
+        throw opp_runtime_error("Unsupported binary eventlog version %d", (int)version);
+    simtimeScaleExp = in.readZigzagVarint();
+    position = Position();
+    position.binaryOffset = in.getOffset();
+    entryTypes.clear();
+}
+
+void BinaryEventLogReader::Decoder::readEntryType(file_offset_t declarationOffset)
+{
+    uint64_t typeIndex = in.readVarint();
+    if (typeIndex > 10000)
+        throw opp_runtime_error("Entry type index out of range");
+    EntryType type;
+    in.readString(type.code);
+    uint64_t numFields = in.readVarint();
+    if (numFields > 64)
+        throw opp_runtime_error("Too many fields in entry type '%s'", type.code.c_str());
+    for (uint64_t i = 0; i < numFields; i++) {
+        FieldType field;
+        in.readString(field.code);
+        field.kind = in.readVarint();
+        field.isOptional = in.readVarint() != 0;
+        type.hasOptionalFields = type.hasOptionalFields || field.isOptional;
+        type.fields.push_back(field);
+    }
+
+    // note: the tables are only updated after the whole record has been read
+    int declarationIndex;
+    auto it = declarationAtOffset.find(declarationOffset);
+    if (it != declarationAtOffset.end())
+        declarationIndex = it->second;
+    else if (isIndexing) {
+        declarationIndex = declarations.size();
+        declarations.push_back(type);
+        declarationAtOffset[declarationOffset] = declarationIndex;
+    }
+    else
+        throw opp_runtime_error("Entry type declaration not found in index");
+    if (typeIndex >= entryTypes.size())
+        entryTypes.resize(typeIndex + 1, -1);
+    entryTypes[typeIndex] = declarationIndex;
+}
+
+void BinaryEventLogReader::Decoder::readField(const FieldType& field, std::string& line)
+{
+    line += ' ';
+    line += field.code;
+    line += ' ';
+    switch (field.kind) {
+        case BINLOG_FIELD_BOOL: line += in.readByte() ? '1' : '0'; break;
+        case BINLOG_FIELD_INT: appendInt(line, in.readZigzagVarint()); break;
+        case BINLOG_FIELD_MODULEID: appendInt(line, readDelta(position.lastModuleId)); break;
+        case BINLOG_FIELD_EVENTNUMBER: {
+            int64_t value = readDelta(position.lastEventNumber);
+            if (isEventEntry && field.code == "#")
+                eventNumber = value;
+            appendInt(line, value);
+            break;
+        }
+        case BINLOG_FIELD_MESSAGEID: appendInt(line, readDelta(position.lastMessageId)); break;
+        case BINLOG_FIELD_SIMTIME: {
+            int64_t value = readDelta(position.lastSimTime);
+            if (isEventEntry && field.code == "t")
+                eventSimTime = value;
+            line += BigDecimal(value, simtimeScaleExp).str();
+            break;
+        }
+        case BINLOG_FIELD_FILEOFFSET: {
+            // the entry's own offset, or a reference to an earlier snapshot or index entry
+            file_offset_t offset = in.readZigzagVarint();
+            if (offset == position.recordOffset) {
+                offsetMap[offset] = position.textOffset;
+                appendInt(line, position.textOffset);
+            }
+            else {
+                auto it = offsetMap.find(offset);
+                appendInt(line, it != offsetMap.end() ? it->second : offset);
+            }
+            break;
+        }
+        case BINLOG_FIELD_STRING: {
+            uint64_t tag = in.readVarint();
+            const char *s;
+            if (tag == BINLOG_STRING_NULL)
+                s = "";
+            else if (tag == BINLOG_STRING_INLINE || tag == BINLOG_STRING_NEW) {
+                in.readString(str);
+                if (tag == BINLOG_STRING_NEW && isIndexing)
+                    strings.push_back(str);
+                s = str.c_str();
+            }
+            else if (tag - BINLOG_STRING_FIRSTINDEX < strings.size())
+                s = strings[tag - BINLOG_STRING_FIRSTINDEX].c_str();
+            else
+                throw opp_runtime_error("String table index out of range");
+            if (opp_needsquotes(s))
+                line += opp_quotestr(s);
+            else
+                line += s;
+            break;
+        }
+        default:
+            throw opp_runtime_error("Unknown field kind %d", field.kind);
+    }
+}
+
+void BinaryEventLogReader::Decoder::readEntry(int typeIndex, std::string& line)
+{
+    if (typeIndex >= (int)entryTypes.size() || entryTypes[typeIndex] == -1)
+        throw opp_runtime_error("Undeclared entry type");
+    const EntryType& type = declarations[entryTypes[typeIndex]];
+    uint64_t optionalFieldMask = type.hasOptionalFields ? in.readVarint() : 0;
+    isEventEntry = type.code == "E";
+    line += type.code;
+    int optionalFieldIndex = 0;
+    for (const FieldType& field : type.fields) {
+        if (field.isOptional && !(optionalFieldMask & ((uint64_t)1 << optionalFieldIndex++)))
+            continue;
+        readField(field, line);
+    }
+    line += '\n';
+}
+
+bool BinaryEventLogReader::Decoder::readRecord(std::string& line)
+{
+    line.clear();
+    isEventEntry = false;
+    if (in.atEnd())
+        return false;
+    // the writer takes the offset of an entry before declaring its type
+    file_offset_t tagOffset = in.getOffset();
+    if (!position.isAfterTypeDeclaration)
+        position.recordOffset = tagOffset;
+    uint64_t tag = in.readVarint();
+    if (tag == BINLOG_EMPTYLINE)
+        line += '\n';
+    else if (tag == BINLOG_LOGLINE) {
+        line += "- ";
+        in.readString(str);
+        line += str;
+        in.readString(str);
+        line += str;
+        line += '\n';
+    }
+    else if (tag == BINLOG_ENTRYTYPE)
+        readEntryType(tagOffset);
+    else if (tag >= BINLOG_FIRSTENTRY && tag - BINLOG_FIRSTENTRY < entryTypes.size())
+        readEntry(tag - BINLOG_FIRSTENTRY, line);
+    else
+        throw opp_runtime_error("Unknown record tag %d", (int)tag);
+    position.isAfterTypeDeclaration = tag == BINLOG_ENTRYTYPE;
+    position.binaryOffset = in.getOffset();
+    position.textOffset += line.size();
+    return true;
+}
+
+void BinaryEventLogReader::Decoder::truncateTables(size_t numDeclarations, size_t numStrings)
+{
+    declarations.resize(numDeclarations);
+    for (auto it = declarationAtOffset.begin(); it != declarationAtOffset.end(); ) {
+        if (it->second >= (int)numDeclarations)
+            it = declarationAtOffset.erase(it);
+        else
+            ++it;
+    }
+    strings.resize(numStrings);
+}
+
+// *************************************************************************************************
+
+BinaryEventLogReader::BinaryEventLogReader(const char *fileName, size_t bufferSize) : FileReader(fileName, bufferSize)
+{
+}
+
+BinaryEventLogReader::~BinaryEventLogReader()
+{
+    delete decoder;
+    if (binaryFile)
+        fclose(binaryFile);
+}
+
+void BinaryEventLogReader::ensureBinaryFileOpen()
+{
+    if (!binaryFile) {
+        binaryFile = fopen(getFileName(), "rb");
+        if (!binaryFile)
+            throw opp_runtime_error("Cannot open file '%s'", getFileName());
+        decoder = new Decoder(binaryFile);
+    }
+}
+
+void BinaryEventLogReader::clearIndex()
+{
+    checkpoints.clear();
+    indexEnd = Checkpoint();
+    eventNumbers.clear();
+    simulationTimes.clear();
+    eventOffsets.clear();
+    blocks.clear();
+    // the decoder tables are rebuilt as well
+    delete decoder;
+    decoder = new Decoder(binaryFile);
+}
+
+void BinaryEventLogReader::updateIndex()
+{
+    file_offset_t lastBlockOffset = checkpoints.empty() ? 0 : checkpoints.back().position.textOffset;
+    try {
+        decoder->setIndexing(true);
+        if (checkpoints.empty()) {
+            decoder->readHeader();
+            checkpoints.push_back(decoder->getCheckpoint());
+        }
+        else
+            decoder->setCheckpoint(indexEnd);
+
+        std::string line;
+        Position lastComplete = decoder->getPosition();
+        while (true) {
+            size_t numDeclarations = decoder->getNumDeclarations();
+            size_t numStrings = decoder->getNumStrings();
+            try {
+                if (!decoder->readRecord(line))
+                    break;
+            }
+            catch (EndOfInput&) {
+                // incomplete last record, e.g. the simulation is still writing it or it crashed
+                decoder->truncateTables(numDeclarations, numStrings);
+                decoder->setPosition(lastComplete);
+                break;
+            }
+            if (decoder->wasEventEntry()) {
+                eventNumbers.push_back(decoder->getEventNumber());
+                simulationTimes.push_back(decoder->getEventSimulationTime());
+                eventOffsets.push_back(lastComplete.textOffset);
+            }
+            lastComplete = decoder->getPosition();
+            if (decoder->isAtCheckpoint() && lastComplete.textOffset - checkpoints.back().position.textOffset >= CHECKPOINT_INTERVAL)
+                checkpoints.push_back(decoder->getCheckpoint());
+        }
+        indexEnd = decoder->getCheckpoint();
+        decoder->setIndexing(false);
+    }
+    catch (EndOfInput&) {
+        throw opp_runtime_error("Cannot decode binary eventlog file '%s': File is truncated", getFileName());
+    }
+    catch (std::exception& e) {
+        throw opp_runtime_error("Cannot decode binary eventlog file '%s': %s", getFileName(), e.what());
+    }
+
+    // the last block may have grown
+    blocks.erase(std::remove_if(blocks.begin(), blocks.end(), [&] (const Block& block) {return block.offset >= lastBlockOffset;}), blocks.end());
+}
+
+void BinaryEventLogReader::decodeBlock(size_t checkpointIndex, std::string& text)
+{
+    file_offset_t endOffset = checkpointIndex + 1 < checkpoints.size() ? checkpoints[checkpointIndex + 1].position.textOffset : indexEnd.position.textOffset;
+    text.clear();
+    try {
+        decoder->setCheckpoint(checkpoints[checkpointIndex]);
+        std::string line;
+        while (decoder->getPosition().textOffset < endOffset) {
+            if (!decoder->readRecord(line))
+                throw opp_runtime_error("File is truncated");
+            text += line;
+        }
+    }
+    catch (EndOfInput&) {
+        throw opp_runtime_error("Cannot decode binary eventlog file '%s': File is truncated", getFileName());
+    }
+    catch (std::exception& e) {
+        throw opp_runtime_error("Cannot decode binary eventlog file '%s': %s", getFileName(), e.what());
+    }
+}
+
+const BinaryEventLogReader::Block& BinaryEventLogReader::getBlock(file_offset_t fileOffset)
+{
+    for (size_t i = 0; i < blocks.size(); i++) {
+        if (blocks[i].offset <= fileOffset && fileOffset < blocks[i].offset + (file_offset_t)blocks[i].text.size()) {
+            std::rotate(blocks.begin(), blocks.begin() + i, blocks.begin() + i + 1);
+            return blocks.front();
+        }
+    }
+
+    // the block starts at the last checkpoint at or before the offset
+    auto it = std::upper_bound(checkpoints.begin(), checkpoints.end(), fileOffset,
+            [] (file_offset_t offset, const Checkpoint& checkpoint) {return offset < checkpoint.position.textOffset;});
+    Block block;
+    block.offset = (it - 1)->position.textOffset;
+    decodeBlock(it - checkpoints.begin() - 1, block.text);
+    if (blocks.size() == MAX_CACHED_BLOCKS)
+        blocks.pop_back();
+    blocks.insert(blocks.begin(), std::move(block));
+    return blocks.front();
+}
+
+size_t BinaryEventLogReader::readFileData(file_offset_t fileOffset, char *dataPointer, size_t size)
+{
+    ensureBinaryFileOpen();
+    size_t bytesRead = 0;
+    while (bytesRead < size && fileOffset < indexEnd.position.textOffset) {
+        const Block& block = getBlock(fileOffset);
+        size_t n = std::min((file_offset_t)(size - bytesRead), block.offset + (file_offset_t)block.text.size() - fileOffset);
+        if (n == 0)
+            break;
+        memcpy(dataPointer + bytesRead, block.text.data() + (fileOffset - block.offset), n);
+        bytesRead += n;
+        fileOffset += n;
+    }
+    return bytesRead;
+}
+
+void BinaryEventLogReader::getFileInformation(int64_t& size, time_t& lastModificationTime)
+{
+    ensureBinaryFileOpen();
+    struct opp_stat_t s;
+    if (opp_fstat(fileno(binaryFile), &s) != 0)
+        throw opp_runtime_error("Cannot stat file '%s'", getFileName());
+    if (s.st_size != binaryFileSize || s.st_mtime != binaryModificationTime) {
+        // index what has been appended, or everything if the file has been overwritten with a shorter one
+        if (s.st_size < binaryFileSize)
+            clearIndex();
+        binaryFileSize = s.st_size;
+        binaryModificationTime = s.st_mtime;
+        updateIndex();
+    }
+    size = indexEnd.position.textOffset;
+    lastModificationTime = s.st_mtime;
+}
+
+EventOffsetTable *BinaryEventLogReader::createOffsetTable()
+{
+    getFileSize();  // builds the index if not yet built
+    EventOffsetTable *table = new EventOffsetTable();
+    table->fileSize = table->indexedSize = indexEnd.position.textOffset;
+    table->fileModificationTime = binaryModificationTime;
+    table->eventNumbers = eventNumbers;
+    table->simulationTimes = simulationTimes;
+    table->offsets = eventOffsets;
+    try {
+        table->checkOrder(getFileName());
+    }
+    catch (std::exception&) {
+        delete table;
+        throw;
+    }
+    return table;
+}
+
+// *************************************************************************************************
+
+bool BinaryEventLogDecoder::isBinaryEventLog(const char *fileName)
+{
+    FILE *f = fopen(fileName, "rb");
+    if (!f)
+        return false;
+    char magic[8];
+    bool result = fread(magic, 1, 8, f) == 8 && memcmp(magic, BINARY_EVENTLOG_FILE_MAGIC, 8) == 0;
+    fclose(f);
+    return result;
+}
+
+void BinaryEventLogDecoder::decode(const char *binaryFileName, const char *textFileName)
+{
+    BinaryEventLogReader reader(binaryFileName);
+    reader.setCheckFileForChanges(false);
+    FILE *out = fopen(textFileName, "wb");
+    if (!out)
+        throw opp_runtime_error("Cannot open file '%s' for write", textFileName);
+    try {
+        char *line;
+        while ((line = reader.getNextLineBufferPointer()) != nullptr)
+            if (fwrite(line, 1, reader.getCurrentLineLength(), out) != reader.getCurrentLineLength())
+                throw opp_runtime_error("Write error");
+        if (fclose(out) != 0)
+            throw opp_runtime_error("Write error");
+    }
+    catch (std::exception& e) {
+        fclose(out);
+        throw opp_runtime_error("Cannot decode binary eventlog file '%s': %s", binaryFileName, e.what());
+    }
+}
+
+FileReader *BinaryEventLogDecoder::createFileReader(const char *fileName)
+{
+    if (isBinaryEventLog(fileName))
+        return new BinaryEventLogReader(fileName);
+    else
+        return new FileReader(fileName);
+}
+
+FileReader *BinaryEventLogDecoder::createFileReader(const char *fileName, size_t bufferSize)
+{
+    if (isBinaryEventLog(fileName))
+        return new BinaryEventLogReader(fileName, bufferSize);
+    else
+        return new FileReader(fileName, bufferSize);
+}
+
+}  // namespace eventlog
+}  // namespace omnetpp
@@ -0,0 +1,150 @@
+//=========================================================================
+//  BINARYEVENTLOGDECODER.H - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_EVENTLOG_BINARYEVENTLOGDECODER_H
+#define __OMNETPP_EVENTLOG_BINARYEVENTLOGDECODER_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "common/filereader.h"
+#include "eventlogdefs.h"
+
+namespace omnetpp {
+namespace eventlog {
+
+class EventOffsetTable;
+
+/**
+ * Utility functions for binary eventlog files (see common/binaryeventlogformat.h).
+ */
+class EVENTLOG_API BinaryEventLogDecoder
+{
+    public:
+        /**
+         * Returns true if the file starts with the binary eventlog magic.
+         */
+        static bool isBinaryEventLog(const char *fileName);
+
+        /**
+         * Decodes the given binary eventlog file into a text eventlog file.
+         * Throws an exception on errors.
+         */
+        static void decode(const char *binaryFileName, const char *textFileName);
+
+        /**
+         * Returns a new FileReader for the given eventlog file: a plain
+         * FileReader for text eventlogs, and a BinaryEventLogReader for
+         * binary ones. Readers passed to EventLogIndex and EventLog must be
+         * created this way, because they cannot read binary files otherwise.
+         */
+        static FileReader *createFileReader(const char *fileName);
+
+        /**
+         * Same as above, with the given buffer size.
+         */
+        static FileReader *createFileReader(const char *fileName, size_t bufferSize);
+};
+
+/**
+ * A FileReader that presents a binary eventlog file as the equivalent text
+ * eventlog, so that the rest of the library can work on it unchanged. All
+ * offsets (including the ones in snapshot and index entries) are offsets in
+ * the text content, which is never written to disk.
+ *
+ * When the file is opened, it is scanned once to build an in-memory index:
+ * the decoder state (the bases of the delta-coded values and the entry types
+ * in effect) at record boundaries about every CHECKPOINT_INTERVAL bytes of
+ * text, and the event number, simulation time and offset of every event.
+ * Reads decode only the blocks between the checkpoints they touch, and a few
+ * recently decoded blocks are kept. When the file grows, the index is extended
+ * from where it ended.
+ *
+ * Decoding is driven by the entry types declared in the file, so it does not
+ * depend on the entry definitions compiled into the library. An incomplete
+ * record at the end of the file (e.g. after a crash, or while the simulation
+ * is still writing it) is not part of the content.
+ */
+class EVENTLOG_API BinaryEventLogReader : public FileReader
+{
+    protected:
+        class Decoder;
+
+        // where decoding continues from
+        struct Position {
+            file_offset_t binaryOffset = 0;  // offset of the next record in the file
+            file_offset_t textOffset = 0;    // offset of its text
+            file_offset_t recordOffset = 0;  // offset of the last entry, including preceding type declarations
+            bool isAfterTypeDeclaration = false;
+            int64_t lastEventNumber = 0;
+            int64_t lastMessageId = 0;
+            int64_t lastModuleId = 0;
+            int64_t lastSimTime = 0;
+        };
+
+        struct Checkpoint {
+            Position position;
+            std::vector<int> entryTypes;  // declaration in effect for each entry type index
+        };
+
+        static const file_offset_t CHECKPOINT_INTERVAL = 16 * 1024;
+
+        FILE *binaryFile = nullptr;
+        Decoder *decoder = nullptr;
+        int64_t binaryFileSize = -1;  // when the index was last updated
+        time_t binaryModificationTime = -1;
+
+        // the index
+        std::vector<Checkpoint> checkpoints;  // ordered by offset; the first one is right after the file header
+        Checkpoint indexEnd;  // after the last complete record
+        std::vector<eventnumber_t> eventNumbers;
+        std::vector<simtime_t> simulationTimes;
+        std::vector<file_offset_t> eventOffsets;
+
+        // recently decoded blocks (text between two checkpoints), most recent first
+        struct Block {
+            file_offset_t offset;
+            std::string text;
+        };
+        static const int MAX_CACHED_BLOCKS = 16;
+        std::vector<Block> blocks;
+
+    protected:
+        void ensureBinaryFileOpen();
+        void clearIndex();
+        void updateIndex();
+        void decodeBlock(size_t checkpointIndex, std::string& text);
+        const Block& getBlock(file_offset_t fileOffset);
+        virtual size_t readFileData(file_offset_t fileOffset, char *dataPointer, size_t size) override;
+        virtual void getFileInformation(int64_t& size, time_t& lastModificationTime) override;
+
+    public:
+        /**
+         * Creates a reader for the given binary eventlog file. The file does
+         * not get opened yet.
+         */
+        BinaryEventLogReader(const char *fileName, size_t bufferSize = 256 * 1024);
+        virtual ~BinaryEventLogReader();
+
+        /**
+         * Returns a new event offset table for the content indexed so far.
+         */
+        EventOffsetTable *createOffsetTable();
+};
+
+}  // namespace eventlog
+}  // namespace omnetpp
+
+
+#endif
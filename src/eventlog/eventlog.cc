@@ -29,10 +29,10 @@ OPP_THREAD_LOCAL StaticStringPool eventLogStringPool;
 
 EventLog::EventLog(FileReader *reader) : EventLogIndex(reader)
 {
-    reader->setFileLocking(true);
+    this->reader->setFileLocking(true);
     clearInternalState();
     parseIndex();
-    if (reader->getFileSize() < 10E+6)
+    if (this->reader->getFileSize() < 10E+6)
         parseAll();
     else {
         parseBegin(1E+6);
@@ -16,6 +16,7 @@
 #include <algorithm>
 #include <cinttypes>
 #include "common/exception.h"
+#include "binaryeventlogdecoder.h"
 #include "eventlogentry.h"
 #include "eventlogindex.h"
 
@@ -93,14 +94,30 @@ void EventLogIndex::CacheEntry::getEndKey(simtime_t& key)
 
 EventLogIndex::EventLogIndex(FileReader *reader): reader(reader)
 {
-    this->tokenizer = new LineTokenizer(reader->getMaxLineSize() + 1);
+    // binary eventlogs must be read through a decoding reader
+    if (!dynamic_cast<BinaryEventLogReader *>(reader) && BinaryEventLogDecoder::isBinaryEventLog(reader->getFileName()))
+        throw opp_runtime_error("Eventlog file '%s' is binary, it must be opened with BinaryEventLogDecoder::createFileReader()", reader->getFileName());
+
+    this->tokenizer = new LineTokenizer(this->reader->getMaxLineSize() + 1);
     clearInternalState();
+
+    // the binary reader indexes events when it opens the file; otherwise, use the index file if it is up to date
+    if (BinaryEventLogReader *binaryReader = dynamic_cast<BinaryEventLogReader *>(this->reader))
+        setOffsetTable(binaryReader->createOffsetTable());
+    else {
+        EventOffsetTable *table = new EventOffsetTable();
+        if (table->load(this->reader->getFileName()))
+            setOffsetTable(table);
+        else
+            delete table;
+    }
 }
 
 EventLogIndex::~EventLogIndex()
 {
     delete reader;
     delete tokenizer;
+    delete offsetTable;
 }
 
 void EventLogIndex::clearInternalState()
@@ -113,6 +130,51 @@ void EventLogIndex::clearInternalState()
     lastEventOffset = -1;
     eventNumberToCacheEntryMap.clear();
     simulationTimeToCacheEntryMap.clear();
+    setOffsetTable(nullptr);
+}
+
+void EventLogIndex::setOffsetTable(EventOffsetTable *table)
+{
+    delete offsetTable;
+    offsetTable = nullptr;
+    // a partially written last line means the file is still being written, use the file instead
+    if (table && table->getIndexedSize() != reader->getFileSize()) {
+        delete table;
+        table = nullptr;
+    }
+    offsetTable = table;
+    if (offsetTable && offsetTable->getNumEvents() > 0) {
+        int64_t last = offsetTable->getNumEvents() - 1;
+        firstEventNumber = offsetTable->getEventNumber(0);
+        firstSimulationTime = offsetTable->getSimulationTime(0);
+        firstEventOffset = offsetTable->getOffset(0);
+        lastEventNumber = offsetTable->getEventNumber(last);
+        lastSimulationTime = offsetTable->getSimulationTime(last);
+        lastEventOffset = offsetTable->getOffset(last);
+        cacheEntry(firstEventNumber, firstSimulationTime, firstEventOffset, getEndOffsetForBeginOffset(firstEventOffset));
+        cacheEntry(lastEventNumber, lastSimulationTime, lastEventOffset, reader->getFileSize());
+    }
+}
+
+void EventLogIndex::buildOffsetTable(int numThreads, bool saveIndexFile)
+{
+    // binary eventlogs have an in-memory index, there is no index file for them
+    if (BinaryEventLogReader *binaryReader = dynamic_cast<BinaryEventLogReader *>(reader)) {
+        setOffsetTable(binaryReader->createOffsetTable());
+        return;
+    }
+
+    EventOffsetTable *table = new EventOffsetTable();
+    try {
+        table->build(reader->getFileName(), numThreads);
+        if (saveIndexFile)
+            table->save(reader->getFileName());
+    }
+    catch (std::exception&) {
+        delete table;
+        throw;
+    }
+    setOffsetTable(table);
 }
 
 void EventLogIndex::synchronize(FileReader::FileChange change)
@@ -124,6 +186,7 @@ void EventLogIndex::synchronize(FileReader::FileChange change)
                 clearInternalState();
                 break;
             case FileReader::APPENDED:
+                setOffsetTable(nullptr);
                 eventNumberToCacheEntryMap.erase(lastEventNumber);
                 simulationTimeToCacheEntryMap.erase(lastSimulationTime);
                 lastEventNumber = EVENT_NOT_YET_CALCULATED;
@@ -189,6 +252,9 @@ file_offset_t EventLogIndex::getBeginOffsetForEndOffset(file_offset_t endOffset)
 {
     Assert(endOffset >= 0);
 
+    if (offsetTable)
+        return offsetTable->getPreviousOffset(endOffset);
+
     eventnumber_t eventNumber;
     simtime_t simulationTime;
     file_offset_t lineBeginOffset, lineEndOffset;
@@ -203,6 +269,11 @@ file_offset_t EventLogIndex::getEndOffsetForBeginOffset(file_offset_t beginOffse
 {
     Assert(beginOffset >= 0);
 
+    if (offsetTable) {
+        file_offset_t offset = offsetTable->getNextOffset(beginOffset);
+        return offset != -1 ? offset : reader->getFileSize();
+    }
+
     eventnumber_t eventNumber;
     simtime_t simulationTime;
     file_offset_t lineBeginOffset, lineEndOffset;
@@ -224,7 +295,7 @@ bool EventLogIndex::isEventBeginOffset(file_offset_t offset)
 file_offset_t EventLogIndex::getOffsetForEventNumber(eventnumber_t eventNumber, MatchKind matchKind)
 {
     Assert(eventNumber >= 0);
-    file_offset_t offset = searchForOffset(eventNumberToCacheEntryMap, eventNumber, matchKind);
+    file_offset_t offset = offsetTable ? offsetTable->getOffsetForEventNumber(eventNumber, matchKind) : searchForOffset(eventNumberToCacheEntryMap, eventNumber, matchKind);
 
     if (PRINT_DEBUG_MESSAGES)
         printf("Found event number: %" PRId64 " for match kind: %d at offset: %" PRId64 "\n", eventNumber, matchKind, offset);
@@ -235,7 +306,7 @@ file_offset_t EventLogIndex::getOffsetForEventNumber(eventnumber_t eventNumber,
 file_offset_t EventLogIndex::getOffsetForSimulationTime(simtime_t simulationTime, MatchKind matchKind)
 {
     Assert(simulationTime >= 0);
-    file_offset_t offset = searchForOffset(simulationTimeToCacheEntryMap, simulationTime, matchKind);
+    file_offset_t offset = offsetTable ? offsetTable->getOffsetForSimulationTime(simulationTime, matchKind) : searchForOffset(simulationTimeToCacheEntryMap, simulationTime, matchKind);
 
     if (PRINT_DEBUG_MESSAGES)
         printf("Found simulation time: %.*g for match kind: %d at offset: %" PRId64 "\n", 12, simulationTime.dbl(), matchKind, offset);
@@ -395,6 +466,7 @@ template<typename T> bool EventLogIndex::cacheSearchForOffset(std::map<T, CacheE
             lowerOffset = cacheEntry.endOffset;
         }
         else {
+            itLower = map.end();  // there is no element before the key
             lowerKey = getKey(key, getFirstEventNumber(), getFirstSimulationTime());
             lowerOffset = getFirstEventOffset();
         }
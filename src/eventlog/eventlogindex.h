@@ -24,6 +24,7 @@
 #include "common/linetokenizer.h"
 #include "eventlogdefs.h"
 #include "enums.h"
+#include "eventoffsettable.h"
 
 namespace omnetpp {
 namespace eventlog {
@@ -32,6 +33,14 @@ namespace eventlog {
  * Allows random access of an eventlog file, i.e. positioning on arbitrary event numbers and simulation times.
  * TODO: throw out entries from cache to free memory. This is not that urgent because the cache will be quite
  * small unless the file is linearly read through which is not supposed to happen.
+ *
+ * If an EventOffsetTable is available (loaded from the index file next to the eventlog,
+ * or built with buildOffsetTable()), offsets are looked up in that table instead of
+ * searching the file. The table is dropped when the file changes.
+ *
+ * Binary eventlogs must be read through a BinaryEventLogReader (see
+ * BinaryEventLogDecoder::createFileReader()), and their offset table comes from the
+ * reader's index.
  */
 class EVENTLOG_API EventLogIndex
 {
@@ -45,6 +54,7 @@ class EVENTLOG_API EventLogIndex
         eventnumber_t lastEventNumber;
         simtime_t firstSimulationTime;
         simtime_t lastSimulationTime;
+        EventOffsetTable *offsetTable = nullptr;
 
         /**
          * An entry stores information for a simulation time and the corresponding event number and file offset ranges.
@@ -116,6 +126,7 @@ class EVENTLOG_API EventLogIndex
         template <typename T> file_offset_t linearSearchForOffset(T key, file_offset_t beginOffset, bool forward, bool exactMatchRequired);
 
         void clearInternalState();
+        void setOffsetTable(EventOffsetTable *table);
 
         bool isEventBeginOffset(file_offset_t offset);
 
@@ -127,6 +138,13 @@ class EVENTLOG_API EventLogIndex
         virtual ~EventLogIndex();
 
         virtual void synchronize(FileReader::FileChange change);
+        /**
+         * Builds the offset table of the whole file by scanning it on the given number of threads
+         * (0 means the number of hardware threads), and optionally saves it into the index file.
+         * For binary eventlogs, the table is taken from the reader's index, and no file is saved.
+         */
+        void buildOffsetTable(int numThreads = 0, bool saveIndexFile = true);
+        bool hasOffsetTable() {return offsetTable != nullptr;}
         eventnumber_t getFirstEventNumber();
         eventnumber_t getLastEventNumber();
         simtime_t getFirstSimulationTime();
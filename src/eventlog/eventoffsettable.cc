@@ -0,0 +1,467 @@
+//=========================================================================
+//  EVENTOFFSETTABLE.CC - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <thread>
+#include "common/exception.h"
+#include "omnetpp/platdep/platmisc.h"
+#include "eventoffsettable.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace omnetpp::common;
+
+namespace omnetpp {
+namespace eventlog {
+
+#define EVENT_OFFSET_TABLE_MAGIC      "OPPEIDX\n"
+#define EVENT_OFFSET_TABLE_VERSION    1
+#define EVENT_OFFSET_TABLE_BYTEORDER  0x01020304
+
+namespace {
+
+struct IndexFileHeader {
+    char magic[8];          // EVENT_OFFSET_TABLE_MAGIC, without the terminating zero
+    int32_t version;        // EVENT_OFFSET_TABLE_VERSION
+    int32_t byteOrderMark;  // EVENT_OFFSET_TABLE_BYTEORDER, as written by the host
+    int64_t fileSize;       // size of the eventlog file
+    int64_t fileModificationTime;
+    int64_t indexedSize;
+    int64_t numEvents;      // followed by this many IndexFileEntry records
+};
+
+struct IndexFileEntry {
+    int64_t eventNumber;
+    int64_t offset;
+    int64_t simulationTimeIntValue;
+    int64_t simulationTimeScale;
+};
+
+/**
+ * Read-only memory mapping of a whole file.
+ */
+class MappedFile
+{
+    private:
+        const char *data = nullptr;
+        size_t size = 0;
+        int64_t modificationTime = 0;  // from the same file handle as size
+#ifdef _WIN32
+        HANDLE fileHandle = INVALID_HANDLE_VALUE;
+        HANDLE mappingHandle = nullptr;
+#endif
+
+    public:
+        MappedFile(const char *fileName);
+        ~MappedFile();
+        const char *getData() const {return data;}
+        size_t getSize() const {return size;}
+        int64_t getModificationTime() const {return modificationTime;}
+};
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const char *fileName)
+{
+    fileHandle = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ|FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        throw opp_runtime_error("Cannot open '%s' for read", fileName);
+    LARGE_INTEGER fileSize;
+    FILETIME lastWriteTime;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || !GetFileTime(fileHandle, nullptr, nullptr, &lastWriteTime)) {
+        CloseHandle(fileHandle);
+        throw opp_runtime_error("Cannot determine size of '%s'", fileName);
+    }
+    size = fileSize.QuadPart;
+    // FILETIME counts 100ns units since 1601-01-01; convert to seconds since the Unix epoch, as st_mtime
+    int64_t ticks = ((int64_t)lastWriteTime.dwHighDateTime << 32) | lastWriteTime.dwLowDateTime;
+    modificationTime = (ticks - 116444736000000000LL) / 10000000;
+    if (size == 0)
+        return;  // empty files cannot be mapped
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle != nullptr)
+        data = (const char *)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr) {
+        if (mappingHandle)
+            CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        throw opp_runtime_error("Cannot map '%s' into memory", fileName);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (data)
+        UnmapViewOfFile(data);
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+    CloseHandle(fileHandle);
+}
+
+#else
+
+MappedFile::MappedFile(const char *fileName)
+{
+    int fd = open(fileName, O_RDONLY);
+    if (fd == -1)
+        throw opp_runtime_error("Cannot open '%s' for read", fileName);
+    struct stat s;
+    if (fstat(fd, &s) != 0) {
+        ::close(fd);
+        throw opp_runtime_error("Cannot determine size of '%s'", fileName);
+    }
+    size = s.st_size;
+    modificationTime = s.st_mtime;
+    if (size == 0) {
+        ::close(fd);
+        return;  // empty files cannot be mapped
+    }
+    void *p = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // the mapping stays valid
+    if (p == MAP_FAILED)
+        throw opp_runtime_error("Cannot map '%s' into memory: %s", fileName, strerror(errno));
+    data = (const char *)p;
+    madvise(p, size, MADV_SEQUENTIAL);
+}
+
+MappedFile::~MappedFile()
+{
+    if (data)
+        munmap((void *)data, size);
+}
+
+#endif
+
+/**
+ * The events found in one chunk of the file.
+ */
+struct Chunk {
+    file_offset_t begin;
+    file_offset_t end;
+    std::vector<eventnumber_t> eventNumbers;
+    std::vector<simtime_t> simulationTimes;
+    std::vector<file_offset_t> offsets;
+    std::exception_ptr error;
+};
+
+/**
+ * Copies the space-separated token starting at s into buffer, NUL-terminated.
+ */
+const char *copyToken(const char *s, const char *end, char *buffer, size_t bufferSize)
+{
+    size_t length = 0;
+    while (s + length < end && s[length] != ' ' && s[length] != '\r' && length < bufferSize - 1)
+        length++;
+    memcpy(buffer, s, length);
+    buffer[length] = '\0';
+    return buffer;
+}
+
+/**
+ * Parses an "E" line ("E # 12345 t 1.2345 ..."), the line is between s and end.
+ */
+void parseEventLine(const char *s, const char *end, eventnumber_t& eventNumber, simtime_t& simulationTime)
+{
+    char buffer[64];
+    eventNumber = -1;
+    simulationTime = simtime_nil;
+    s += 2;  // "E "
+    while (s < end) {
+        const char *key = s;
+        while (s < end && *s != ' ')
+            s++;
+        bool isSingleChar = s - key == 1;
+        if (s < end)
+            s++;
+        const char *value = s;
+        while (s < end && *s != ' ')
+            s++;
+        if (s < end)
+            s++;
+        if (isSingleChar && *key == '#')
+            eventNumber = strtoll(copyToken(value, end, buffer, sizeof(buffer)), nullptr, 10);
+        else if (isSingleChar && *key == 't')
+            simulationTime = BigDecimal::parse(copyToken(value, end, buffer, sizeof(buffer)));
+        if (eventNumber != -1 && simulationTime != simtime_nil)
+            return;
+    }
+}
+
+/**
+ * Indexes the "E" lines that start in [chunk.begin, chunk.end). Lines may
+ * extend beyond the end of the chunk, but not beyond dataSize.
+ */
+void scanChunk(const char *data, size_t dataSize, Chunk& chunk)
+{
+    size_t pos = chunk.begin;
+    if (pos > 0 && data[pos - 1] != '\n') {
+        const char *nl = (const char *)memchr(data + pos, '\n', dataSize - pos);
+        pos = nl ? nl - data + 1 : dataSize;
+    }
+    while (pos < (size_t)chunk.end) {
+        const char *line = data + pos;
+        const char *nl = (const char *)memchr(line, '\n', dataSize - pos);
+        if (!nl)
+            break;  // cannot happen, dataSize ends with a newline
+        if (line[0] == 'E' && line[1] == ' ') {
+            eventnumber_t eventNumber;
+            simtime_t simulationTime;
+            parseEventLine(line, nl, eventNumber, simulationTime);
+            if (eventNumber == -1 || simulationTime == simtime_nil)
+                throw opp_runtime_error("Wrong file format: No event number or simulation time in 'E' line at offset %" PRId64, (int64_t)pos);
+            chunk.eventNumbers.push_back(eventNumber);
+            chunk.simulationTimes.push_back(simulationTime);
+            chunk.offsets.push_back(pos);
+        }
+        pos = nl - data + 1;
+    }
+}
+
+int64_t getModificationTime(const char *fileName, file_offset_t& fileSize)
+{
+    struct opp_stat_t s;
+    if (opp_stat(fileName, &s) != 0)
+        throw opp_runtime_error("Cannot stat file '%s'", fileName);
+    fileSize = s.st_size;
+    return s.st_mtime;
+}
+
+template<typename T>
+file_offset_t lookup(const std::vector<T>& keys, const std::vector<file_offset_t>& offsets, const T& key, MatchKind matchKind)
+{
+    auto range = std::equal_range(keys.begin(), keys.end(), key);
+    size_t lo = range.first - keys.begin();
+    size_t hi = range.second - keys.begin();
+    bool found = lo != hi;
+    switch (matchKind) {
+        case EXACT:
+            if (hi - lo > 1)
+                throw opp_runtime_error("Found non unique simulation time when exact match is requested");
+            return found ? offsets[lo] : -1;
+        case FIRST_OR_PREVIOUS:
+            return found ? offsets[lo] : lo > 0 ? offsets[lo - 1] : -1;
+        case FIRST_OR_NEXT:
+            return lo < keys.size() ? offsets[lo] : -1;
+        case LAST_OR_NEXT:
+            return found ? offsets[hi - 1] : hi < keys.size() ? offsets[hi] : -1;
+        case LAST_OR_PREVIOUS:
+            return hi > 0 ? offsets[hi - 1] : -1;
+    }
+    throw opp_runtime_error("Unknown match kind");
+}
+
+}  // namespace
+
+std::string EventOffsetTable::getIndexFileName(const char *eventLogFileName)
+{
+    return std::string(eventLogFileName) + ".idx";
+}
+
+void EventOffsetTable::build(const char *eventLogFileName, int numThreads, size_t minChunkSize)
+{
+    if (minChunkSize == 0)
+        throw opp_runtime_error("Chunk size must be positive");
+    eventNumbers.clear();
+    simulationTimes.clear();
+    offsets.clear();
+
+    // size and modification time are taken from the mapped file itself, so they match the indexed data
+    MappedFile file(eventLogFileName);
+    const char *data = file.getData();
+    fileSize = file.getSize();
+    fileModificationTime = file.getModificationTime();
+
+    // only index complete lines
+    indexedSize = fileSize;
+    while (indexedSize > 0 && data[indexedSize - 1] != '\n')
+        indexedSize--;
+
+    // split the file into chunks, and scan them in parallel
+    if (numThreads <= 0)
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    int numChunks = (int)std::max((file_offset_t)1, std::min((file_offset_t)numThreads, indexedSize / (file_offset_t)minChunkSize));
+    std::vector<Chunk> chunks(numChunks);
+    for (int i = 0; i < numChunks; i++) {
+        chunks[i].begin = indexedSize * i / numChunks;
+        chunks[i].end = indexedSize * (i + 1) / numChunks;
+    }
+    auto scan = [&](Chunk& chunk) {
+        try {
+            scanChunk(data, indexedSize, chunk);
+        }
+        catch (std::exception&) {
+            chunk.error = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int i = 1; i < numChunks; i++)
+        threads.push_back(std::thread(scan, std::ref(chunks[i])));
+    scan(chunks[0]);
+    for (std::thread& thread : threads)
+        thread.join();
+
+    size_t numEvents = 0;
+    for (Chunk& chunk : chunks) {
+        if (chunk.error)
+            std::rethrow_exception(chunk.error);
+        numEvents += chunk.offsets.size();
+    }
+    eventNumbers.reserve(numEvents);
+    simulationTimes.reserve(numEvents);
+    offsets.reserve(numEvents);
+    for (Chunk& chunk : chunks) {
+        eventNumbers.insert(eventNumbers.end(), chunk.eventNumbers.begin(), chunk.eventNumbers.end());
+        simulationTimes.insert(simulationTimes.end(), chunk.simulationTimes.begin(), chunk.simulationTimes.end());
+        offsets.insert(offsets.end(), chunk.offsets.begin(), chunk.offsets.end());
+    }
+    checkOrder(eventLogFileName);
+}
+
+void EventOffsetTable::checkOrder(const char *fileName)
+{
+    for (size_t i = 1; i < offsets.size(); i++) {
+        if (eventNumbers[i] <= eventNumbers[i - 1])
+            throw opp_runtime_error("Event numbers are not increasing in eventlog file '%s' at offset %" PRId64, fileName, (int64_t)offsets[i]);
+        if (simulationTimes[i] < simulationTimes[i - 1])
+            throw opp_runtime_error("Simulation times are decreasing in eventlog file '%s' at offset %" PRId64, fileName, (int64_t)offsets[i]);
+    }
+}
+
+bool EventOffsetTable::load(const char *eventLogFileName)
+{
+    std::string indexFileName = getIndexFileName(eventLogFileName);
+    file_offset_t currentFileSize;
+    int64_t currentModificationTime;
+    try {
+        currentModificationTime = getModificationTime(eventLogFileName, currentFileSize);
+    }
+    catch (std::exception&) {
+        return false;
+    }
+
+    FILE *f = fopen(indexFileName.c_str(), "rb");
+    if (!f)
+        return false;
+    IndexFileHeader header;
+    bool ok = fread(&header, sizeof(header), 1, f) == 1 &&
+              memcmp(header.magic, EVENT_OFFSET_TABLE_MAGIC, 8) == 0 &&
+              header.version == EVENT_OFFSET_TABLE_VERSION &&
+              header.byteOrderMark == EVENT_OFFSET_TABLE_BYTEORDER &&
+              header.fileSize == currentFileSize &&
+              header.fileModificationTime == currentModificationTime &&
+              header.numEvents >= 0 && header.numEvents <= header.indexedSize;
+    std::vector<IndexFileEntry> entries;
+    if (ok) {
+        entries.resize(header.numEvents);
+        ok = fread(entries.data(), sizeof(IndexFileEntry), entries.size(), f) == entries.size();
+    }
+    fclose(f);
+    if (!ok)
+        return false;
+
+    fileSize = header.fileSize;
+    fileModificationTime = header.fileModificationTime;
+    indexedSize = header.indexedSize;
+    eventNumbers.resize(entries.size());
+    simulationTimes.resize(entries.size());
+    offsets.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        eventNumbers[i] = entries[i].eventNumber;
+        simulationTimes[i] = BigDecimal(entries[i].simulationTimeIntValue, (int)entries[i].simulationTimeScale);
+        offsets[i] = entries[i].offset;
+    }
+    return true;
+}
+
+void EventOffsetTable::save(const char *eventLogFileName) const
+{
+    IndexFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, EVENT_OFFSET_TABLE_MAGIC, 8);
+    header.version = EVENT_OFFSET_TABLE_VERSION;
+    header.byteOrderMark = EVENT_OFFSET_TABLE_BYTEORDER;
+    header.fileSize = fileSize;
+    header.fileModificationTime = fileModificationTime;
+    header.indexedSize = indexedSize;
+    header.numEvents = offsets.size();
+
+    // write to a temp file then rename, so that concurrent readers never see partial files
+    std::string indexFileName = getIndexFileName(eventLogFileName);
+    std::string tmpFileName = indexFileName + ".tmp";
+    FILE *f = fopen(tmpFileName.c_str(), "wb");
+    if (!f)
+        throw opp_runtime_error("Cannot open index file '%s' for write", tmpFileName.c_str());
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    std::vector<IndexFileEntry> entries;
+    const size_t batchSize = 64 * 1024;
+    for (size_t i = 0; ok && i < offsets.size(); i += batchSize) {
+        size_t n = std::min(batchSize, offsets.size() - i);
+        entries.resize(n);
+        for (size_t j = 0; j < n; j++) {
+            entries[j].eventNumber = eventNumbers[i + j];
+            entries[j].offset = offsets[i + j];
+            entries[j].simulationTimeIntValue = simulationTimes[i + j].getIntValue();
+            entries[j].simulationTimeScale = simulationTimes[i + j].getScale();
+        }
+        ok = fwrite(entries.data(), sizeof(IndexFileEntry), n, f) == n;
+    }
+    ok = (fclose(f) == 0) && ok;
+    if (ok) {
+#ifdef _WIN32
+        ::remove(indexFileName.c_str());  // rename() does not overwrite on Windows
+#endif
+        ok = ::rename(tmpFileName.c_str(), indexFileName.c_str()) == 0;
+    }
+    if (!ok) {
+        ::remove(tmpFileName.c_str());
+        throw opp_runtime_error("Cannot write index file '%s'", indexFileName.c_str());
+    }
+}
+
+file_offset_t EventOffsetTable::getOffsetForEventNumber(eventnumber_t eventNumber, MatchKind matchKind) const
+{
+    return lookup(eventNumbers, offsets, eventNumber, matchKind);
+}
+
+file_offset_t EventOffsetTable::getOffsetForSimulationTime(simtime_t simulationTime, MatchKind matchKind) const
+{
+    return lookup(simulationTimes, offsets, simulationTime, matchKind);
+}
+
+file_offset_t EventOffsetTable::getNextOffset(file_offset_t offset) const
+{
+    auto it = std::upper_bound(offsets.begin(), offsets.end(), offset);
+    return it != offsets.end() ? *it : -1;
+}
+
+file_offset_t EventOffsetTable::getPreviousOffset(file_offset_t offset) const
+{
+    auto it = std::lower_bound(offsets.begin(), offsets.end(), offset);
+    return it != offsets.begin() ? *(it - 1) : -1;
+}
+
+}  // namespace eventlog
+}  // namespace omnetpp
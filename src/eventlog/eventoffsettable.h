@@ -0,0 +1,121 @@
+//=========================================================================
+//  EVENTOFFSETTABLE.H - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_EVENTLOG_EVENTOFFSETTABLE_H
+#define __OMNETPP_EVENTLOG_EVENTOFFSETTABLE_H
+
+#include <string>
+#include <vector>
+#include "omnetpp/platdep/platmisc.h"  // file_offset_t
+#include "eventlogdefs.h"
+#include "enums.h"
+
+namespace omnetpp {
+namespace eventlog {
+
+/**
+ * A dense table of all events of an eventlog file: the event number,
+ * simulation time and begin file offset of each "E" line, in file order.
+ * Both event numbers and simulation times are monotonic in the file, so
+ * lookups are binary searches in memory.
+ *
+ * The table is built by scanning the memory-mapped file in chunks on
+ * multiple threads, and it can be saved into an index file next to the
+ * eventlog (see getIndexFileName()). The index file records the size and
+ * modification time of the eventlog, and it is only loaded if they match.
+ *
+ * Only complete lines are indexed, i.e. a partially written last line is
+ * ignored; getIndexedSize() returns the size of the indexed part of the file.
+ */
+class EVENTLOG_API EventOffsetTable
+{
+    friend class BinaryEventLogReader;  // fills the table from its own index
+
+    protected:
+        file_offset_t indexedSize = 0;  // size of the indexed part of the file
+        file_offset_t fileSize = 0;     // size of the file when the table was built
+        int64_t fileModificationTime = 0;
+        std::vector<eventnumber_t> eventNumbers;
+        std::vector<simtime_t> simulationTimes;
+        std::vector<file_offset_t> offsets;
+
+    protected:
+        void checkOrder(const char *fileName);
+
+    public:
+        /**
+         * Files are only split among threads into chunks of at least this size.
+         */
+        static const size_t DEFAULT_MIN_CHUNK_SIZE = 4 * 1024 * 1024;
+
+    public:
+        /**
+         * Returns the name of the index file for the given eventlog file:
+         * "foo.elog" becomes "foo.elog.idx".
+         */
+        static std::string getIndexFileName(const char *eventLogFileName);
+
+        /**
+         * Scans the given eventlog file using the given number of threads;
+         * 0 means the number of hardware threads. The file is split into at
+         * most numThreads chunks of at least minChunkSize bytes, which are
+         * scanned in parallel. Throws an exception on errors.
+         */
+        void build(const char *eventLogFileName, int numThreads = 0, size_t minChunkSize = DEFAULT_MIN_CHUNK_SIZE);
+
+        /**
+         * Loads the index file of the given eventlog file. Returns false if
+         * the index file does not exist, cannot be read, or is out of date.
+         */
+        bool load(const char *eventLogFileName);
+
+        /**
+         * Saves the table into the index file of the given eventlog file.
+         * Throws an exception on errors.
+         */
+        void save(const char *eventLogFileName) const;
+
+        int64_t getNumEvents() const {return offsets.size();}
+        file_offset_t getIndexedSize() const {return indexedSize;}
+        eventnumber_t getEventNumber(int64_t index) const {return eventNumbers[index];}
+        simtime_t getSimulationTime(int64_t index) const {return simulationTimes[index];}
+        file_offset_t getOffset(int64_t index) const {return offsets[index];}
+
+        /**
+         * Returns the begin offset of the event that matches the given event
+         * number or simulation time (see MatchKind), or -1 if there is no such
+         * event. For an EXACT match on a simulation time shared by multiple
+         * events, an exception is thrown.
+         */
+        file_offset_t getOffsetForEventNumber(eventnumber_t eventNumber, MatchKind matchKind) const;
+        file_offset_t getOffsetForSimulationTime(simtime_t simulationTime, MatchKind matchKind) const;
+
+        /**
+         * Returns the begin offset of the first event that starts after the
+         * given offset, or -1 if there is none.
+         */
+        file_offset_t getNextOffset(file_offset_t offset) const;
+
+        /**
+         * Returns the begin offset of the last event that starts before the
+         * given offset, or -1 if there is none.
+         */
+        file_offset_t getPreviousOffset(file_offset_t offset) const;
+};
+
+}  // namespace eventlog
+}  // namespace omnetpp
+
+
+#endif
@@ -17,6 +17,7 @@
 #include "common/filereader.h"
 #include "common/linetokenizer.h"
 #include "omnetpp/platdep/platmisc.h"
+#include "binaryeventlogdecoder.h"
 #include "eventlogindex.h"
 #include "eventlog.h"
 #include "filteredeventlog.h"
@@ -132,7 +133,7 @@ eventnumber_t Options::getFirstEventNumber()
         if (fromEventNumber != -1)
             firstEventNumber = fromEventNumber;
         else if (fromSimulationTime != simtime_nil) {
-            FileReader *fileReader = new FileReader(inputFileName);
+            FileReader *fileReader = BinaryEventLogDecoder::createFileReader(inputFileName);
             EventLog eventLog(fileReader);
             IEvent *event = eventLog.getEventForSimulationTime(fromSimulationTime, FIRST_OR_NEXT);
             if (event)
@@ -153,7 +154,7 @@ eventnumber_t Options::getLastEventNumber()
         if (toEventNumber != -1)
             lastEventNumber = toEventNumber;
         else if (toSimulationTime != simtime_nil) {
-            FileReader *fileReader = new FileReader(inputFileName);
+            FileReader *fileReader = BinaryEventLogDecoder::createFileReader(inputFileName);
             EventLog eventLog(fileReader);
             IEvent *event = eventLog.getEventForSimulationTime(toSimulationTime, LAST_OR_PREVIOUS);
             if (event)
@@ -173,7 +174,7 @@ void offsets(Options options)
     if (options.verbose)
         fprintf(stdout, "# Printing event offsets from log file %s\n", options.inputFileName);
 
-    FileReader *fileReader = new FileReader(options.inputFileName);
+    FileReader *fileReader = BinaryEventLogDecoder::createFileReader(options.inputFileName);
     EventLogIndex eventLogIndex(fileReader);
 
     long begin = clock();
@@ -205,7 +206,7 @@ void events(Options options)
     if (options.verbose)
         fprintf(stdout, "# Printing events from log file %s\n", options.inputFileName);
 
-    FileReader *fileReader = new FileReader(options.inputFileName);
+    FileReader *fileReader = BinaryEventLogDecoder::createFileReader(options.inputFileName);
     EventLog eventLog(fileReader);
 
     long begin = clock();
@@ -232,7 +233,7 @@ void ranges(Options options)
     if (options.verbose)
         fprintf(stdout, "# Printing continuous ranges from log file %s\n", options.inputFileName);
 
-    FileReader *fileReader = new FileReader(options.inputFileName);
+    FileReader *fileReader = BinaryEventLogDecoder::createFileReader(options.inputFileName);
     EventLog eventLog(fileReader);
 
     long begin = clock();
@@ -262,7 +263,7 @@ void echo(Options options)
     if (options.verbose)
         fprintf(stdout, "# Echoing events from log file %s from event number #%" EVENTNUMBER_PRINTF_FORMAT " to event number #%" EVENTNUMBER_PRINTF_FORMAT "\n", options.inputFileName, options.getFirstEventNumber(), options.getLastEventNumber());
 
-    FileReader *fileReader = new FileReader(options.inputFileName);
+    FileReader *fileReader = BinaryEventLogDecoder::createFileReader(options.inputFileName);
     IEventLog *eventLog = options.createEventLog(fileReader);
 
     long begin = clock();
@@ -280,7 +281,7 @@ void cat(Options options)
     if (options.verbose)
         fprintf(stdout, "# Cating from file %s\n", options.inputFileName);
 
-    FileReader *fileReader = new FileReader(options.inputFileName);
+    FileReader *fileReader = BinaryEventLogDecoder::createFileReader(options.inputFileName);
 
     long begin = clock();
     char *line;
@@ -292,6 +293,22 @@ void cat(Options options)
         fprintf(stdout, "# Cating of %" PRId64 " lines and %" PRId64 " bytes from log file %s completed in %g seconds\n", fileReader->getNumReadLines(), fileReader->getNumReadBytes(), options.inputFileName, (double)(end - begin) / CLOCKS_PER_SEC);
 }
 
+void buildIndex(Options options)
+{
+    if (options.verbose)
+        fprintf(stdout, "# Building event offset index for log file %s\n", options.inputFileName);
+
+    FileReader *fileReader = BinaryEventLogDecoder::createFileReader(options.inputFileName);
+    EventLogIndex eventLogIndex(fileReader);
+
+    long begin = clock();
+    eventLogIndex.buildOffsetTable();
+    long end = clock();
+
+    if (options.verbose)
+        fprintf(stdout, "# Building event offset index %s completed in %g seconds of CPU time\n", EventOffsetTable::getIndexFileName(fileReader->getFileName()).c_str(), (double)(end - begin) / CLOCKS_PER_SEC);
+}
+
 void filter(Options options)
 {
     eventnumber_t tracedEventNumber = options.eventNumbers.empty() ? -1 : options.eventNumbers.at(0);
@@ -300,7 +317,7 @@ void filter(Options options)
         fprintf(stdout, "# Filtering events from log file %s for traced event number #%" EVENTNUMBER_PRINTF_FORMAT " from event number #%" EVENTNUMBER_PRINTF_FORMAT " to event number #%" EVENTNUMBER_PRINTF_FORMAT "\n",
                 options.inputFileName, tracedEventNumber, options.getFirstEventNumber(), options.getLastEventNumber());
 
-    FileReader *fileReader = new FileReader(options.inputFileName);
+    FileReader *fileReader = BinaryEventLogDecoder::createFileReader(options.inputFileName);
     IEventLog *eventLog = options.createEventLog(fileReader);
 
     long begin = clock();
@@ -330,6 +347,8 @@ void usage(const char *message)
 "      events      - prints the events for the given offsets (-f), all other options are ignored.\n"
 "      ranges      - prints the continuous event number ranges found in the input as event number pairs, all other options are ignored.\n"
 "      echo        - echos the input to the output, range options are supported.\n"
+"      index       - builds the event offset index file (<input-file-name>.idx) that speeds up opening large files,\n"
+"                    all other options are ignored.\n"
 "      filter      - filters the input according to the various options and outputs the result, only one event number is traced,\n"
 "                    but it may be outside of the specified event number or simulation time range.\n"
 "\n"
@@ -513,6 +532,8 @@ int main(int argc, char **argv)
                     echo(options);
                 else if (!strcmp(command, "cat"))
                     cat(options);
+                else if (!strcmp(command, "index"))
+                    buildIndex(options);
                 else
                     usage("Unknown or invalid command");
 
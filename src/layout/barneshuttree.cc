@@ -0,0 +1,136 @@
+//=========================================================================
+//  BARNESHUTTREE.CC - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cfloat>
+#include <exception>
+#include <thread>
+#include "barneshuttree.h"
+
+namespace omnetpp {
+namespace layout {
+
+void BarnesHutTree::build(const std::vector<Item>& newItems)
+{
+    items = newItems;
+    cells.clear();
+    if (items.empty())
+        return;
+
+    double minX = DBL_MAX, minY = DBL_MAX, maxX = -DBL_MAX, maxY = -DBL_MAX;
+    for (const Item& item : items) {
+        minX = std::min(minX, item.x);
+        minY = std::min(minY, item.y);
+        maxX = std::max(maxX, item.x);
+        maxY = std::max(maxY, item.y);
+    }
+    double size = std::max(maxX - minX, maxY - minY);
+    size = size > 0 ? size * (1 + 1E-9) : 1;
+
+    cells.emplace_back();
+    buildCell(0, 0, items.size(), minX, minY, size, 0);
+}
+
+void BarnesHutTree::buildCell(int cellIndex, int begin, int end, double x1, double y1, double size, int depth)
+{
+    double weight = 0, x = 0, y = 0, z = 0;
+    for (int i = begin; i < end; i++) {
+        const Item& item = items[i];
+        weight += item.weight;
+        x += item.weight * item.x;
+        y += item.weight * item.y;
+        z += item.weight * item.z;
+    }
+    if (weight != 0) {
+        x /= weight;
+        y /= weight;
+        z /= weight;
+    }
+    else {
+        x = y = z = 0;
+        for (int i = begin; i < end; i++) {
+            x += items[i].x;
+            y += items[i].y;
+            z += items[i].z;
+        }
+        int n = std::max(1, end - begin);
+        x /= n;
+        y /= n;
+        z /= n;
+    }
+
+    Cell& cell = cells[cellIndex];
+    cell.x1 = x1;
+    cell.y1 = y1;
+    cell.size = size;
+    cell.x = x;
+    cell.y = y;
+    cell.z = z;
+    cell.weight = weight;
+    cell.firstItem = begin;
+    cell.numItems = end - begin;
+    cell.firstChild = -1;
+    if (end - begin <= leafSize || depth >= MAX_DEPTH)
+        return;
+
+    // split into quadrants: [begin, middleY) is the top half, [middleY, end) the bottom half,
+    // and each half is further split into left and right
+    double half = size / 2;
+    double middleX = x1 + half, middleY = y1 + half;
+    auto first = items.begin();
+    int splitY = std::partition(first + begin, first + end, [middleY](const Item& item) {return item.y < middleY;}) - first;
+    int splitTop = std::partition(first + begin, first + splitY, [middleX](const Item& item) {return item.x < middleX;}) - first;
+    int splitBottom = std::partition(first + splitY, first + end, [middleX](const Item& item) {return item.x < middleX;}) - first;
+
+    int firstChild = cells.size();
+    cells[cellIndex].firstChild = firstChild;  // note: 'cell' is invalidated by the resize below
+    cells.resize(firstChild + 4);
+    buildCell(firstChild, begin, splitTop, x1, y1, half, depth + 1);
+    buildCell(firstChild + 1, splitTop, splitY, middleX, y1, half, depth + 1);
+    buildCell(firstChild + 2, splitY, splitBottom, x1, middleY, half, depth + 1);
+    buildCell(firstChild + 3, splitBottom, end, middleX, middleY, half, depth + 1);
+}
+
+void runInParallel(int count, int numThreads, int minCountPerThread, const std::function<void(int,int)>& function)
+{
+    if (numThreads <= 0)
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    numThreads = std::min(numThreads, count / std::max(1, minCountPerThread));
+    if (numThreads <= 1) {
+        function(0, count);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> errors(numThreads);
+    for (int i = 0; i < numThreads; i++) {
+        int begin = (int)((long long)count * i / numThreads);
+        int end = (int)((long long)count * (i + 1) / numThreads);
+        threads.emplace_back([&function, &errors, i, begin, end]() {
+            try {
+                function(begin, end);
+            }
+            catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    for (auto& error : errors)
+        if (error)
+            std::rethrow_exception(error);
+}
+
+}  // namespace layout
+}  // namespace omnetpp
@@ -0,0 +1,143 @@
+//=========================================================================
+//  BARNESHUTTREE.H - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_LAYOUT_BARNESHUTTREE_H
+#define __OMNETPP_LAYOUT_BARNESHUTTREE_H
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include "layoutdefs.h"
+
+namespace omnetpp {
+namespace layout {
+
+/**
+ * A quadtree over weighted points, used for approximating the sum of pairwise
+ * interactions (e.g. repulsive forces among layouted nodes) with the Barnes-Hut
+ * algorithm. The tree partitions the points along the x and y coordinates;
+ * the z coordinate only takes part in distance calculations.
+ *
+ * Each cell stores the total weight and the weighted center of the points in
+ * it. During visit(), a cell whose size divided by its distance from the query
+ * point is less than theta is considered far, and may be processed as a
+ * single point placed at its center; other cells are opened, down to the
+ * individual points in the leaves.
+ */
+class LAYOUT_API BarnesHutTree
+{
+  public:
+    struct Item {
+        double x, y, z;
+        double weight;
+        int index;      // identifies the item for the user
+    };
+
+    struct Cell {
+        double x1, y1;  // top left corner of the square region covered
+        double size;    // side length of the region
+        double x, y, z; // weighted center of the items (plain center if total weight is zero)
+        double weight;  // total weight of the items
+        int firstItem;  // the items of the cell are items[firstItem .. firstItem+numItems-1]
+        int numItems;
+        int firstChild; // index of the first of the 4 child cells, or -1 for leaves
+    };
+
+  protected:
+    enum { MAX_DEPTH = 40 };  // limits the depth for coinciding points
+    int leafSize;
+    std::vector<Item> items;
+    std::vector<Cell> cells;
+
+  protected:
+    void buildCell(int cellIndex, int begin, int end, double x1, double y1, double size, int depth);
+
+  public:
+    BarnesHutTree(int leafSize = 4) : leafSize(leafSize) {}
+
+    /**
+     * Builds the tree from the given items, discarding the previous content.
+     */
+    void build(const std::vector<Item>& items);
+
+    bool isEmpty() const {return items.empty();}
+    const std::vector<Item>& getItems() const {return items;}
+
+    /**
+     * Traverses the tree for the query point (x,y,z). Leaf items are passed
+     * to near(const Item&); far cells are passed to far(const Cell&), which
+     * should return false if it wants the cell to be opened anyway. The query
+     * point itself (if it is an item) is also passed to near(). Zero theta
+     * means that all items are visited individually.
+     *
+     * If maxDistance is non-negative, cells whose region is farther than
+     * maxDistance from the query point (in the x-y plane) are skipped
+     * altogether, i.e. the traversal becomes a range query.
+     */
+    template <typename NearFunction, typename FarFunction>
+    void visit(double x, double y, double z, double theta, double maxDistance, NearFunction near, FarFunction far) const;
+};
+
+template <typename NearFunction, typename FarFunction>
+void BarnesHutTree::visit(double x, double y, double z, double theta, double maxDistance, NearFunction near, FarFunction far) const
+{
+    if (cells.empty())
+        return;
+    int stack[3 * MAX_DEPTH + 4];
+    int top = 0;
+    stack[top++] = 0;
+    double thetaSquare = theta * theta;
+    double maxDistanceSquare = maxDistance * maxDistance;
+    while (top > 0) {
+        const Cell& cell = cells[stack[--top]];
+        if (cell.numItems == 0)
+            continue;
+        bool inside = x >= cell.x1 && x <= cell.x1 + cell.size && y >= cell.y1 && y <= cell.y1 + cell.size;
+        if (maxDistance >= 0 && !inside) {
+            double dx = std::max(0.0, std::max(cell.x1 - x, x - cell.x1 - cell.size));
+            double dy = std::max(0.0, std::max(cell.y1 - y, y - cell.y1 - cell.size));
+            if (dx * dx + dy * dy > maxDistanceSquare)
+                continue;
+        }
+        if (cell.firstChild == -1) {
+            for (int i = cell.firstItem; i < cell.firstItem + cell.numItems; i++)
+                near(items[i]);
+            continue;
+        }
+        if (theta > 0 && !inside) {
+            double dx = cell.x - x;
+            double dy = cell.y - y;
+            double dz = cell.z - z;
+            if (cell.size * cell.size < thetaSquare * (dx * dx + dy * dy + dz * dz) && far(cell))
+                continue;
+        }
+        for (int i = 0; i < 4; i++)
+            stack[top++] = cell.firstChild + i;
+    }
+}
+
+/**
+ * Calls function(begin, end) for disjoint consecutive subranges of [0, count)
+ * on multiple threads, and waits for all of them to finish. numThreads = 0
+ * means the number of hardware threads; no more threads are used than what
+ * gives each at least minCountPerThread elements. If only one thread would be
+ * used, the function is called on the caller's thread.
+ */
+LAYOUT_API void runInParallel(int count, int numThreads, int minCountPerThread, const std::function<void(int,int)>& function);
+
+}  // namespace layout
+}  // namespace omnetpp
+
+
+#endif
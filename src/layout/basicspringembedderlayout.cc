@@ -25,6 +25,7 @@
 
 #include "common/commonutil.h"
 #include "basicspringembedderlayout.h"
+#include "barneshuttree.h"
 
 using namespace omnetpp::common;
 
@@ -49,6 +50,8 @@ void BasicSpringEmbedderLayout::setEnvironment(GraphLayouterEnvironment *environ
     attractionForce = environment->getDoubleParameter("bgl", 1, attractionForce);
     defaultEdgeLen = environment->getDoubleParameter("bgl", 2, defaultEdgeLen);
     maxIterations = environment->getLongParameter("bgl", 3, maxIterations);
+    barnesHutTheta = environment->getDoubleParameter("bgl", 4, barnesHutTheta);
+    numThreads = environment->getLongParameter("bgl", 5, numThreads);
 }
 
 BasicSpringEmbedderLayout::Node *BasicSpringEmbedderLayout::findNode(int nodeId)
@@ -502,44 +505,50 @@ double BasicSpringEmbedderLayout::relax()
     // nodes of *different* colors ceases after a short distance. (This is done
     // to avoid "blow-up" of non-connected graphs.)
     //
-    for (i = nodes.begin(); i != nodes.end(); ++i) {
-        Node& n1 = *(*i);
-        if (n1.fixed)
-            continue;
-
-        double fx = 0;
-        double fy = 0;
-
-        // TBD performance improvement: use (i=0..N, j=i+1..N) loop unless more than N/2 nodes are fixed
-        for (j = nodes.begin(); j != nodes.end(); ++j) {
-            if (i == j)
-                continue;
-
-            Node& n2 = *(*j);
-            if (n1.anchor && n1.anchor == n2.anchor)
+    // for large graphs, the O(n^2) loop is replaced with the Barnes-Hut approximation
+    //
+    if (barnesHutTheta > 0 && (int)nodes.size() >= barnesHutMinNodes)
+        addBarnesHutRepulsion();
+    else {
+        for (i = nodes.begin(); i != nodes.end(); ++i) {
+            Node& n1 = *(*i);
+            if (n1.fixed)
                 continue;
 
-            double deltax = n1.x - n2.x;
-            double deltay = n1.y - n2.y;
-            double distsq = deltax * deltax + deltay * deltay;
-
-            // different colors repulse only up to 100 units, so that unconnected networks do not blow up
-            if (n1.color == n2.color || distsq < 100*100) {
-                if (distsq < 1.0) {
-                    // use 1.0 instead of distsq, to avoid division by (near) zero;
-                    // plus add random noise to help nodes mode aways from each other
-                    fx += deltax + privRand01()-0.5;
-                    fy += deltay + privRand01()-0.5;
-                }
-                else {
-                    fx += deltax / distsq;
-                    fy += deltay / distsq;
+            double fx = 0;
+            double fy = 0;
+
+            // TBD performance improvement: use (i=0..N, j=i+1..N) loop unless more than N/2 nodes are fixed
+            for (j = nodes.begin(); j != nodes.end(); ++j) {
+                if (i == j)
+                    continue;
+
+                Node& n2 = *(*j);
+                if (n1.anchor && n1.anchor == n2.anchor)
+                    continue;
+
+                double deltax = n1.x - n2.x;
+                double deltay = n1.y - n2.y;
+                double distsq = deltax * deltax + deltay * deltay;
+
+                // different colors repulse only up to 100 units, so that unconnected networks do not blow up
+                if (n1.color == n2.color || distsq < 100*100) {
+                    if (distsq < 1.0) {
+                        // use 1.0 instead of distsq, to avoid division by (near) zero;
+                        // plus add random noise to help nodes mode aways from each other
+                        fx += deltax + privRand01()-0.5;
+                        fy += deltay + privRand01()-0.5;
+                    }
+                    else {
+                        fx += deltax / distsq;
+                        fy += deltay / distsq;
+                    }
                 }
             }
-        }
 
-        n1.vx += repulsiveForce * fx;
-        n1.vy += repulsiveForce * fy;
+            n1.vx += repulsiveForce * fx;
+            n1.vy += repulsiveForce * fy;
+        }
     }
 
     if (debug) {
@@ -656,6 +665,102 @@ double BasicSpringEmbedderLayout::relax()
     return maxd;
 }
 
+void BasicSpringEmbedderLayout::addBarnesHutRepulsion()
+{
+    // Same as the loop in relax(), except that same-colored nodes far away are
+    // substituted with their center (using one tree per color), and nodes of
+    // other colors are collected with a range query. Nodes at (nearly) the same
+    // position are counted, and the random noise is added afterwards, so that
+    // privRand01() is only called from this thread.
+    int numNodes = nodes.size();
+    int numColors = 0;
+    std::vector<BarnesHutTree::Item> items(numNodes);
+    for (int i = 0; i < numNodes; i++) {
+        Node& n = *nodes[i];
+        items[i] = {n.x, n.y, 0, 1, i};
+        numColors = std::max(numColors, n.color + 1);
+    }
+    std::vector<std::vector<BarnesHutTree::Item>> colorItems(numColors);
+    for (int i = 0; i < numNodes; i++)
+        colorItems[nodes[i]->color].push_back(items[i]);
+    std::vector<BarnesHutTree> colorTrees(numColors);
+    for (int color = 0; color < numColors; color++)
+        colorTrees[color].build(colorItems[color]);
+    BarnesHutTree tree;
+    if (numColors > 1)
+        tree.build(items);
+
+    std::vector<double> fxs(numNodes, 0), fys(numNodes, 0);
+    std::vector<int> numCoincidingNodes(numNodes, 0);
+    runInParallel(numNodes, numThreads, 64, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            Node& n1 = *nodes[i];
+            if (n1.fixed)
+                continue;
+
+            double fx = 0;
+            double fy = 0;
+            int numCoinciding = 0;
+            auto addRepulsion = [&](const BarnesHutTree::Item& item, bool sameColor) {
+                Node& n2 = *nodes[item.index];
+                if (item.index == i || (n1.anchor && n1.anchor == n2.anchor))
+                    return;
+                double deltax = n1.x - n2.x;
+                double deltay = n1.y - n2.y;
+                double distsq = deltax * deltax + deltay * deltay;
+                if (sameColor || distsq < 100*100) {
+                    if (distsq < 1.0) {
+                        fx += deltax;
+                        fy += deltay;
+                        numCoinciding++;
+                    }
+                    else {
+                        fx += deltax / distsq;
+                        fy += deltay / distsq;
+                    }
+                }
+            };
+
+            colorTrees[n1.color].visit(n1.x, n1.y, 0, barnesHutTheta, -1,
+                [&](const BarnesHutTree::Item& item) {addRepulsion(item, true);},
+                [&](const BarnesHutTree::Cell& cell) {
+                    double deltax = n1.x - cell.x;
+                    double deltay = n1.y - cell.y;
+                    double distsq = deltax * deltax + deltay * deltay;
+                    if (distsq < 1.0)
+                        return false;
+                    fx += cell.weight * deltax / distsq;
+                    fy += cell.weight * deltay / distsq;
+                    return true;
+                });
+
+            if (numColors > 1)
+                tree.visit(n1.x, n1.y, 0, 0, 100,
+                    [&](const BarnesHutTree::Item& item) {
+                        if (nodes[item.index]->color != n1.color)
+                            addRepulsion(item, false);
+                    },
+                    [](const BarnesHutTree::Cell& cell) {return false;});
+
+            fxs[i] = fx;
+            fys[i] = fy;
+            numCoincidingNodes[i] = numCoinciding;
+        }
+    });
+
+    for (int i = 0; i < numNodes; i++) {
+        Node& n1 = *nodes[i];
+        if (n1.fixed)
+            continue;
+        for (int k = 0; k < numCoincidingNodes[i]; k++) {
+            fxs[i] += privRand01()-0.5;
+            fys[i] += privRand01()-0.5;
+        }
+        n1.vx += repulsiveForce * fxs[i];
+        n1.vy += repulsiveForce * fys[i];
+    }
+}
+
 void BasicSpringEmbedderLayout::debugDraw(int step)
 {
     if (step % 5 != 0)
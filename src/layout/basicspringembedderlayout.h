@@ -92,6 +92,10 @@ class LAYOUT_API BasicSpringEmbedderLayout : public GraphLayouter
     double repulsiveForce = 50;
     double attractionForce = 0.3;
 
+    double barnesHutTheta = 0.7;  // repulsion is approximated with the Barnes-Hut algorithm if positive
+    int barnesHutMinNodes = 1000; // ...and there are at least this many nodes
+    int numThreads = 0;           // for Barnes-Hut; 0 means the number of hardware threads
+
   protected:
     // utility
     Node *findNode(int nodeId);
@@ -114,6 +118,9 @@ class LAYOUT_API BasicSpringEmbedderLayout : public GraphLayouter
     // main algorithm (modified spring embedder)
     virtual double relax();
 
+    // node repulsion part of relax(), with the Barnes-Hut approximation
+    virtual void addBarnesHutRepulsion();
+
     // for debugging: draw whole thing in a window
     void debugDraw(int step);
 
@@ -168,6 +175,18 @@ class LAYOUT_API BasicSpringEmbedderLayout : public GraphLayouter
 #endif
         attractionForce = force;
     }
+    void setBarnesHutTheta(double theta) {
+#ifdef TRACE_LAYOUTER
+        TRACE_CALL("BasicSpringEmbedderLayout::setBarnesHutTheta(theta: %g)", theta);
+#endif
+        barnesHutTheta = theta;
+    }
+    void setNumThreads(int threads) {
+#ifdef TRACE_LAYOUTER
+        TRACE_CALL("BasicSpringEmbedderLayout::setNumThreads(threads: %d)", threads);
+#endif
+        numThreads = threads;
+    }
 };
 
 }  // namespace layout
@@ -68,6 +68,11 @@ void ForceDirectedGraphLayouter::setParameters()
     preEmbedding = environment->getBoolParameter("pe", 0, privRand01() < 0.5);
     forceDirectedEmbedding = environment->getBoolParameter("fde", 0, true);
 
+    // electric repulsion approximation
+    barnesHutTheta = environment->getDoubleParameter("bht", 0, 0.7);
+    barnesHutMinBodies = environment->getLongParameter("bhmb", 0, 500);
+    numThreads = environment->getLongParameter("nt", 0, 0);
+
     // debug parameters
     debugWaitTime = environment->getDoubleParameter("dwt", 0, 0);
     showForces = environment->getBoolParameter("sf", 0, false);
@@ -247,6 +252,26 @@ void ForceDirectedGraphLayouter::setBorderPositions()
 void ForceDirectedGraphLayouter::addElectricRepulsions()
 {
     const std::vector<IBody *>& bodies = embedding.getBodies();
+    int numBodies = 0;
+    for (auto body : bodies)
+        if (!dynamic_cast<WallBody *>(body))
+            numBodies++;
+
+    if (barnesHutTheta > 0 && numBodies >= barnesHutMinBodies) {
+        BarnesHutElectricRepulsion *repulsion = new BarnesHutElectricRepulsion(barnesHutTheta, numThreads, expectedEdgeLength / 2, expectedEdgeLength);
+        std::map<GraphComponent *, int> componentIndices;
+        for (auto body : bodies) {
+            if (!dynamic_cast<WallBody *>(body)) {
+                Vertex *vertex = graphComponent.findVertex(body->getVariable());
+                Assert(vertex);
+                auto it = componentIndices.insert(std::make_pair(vertex->connectedSubComponent, (int)componentIndices.size())).first;
+                repulsion->addBody(body, it->second);
+            }
+        }
+        embedding.addForceProvider(repulsion);
+        return;
+    }
+
     for (int i = 0; i < (int)bodies.size(); i++)
         for (int j = i + 1; j < (int)bodies.size(); j++) {
             IBody *body1 = bodies[i];
@@ -86,6 +86,19 @@ class LAYOUT_API ForceDirectedGraphLayouter : public GraphLayouter
     double threeDFactor;
     double threeDCoefficient;
 
+    /**
+     * Electric repulsions are approximated with the Barnes-Hut algorithm (see
+     * BarnesHutElectricRepulsion) if theta is positive and there are at least
+     * barnesHutMinBodies bodies; otherwise each pair gets an ElectricRepulsion.
+     */
+    double barnesHutTheta;
+    int barnesHutMinBodies;
+
+    /**
+     * Number of threads used for calculating Barnes-Hut repulsions, 0 means the number of hardware threads.
+     */
+    int numThreads;
+
     /**
      * Various measures calculated before the actual layout.
      */
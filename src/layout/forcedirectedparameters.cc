@@ -17,6 +17,167 @@
 namespace omnetpp {
 namespace layout {
 
+BarnesHutElectricRepulsion::BarnesHutElectricRepulsion(double theta, int numThreads, double componentLinearityDistance, double componentMaxDistance) : AbstractForceProvider(-1)
+{
+    Assert(componentMaxDistance >= 0);
+    this->theta = theta;
+    this->numThreads = numThreads;
+    this->componentLinearityDistance = componentLinearityDistance;
+    this->componentMaxDistance = componentMaxDistance;
+    linearityDistance = -1;
+    maxDistance = -1;
+    maxBodyRadius = 0;
+}
+
+void BarnesHutElectricRepulsion::addBody(IBody *body, int componentIndex)
+{
+    Assert(componentIndex >= 0);
+    Charge charge;
+    charge.body = body;
+    charge.componentIndex = componentIndex;
+    charge.variable = body->getVariable();
+    charge.charge = 0;
+    charges.push_back(charge);
+    if (componentIndex >= (int)componentTrees.size())
+        componentTrees.resize(componentIndex + 1);
+}
+
+void BarnesHutElectricRepulsion::reinitialize()
+{
+    AbstractForceProvider::reinitialize();
+    linearityDistance = embedding->parameters.defaultElectricRepulsionLinearityDistance;
+    maxDistance = embedding->parameters.defaultElectricRepulsionMaxDistance;
+}
+
+void BarnesHutElectricRepulsion::buildTrees()
+{
+    // take a snapshot of the bodies, so that the (possibly multi-threaded) calculation
+    // does not call into them (e.g. RelativelyPositionedBody computes its position on the fly)
+    std::vector<std::vector<BarnesHutTree::Item>> componentItems(componentTrees.size());
+    std::vector<BarnesHutTree::Item> items;
+    items.reserve(charges.size());
+    maxBodyRadius = 0;
+    for (int i = 0; i < (int)charges.size(); i++) {
+        Charge& charge = charges[i];
+        charge.position = charge.body->getPosition();
+        charge.size = charge.body->getSize();
+        charge.charge = charge.body->getCharge();
+        maxBodyRadius = std::max(maxBodyRadius, sqrt(charge.size.width * charge.size.width + charge.size.height * charge.size.height) / 2);
+        BarnesHutTree::Item item = {charge.position.x, charge.position.y, charge.position.z, charge.charge, i};
+        componentItems[charge.componentIndex].push_back(item);
+        items.push_back(item);
+    }
+    for (int i = 0; i < (int)componentTrees.size(); i++)
+        componentTrees[i].build(componentItems[i]);
+    tree.build(items);
+}
+
+double BarnesHutElectricRepulsion::getPower(double distance, double charge1, double charge2, double linearityDistance, double maxDistance)
+{
+    double power;
+    if (distance == 0)
+        power = maxForce;
+    else
+        power = std::min(maxForce, embedding->parameters.electricRepulsionCoefficient * charge1 * charge2 / distance / distance);
+
+    if (linearityDistance != -1 && distance > linearityDistance)
+        power *= 1 - std::min(1.0, (distance - linearityDistance) / (maxDistance - linearityDistance));
+
+    return power;
+}
+
+Pt BarnesHutElectricRepulsion::getForce(const Charge& charge)
+{
+    Pt force = Pt::getZero();
+    const Pt& position = charge.position;
+    auto addForce = [&](const Charge& other, double linearityDistance, double maxDistance) {
+        double distance;
+        Pt vector = getDistanceAndVector(position, charge.size, other.position, other.size, distance);
+        vector.multiply(getPower(distance, charge.charge, other.charge, linearityDistance, maxDistance));
+        if (vector.isFullySpecified())
+            force.add(vector);
+    };
+
+    // body sizes may reduce the distance of bodies compared to their centers
+    double margin = pointLikeDistance && !slippery ? 0 : 2 * maxBodyRadius;
+
+    // same component: Barnes-Hut approximation
+    componentTrees[charge.componentIndex].visit(position.x, position.y, position.z, theta, maxDistance == -1 ? -1 : maxDistance + margin,
+        [&](const BarnesHutTree::Item& item) {
+            const Charge& other = charges[item.index];
+            if (other.variable != charge.variable)
+                addForce(other, linearityDistance, maxDistance);
+        },
+        [&](const BarnesHutTree::Cell& cell) {
+            Pt vector = Pt(position).subtract(Pt(cell.x, cell.y, cell.z));
+            double distance = vector.getLength();
+            vector.divide(distance);
+            // the force of a single body is limited by maxForce, and so is the average of the cell
+            double power = cell.numItems * getPower(distance, charge.charge, cell.weight / cell.numItems, linearityDistance, maxDistance);
+            vector.multiply(power);
+            if (!vector.isFullySpecified())
+                return false;
+            force.add(vector);
+            return true;
+        });
+
+    // other components: exact calculation within the max distance
+    if (componentTrees.size() > 1)
+        tree.visit(position.x, position.y, position.z, 0, componentMaxDistance + margin,
+            [&](const BarnesHutTree::Item& item) {
+                const Charge& other = charges[item.index];
+                if (other.componentIndex != charge.componentIndex)
+                    addForce(other, componentLinearityDistance, componentMaxDistance);
+            },
+            [](const BarnesHutTree::Cell& cell) {return false;});
+
+    return force;
+}
+
+void BarnesHutElectricRepulsion::applyForces()
+{
+    buildTrees();
+    runInParallel(charges.size(), numThreads, 256, [this](int begin, int end) {
+        for (int i = begin; i < end; i++)
+            charges[i].force = getForce(charges[i]);
+    });
+    for (auto& charge : charges)
+        charge.variable->addForce(charge.force);
+}
+
+double BarnesHutElectricRepulsion::getPotentialEnergy()
+{
+    buildTrees();
+    double coefficient = embedding->parameters.electricRepulsionCoefficient;
+    std::vector<double> energies(charges.size());
+    runInParallel(charges.size(), numThreads, 256, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            const Charge& charge = charges[i];
+            double energy = 0;
+            tree.visit(charge.position.x, charge.position.y, charge.position.z, theta, -1,
+                [&](const BarnesHutTree::Item& item) {
+                    const Charge& other = charges[item.index];
+                    if (other.variable != charge.variable) {
+                        double distance;
+                        getDistanceAndVector(charge.position, charge.size, other.position, other.size, distance);
+                        energy += coefficient * charge.charge * other.charge / distance;
+                    }
+                },
+                [&](const BarnesHutTree::Cell& cell) {
+                    double distance = Pt(charge.position).subtract(Pt(cell.x, cell.y, cell.z)).getLength();
+                    if (distance == 0)
+                        return false;
+                    energy += coefficient * charge.charge * cell.weight / distance;
+                    return true;
+                });
+            energies[i] = energy;
+        }
+    });
+    double energy = 0;
+    for (double e : energies)
+        energy += e;
+    return energy / 2;  // each pair was counted twice
+}
+
 }  // namespace layout
 }  // namespace omnetpp
-
@@ -17,6 +17,7 @@
 
 #include <cmath>
 #include "geometry.h"
+#include "barneshuttree.h"
 #include "forcedirectedparametersbase.h"
 #include "forcedirectedembedding.h"
 
@@ -233,16 +234,23 @@ class AbstractForceProvider : public IForceProvider {
                 return getStandardDistanceAndVector(body1, body2, distance);
         }
 
+        Pt getDistanceAndVector(const Pt& pt1, const Rs& rs1, const Pt& pt2, const Rs& rs2, double &distance) {
+            if (slippery)
+                return getSlipperyDistanceAndVector(pt1, rs1, pt2, rs2, distance);
+            else
+                return getStandardDistanceAndVector(pt1, rs1, pt2, rs2, distance);
+        }
+
         Pt getStandardDistanceAndVector(IBody *body1, IBody *body2, double &distance) {
-            const Pt& pt1 = body1->getPosition();
-            const Pt& pt2 = body2->getPosition();
+            return getStandardDistanceAndVector(body1->getPosition(), body1->getSize(), body2->getPosition(), body2->getSize(), distance);
+        }
+
+        Pt getStandardDistanceAndVector(const Pt& pt1, const Rs& rs1, const Pt& pt2, const Rs& rs2, double &distance) {
             Pt vector = Pt(pt1).subtract(pt2);
             distance = vector.getLength();
             vector.divide(distance);
 
             if (!pointLikeDistance) {
-                const Rs& rs1 = body1->getSize();
-                const Rs& rs2 = body2->getSize();
                 double dx = fabs(pt1.x - pt2.x);
                 double dy = fabs(pt1.y - pt2.y);
                 double dHalf = vector.getBasePlaneProjectionLength() / 2;
@@ -278,8 +286,12 @@ class AbstractForceProvider : public IForceProvider {
         }
 
         Pt getSlipperyDistanceAndVector(IBody *body1, IBody *body2, double &distance) {
-            Rc rc1 = Rc::getRcFromCenterSize(body1->getPosition(), body1->getSize());
-            Rc rc2 = Rc::getRcFromCenterSize(body2->getPosition(), body2->getSize());
+            return getSlipperyDistanceAndVector(body1->getPosition(), body1->getSize(), body2->getPosition(), body2->getSize(), distance);
+        }
+
+        Pt getSlipperyDistanceAndVector(const Pt& pt1, const Rs& rs1, const Pt& pt2, const Rs& rs2, double &distance) {
+            Rc rc1 = Rc::getRcFromCenterSize(pt1, rs1);
+            Rc rc2 = Rc::getRcFromCenterSize(pt2, rs2);
             Ln ln = rc1.getBasePlaneProjectionDistance(rc2, distance);
             Pt vector = ln.begin;
             vector.subtract(ln.end);
@@ -419,6 +431,76 @@ class HorizontalElectricRepulsion : public AbstractElectricRepulsion {
         }
 };
 
+/**
+ * Electric repulsion among all pairs of a set of bodies, approximated with the
+ * Barnes-Hut algorithm in O(n log n) time, instead of adding O(n^2) ElectricRepulsion
+ * instances. Bodies are grouped into components: bodies in the same component repulse
+ * each other like ElectricRepulsion with the default parameters, while bodies in different
+ * components repulse each other with the given linearity and max distance. Since the
+ * latter force vanishes beyond the max distance, it is calculated exactly for the bodies
+ * within that range. Bodies sharing the same variable do not repulse each other.
+ *
+ * Theta controls the accuracy: a group of distant bodies is substituted with its
+ * center of charge if the extent of the group divided by its distance is less than
+ * theta. Zero theta gives the exact result. Forces of the bodies are calculated
+ * on numThreads threads (0 means the number of hardware threads).
+ */
+class BarnesHutElectricRepulsion : public AbstractForceProvider {
+    protected:
+        struct Charge {
+            IBody *body;
+            int componentIndex;
+            Variable *variable;
+            Pt position;
+            Rs size;
+            double charge;
+            Pt force;
+        };
+
+        double theta;
+
+        int numThreads;
+
+        double componentLinearityDistance;
+
+        double componentMaxDistance;
+
+        double linearityDistance;
+
+        double maxDistance;
+
+        std::vector<Charge> charges;
+
+        std::vector<BarnesHutTree> componentTrees;
+
+        BarnesHutTree tree;
+
+        double maxBodyRadius;
+
+    public:
+        BarnesHutElectricRepulsion(double theta, int numThreads, double componentLinearityDistance, double componentMaxDistance);
+
+        /**
+         * Adds a body. Bodies with the same componentIndex belong to the same component.
+         */
+        void addBody(IBody *body, int componentIndex);
+
+        virtual void reinitialize() override;
+
+        virtual const char *getClassName() override {
+            return "BarnesHutElectricRepulsion";
+        }
+
+        virtual void applyForces() override;
+
+        virtual double getPotentialEnergy() override;
+
+    protected:
+        virtual void buildTrees();
+        virtual Pt getForce(const Charge& charge);
+        double getPower(double distance, double charge1, double charge2, double linearityDistance, double maxDistance);
+};
+
 /**
  * An attractive force which increases in a linear way proportional to the distance of the bodies.
  * Abstract base class for spring attractive forces.
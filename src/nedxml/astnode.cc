@@ -123,6 +123,17 @@ ASTNode *ASTNode::dupTree() const
     return newNode;
 }
 
+void ASTNode::adoptTreeIntoCurrentThread()
+{
+    id = ++lastId;
+    numCreated++;
+    numExisting++;
+    srcLoc.file = opp_staticpooledstring(srcLoc.file.c_str());
+    directory = opp_staticpooledstring(directory.c_str());
+    for (ASTNode *child = getFirstChild(); child; child = child->getNextSibling())
+        child->adoptTreeIntoCurrentThread();
+}
+
 void ASTNode::applyDefaults()
 {
     int n = getNumAttributes();
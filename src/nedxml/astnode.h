@@ -138,6 +138,14 @@ class NEDXML_API ASTNode
      * Recursive version of dup(): duplicates the whole subtree.
      */
     virtual ASTNode *dupTree() const;
+
+    /**
+     * Assigns new IDs to the nodes of the subtree, and moves their strings
+     * into the current thread's string pool. This is needed for using a tree
+     * that was built in another thread, as both are thread-local. Must be
+     * called before the other thread exits.
+     */
+    virtual void adoptTreeIntoCurrentThread();
     //@}
 
     /** @name Common properties */
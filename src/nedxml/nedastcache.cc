@@ -0,0 +1,344 @@
+//==========================================================================
+// NEDASTCACHE.CC -
+//
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2002-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "omnetpp/platdep/platmisc.h"
+#include "common/fileutil.h"
+#include "common/stringutil.h"
+#include "exception.h"
+#include "nedastcache.h"
+#include "nedelements.h"
+
+using namespace omnetpp::common;
+
+namespace omnetpp {
+namespace nedxml {
+
+#define NEDAST_MAGIC           "OPPNAST\n"
+#define NEDAST_VERSION         1
+#define NEDAST_BYTEORDERMARK   0x01020304
+
+namespace {
+
+uint64_t fnv1a(const char *data, size_t size, uint64_t hash=14695981039346656037ULL)
+{
+    for (size_t i = 0; i < size; i++) {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t fnv1aString(const char *s, uint64_t hash)
+{
+    return fnv1a(s, strlen(s)+1, hash);
+}
+
+// hash of the element types and their attributes, so that cache files
+// written by a different version of the NED AST are not used
+uint64_t getSchemaHash()
+{
+    static const uint64_t schemaHash = [] {
+        NedAstNodeFactory factory;
+        uint64_t hash = fnv1aString(NEDAST_MAGIC, 0);
+        for (int tag = NED_NULL+1; tag < NED_UNKNOWN; tag++) {
+            ASTNode *node = factory.createElementWithTag(tag);
+            hash = fnv1aString(node->getTagName(), hash);
+            for (int i = 0; i < node->getNumAttributes(); i++)
+                hash = fnv1aString(node->getAttributeName(i), hash);
+            delete node;
+        }
+        return hash;
+    }();
+    return schemaHash;
+}
+
+class Writer
+{
+  private:
+    std::string& buffer;
+  public:
+    Writer(std::string& buffer) : buffer(buffer) {}
+    template<typename T> void write(T value) {buffer.append((const char *)&value, sizeof(T));}
+    void writeString(const char *s) {size_t len = strlen(s); write<uint32_t>(len); buffer.append(s, len+1);}
+};
+
+class Reader
+{
+  private:
+    const char *p;
+    const char *end;
+  public:
+    Reader(const char *data, size_t size) : p(data), end(data+size) {}
+    void check(size_t size) {if ((size_t)(end-p) < size) throw NedException("Truncated data");}
+    template<typename T> T read() {check(sizeof(T)); T value; memcpy(&value, p, sizeof(T)); p += sizeof(T); return value;}
+    const char *readString() {
+        uint32_t len = read<uint32_t>();
+        check(len+1);
+        const char *s = p;
+        if (s[len] != 0)
+            throw NedException("Malformed string");
+        p += len+1;
+        return s;
+    }
+    const char *getPosition() const {return p;}
+    size_t getRemainingSize() const {return end-p;}
+};
+
+class StringTable
+{
+  private:
+    std::map<std::string,uint32_t> indices;
+    std::vector<const char *> strings;
+  public:
+    uint32_t indexOf(const char *s) {
+        auto it = indices.find(s);
+        if (it != indices.end())
+            return it->second;
+        uint32_t index = strings.size();
+        it = indices.insert(std::make_pair(std::string(s), index)).first;
+        strings.push_back(it->first.c_str());
+        return index;
+    }
+    const std::vector<const char *>& getStrings() const {return strings;}
+};
+
+bool serializeNode(ASTNode *node, StringTable& stringTable, Writer& out, uint32_t& numNodes)
+{
+    int tag = node->getTagCode();
+    if (tag <= NED_NULL || tag >= NED_UNKNOWN)
+        return false;
+    int numAttributes = node->getNumAttributes();
+    out.write<uint16_t>(tag);
+    out.write<uint16_t>(numAttributes);
+    FileLine loc = node->getSourceLocation();
+    out.write<uint32_t>(stringTable.indexOf(loc.file.c_str() ? loc.file.c_str() : ""));
+    out.write<int32_t>(loc.line);
+    const SourceRegion& region = node->getSourceRegion();
+    out.write<int32_t>(region.startLine);
+    out.write<int32_t>(region.startColumn);
+    out.write<int32_t>(region.endLine);
+    out.write<int32_t>(region.endColumn);
+    for (int i = 0; i < numAttributes; i++)
+        out.write<uint32_t>(stringTable.indexOf(node->getAttribute(i)));
+    uint32_t numChildren = 0;
+    for (ASTNode *child = node->getFirstChild(); child; child = child->getNextSibling())
+        numChildren++;
+    out.write<uint32_t>(numChildren);
+    numNodes++;
+    for (ASTNode *child = node->getFirstChild(); child; child = child->getNextSibling())
+        if (!serializeNode(child, stringTable, out, numNodes))
+            return false;
+    return true;
+}
+
+ASTNode *deserializeNode(NedAstNodeFactory& factory, const std::vector<const char *>& strings, Reader& in, int depth)
+{
+    auto getString = [&strings](uint32_t index) {
+        if (index >= strings.size())
+            throw NedException("String index out of range");
+        return strings[index];
+    };
+
+    if (depth > 1000)
+        throw NedException("Tree too deep");
+    int tag = in.read<uint16_t>();
+    int numAttributes = in.read<uint16_t>();
+    if (tag <= NED_NULL || tag >= NED_UNKNOWN)
+        throw NedException("Invalid tag code");
+    ASTNode *node = factory.createElementWithTag(tag);
+    try {
+        if (node->getNumAttributes() != numAttributes)
+            throw NedException("Attribute count mismatch");
+        const char *file = getString(in.read<uint32_t>());
+        int line = in.read<int32_t>();
+        node->setSourceLocation(FileLine(file, line));
+        SourceRegion region;
+        region.startLine = in.read<int32_t>();
+        region.startColumn = in.read<int32_t>();
+        region.endLine = in.read<int32_t>();
+        region.endColumn = in.read<int32_t>();
+        node->setSourceRegion(region);
+        for (int i = 0; i < numAttributes; i++)
+            node->setAttribute(i, getString(in.read<uint32_t>()));
+        uint32_t numChildren = in.read<uint32_t>();
+        for (uint32_t i = 0; i < numChildren; i++)
+            node->appendChild(deserializeNode(factory, strings, in, depth+1));
+    }
+    catch (std::exception&) {
+        delete node;
+        throw;
+    }
+    return node;
+}
+
+}  // namespace
+
+bool NedAstCache::serialize(ASTNode *tree, std::string& buffer)
+{
+    StringTable stringTable;
+    std::string nodesBuffer;
+    Writer nodesOut(nodesBuffer);
+    uint32_t numNodes = 0;
+    if (!serializeNode(tree, stringTable, nodesOut, numNodes))
+        return false;
+
+    Writer out(buffer);
+    out.write<uint32_t>(stringTable.getStrings().size());
+    for (const char *s : stringTable.getStrings())
+        out.writeString(s);
+    out.write<uint32_t>(numNodes);
+    buffer += nodesBuffer;
+    return true;
+}
+
+ASTNode *NedAstCache::deserialize(const char *data, size_t size)
+{
+    Reader in(data, size);
+    uint32_t numStrings = in.read<uint32_t>();
+    if (numStrings > size)
+        throw NedException("Invalid string count");
+    std::vector<const char *> strings;
+    strings.reserve(numStrings);
+    for (uint32_t i = 0; i < numStrings; i++)
+        strings.push_back(in.readString());  // point into the data, no copying
+    in.read<uint32_t>();  // numNodes, informational
+    NedAstNodeFactory factory;
+    ASTNode *tree = deserializeNode(factory, strings, in, 0);
+    if (in.getRemainingSize() != 0) {
+        delete tree;
+        throw NedException("Trailing garbage after tree");
+    }
+    return tree;
+}
+
+NedAstCache::NedAstCache(const char *cacheDir) : cacheDir(cacheDir)
+{
+}
+
+std::string NedAstCache::getCacheFileName(const FileKey& key) const
+{
+    return concatDirAndFile(cacheDir.c_str(), opp_stringf("%016llx.nedast", (unsigned long long)fnv1a(key.fileName.data(), key.fileName.size())).c_str());
+}
+
+static bool readFile(const char *fileName, std::string& content)
+{
+    std::ifstream in(fileName, std::ios::in | std::ios::binary);
+    if (!in)
+        return false;
+    std::ostringstream out;
+    out << in.rdbuf();
+    if (in.bad())
+        return false;
+    content = out.str();
+    return true;
+}
+
+NedAstCache::FileKey NedAstCache::makeKey(const char *fileName) const
+{
+    FileKey key;
+    key.fileName = fileName;
+    struct opp_stat_t s;
+    std::string content;
+    if (opp_stat(fileName, &s) != 0 || !readFile(fileName, content))
+        return key;  // invalid
+    key.lastModified = (int64_t)s.st_mtime;
+    key.fileSize = content.size();
+    key.contentHash = fnv1a(content.data(), content.size());
+    return key;
+}
+
+NedFileElement *NedAstCache::load(const FileKey& key) const
+{
+    if (!key.isValid())
+        return nullptr;
+    std::string data;
+    if (!readFile(getCacheFileName(key).c_str(), data))
+        return nullptr;
+
+    try {
+        Reader in(data.data(), data.size());
+        in.check(8);
+        if (memcmp(in.getPosition(), NEDAST_MAGIC, 8) != 0)
+            return nullptr;
+        in.read<uint64_t>();
+        if (in.read<uint32_t>() != NEDAST_VERSION || in.read<uint32_t>() != NEDAST_BYTEORDERMARK || in.read<uint64_t>() != getSchemaHash())
+            return nullptr;
+        if (in.read<int64_t>() != key.lastModified || in.read<int64_t>() != key.fileSize || in.read<uint64_t>() != key.contentHash)
+            return nullptr;
+        if (key.fileName != in.readString())
+            return nullptr;  // hash collision of file names
+        ASTNode *tree = deserialize(in.getPosition(), in.getRemainingSize());
+        NedFileElement *nedFileElement = dynamic_cast<NedFileElement *>(tree);
+        if (!nedFileElement)
+            delete tree;
+        return nedFileElement;
+    }
+    catch (std::exception&) {
+        return nullptr;  // treat malformed cache files as missing
+    }
+}
+
+void NedAstCache::store(const FileKey& key, NedFileElement *tree) const
+{
+    if (!key.isValid())
+        return;
+
+    std::string data;
+    Writer out(data);
+    data.append(NEDAST_MAGIC, 8);
+    out.write<uint32_t>(NEDAST_VERSION);
+    out.write<uint32_t>(NEDAST_BYTEORDERMARK);
+    out.write<uint64_t>(getSchemaHash());
+    out.write<int64_t>(key.lastModified);
+    out.write<int64_t>(key.fileSize);
+    out.write<uint64_t>(key.contentHash);
+    out.writeString(key.fileName.c_str());
+    if (!serialize(tree, data))
+        return;
+
+    // write to a temp file then rename, so that concurrent readers never see partial files
+    try {
+        mkPath(cacheDir.c_str());
+        std::string fileName = getCacheFileName(key);
+        std::string tmpFileName = opp_stringf("%s.%d.%llx.tmp", fileName.c_str(), (int)getpid(), (unsigned long long)std::hash<std::thread::id>()(std::this_thread::get_id()));
+        FILE *f = fopen(tmpFileName.c_str(), "wb");
+        if (!f)
+            return;
+        bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+        ok = (fclose(f) == 0) && ok;
+        if (ok) {
+#ifdef _WIN32
+            ::remove(fileName.c_str());  // rename() does not overwrite on Windows
+#endif
+            ok = ::rename(tmpFileName.c_str(), fileName.c_str()) == 0;
+        }
+        if (!ok)
+            ::remove(tmpFileName.c_str());
+    }
+    catch (std::exception&) {
+        // ignore, the cache is only an optimization
+    }
+}
+
+}  // namespace nedxml
+}  // namespace omnetpp
@@ -0,0 +1,112 @@
+//==========================================================================
+// NEDASTCACHE.H -
+//
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2002-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+
+#ifndef __OMNETPP_NEDXML_NEDASTCACHE_H
+#define __OMNETPP_NEDXML_NEDASTCACHE_H
+
+#include <cstdint>
+#include <string>
+#include "nedxmldefs.h"
+
+namespace omnetpp {
+namespace nedxml {
+
+class ASTNode;
+class NedFileElement;
+
+/**
+ * @brief On-disk cache of parsed and validated NED files.
+ *
+ * Each NED file is stored in a separate cache file in the cache directory,
+ * in a compact binary serialization of its AST. A cache file is only used
+ * if the name, modification time, size and content hash of the NED file
+ * match the ones recorded in it, and it was written with the same AST
+ * schema (set of element types and attributes). Cache files are written
+ * atomically (to a temp file which is then renamed), so several processes
+ * may share the same cache directory.
+ *
+ * Methods are thread-safe, as the object has no mutable state.
+ *
+ * @ingroup NedResources
+ */
+class NEDXML_API NedAstCache
+{
+  public:
+    /**
+     * Identifies a particular version of a NED file.
+     */
+    struct FileKey {
+        std::string fileName;
+        int64_t lastModified = -1;
+        int64_t fileSize = -1;
+        uint64_t contentHash = 0;
+        bool isValid() const {return fileSize != -1;}
+    };
+
+  private:
+    std::string cacheDir;
+
+  private:
+    std::string getCacheFileName(const FileKey& key) const;
+
+  public:
+    /**
+     * Constructor. The cache directory is created on demand.
+     */
+    explicit NedAstCache(const char *cacheDir);
+
+    /**
+     * Returns the cache directory.
+     */
+    const char *getCacheDir() const {return cacheDir.c_str();}
+
+    /**
+     * Returns the key for the current contents of the given file. The
+     * returned key is invalid if the file cannot be read.
+     */
+    FileKey makeKey(const char *fileName) const;
+
+    /**
+     * Returns the tree stored for the given key, or nullptr if there is no
+     * up-to-date cache file for it (or it cannot be read).
+     */
+    NedFileElement *load(const FileKey& key) const;
+
+    /**
+     * Stores the tree for the given key. Errors are silently ignored,
+     * as the cache is merely an optimization.
+     */
+    void store(const FileKey& key, NedFileElement *tree) const;
+
+    /**
+     * Appends the binary serialization of the given tree to the buffer.
+     * Returns false if the tree contains nodes that cannot be serialized.
+     */
+    static bool serialize(ASTNode *tree, std::string& buffer);
+
+    /**
+     * Recreates a tree from its binary serialization. Throws an exception
+     * if the data is malformed.
+     */
+    static ASTNode *deserialize(const char *data, size_t size);
+};
+
+}  // namespace nedxml
+}  // namespace omnetpp
+
+
+#endif
@@ -14,8 +14,14 @@
   `license' for details on this and other legal matters.
 *--------------------------------------------------------------*/
 
+#include <algorithm>
+#include <condition_variable>
 #include <cstdio>
 #include <cstring>
+#include <exception>
+#include <functional>
+#include <set>
+#include <thread>
 #include "common/fileutil.h"
 #include "common/stringutil.h"
 #include "common/stlutil.h"
@@ -25,6 +31,7 @@
 #include "common/stringtokenizer.h"
 #include "exception.h"
 #include "nedresourcecache.h"
+#include "nedastcache.h"
 
 #include "errorstore.h"
 #include "nedparser.h"
@@ -52,6 +59,19 @@ NedResourceCache::~NedResourceCache()
         delete file.second;
     for (auto & nedType : nedTypes)
         delete nedType.second;
+    delete astCache;
+}
+
+void NedResourceCache::setAstCacheDir(const char *dir)
+{
+    LOCK;
+    delete astCache;
+    astCache = opp_isempty(dir) ? nullptr : new NedAstCache(dir);
+}
+
+const char *NedResourceCache::getAstCacheDir() const
+{
+    return astCache ? astCache->getCacheDir() : nullptr;
 }
 
 void NedResourceCache::registerBuiltinDeclarations()
@@ -108,11 +128,20 @@ int NedResourceCache::doLoadNedSourceFolder(const char *folderName, const char *
 {
     LOCK;
 
+    std::vector<NedFileToLoad> files;
+    collectNedSourceFolderFiles(folderName, expectedPackage, excludedPackages, files);
+    loadNedSourceFolderFiles(files);
+    return files.size();
+}
+
+void NedResourceCache::collectNedSourceFolderFiles(const char *folderName, const char *expectedPackage, const std::vector<std::string>& excludedPackages, std::vector<NedFileToLoad>& result)
+{
+    LOCK;
+
     if (!opp_isempty(expectedPackage) && contains(excludedPackages, std::string(expectedPackage)))  // note: the root package "" cannot be excluded
-        return 0;
+        return;
 
     PushDir pushDir(folderName);
-    int count = 0;
 
     FileGlobber globber("*");
     const char *filename;
@@ -121,14 +150,144 @@ int NedResourceCache::doLoadNedSourceFolder(const char *folderName, const char *
             continue;  // ignore ".", "..", and dotfiles
         }
         if (isDirectory(filename)) {
-            count += doLoadNedSourceFolder(filename, expectedPackage == nullptr ? nullptr : opp_join(".", expectedPackage, filename).c_str(), excludedPackages);
+            collectNedSourceFolderFiles(filename, expectedPackage == nullptr ? nullptr : opp_join(".", expectedPackage, filename).c_str(), excludedPackages, result);
         }
         else if (opp_stringendswith(filename, ".ned")) {
-            doLoadNedFileOrText(filename, nullptr, expectedPackage, false);
-            count++;
+            result.push_back(NedFileToLoad{canonicalize(filename), opp_nulltoempty(expectedPackage), expectedPackage != nullptr});
+        }
+    }
+}
+
+namespace {
+
+/**
+ * Parses a list of NED files on a number of threads. Results can be taken
+ * in order; taking a result blocks until that file has been parsed.
+ * Parsed trees are adopted into the calling thread (see ASTNode::adoptTreeIntoCurrentThread()),
+ * which requires the worker threads to stay alive until then, so they only
+ * exit when the object is destroyed.
+ */
+class ParallelNedFileParser
+{
+  public:
+    typedef std::function<NedFileElement*(const char *fileName)> ParseFunction;
+
+  private:
+    struct Result {
+        NedFileElement *tree = nullptr;
+        std::exception_ptr error;
+        bool done = false;
+    };
+    const std::vector<std::string>& fileNames;
+    ParseFunction parse;
+    std::vector<Result> results;
+    size_t nextToParse = 0;
+    size_t nextToTake = 0;
+    bool finishing = false;
+    std::mutex mutex;
+    std::condition_variable resultDone;
+    std::condition_variable finished;
+    std::vector<std::thread> threads;
+
+  private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!finishing && nextToParse < fileNames.size()) {
+            size_t index = nextToParse++;
+            lock.unlock();
+            Result result;
+            try {
+                result.tree = parse(fileNames[index].c_str());
+            }
+            catch (...) {
+                result.error = std::current_exception();
+            }
+            result.done = true;
+            lock.lock();
+            results[index] = result;
+            resultDone.notify_all();
+        }
+        finished.wait(lock, [this] {return finishing;});  // keep thread-local string pool alive
+    }
+
+  public:
+    ParallelNedFileParser(const std::vector<std::string>& fileNames, ParseFunction parse, int numThreads) :
+            fileNames(fileNames), parse(parse), results(fileNames.size()) {
+        for (int i = 0; i < numThreads; i++)
+            threads.push_back(std::thread(&ParallelNedFileParser::run, this));
+    }
+
+    ~ParallelNedFileParser() {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            finishing = true;
+            finished.notify_all();
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+        for (size_t i = nextToTake; i < results.size(); i++)
+            delete results[i].tree;
+    }
+
+    // returns the tree of the next file in the list, or throws its parse error
+    NedFileElement *takeNext() {
+        std::unique_lock<std::mutex> lock(mutex);
+        size_t index = nextToTake++;
+        resultDone.wait(lock, [this,index] {return results[index].done;});
+        Result& result = results[index];
+        if (result.error)
+            std::rethrow_exception(result.error);
+        NedFileElement *tree = result.tree;
+        result.tree = nullptr;
+        tree->adoptTreeIntoCurrentThread();
+        return tree;
+    }
+};
+
+}  // namespace
+
+void NedResourceCache::loadNedSourceFolderFiles(const std::vector<NedFileToLoad>& files)
+{
+    LOCK;
+
+    int numThreads = numLoaderThreads > 0 ? numLoaderThreads : std::thread::hardware_concurrency();
+    numThreads = std::min(numThreads, (int)files.size());
+#if !OPP_HAS_THREAD_LOCAL
+    numThreads = 1;  // the parser's global state (string pools, etc.) would be shared by the threads
+#endif
+    if (numThreads <= 1) {
+        for (const NedFileToLoad& file : files)
+            doLoadNedFileOrText(file.fileName.c_str(), nullptr, file.hasExpectedPackage ? file.expectedPackage.c_str() : nullptr, false);
+        return;
+    }
+
+    // parse files in parallel (parsing and syntax validation do not touch
+    // the cache), and add them in the original order so that the outcome,
+    // including the error reported, is the same as with serial loading
+    std::vector<const NedFileToLoad*> filesToParse;
+    std::vector<std::string> fileNames;
+    std::set<std::string> fileNameSet;
+    for (const NedFileToLoad& file : files) {
+        if (!containsKey(nedFiles, file.fileName) && fileNameSet.insert(file.fileName).second) {  // skip already loaded ones
+            filesToParse.push_back(&file);
+            fileNames.push_back(file.fileName);
+        }
+    }
+    ParallelNedFileParser parser(fileNames, [this](const char *fileName) {return doParseAndValidateNedFileOrText(fileName, nullptr, false, astCache);}, numThreads);
+    for (const NedFileToLoad *fileToParse : filesToParse) {
+        const NedFileToLoad& file = *fileToParse;
+        NedFileElement *tree = parser.takeNext();
+        if (nedTypes.empty())
+            registerBuiltinDeclarations();
+        try {
+            addFile(tree, file.hasExpectedPackage ? file.expectedPackage.c_str() : nullptr);
+        }
+        catch (std::exception&) {
+            if (!containsKey(nedFiles, file.fileName))
+                delete tree;
+            throw;
         }
     }
-    return count;
 }
 
 inline bool isPackageNedFile(const char *fname)
@@ -198,6 +357,20 @@ void NedResourceCache::addFile(NedFileElement *tree, const char *expectedPackage
 NedFileElement *NedResourceCache::parseAndValidateNedFileOrText(const char *fname, const char *nedText, bool isXML) const
 {
     LOCK;
+    return doParseAndValidateNedFileOrText(fname, nedText, isXML, astCache);
+}
+
+NedFileElement *NedResourceCache::doParseAndValidateNedFileOrText(const char *fname, const char *nedText, bool isXML, const NedAstCache *astCache)
+{
+    // note: no locking, as this function may be called from several threads in parallel
+
+    // try the AST cache first
+    NedAstCache::FileKey cacheKey;
+    if (astCache && !nedText && !isXML) {
+        cacheKey = astCache->makeKey(fname);
+        if (NedFileElement *nedFileElement = astCache->load(cacheKey))
+            return nedFileElement;
+    }
 
     // load file
     ASTNode *tree = nullptr;
@@ -217,7 +390,7 @@ NedFileElement *NedResourceCache::parseAndValidateNedFileOrText(const char *fnam
     }
     if (errors.containsError()) {
         delete tree;
-        throw NedException("%s", getFirstError(&errors).c_str());
+        throw NedException("%s", formatFirstError(&errors).c_str());
     }
 
     // DTD validation and additional syntax validation
@@ -225,25 +398,31 @@ NedFileElement *NedResourceCache::parseAndValidateNedFileOrText(const char *fnam
     dtdvalidator.validate(tree);
     if (errors.containsError()) {
         delete tree;
-        throw NedException("%s", getFirstError(&errors, "NED internal DTD validation failure: ").c_str());
+        throw NedException("%s", formatFirstError(&errors, "NED internal DTD validation failure: ").c_str());
     }
 
     NedSyntaxValidator syntaxvalidator(&errors);
     syntaxvalidator.validate(tree);
     if (errors.containsError()) {
         delete tree;
-        throw NedException("%s", getFirstError(&errors).c_str());
+        throw NedException("%s", formatFirstError(&errors).c_str());
     }
     NedFileElement *nedFileElement = dynamic_cast<NedFileElement*>(tree);
     if (!nedFileElement)
         throw NedException("<ned-file> expected as root element, in file %s", fname);
+    if (cacheKey.isValid())
+        astCache->store(cacheKey, nedFileElement);
     return nedFileElement;
 }
 
 std::string NedResourceCache::getFirstError(ErrorStore *errors, const char *prefix) const
 {
     LOCK;
+    return formatFirstError(errors, prefix);
+}
 
+std::string NedResourceCache::formatFirstError(ErrorStore *errors, const char *prefix)
+{
     // find first error
     int i;
     for (i = 0; i < errors->numMessages(); i++)
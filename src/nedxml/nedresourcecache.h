@@ -29,6 +29,7 @@ namespace omnetpp {
 namespace nedxml {
 
 class ErrorStore;
+class NedAstCache;
 
 /**
  * @brief Context of NED type lookup, for NedResourceCache.
@@ -96,6 +97,19 @@ class NEDXML_API NedResourceCache
     typedef std::map<std::string,std::string> StringMap;
     StringMap folderPackages;
 
+    // number of threads for parsing the files of NED source folders; 0 means number of cores
+    int numLoaderThreads = 0;
+
+    // on-disk cache of parsed NED files, or nullptr
+    NedAstCache *astCache = nullptr;
+
+    // a NED file found in a NED source folder, to be loaded
+    struct NedFileToLoad {
+        std::string fileName;  // canonical
+        std::string expectedPackage;
+        bool hasExpectedPackage;
+    };
+
   public:
     // internal: members must be protected against concurrent access from multiple threads
     static std::recursive_mutex nedMutex;
@@ -104,8 +118,11 @@ class NEDXML_API NedResourceCache
     virtual void addFile(NedFileElement *node, const char *expectedPackage);
     virtual void registerBuiltinDeclarations();
     virtual int doLoadNedSourceFolder(const char *foldername, const char *expectedPackage, const std::vector<std::string>& excludedFolders);
+    virtual void collectNedSourceFolderFiles(const char *foldername, const char *expectedPackage, const std::vector<std::string>& excludedFolders, std::vector<NedFileToLoad>& result);
+    virtual void loadNedSourceFolderFiles(const std::vector<NedFileToLoad>& files);
     virtual void doLoadNedFileOrText(const char *nedfname, const char *nedtext, const char *expectedPackage, bool isXML);
     virtual NedFileElement *parseAndValidateNedFileOrText(const char *nedfname, const char *nedtext, bool isXML) const;
+    static NedFileElement *doParseAndValidateNedFileOrText(const char *nedfname, const char *nedtext, bool isXML, const NedAstCache *astCache);
     virtual std::string determineRootPackageName(const char *nedSourceFolderName) const;
     virtual std::string getNedSourceFolderForFolder(const char *folder) const;
     virtual void collectNedTypesFrom(ASTNode *node, const std::string& packagePrefix, bool areInnerTypes);
@@ -113,6 +130,7 @@ class NEDXML_API NedResourceCache
     virtual void registerNedType(const char *qname, bool isInnerType, ASTNode *node);
     virtual bool hasResolvedTypeUnder(const std::string& packageName) const;
     virtual std::string getFirstError(ErrorStore *errors, const char *prefix=nullptr) const;
+    static std::string formatFirstError(ErrorStore *errors, const char *prefix=nullptr);
 
   public:
     /** Constructor */
@@ -132,6 +150,33 @@ class NEDXML_API NedResourceCache
      */
     virtual int loadNedFolder(const char *foldername, const char *excludedPackages);
 
+    /**
+     * Sets the number of threads loadNedFolder() uses for parsing and
+     * syntax-validating NED files. Files are still added to the cache
+     * one by one in the same order as with serial loading, so the outcome
+     * (including the error reported, if any) does not depend on this setting.
+     * 0 means the number of CPU cores, and 1 means serial loading.
+     */
+    virtual void setNumLoaderThreads(int n) {numLoaderThreads = n;}
+
+    /**
+     * Returns the value set via setNumLoaderThreads().
+     */
+    virtual int getNumLoaderThreads() const {return numLoaderThreads;}
+
+    /**
+     * Enables caching the parsed and validated form of NED files on disk,
+     * in the given directory (see NedAstCache). NED files whose cache entry
+     * is up to date are not parsed again. nullptr or "" disables the cache.
+     */
+    virtual void setAstCacheDir(const char *dir);
+
+    /**
+     * Returns the directory set via setAstCacheDir(), or nullptr if the
+     * cache is disabled.
+     */
+    virtual const char *getAstCacheDir() const;
+
     /**
      * Load a single NED file. If the expected package is given (non-nullptr),
      * it should match the package declaration inside the NED file.
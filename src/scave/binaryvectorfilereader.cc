@@ -0,0 +1,338 @@
+//=========================================================================
+//  BINARYVECTORFILEREADER.CC - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include "common/exception.h"
+#include "common/stlutil.h"
+#include "common/binaryvectorfileformat.h"
+#include "omnetpp/platdep/platmisc.h"
+#include "binaryvectorfilereader.h"
+#include "indexfilereader.h"
+#include "indexfileutils.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace omnetpp::common;
+
+namespace omnetpp {
+namespace scave {
+
+bool BinaryVectorFileReader::isBinaryVectorFile(const char *fileName)
+{
+    bool retval = false;
+    FILE *f = fopen(fileName, "rb");
+    if (f != nullptr) {
+        char buff[8];
+        if (fread(buff, sizeof(buff), 1, f) == 1)
+            retval = memcmp(buff, BINARY_VECTOR_FILE_MAGIC, sizeof(buff)) == 0;
+        fclose(f);
+    }
+    return retval;
+}
+
+BinaryVectorFileReader::BinaryVectorFileReader(const char *filename, bool includeEventNumbers, AdapterLambdaType adapterLambda, const FileFingerprint& fingerprint)
+    : adapterLambda(adapterLambda), fname(filename), includeEventNumbers(includeEventNumbers)
+{
+    std::string ifname = IndexFileUtils::getIndexFileName(filename);
+    IndexFileReader indexReader(ifname.c_str());
+    index = indexReader.readAll();
+
+    try {
+        FileFingerprint expectedFingerprint = fingerprint, actualFingerprint = readFileFingerprint(fname.c_str());
+        if (!expectedFingerprint.isEmpty() && actualFingerprint != expectedFingerprint)
+            throw opp_runtime_error("Vector file \"%s\" changed on disk", fname.c_str());
+        if (actualFingerprint != index->fingerprint)
+            throw opp_runtime_error("Index file (.vci) for \"%s\" is out of date", fname.c_str());
+
+        mapFile();
+
+        const BinaryVectorFileHeader *header = (const BinaryVectorFileHeader *)data;
+        if (dataSize < sizeof(BinaryVectorFileHeader) || memcmp(header->magic, BINARY_VECTOR_FILE_MAGIC, sizeof(header->magic)) != 0)
+            throw opp_runtime_error("\"%s\" is not a binary vector file", fname.c_str());
+        if (header->byteOrderMark != BINARY_VECTOR_FILE_BYTEORDER)
+            throw opp_runtime_error("Binary vector file \"%s\" was written on a platform with different byte order", fname.c_str());
+        if (header->version != BINARY_VECTOR_FILE_VERSION)
+            throw opp_runtime_error("Binary vector file \"%s\" has unsupported version %d", fname.c_str(), (int)header->version);
+    }
+    catch (std::exception&) {
+        unmapFile();
+        delete index;
+        throw;
+    }
+}
+
+BinaryVectorFileReader::~BinaryVectorFileReader()
+{
+    unmapFile();
+    delete index;
+}
+
+#ifdef _WIN32
+
+void BinaryVectorFileReader::mapFile()
+{
+    HANDLE file = CreateFileA(fname.c_str(), GENERIC_READ, FILE_SHARE_READ|FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw opp_runtime_error("Cannot open '%s' for read", fname.c_str());
+    fileHandle = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+        throw opp_runtime_error("Cannot determine size of '%s'", fname.c_str());
+    dataSize = size.QuadPart;
+    mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle == nullptr)
+        throw opp_runtime_error("Cannot map '%s' into memory", fname.c_str());
+    data = (const char *)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (data == nullptr)
+        throw opp_runtime_error("Cannot map '%s' into memory", fname.c_str());
+}
+
+void BinaryVectorFileReader::unmapFile()
+{
+    if (data)
+        UnmapViewOfFile(data);
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+    if (fileHandle)
+        CloseHandle(fileHandle);
+    data = nullptr;
+    mappingHandle = fileHandle = nullptr;
+}
+
+#else
+
+void BinaryVectorFileReader::mapFile()
+{
+    int fd = open(fname.c_str(), O_RDONLY);
+    if (fd == -1)
+        throw opp_runtime_error("Cannot open '%s' for read", fname.c_str());
+    struct stat s;
+    if (fstat(fd, &s) != 0) {
+        ::close(fd);
+        throw opp_runtime_error("Cannot determine size of '%s'", fname.c_str());
+    }
+    dataSize = s.st_size;
+    void *p = mmap(nullptr, dataSize, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // the mapping stays valid
+    if (p == MAP_FAILED)
+        throw opp_runtime_error("Cannot map '%s' into memory: %s", fname.c_str(), strerror(errno));
+    data = (const char *)p;
+    madvise(p, dataSize, MADV_SEQUENTIAL);
+}
+
+void BinaryVectorFileReader::unmapFile()
+{
+    if (data)
+        munmap((void *)data, dataSize);
+    data = nullptr;
+}
+
+#endif
+
+BinaryVectorFileReader::Columns BinaryVectorFileReader::getColumns(const Block& block)
+{
+    if (block.startOffset < (file_offset_t)sizeof(BinaryVectorFileHeader) || block.startOffset + block.size > (file_offset_t)dataSize)
+        throw opp_runtime_error("Invalid block offset %" PRId64 " in the index of binary vector file \"%s\"", (int64_t)block.startOffset, fname.c_str());
+
+    const BinaryVectorBlockHeader *header = (const BinaryVectorBlockHeader *)(data + block.startOffset);
+    size_t count = header->count;
+    bool hasEventNumbers = (header->flags & BINVEC_EVENTNUMBERS) != 0;
+    size_t expectedSize = sizeof(BinaryVectorBlockHeader) + count * (hasEventNumbers ? 3 : 2) * 8;
+    if (header->vectorId != block.vectorId || (long)count != block.getCount() || expectedSize != (size_t)block.size)
+        throw opp_runtime_error("Block at offset %" PRId64 " in binary vector file \"%s\" does not match the index", (int64_t)block.startOffset, fname.c_str());
+
+    const int64_t *columns = (const int64_t *)(header + 1);
+    Columns result;
+    result.vectorId = block.vectorId;
+    result.startSerial = block.startSerial;
+    result.count = count;
+    result.eventNumbers = hasEventNumbers ? columns : nullptr;
+    result.rawTimes = hasEventNumbers ? columns + count : columns;
+    result.simtimeScaleExp = header->simtimeScaleExp;
+    result.values = (const double *)(result.rawTimes + count);
+    return result;
+}
+
+static BinaryVectorFileReader::Columns slice(const BinaryVectorFileReader::Columns& columns, size_t start, size_t end)
+{
+    BinaryVectorFileReader::Columns result = columns;
+    result.startSerial += start;
+    result.count = end - start;
+    if (result.eventNumbers)
+        result.eventNumbers += start;
+    result.rawTimes += start;
+    result.values += start;
+    return result;
+}
+
+BinaryVectorFileReader::Columns BinaryVectorFileReader::getColumnsInSimtimeInterval(const Block& block, simultime_t startTime, simultime_t endTime)
+{
+    // times are non-decreasing within a vector, so the matching samples are contiguous
+    Columns columns = getColumns(block);
+    int scaleExp = columns.simtimeScaleExp;
+    auto lessThan = [scaleExp](int64_t raw, const simultime_t& t) { return BigDecimal(raw, scaleExp) < t; };
+    const int64_t *begin = columns.rawTimes, *end = columns.rawTimes + columns.count;
+    size_t start = std::lower_bound(begin, end, startTime, lessThan) - begin;
+    size_t stop = std::lower_bound(begin, end, endTime, lessThan) - begin;
+    return slice(columns, start, std::max(start, stop));
+}
+
+BinaryVectorFileReader::Columns BinaryVectorFileReader::getColumnsInEventnumInterval(const Block& block, eventnumber_t startEventNum, eventnumber_t endEventNum)
+{
+    Columns columns = getColumns(block);
+    if (!columns.eventNumbers) {
+        // all samples have event number -1
+        bool inRange = -1 >= startEventNum && -1 < endEventNum;
+        return slice(columns, 0, inRange ? columns.count : 0);
+    }
+    const eventnumber_t *begin = columns.eventNumbers, *end = columns.eventNumbers + columns.count;
+    size_t start = std::lower_bound(begin, end, startEventNum) - begin;
+    size_t stop = std::lower_bound(begin, end, endEventNum) - begin;
+    return slice(columns, start, std::max(start, stop));
+}
+
+Entries BinaryVectorFileReader::toEntries(const Columns& columns)
+{
+    Entries result;
+    result.resize(columns.count);
+    for (size_t i = 0; i < columns.count; i++) {
+        VectorDatum& entry = result[i];
+        entry.serial = columns.startSerial + i;
+        if (includeEventNumbers && columns.eventNumbers)
+            entry.eventNumber = columns.eventNumbers[i];
+        entry.simtime = BigDecimal(columns.rawTimes[i], columns.simtimeScaleExp);
+        entry.value = columns.values[i];
+    }
+    return result;
+}
+
+void BinaryVectorFileReader::collectColumns(const std::set<int>& vectorIds, simultime_t startTime, simultime_t endTime, ColumnsAdapterLambdaType adapter)
+{
+    for (auto block : index->getBlocks()) {
+        if (contains(vectorIds, block->vectorId)) {
+            if (block->endTime < startTime || block->startTime >= endTime) {
+                // no-op, block is completely out of filtered range
+            }
+            else if (block->startTime >= startTime && block->endTime < endTime)
+                adapter(getColumns(*block));
+            else
+                adapter(getColumnsInSimtimeInterval(*block, startTime, endTime));
+        }
+    }
+}
+
+VectorDatum *BinaryVectorFileReader::getEntryBySerial(int vectorId, int64_t serial)
+{
+    VectorInfo *vector = index->getVectorById(vectorId);
+    if (!vector)
+        return nullptr;
+
+    const Block *block = vector->getBlockBySerial(serial);
+    if (!block)
+        return nullptr;
+
+    Columns columns = getColumns(*block);
+    return new VectorDatum(toEntries(slice(columns, serial - block->startSerial, serial - block->startSerial + 1)).at(0));
+}
+
+VectorDatum *BinaryVectorFileReader::getEntryBySimtime(int vectorId, simultime_t simtime, bool after)
+{
+    VectorInfo *vector = index->getVectorById(vectorId);
+    if (!vector)
+        return nullptr;
+
+    const Block *block = vector->getBlockBySimtime(simtime, after);
+    if (!block)
+        return nullptr;
+
+    Entries data = loadBlock(*block);
+
+    VectorDatum datumToFind;
+    datumToFind.simtime = simtime;
+
+    if (after) {
+        auto first = std::lower_bound(data.begin(), data.end(), datumToFind, [](const VectorDatum &a, const VectorDatum &b) { return a.simtime < b.simtime; } );
+        return first != data.end() ? new VectorDatum(*first) : nullptr;
+    }
+    else {
+        auto last = std::lower_bound(data.rbegin(), data.rend(), datumToFind, [](const VectorDatum &a, const VectorDatum &b) { return a.simtime > b.simtime; });
+        return last != data.rend() ? new VectorDatum(*last) : nullptr;
+    }
+}
+
+VectorDatum *BinaryVectorFileReader::getEntryByEventnum(int vectorId, eventnumber_t eventNum, bool after)
+{
+    VectorInfo *vector = index->getVectorById(vectorId);
+    if (!vector)
+        return nullptr;
+
+    const Block *block = vector->getBlockByEventnum(eventNum, after);
+    if (!block)
+        return nullptr;
+
+    Entries data = loadBlock(*block);
+
+    VectorDatum datumToFind;
+    datumToFind.eventNumber = eventNum;
+
+    if (after) {
+        auto first = std::lower_bound(data.begin(), data.end(), datumToFind, [](const VectorDatum &a, const VectorDatum &b) { return a.eventNumber < b.eventNumber; } );
+        return first != data.end() ? new VectorDatum(*first) : nullptr;
+    }
+    else {
+        auto last = std::lower_bound(data.rbegin(), data.rend(), datumToFind, [](const VectorDatum &a, const VectorDatum &b) { return a.eventNumber > b.eventNumber; });
+        return last != data.rend() ? new VectorDatum(*last) : nullptr;
+    }
+}
+
+void BinaryVectorFileReader::collectEntries(const std::set<int>& vectorIds)
+{
+    for (auto block : index->getBlocks())
+        if (contains(vectorIds, block->vectorId))
+            adapterLambda(block->vectorId, loadBlock(*block));
+}
+
+void BinaryVectorFileReader::collectEntriesInSimtimeInterval(const std::set<int>& vectorIds, simultime_t startTime, simultime_t endTime)
+{
+    collectColumns(vectorIds, startTime, endTime, [this](const Columns& columns) {
+        adapterLambda(columns.vectorId, toEntries(columns));
+    });
+}
+
+void BinaryVectorFileReader::collectEntriesInEventnumInterval(const std::set<int>& vectorIds, eventnumber_t startEventNum, eventnumber_t endEventNum)
+{
+    for (auto block : index->getBlocks()) {
+        if (contains(vectorIds, block->vectorId)) {
+            if (block->endEventNum < startEventNum || block->startEventNum >= endEventNum) {
+                // no-op, block is completely out of filtered range
+            }
+            else if (block->startEventNum >= startEventNum && block->endEventNum < endEventNum)
+                adapterLambda(block->vectorId, loadBlock(*block));
+            else
+                adapterLambda(block->vectorId, toEntries(getColumnsInEventnumInterval(*block, startEventNum, endEventNum)));
+        }
+    }
+}
+
+}  // namespace scave
+}  // namespace omnetpp
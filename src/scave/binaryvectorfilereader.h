@@ -0,0 +1,113 @@
+//=========================================================================
+//  BINARYVECTORFILEREADER.H - part of
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_SCAVE_BINARYVECTORFILEREADER_H
+#define __OMNETPP_SCAVE_BINARYVECTORFILEREADER_H
+
+#include <functional>
+#include <set>
+#include <vector>
+#include "scavedefs.h"
+#include "ivectordatareader.h"
+#include "vectorfileindex.h"
+#include "filefingerprint.h"
+
+namespace omnetpp {
+namespace scave {
+
+/**
+ * Reader for binary vector files (see common/binaryvectorfileformat.h).
+ * The file is memory-mapped, and blocks are located via the index file (.vci).
+ * Besides the IVectorDataReader interface, it offers collectColumns() that
+ * exposes the column arrays of the blocks in place, without any conversion.
+ */
+class SCAVE_API BinaryVectorFileReader : public IVectorDataReader
+{
+    using VectorInfo = VectorFileIndex::VectorInfo;
+    using Block = VectorFileIndex::Block;
+
+    public:
+        /**
+         * A range of samples of one vector. Pointers point into the mapped
+         * file, and remain valid until the reader is deleted.
+         */
+        struct Columns {
+            int vectorId;
+            long startSerial;
+            size_t count;
+            const eventnumber_t *eventNumbers; // nullptr if the vector has no event numbers
+            const int64_t *rawTimes;           // times are rawTimes[i] * 10^simtimeScaleExp
+            int simtimeScaleExp;
+            const double *values;
+        };
+
+        using ColumnsAdapterLambdaType = std::function<void(const Columns& columns)>;
+
+    private:
+        AdapterLambdaType adapterLambda;
+
+        std::string fname;  // file name of the vector file
+        VectorFileIndex *index = nullptr; // index of the vector file, loaded fully into the memory
+        bool includeEventNumbers;
+
+        const char *data = nullptr; // the mapped file
+        size_t dataSize = 0;
+#ifdef _WIN32
+        void *fileHandle = nullptr;
+        void *mappingHandle = nullptr;
+#endif
+
+    protected:
+        void mapFile();
+        void unmapFile();
+        Columns getColumns(const Block& block);
+        Columns getColumnsInSimtimeInterval(const Block& block, simultime_t startTime, simultime_t endTime);
+        Columns getColumnsInEventnumInterval(const Block& block, eventnumber_t startEventNum, eventnumber_t endEventNum);
+        Entries toEntries(const Columns& columns);
+        Entries loadBlock(const Block& block) {return toEntries(getColumns(block));}
+
+    public:
+        /**
+         * Returns true if the given file is a binary vector file.
+         */
+        static bool isBinaryVectorFile(const char *fileName);
+
+        explicit BinaryVectorFileReader(const char* filename, bool includeEventNumbers, Adapter *adapter, const FileFingerprint& fingerprint=FileFingerprint()) :
+            BinaryVectorFileReader(filename, includeEventNumbers, [adapter](int vectorId, const std::vector<VectorDatum>& data) { adapter->process(vectorId, data); }, fingerprint)
+        { }
+
+        explicit BinaryVectorFileReader(const char* filename, bool includeEventNumbers, AdapterLambdaType adapter, const FileFingerprint& fingerprint=FileFingerprint());
+        ~BinaryVectorFileReader();
+
+        /**
+         * Passes the samples of the given vectors that fall into the
+         * [startTime, endTime) interval to the adapter, one block at a time.
+         */
+        void collectColumns(const std::set<int>& vectorIds, simultime_t startTime, simultime_t endTime, ColumnsAdapterLambdaType adapter);
+
+        int getNumberOfEntries(int vectorId) override { return index->getVectorById(vectorId)->getCount(); };
+
+        VectorDatum *getEntryBySerial(int vectorId, int64_t serial) override;
+        VectorDatum *getEntryBySimtime(int vectorId, simultime_t simtime, bool after) override;
+        VectorDatum *getEntryByEventnum(int vectorId, eventnumber_t eventNum, bool after) override;
+
+        void collectEntries(const std::set<int>& vectorIds) override;
+        void collectEntriesInSimtimeInterval(const std::set<int>& vectorIds, simultime_t startTime, simultime_t endTime) override;
+        void collectEntriesInEventnumInterval(const std::set<int>& vectorIds, eventnumber_t startEventNum, eventnumber_t endEventNum) override;
+};
+
+}  // namespace scave
+}  // namespace omnetpp
+
+#endif
@@ -36,6 +36,7 @@
 #include "common/stringutil.h"
 #include "common/stlutil.h"
 #include "omnetpp/platdep/platmisc.h"
+#include "binaryvectorfilereader.h"
 #include "indexfileutils.h"
 #include "indexfilereader.h"
 #include "scaveutils.h"
@@ -380,8 +381,17 @@ ResultFile *OmnetppResultFileLoader::loadFile(const char *displayName, const cha
     try {
         //TODO handle lockfileOption
 
-        bool isVecFile = IndexFileUtils::isExistingVectorFile(fileSystemFileName);
+        bool isBinaryVecFile = BinaryVectorFileReader::isBinaryVectorFile(fileSystemFileName);
+        bool isVecFile = isBinaryVecFile || IndexFileUtils::isExistingVectorFile(fileSystemFileName);
         bool hasUpToDateIndex = isVecFile && IndexFileUtils::isIndexFileUpToDate(fileSystemFileName);
+        if (isBinaryVecFile && !hasUpToDateIndex) {
+            // run and vector metadata are only stored in the index, so it cannot be scanned or reindexed
+            if (indexingOption == ResultFileManager::SKIP_IF_NO_INDEX) {
+                LOG << "file " << fileSystemFileName << " has no valid index, skipping\n";
+                return nullptr;
+            }
+            throw opp_runtime_error("Binary vector file '%s' has no valid index (.vci) file", fileSystemFileName);
+        }
         if (isVecFile && !hasUpToDateIndex) {
             // vector file with a missing or out-of-date index
             LOG << "file " << fileSystemFileName << " has no valid index, ";
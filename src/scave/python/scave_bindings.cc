@@ -43,6 +43,47 @@ using namespace omnetpp::common;
 
 #define MODULENAME CONCAT(scave_bindings, OMNETPP_MODE_SUFFIX)
 
+/**
+ * Moves the contents of the vector into a heap-allocated one, and returns a
+ * NumPy array that refers to its buffer. The vector is freed when the array
+ * is garbage collected. No element is copied.
+ */
+template <typename T>
+static nb::ndarray<nb::numpy, T, nb::ndim<1>> moveToNumpyArray(std::vector<T>& v)
+{
+    std::vector<T> *owned = new std::vector<T>(std::move(v));
+    v = std::vector<T>();
+    nb::capsule owner(owned, [](void *p) noexcept { delete (std::vector<T> *)p; });
+    return nb::ndarray<nb::numpy, T, nb::ndim<1>>(owned->data(), {owned->size()}, owner);
+}
+
+/**
+ * Converts the precise X values of the array into int64 values with a common
+ * decimal exponent, i.e. x[i] = values[i] * 10^exponent, and frees them.
+ */
+static std::pair<nb::ndarray<nb::numpy, int64_t, nb::ndim<1>>, int> takePreciseX(XYArray *xyArray)
+{
+    int exponent = 0;
+    for (const BigDecimal& x : xyArray->xps) {
+        if (x.isSpecial())
+            throw std::runtime_error("takePreciseX: special value (NaN, infinity or Nil) in vector data");
+        exponent = std::min(exponent, x.getScale());
+    }
+    std::vector<int64_t> values;
+    values.reserve(xyArray->xps.size());
+    for (const BigDecimal& x : xyArray->xps) {
+        int64_t value = x.getIntValue();
+        for (int i = x.getScale(); i > exponent; i--) {
+            if (value > INT64_MAX / 10 || value < INT64_MIN / 10)
+                throw std::runtime_error("takePreciseX: values do not fit into a common exponent");
+            value *= 10;
+        }
+        values.push_back(value);
+    }
+    xyArray->xps = std::vector<BigDecimal>();
+    return {moveToNumpyArray(values), exponent};
+}
+
 NB_MODULE(MODULENAME, m) {
 
     nb::class_<InterruptedFlag>(m, "InterruptedFlag")
@@ -74,6 +115,9 @@ NB_MODULE(MODULENAME, m) {
         .def("loadFile", &ResultFileManager::loadFile, nb::rv_policy::reference,
             nb::call_guard<nb::gil_scoped_release>(),
             nb::arg(), nb::arg(), nb::arg(), nb::arg("interrupted").none() = nullptr)
+        .def("loadFiles", &ResultFileManager::loadFiles, nb::rv_policy::reference,
+            nb::call_guard<nb::gil_scoped_release>(),
+            nb::arg(), nb::arg(), nb::arg(), nb::arg("interrupted").none() = nullptr, nb::arg("numThreads") = 0)
 
         .def("getSerial", &ResultFileManager::getSerial)
         .def("clear", &ResultFileManager::clear)
@@ -257,6 +301,16 @@ NB_MODULE(MODULENAME, m) {
         .def("getY", &XYArray::getY)
         //.def("getPreciseX", &XYArray::getPreciseX)
         .def("getEventNumber", &XYArray::getEventNumber)
+        .def("hasPreciseX", &XYArray::hasPreciseX)
+        .def("hasEventNumbers", &XYArray::hasEventNumbers)
+
+        // These hand over the data to NumPy without copying it, and leave the
+        // respective column of the XYArray empty. The arrays stay valid after
+        // the XYArray is deleted.
+        .def("takeX", [](XYArray *xyArray) { return moveToNumpyArray(xyArray->xs); })
+        .def("takeY", [](XYArray *xyArray) { return moveToNumpyArray(xyArray->ys); })
+        .def("takeEventNumbers", [](XYArray *xyArray) { return moveToNumpyArray(xyArray->ens); })
+        .def("takePreciseX", &takePreciseX)
         ;
 
     m.def("xyArrayToNumpyArrays", [](
@@ -21,6 +21,10 @@
 #include <algorithm>
 #include <utility>
 #include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
 #include "common/opp_ctype.h"
 #include "common/matchexpression.h"
 #include "common/patternmatcher.h"
@@ -1235,6 +1239,56 @@ int ResultFileManager::addHistogram(FileRun *fileRunRef, const char *moduleName,
     return histograms.size() - 1;
 }
 
+ResultFile *ResultFileManager::mergeFile(const ResultFile *stagedFile)
+{
+    // copy the file, then its runs and result items; names and attributes get pooled in this manager
+    ResultFile *file = new ResultFile(*stagedFile);
+    file->resultFileManager = this;
+    file->fileRuns.clear();
+    fileList.insert(file);
+    filesByDisplayName[file->displayName] = file;
+
+    for (const FileRun *stagedFileRun : stagedFile->fileRuns) {
+        const Run *stagedRun = stagedFileRun->runRef;
+        Run *run = getRunByName(stagedRun->runName.c_str());
+        if (!run) {
+            run = addRun(stagedRun->runName);
+            run->attributes = stagedRun->attributes;
+            run->itervars = stagedRun->itervars;
+            run->configEntries = stagedRun->configEntries;
+        }
+        FileRun *fileRun = addFileRun(file, run);
+
+        fileRun->scalarResults.reserve(stagedFileRun->scalarResults.size());
+        for (const ScalarResult& scalar : stagedFileRun->scalarResults)
+            fileRun->scalarResults.push_back(ScalarResult(fileRun, scalar.getModuleName(), scalar.getName(), scalar.getAttributes(), scalar.value, scalar.ownID));
+
+        fileRun->parameterResults.reserve(stagedFileRun->parameterResults.size());
+        for (const ParameterResult& param : stagedFileRun->parameterResults)
+            fileRun->parameterResults.push_back(ParameterResult(fileRun, param.getModuleName(), param.getName(), param.getAttributes(), param.value));
+
+        fileRun->vectorResults.reserve(stagedFileRun->vectorResults.size());
+        for (const VectorResult& stagedVector : stagedFileRun->vectorResults) {
+            VectorResult vector(fileRun, stagedVector.getModuleName(), stagedVector.getName(), stagedVector.getAttributes(), stagedVector.vectorId, stagedVector.columns);
+            vector.startEventNum = stagedVector.startEventNum;
+            vector.endEventNum = stagedVector.endEventNum;
+            vector.startTime = stagedVector.startTime;
+            vector.endTime = stagedVector.endTime;
+            vector.stat = stagedVector.stat;
+            fileRun->vectorResults.push_back(vector);
+        }
+
+        fileRun->statisticsResults.reserve(stagedFileRun->statisticsResults.size());
+        for (const StatisticsResult& statistics : stagedFileRun->statisticsResults)
+            fileRun->statisticsResults.push_back(StatisticsResult(fileRun, statistics.getModuleName(), statistics.getName(), statistics.getAttributes(), statistics.stat));
+
+        fileRun->histogramResults.reserve(stagedFileRun->histogramResults.size());
+        for (const HistogramResult& histogram : stagedFileRun->histogramResults)
+            fileRun->histogramResults.push_back(HistogramResult(fileRun, histogram.getModuleName(), histogram.getName(), histogram.getAttributes(), histogram.stat, histogram.bins));
+    }
+    return file;
+}
+
 static bool isFileReadable(const char *fileName)
 {
     FILE *f = fopen(fileName, "r");
@@ -1253,18 +1307,10 @@ ResultFile *ResultFileManager::loadFile(const char *displayName, const char *fil
     WRITER_MUTEX
 
     // extract and validate flags
+    checkLoadFlags(flags);
     int reloadOption = flags & (RELOAD|RELOAD_IF_CHANGED|NEVER_RELOAD);
-    int indexingOption = flags & (ALLOW_INDEXING|SKIP_IF_NO_INDEX|ALLOW_LOADING_WITHOUT_INDEX);
-    int lockfileOption = flags & (SKIP_IF_LOCKED|IGNORE_LOCK_FILE);
     bool verbose = (flags & VERBOSE) != 0;
 
-    if (reloadOption != RELOAD && reloadOption != RELOAD_IF_CHANGED && reloadOption != NEVER_RELOAD)
-        throw opp_runtime_error("invalid reload flags %d, must be one of: RELOAD, RELOAD_IF_CHANGED, NEVER_RELOAD", reloadOption);
-    if (indexingOption != ALLOW_INDEXING && indexingOption != SKIP_IF_NO_INDEX && indexingOption != ALLOW_LOADING_WITHOUT_INDEX)
-        throw opp_runtime_error("invalid indexing flags %d, must be one of: ALLOW_INDEXING, SKIP_IF_NO_INDEX, ALLOW_LOADING_WITHOUT_INDEX", indexingOption);
-    if (lockfileOption != SKIP_IF_LOCKED && lockfileOption != IGNORE_LOCK_FILE)
-        throw opp_runtime_error("invalid lockfile handling flags %d, must be one of: SKIP_IF_LOCKED, IGNORE_LOCK_FILE", lockfileOption);
-
     if (interrupted == nullptr) {
         static OPP_THREAD_LOCAL InterruptedFlag neverInterrupted;
         interrupted = &neverInterrupted; // eliminate need for nullptr checks
@@ -1317,6 +1363,182 @@ ResultFile *ResultFileManager::loadFile(const char *displayName, const char *fil
     }
 }
 
+void ResultFileManager::checkLoadFlags(int flags)
+{
+    int reloadOption = flags & (RELOAD|RELOAD_IF_CHANGED|NEVER_RELOAD);
+    int indexingOption = flags & (ALLOW_INDEXING|SKIP_IF_NO_INDEX|ALLOW_LOADING_WITHOUT_INDEX);
+    int lockfileOption = flags & (SKIP_IF_LOCKED|IGNORE_LOCK_FILE);
+
+    if (reloadOption != RELOAD && reloadOption != RELOAD_IF_CHANGED && reloadOption != NEVER_RELOAD)
+        throw opp_runtime_error("invalid reload flags %d, must be one of: RELOAD, RELOAD_IF_CHANGED, NEVER_RELOAD", reloadOption);
+    if (indexingOption != ALLOW_INDEXING && indexingOption != SKIP_IF_NO_INDEX && indexingOption != ALLOW_LOADING_WITHOUT_INDEX)
+        throw opp_runtime_error("invalid indexing flags %d, must be one of: ALLOW_INDEXING, SKIP_IF_NO_INDEX, ALLOW_LOADING_WITHOUT_INDEX", indexingOption);
+    if (lockfileOption != SKIP_IF_LOCKED && lockfileOption != IGNORE_LOCK_FILE)
+        throw opp_runtime_error("invalid lockfile handling flags %d, must be one of: SKIP_IF_LOCKED, IGNORE_LOCK_FILE", lockfileOption);
+}
+
+namespace {
+
+/**
+ * Loads result files on worker threads, each into a private ResultFileManager
+ * that serves as staging area. Results are taken in the order of the files;
+ * the workers stay at most a few files ahead, to limit memory usage.
+ */
+class ParallelResultFileLoader
+{
+  public:
+    struct Result {
+        ResultFileManager *manager = nullptr;  // owned by the caller after takeNext()
+        ResultFile *file = nullptr;  // nullptr if skipped
+        std::exception_ptr error;
+        bool done = false;
+    };
+
+  private:
+    const std::vector<std::pair<std::string,std::string>>& files;  // display name, file system name
+    int flags;
+    InterruptedFlag *interrupted;
+    size_t maxAhead;
+    std::vector<Result> results;
+    size_t nextToLoad = 0;
+    size_t nextToTake = 0;
+    bool finishing = false;
+    std::mutex mutex;
+    std::condition_variable resultDone;
+    std::condition_variable resultTaken;
+    std::vector<std::thread> threads;
+
+  private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            resultTaken.wait(lock, [this] {return finishing || nextToLoad >= files.size() || nextToLoad < nextToTake + maxAhead;});
+            if (finishing || nextToLoad >= files.size())
+                break;
+            size_t index = nextToLoad++;
+            lock.unlock();
+            Result result;
+            result.manager = new ResultFileManager();
+            try {
+                result.file = result.manager->loadFile(files[index].first.c_str(), files[index].second.c_str(), flags, interrupted);
+            }
+            catch (...) {
+                result.error = std::current_exception();
+            }
+            result.done = true;
+            lock.lock();
+            results[index] = result;
+            resultDone.notify_all();
+        }
+    }
+
+  public:
+    ParallelResultFileLoader(const std::vector<std::pair<std::string,std::string>>& files, int flags, InterruptedFlag *interrupted, int numThreads) :
+            files(files), flags(flags), interrupted(interrupted), maxAhead(4 * numThreads), results(files.size()) {
+        for (int i = 0; i < numThreads; i++)
+            threads.push_back(std::thread(&ParallelResultFileLoader::run, this));
+    }
+
+    ~ParallelResultFileLoader() {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            finishing = true;
+            resultTaken.notify_all();
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+        for (size_t i = nextToTake; i < results.size(); i++)
+            delete results[i].manager;
+    }
+
+    // waits for the next file in the list to be loaded
+    Result takeNext() {
+        std::unique_lock<std::mutex> lock(mutex);
+        size_t index = nextToTake++;
+        resultDone.wait(lock, [this,index] {return results[index].done;});
+        Result result = results[index];
+        results[index].manager = nullptr;
+        resultTaken.notify_all();
+        return result;
+    }
+};
+
+}  // namespace
+
+ResultFileList ResultFileManager::loadFiles(const std::vector<std::string>& displayNames, const std::vector<std::string>& fileSystemFileNames, int flags, InterruptedFlag *interrupted, int numThreads)
+{
+    if (!fileSystemFileNames.empty() && fileSystemFileNames.size() != displayNames.size())
+        throw opp_runtime_error("loadFiles(): the number of display names and file system file names differ");
+    checkLoadFlags(flags);
+    int reloadOption = flags & (RELOAD|RELOAD_IF_CHANGED|NEVER_RELOAD);
+
+    if (interrupted == nullptr) {
+        static OPP_THREAD_LOCAL InterruptedFlag neverInterrupted;
+        interrupted = &neverInterrupted; // eliminate need for nullptr checks
+    }
+
+    // find out which files need to be loaded; each file is loaded at most once
+    ResultFileList result(displayNames.size(), nullptr);
+    std::vector<std::pair<std::string,std::string>> filesToLoad;
+    std::vector<size_t> resultIndices;
+    std::map<std::string,size_t> firstOccurrence;
+    std::vector<std::pair<size_t,size_t>> duplicates;
+    {
+        READER_MUTEX
+        for (size_t i = 0; i < displayNames.size(); i++) {
+            const std::string& displayName = displayNames[i];
+            const std::string& fileSystemFileName = fileSystemFileNames.empty() ? displayName : fileSystemFileNames[i];
+            auto it = firstOccurrence.find(displayName);
+            if (it != firstOccurrence.end()) {
+                duplicates.push_back(std::make_pair(i, it->second));
+                continue;
+            }
+            firstOccurrence[displayName] = i;
+            ResultFile *file = getFile(displayName.c_str());
+            if (file && (reloadOption == NEVER_RELOAD || (reloadOption == RELOAD_IF_CHANGED && readFileFingerprint(fileSystemFileName.c_str()) == file->fingerprint))) {
+                result[i] = file;
+                continue;
+            }
+            filesToLoad.push_back(std::make_pair(displayName, fileSystemFileName));
+            resultIndices.push_back(i);
+        }
+    }
+
+    if (numThreads <= 0)
+        numThreads = std::thread::hardware_concurrency();
+    numThreads = std::min(numThreads, (int)filesToLoad.size());
+    if (numThreads <= 1) {
+        for (size_t k = 0; k < filesToLoad.size(); k++)
+            result[resultIndices[k]] = loadFile(filesToLoad[k].first.c_str(), filesToLoad[k].second.c_str(), flags, interrupted);
+    }
+    else {
+        // parse files concurrently, and merge them in the original order, so that IDs are assigned
+        // the same way as with sequential loading
+        ParallelResultFileLoader loader(filesToLoad, (flags & ~(RELOAD_IF_CHANGED|NEVER_RELOAD)) | RELOAD, interrupted, numThreads);
+        for (size_t k = 0; k < filesToLoad.size(); k++) {
+            ParallelResultFileLoader::Result staged = loader.takeNext();
+            std::unique_ptr<ResultFileManager> stagingManager(staged.manager);
+            if (staged.error)
+                std::rethrow_exception(staged.error);
+            if (interrupted->flag)
+                break;
+            if (!staged.file)
+                continue;
+
+            WRITER_MUTEX
+            ResultFile *previous = getFile(filesToLoad[k].first.c_str());
+            if (previous)
+                unloadFile(previous);
+            serial++;
+            result[resultIndices[k]] = mergeFile(staged.file);
+        }
+    }
+
+    for (auto& duplicate : duplicates)
+        result[duplicate.first] = result[duplicate.second];
+    return result;
+}
+
 #undef LOG
 
 void ResultFileManager::setFileInput(ResultFile *file, const char *inputName)
@@ -190,6 +190,8 @@ class SCAVE_API ResultFileManager
     FileRun *addFileRun(ResultFile *file, Run *run);
     Run *getOrAddRun(const std::string& runName);
     FileRun *getOrAddFileRun(ResultFile *file, Run *run);
+    ResultFile *mergeFile(const ResultFile *stagedFile);
+    static void checkLoadFlags(int flags);
 
     int addScalar(FileRun *fileRunRef, const char *moduleName, const char *scalarName, const StringMap& attrs, double value, bool isField);
     int addParameter(FileRun *fileRunRef, const char *moduleName, const char *paramName, const StringMap& attrs, const std::string& value);
@@ -356,6 +358,17 @@ class SCAVE_API ResultFileManager
      * the file is actually read from fileSystemFileName.
      */
     ResultFile *loadFile(const char *displayName, const char *fileSystemFileName, int flags, InterruptedFlag *interrupted);
+
+    /**
+     * Loads several files at once, parsing them concurrently on numThreads threads
+     * (0 means the number of hardware threads). fileSystemFileNames may be empty,
+     * meaning that they are the same as displayNames. The result is the same as
+     * calling loadFile() for each file in order (including the assigned IDs):
+     * returns the loaded files in the order of displayNames, with nullptr for skipped
+     * files. If loading a file fails, the files before it remain loaded, and the
+     * exception is rethrown.
+     */
+    ResultFileList loadFiles(const std::vector<std::string>& displayNames, const std::vector<std::string>& fileSystemFileNames, int flags, InterruptedFlag *interrupted, int numThreads=0);
     void setFileInput(ResultFile *file, const char *inputName); // for the "Inputs" page in the IDE
     void unloadFile(ResultFile *file);
     void unloadFile(const char *displayName);
@@ -28,6 +28,7 @@
 #include "indexfilewriter.h"
 #include "vectorfileindexer.h"
 #include "indexedvectorfilereader.h"
+#include "binaryvectorfilereader.h"
 #include "vectorfileindex.h"
 
 using namespace std;
@@ -57,6 +58,9 @@ static string createTempFileName(const string& baseFileName)
 // TODO: adjacent blocks are merged
 void VectorFileIndexer::generateIndex(const char *vectorFileName, IProgressMonitor *monitor)
 {
+    if (BinaryVectorFileReader::isBinaryVectorFile(vectorFileName))
+        throw opp_runtime_error("Cannot index binary vector file '%s', its index is only written by the simulation", vectorFileName);
+
     FileReader reader(vectorFileName);
     LineTokenizer tokenizer(1024);
     VectorFileIndex index;
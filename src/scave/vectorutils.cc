@@ -25,6 +25,7 @@
 #include "xyarray.h"
 #include "resultfilemanager.h"
 #include "indexedvectorfilereader.h"
+#include "binaryvectorfilereader.h"
 #include "sqliteresultfileutils.h"
 #include "sqlitevectordatareader.h"
 #include "interruptedflag.h"
@@ -91,6 +92,51 @@ vector<XYArray *> readVectorsIntoArrays(ResultFileManager *manager, const IDList
                 throw InterruptedException("Vector loading interrupted");
         };
 
+        const char *fileName = resultFile->getFileSystemFilePath().c_str();
+        if (BinaryVectorFileReader::isBinaryVectorFile(fileName)) {
+            // columns of binary files are appended to the arrays as they are, without going through VectorDatum
+            auto columnsAdapter = [&](const BinaryVectorFileReader::Columns& columns) {
+                memoryUsedBytes += columns.count * elementSize;
+                if (memoryUsedBytes > memoryLimitBytes)
+                    throw opp_runtime_error("Memory limit exceeded during vector data loading");
+
+                XYArray *array = result[vectorIdToIndex.at(columns.vectorId)];
+                size_t n = columns.count;
+                array->xs.reserve(array->xs.size() + n);
+                for (size_t i = 0; i < n; i++)
+                    array->xs.push_back(BigDecimal(columns.rawTimes[i], columns.simtimeScaleExp).dbl());
+                array->ys.insert(array->ys.end(), columns.values, columns.values + n);
+                if (includePreciseX) {
+                    array->xps.reserve(array->xps.size() + n);
+                    for (size_t i = 0; i < n; i++)
+                        array->xps.push_back(BigDecimal(columns.rawTimes[i], columns.simtimeScaleExp));
+                }
+                if (includeEventNumbers) {
+                    if (columns.eventNumbers)
+                        array->ens.insert(array->ens.end(), columns.eventNumbers, columns.eventNumbers + n);
+                    else
+                        array->ens.resize(array->ens.size() + n, -1);
+                }
+
+                if (interrupted != nullptr && interrupted->flag)
+                    throw InterruptedException("Vector loading interrupted");
+            };
+
+            try {
+                BinaryVectorFileReader reader(fileName, includeEventNumbers, IVectorDataReader::AdapterLambdaType(), resultFile->getFingerprint());
+                reader.collectColumns(vectorIdsInFile, simTimeStart, simTimeEnd, columnsAdapter);
+            }
+            catch (std::exception &e) {
+                for (XYArray *a : result)
+                    delete a;
+                result.clear();
+                result.shrink_to_fit();
+                malloc_trim();
+                throw;
+            }
+            continue;
+        }
+
         IVectorDataReader *reader;
         if (SqliteResultFileUtils::isSqliteFile(resultFile->getFileSystemFilePath().c_str()))
             reader = new SqliteVectorDataReader(resultFile->getFileSystemFilePath().c_str(), includeEventNumbers, adapter, resultFile->getFingerprint());
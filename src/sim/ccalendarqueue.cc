@@ -0,0 +1,382 @@
+//=========================================================================
+//  CCALENDARQUEUE.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//   Member functions of
+//    cCalendarQueue : future event set, implemented as calendar queue
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+//  Based on: R. Brown: Calendar Queues: A Fast O(1) Priority Queue
+//  Implementation for the Simulation Event Set Problem. CACM 31(10), 1988.
+
+#include <algorithm>
+#include <sstream>
+#include "omnetpp/globals.h"
+#include "omnetpp/cevent.h"
+#include "omnetpp/ccalendarqueue.h"
+
+namespace omnetpp {
+
+Register_Class(cCalendarQueue);
+
+// number of events sampled from the front of the queue for computing the bucket width
+#define WIDTH_SAMPLE_SIZE   25
+
+// removed items at the front of a bucket are only physically erased above this count
+#define BUCKET_COMPACT_THRESHOLD  32
+
+// the number of buckets is never decreased below this value
+#define MIN_NUM_BUCKETS     16
+
+inline bool precedes(const cEvent *a, const cEvent *b)
+{
+    return a->shouldPrecede(b);
+}
+
+cCalendarQueue::cCalendarQueue(const char *name, int initialNumBuckets) : cFutureEventSet(name)
+{
+    numBuckets = 1;
+    while (numBuckets < initialNumBuckets)
+        numBuckets *= 2;  // must be power of 2
+    buckets.resize(numBuckets);
+}
+
+cCalendarQueue::cCalendarQueue(const cCalendarQueue& other) : cFutureEventSet(other)
+{
+    copy(other);
+}
+
+cCalendarQueue::~cCalendarQueue()
+{
+    clear();
+}
+
+std::string cCalendarQueue::str() const
+{
+    if (isEmpty())
+        return std::string("empty");
+    std::stringstream out;
+    out << "length=" << getLength() << ", buckets=" << numBuckets;
+    return out.str();
+}
+
+void cCalendarQueue::forEachChild(cVisitor *v)
+{
+    sort();
+
+    for (cEvent *event : array)
+        if (!v->visit(event))
+            return;
+}
+
+void cCalendarQueue::clear()
+{
+    for (Bucket& bucket : buckets) {
+        for (size_t i = bucket.head; i < bucket.events.size(); i++)
+            dropAndDelete(bucket.events[i]);
+        bucket.events.clear();
+        bucket.head = 0;
+    }
+    length = 0;
+    currentDay = 0;
+    invalidate();
+    array.clear();
+}
+
+void cCalendarQueue::copy(const cCalendarQueue& other)
+{
+    numBuckets = other.numBuckets;
+    bucketWidth = other.bucketWidth;
+    insertCount = other.insertCount;
+    buckets.clear();
+    buckets.resize(numBuckets);
+    currentDay = other.currentDay;
+    length = 0;
+    invalidate();
+
+    for (const Bucket& bucket : other.buckets) {
+        for (size_t i = bucket.head; i < bucket.events.size(); i++) {
+            cEvent *event = bucket.events[i]->dup();
+            event->insertOrder = bucket.events[i]->insertOrder;
+            take(event);
+            bucketInsert(event);
+            length++;
+        }
+    }
+}
+
+cCalendarQueue& cCalendarQueue::operator=(const cCalendarQueue& other)
+{
+    if (this == &other)
+        return *this;
+    cFutureEventSet::operator=(other);
+    clear();
+    copy(other);
+    return *this;
+}
+
+int64_t cCalendarQueue::dayOf(const cEvent *event) const
+{
+    return event->getArrivalTime().raw() / bucketWidth;
+}
+
+void cCalendarQueue::insert(cEvent *event)
+{
+    take(event);
+    event->insertOrder = insertCount++;
+    bucketInsert(event);
+    length++;
+
+    if (length > 2*numBuckets)
+        resize(2*numBuckets);
+}
+
+void cCalendarQueue::bucketInsert(cEvent *event)
+{
+    int64_t day = dayOf(event);
+    int index = bucketOf(day);
+    Bucket& bucket = buckets[index];
+
+    // appending is by far the most common case (e.g. zero-delay events), so check it first
+    if (bucket.isEmpty() || precedes(bucket.events.back(), event))
+        bucket.events.push_back(event);
+    else {
+        auto it = std::upper_bound(bucket.events.begin() + bucket.head, bucket.events.end(), event, precedes);
+        bucket.events.insert(it, event);
+    }
+    event->heapIndex = index;
+
+    if (day < currentDay)
+        currentDay = day;
+    if (firstBucket != -1 && precedes(event, buckets[firstBucket].front()))
+        firstBucket = index;
+    arrayDirty = true;
+}
+
+void cCalendarQueue::bucketRemove(Bucket& bucket, size_t pos)
+{
+    if (pos == bucket.head) {
+        bucket.head++;
+        if (bucket.head == bucket.events.size()) {
+            bucket.events.clear();
+            bucket.head = 0;
+        }
+        else if (bucket.head >= BUCKET_COMPACT_THRESHOLD && 2*bucket.head >= bucket.events.size()) {
+            bucket.events.erase(bucket.events.begin(), bucket.events.begin() + bucket.head);
+            bucket.head = 0;
+        }
+    }
+    else {
+        bucket.events.erase(bucket.events.begin() + pos);
+    }
+}
+
+int cCalendarQueue::findFirst() const
+{
+    if (length == 0)
+        return -1;
+    if (firstBucket != -1)
+        return firstBucket;
+
+    // scan one "year" starting from the current day; all events are on or after currentDay
+    for (int i = 0; i < numBuckets; i++) {
+        int64_t day = currentDay + i;
+        int index = bucketOf(day);
+        const Bucket& bucket = buckets[index];
+        if (!bucket.isEmpty() && dayOf(bucket.front()) == day) {
+            currentDay = day;
+            return firstBucket = index;
+        }
+    }
+
+    // no event within a year: fall back to direct search among the bucket heads
+    int best = -1;
+    for (int i = 0; i < numBuckets; i++)
+        if (!buckets[i].isEmpty() && (best == -1 || precedes(buckets[i].front(), buckets[best].front())))
+            best = i;
+    ASSERT(best != -1);
+    currentDay = dayOf(buckets[best].front());
+    return firstBucket = best;
+}
+
+cEvent *cCalendarQueue::peekFirst() const
+{
+    int index = findFirst();
+    return index == -1 ? nullptr : buckets[index].front();
+}
+
+cEvent *cCalendarQueue::removeFirst()
+{
+    int index = findFirst();
+    if (index == -1)
+        return nullptr;
+
+    Bucket& bucket = buckets[index];
+    cEvent *event = bucket.front();
+    bucketRemove(bucket, bucket.head);
+    length--;
+    invalidate();
+
+    drop(event);
+    event->heapIndex = -1;
+
+    if (length < numBuckets/2 && numBuckets > MIN_NUM_BUCKETS)
+        resize(numBuckets/2);
+    return event;
+}
+
+cEvent *cCalendarQueue::remove(cEvent *event)
+{
+    // make sure it is really in the queue
+    if (event->heapIndex == -1)
+        return nullptr;
+
+    Bucket& bucket = buckets[event->heapIndex];
+    auto it = std::lower_bound(bucket.events.begin() + bucket.head, bucket.events.end(), event, precedes);
+    ASSERT(it != bucket.events.end() && *it == event);  // sanity check
+    bucketRemove(bucket, it - bucket.events.begin());
+    length--;
+    invalidate();
+
+    drop(event);
+    event->heapIndex = -1;
+
+    if (length < numBuckets/2 && numBuckets > MIN_NUM_BUCKETS)
+        resize(numBuckets/2);
+    return event;
+}
+
+void cCalendarQueue::putBackFirst(cEvent *event)
+{
+    take(event);
+    bucketInsert(event);  // note: insertOrder is retained
+    length++;
+}
+
+void cCalendarQueue::resize(int newNumBuckets)
+{
+    std::vector<cEvent*> events;
+    events.reserve(length);
+    for (Bucket& bucket : buckets)
+        for (size_t i = bucket.head; i < bucket.events.size(); i++)
+            events.push_back(bucket.events[i]);
+
+    bucketWidth = computeBucketWidth(events);
+
+    buckets.clear();
+    buckets.resize(newNumBuckets);
+    numBuckets = newNumBuckets;
+    currentDay = INT64_MAX;  // will be lowered by the insertions
+    invalidate();
+
+    for (cEvent *event : events)
+        bucketInsert(event);
+    if (events.empty())
+        currentDay = 0;
+}
+
+int64_t cCalendarQueue::computeBucketWidth(std::vector<cEvent*>& events) const
+{
+    // Brown's heuristic: bucket width is 3 times the average separation of the
+    // events at the front of the queue, with large separations excluded
+    int n = std::min((int)events.size(), WIDTH_SAMPLE_SIZE);
+    if (n < 2)
+        return bucketWidth;
+    std::partial_sort(events.begin(), events.begin() + n, events.end(), precedes);
+
+    double sum = 0;
+    for (int i = 1; i < n; i++)
+        sum += (double)(events[i]->getArrivalTime().raw() - events[i-1]->getArrivalTime().raw());
+    double avg = sum / (n-1);
+
+    double sum2 = 0;
+    int count2 = 0;
+    for (int i = 1; i < n; i++) {
+        double gap = (double)(events[i]->getArrivalTime().raw() - events[i-1]->getArrivalTime().raw());
+        if (gap <= 2*avg) {
+            sum2 += gap;
+            count2++;
+        }
+    }
+    if (count2 == 0 || sum2 == 0)
+        return bucketWidth;  // all sampled events are at the same time, keep current width
+
+    double width = 3 * sum2 / count2;
+    return width < 1 ? 1 : width > (double)(INT64_MAX/2) ? INT64_MAX/2 : (int64_t)width;
+}
+
+void cCalendarQueue::updateArray() const
+{
+    if (arrayDirty) {
+        array.clear();
+        array.reserve(length);
+        for (const Bucket& bucket : buckets)
+            for (size_t i = bucket.head; i < bucket.events.size(); i++)
+                array.push_back(bucket.events[i]);
+        arrayDirty = false;
+    }
+}
+
+cEvent *cCalendarQueue::get(int k)
+{
+    if (k < 0 || k >= length)
+        return nullptr;
+    updateArray();
+    return array[k];
+}
+
+void cCalendarQueue::sort()
+{
+    updateArray();
+    std::sort(array.begin(), array.end(), precedes);
+}
+
+// like ASSERT(), but active in release mode as well
+#define ENSURE(expr) \
+  ((void) ((expr) ? 0 : (throw omnetpp::cRuntimeError("ENSURE(): Condition '%s' does not hold in function '%s' at %s:%d", \
+                                   #expr, __FUNCTION__, __FILE__, __LINE__), 0)))
+
+void cCalendarQueue::checkQueue()
+{
+    ENSURE((numBuckets & (numBuckets-1)) == 0); // numBuckets must be power of 2
+    ENSURE((int)buckets.size() == numBuckets);
+    ENSURE(bucketWidth > 0);
+
+    int count = 0;
+    for (int index = 0; index < numBuckets; index++) {
+        const Bucket& bucket = buckets[index];
+        ENSURE(bucket.head <= bucket.events.size());
+        for (size_t i = bucket.head; i < bucket.events.size(); i++) {
+            cEvent *event = bucket.events[i];
+            ENSURE(event->getOwner() == this);
+            ENSURE(event->heapIndex == index);
+            ENSURE(bucketOf(dayOf(event)) == index);
+            ENSURE(dayOf(event) >= currentDay);
+            if (i > bucket.head)
+                ENSURE(precedes(bucket.events[i-1], event)); // sort order within bucket
+            count++;
+        }
+    }
+    ENSURE(count == length);
+
+    if (firstBucket != -1) {
+        cEvent *first = buckets[firstBucket].front();
+        for (const Bucket& bucket : buckets)
+            if (!bucket.isEmpty())
+                ENSURE(!precedes(bucket.front(), first));
+    }
+}
+
+}  // namespace omnetpp
+
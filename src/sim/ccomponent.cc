@@ -15,6 +15,7 @@
 
 #include <algorithm>
 #include <mutex>
+#include <unordered_map>
 #include "common/stringutil.h"
 #include "common/stlutil.h"
 #include "omnetpp/ccomponent.h"
@@ -57,6 +58,30 @@ OPP_THREAD_LOCAL int cComponent::notificationSP = 0;
 
 OPP_THREAD_LOCAL bool cComponent::checkSignals;
 
+OPP_THREAD_LOCAL uint64_t cComponent::dispatchCacheGeneration = 0;
+
+// Listener lists to notify when a given signal is emitted by the component:
+// its own list plus those of its ancestors (bottom-up), with listener-less
+// levels skipped. Lists are stored (as opposed to individual listeners) so
+// that they can be pushed on the notification stack, just like in fire().
+struct cComponent::SignalDispatchEntry {
+    struct Level {
+        cComponent *component;
+        cIListener **listeners;
+    };
+    std::vector<Level> levels;
+};
+
+// Per-component cache for emit(). Entries are computed on demand per signal,
+// and are dropped by invalidateDispatchCaches() when a listener list of the
+// component or an ancestor changes. The bit sets are indexed by signalID, and
+// make emitting to a signal without listeners cost a single bit test.
+struct cComponent::SignalDispatchCache {
+    std::vector<uint64_t> knownBits;  // whether signal has been looked up
+    std::vector<uint64_t> listenedBits;  // whether signal has listeners (valid if known)
+    std::unordered_map<simsignal_t,SignalDispatchEntry> entries;  // only for signals with listeners
+};
+
 simsignal_t PRE_MODEL_CHANGE = cComponent::registerSignal("PRE_MODEL_CHANGE");
 simsignal_t POST_MODEL_CHANGE = cComponent::registerSignal("POST_MODEL_CHANGE");
 
@@ -101,6 +126,7 @@ cComponent::~cComponent()
     delete[] rngMap;
     delete[] parArray;
     delete displayString;
+    delete dispatchCache;
 
     if (selfPointers) {
         for (void **pptr : *selfPointers)
@@ -654,40 +680,35 @@ void cComponent::emit(simsignal_t signalID, bool b, cObject *details)
 {
     if (checkSignals)
         getComponentType()->checkSignal(signalID, SIMSIGNAL_BOOL);
-    if (mayHaveListeners(signalID))
-        fire(this, signalID, b, details);
+    dispatch(signalID, b, details);
 }
 
 void cComponent::doEmit(simsignal_t signalID, intval_t i, cObject *details)
 {
     if (checkSignals)
         getComponentType()->checkSignal(signalID, SIMSIGNAL_INT);
-    if (mayHaveListeners(signalID))
-        fire(this, signalID, i, details);
+    dispatch(signalID, i, details);
 }
 
 void cComponent::doEmit(simsignal_t signalID, uintval_t i, cObject *details)
 {
     if (checkSignals)
         getComponentType()->checkSignal(signalID, SIMSIGNAL_UINT);
-    if (mayHaveListeners(signalID))
-        fire(this, signalID, i, details);
+    dispatch(signalID, i, details);
 }
 
 void cComponent::emit(simsignal_t signalID, double d, cObject *details)
 {
     if (checkSignals)
         getComponentType()->checkSignal(signalID, SIMSIGNAL_DOUBLE);
-    if (mayHaveListeners(signalID))
-        fire(this, signalID, d, details);
+    dispatch(signalID, d, details);
 }
 
 void cComponent::emit(simsignal_t signalID, const SimTime& t, cObject *details)
 {
     if (checkSignals)
         getComponentType()->checkSignal(signalID, SIMSIGNAL_SIMTIME);
-    if (mayHaveListeners(signalID))
-        fire(this, signalID, t, details);
+    dispatch(signalID, t, details);
 }
 
 void cComponent::emit(simsignal_t signalID, const char *s, cObject *details)
@@ -696,16 +717,33 @@ void cComponent::emit(simsignal_t signalID, const char *s, cObject *details)
         throw cRuntimeError(this, "emit(): Emitting nullptr as string (const char *) signal value is not allowed, signalID=%d", signalID);
     if (checkSignals)
         getComponentType()->checkSignal(signalID, SIMSIGNAL_STRING);
-    if (mayHaveListeners(signalID))
-        fire(this, signalID, s, details);
+    dispatch(signalID, s, details);
 }
 
 void cComponent::emit(simsignal_t signalID, cObject *obj, cObject *details)
 {
     if (checkSignals)
         getComponentType()->checkSignal(signalID, SIMSIGNAL_OBJECT, obj);
-    if (mayHaveListeners(signalID))
-        fire(this, signalID, obj, details);
+    dispatch(signalID, obj, details);
+}
+
+template<typename T>
+void cComponent::notifyListeners(cIListener **listeners, cComponent *source, simsignal_t signalID, T x, cObject *details)
+{
+    if (notificationSP >= NOTIFICATION_STACK_SIZE)
+        throw cRuntimeError(this, "emit(): Recursive notification stack overflow, signalID=%d", signalID);
+
+    int oldNotificationSP = notificationSP;
+    try {
+        notificationStack[notificationSP++] = listeners;  // lock against modification
+        for (int i = 0; listeners[i]; i++)
+            listeners[i]->receiveSignal(source, signalID, x, details);  // will crash if listener is already deleted
+        notificationSP--;
+    }
+    catch (std::exception& e) {
+        notificationSP = oldNotificationSP;
+        throw;
+    }
 }
 
 template<typename T>
@@ -713,23 +751,8 @@ void cComponent::fire(cComponent *source, simsignal_t signalID, T x, cObject *de
 {
     // notify local listeners if there are any
     SignalListenerList *listenerList = findListenerList(signalID);
-    if (listenerList) {
-        cIListener **listeners = listenerList->listeners;
-        if (notificationSP >= NOTIFICATION_STACK_SIZE)
-            throw cRuntimeError(this, "emit(): Recursive notification stack overflow, signalID=%d", signalID);
-
-        int oldNotificationSP = notificationSP;
-        try {
-            notificationStack[notificationSP++] = listeners;  // lock against modification
-            for (int i = 0; listeners[i]; i++)
-                listeners[i]->receiveSignal(source, signalID, x, details);  // will crash if listener is already deleted
-            notificationSP--;
-        }
-        catch (std::exception& e) {
-            notificationSP = oldNotificationSP;
-            throw;
-        }
-    }
+    if (listenerList)
+        notifyListeners(listenerList->listeners, source, signalID, x, details);
 
     // notify ancestors recursively
     cModule *parent = getParentModule();
@@ -737,6 +760,109 @@ void cComponent::fire(cComponent *source, simsignal_t signalID, T x, cObject *de
         parent->fire(source, signalID, x, details);
 }
 
+template<typename T>
+void cComponent::dispatch(simsignal_t signalID, T x, cObject *details)
+{
+    const SignalDispatchEntry *entry = getDispatchEntry(signalID);
+    if (!entry)
+        return;
+
+    // Listeners may subscribe/unsubscribe or move modules while being notified,
+    // which invalidates (and may free) the entry. In that case, continue with
+    // the slow path from the next ancestor, to preserve fire()'s semantics.
+    uint64_t generation = dispatchCacheGeneration;
+    int n = entry->levels.size();
+    for (int i = 0; i < n; i++) {
+        cComponent *component = entry->levels[i].component;
+        component->notifyListeners(entry->levels[i].listeners, this, signalID, x, details);
+        if (dispatchCacheGeneration != generation) {
+            if (i < n-1) {
+                cModule *parent = component->getParentModule();
+                if (parent)
+                    parent->fire(this, signalID, x, details);
+            }
+            return;
+        }
+    }
+}
+
+const cComponent::SignalDispatchEntry *cComponent::getDispatchEntry(simsignal_t signalID) const
+{
+    if (!dispatchCache)
+        dispatchCache = new SignalDispatchCache;
+
+    // fast path: look up bit sets
+    size_t word = (size_t)signalID >> 6;
+    uint64_t bit = (uint64_t)1 << (signalID & 63);
+    if (signalID >= 0 && word < dispatchCache->knownBits.size() && (dispatchCache->knownBits[word] & bit) != 0)
+        return (dispatchCache->listenedBits[word] & bit) != 0 ? &dispatchCache->entries[signalID] : nullptr;
+
+    // slow path: validate signalID, then collect listener lists up to the root
+    int lastId;
+    {
+        std::lock_guard<std::recursive_mutex> lock(signalRegistrationsMutex);
+        if (signalID < 0 || signalID > signals_->lastId)
+            throwInvalidSignalID(signalID);
+        lastId = signals_->lastId;
+    }
+
+    SignalDispatchEntry entry;
+    for (const cComponent *component = this; component; component = component->getParentModule()) {
+        SignalListenerList *listenerList = component->findListenerList(signalID);
+        if (listenerList && listenerList->hasListener())
+            entry.levels.push_back({const_cast<cComponent *>(component), listenerList->listeners});
+    }
+
+    size_t numWords = (lastId >> 6) + 1;
+    if (dispatchCache->knownBits.size() < numWords) {
+        dispatchCache->knownBits.resize(numWords, 0);
+        dispatchCache->listenedBits.resize(numWords, 0);
+    }
+    dispatchCache->knownBits[word] |= bit;
+    if (entry.levels.empty())
+        return nullptr;
+    dispatchCache->listenedBits[word] |= bit;
+    SignalDispatchEntry& result = dispatchCache->entries[signalID];
+    result = std::move(entry);
+    return &result;
+}
+
+void cComponent::invalidateDispatchCaches(simsignal_t signalID)
+{
+    // only this component and its descendants may have cached our listener
+    // lists; the entries are rebuilt lazily, on their next emit()
+    dispatchCacheGeneration++;
+    invalidateDispatchCachesRec(signalID);
+}
+
+void cComponent::invalidateDispatchCachesRec(simsignal_t signalID)
+{
+    if (dispatchCache) {
+        if (signalID == SIMSIGNAL_NULL) {
+            dispatchCache->knownBits.clear();
+            dispatchCache->listenedBits.clear();
+            dispatchCache->entries.clear();
+        }
+        else {
+            size_t word = (size_t)signalID >> 6;
+            uint64_t bit = (uint64_t)1 << (signalID & 63);
+            if (word < dispatchCache->knownBits.size()) {
+                dispatchCache->knownBits[word] &= ~bit;
+                dispatchCache->listenedBits[word] &= ~bit;
+            }
+            dispatchCache->entries.erase(signalID);
+        }
+    }
+
+    if (isModule()) {
+        cModule *module = static_cast<cModule *>(this);
+        for (cModule::ChannelIterator it(module); !it.end(); ++it)
+            (*it)->invalidateDispatchCachesRec(signalID);
+        for (cModule::SubmoduleIterator it(module); !it.end(); ++it)
+            (*it)->invalidateDispatchCachesRec(signalID);
+    }
+}
+
 void cComponent::fireFinish()
 {
     if (signalTable) {
@@ -761,6 +887,7 @@ void cComponent::subscribe(simsignal_t signalID, cIListener *listener)
     if (!listenerList->addListener(listener))
         throw cRuntimeError(this, "subscribe(): Listener already subscribed at this component to signal '%s' (id=%d)", getSignalName(signalID), signalID);
     signals_->listenerCounts[signalID]++;
+    invalidateDispatchCaches(signalID);
     listener->subscriptions.push_back(std::pair<cComponent*,simsignal_t>(this,signalID));
     listener->subscribedTo(this, signalID);
 }
@@ -786,6 +913,7 @@ void cComponent::unsubscribe(simsignal_t signalID, cIListener *listener)
 
     signals_->listenerCounts[signalID]--;
     ASSERT(signals_->listenerCounts[signalID] >= 0);
+    invalidateDispatchCaches(signalID);
     auto subscription = std::pair<cComponent*,simsignal_t>(this,signalID);
     ASSERT(contains(listener->subscriptions, subscription));
     remove(listener->subscriptions, subscription);
@@ -33,6 +33,15 @@
 #include "task.h"  // Stig Kofoed's "Portable Multitasking" coroutine library
 #endif
 
+#ifdef USE_ASM_COROUTINES
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 namespace omnetpp {
 
 #ifdef USE_PORTABLE_COROUTINES  /* coroutine stacks reside in main stack area */
@@ -208,6 +217,303 @@ unsigned cCoroutine::getStackUsage() const
 
 #endif
 
+#ifdef USE_ASM_COROUTINES
+
+//
+// Context switching. opp_coroutine_switch(from, to) pushes the callee-saved
+// registers onto the current stack, stores the stack pointer into *from,
+// loads the stack pointer from 'to', and pops the registers from there.
+// A new coroutine starts in opp_coroutine_start with the function pointer
+// and the argument placed into callee-saved registers by setup().
+//
+extern "C" void opp_coroutine_switch(void **from, void *to);
+extern "C" void opp_coroutine_start();
+
+#ifdef __APPLE__
+# define COROUTINE_SECTION_BEGIN  ".text\n"
+# define COROUTINE_SECTION_END  ""
+# define COROUTINE_FUNCTION(name)  ".globl _" #name "\n.p2align 4\n_" #name ":\n"
+# define COROUTINE_FUNCTION_END(name)  ""
+# define COROUTINE_CALL_ABORT  "_abort"
+#else
+# define COROUTINE_SECTION_BEGIN  ".pushsection .text\n"
+# define COROUTINE_SECTION_END  ".popsection\n"
+# define COROUTINE_FUNCTION(name)  ".globl " #name "\n.type " #name ",%function\n.p2align 4\n" #name ":\n"
+# define COROUTINE_FUNCTION_END(name)  ".size " #name ",.-" #name "\n"
+# if defined(__x86_64__)
+#  define COROUTINE_CALL_ABORT  "abort@PLT"
+# else
+#  define COROUTINE_CALL_ABORT  "abort"
+# endif
+#endif
+
+#if defined(__x86_64__)
+
+// frame: mxcsr+x87cw, r15, r14, r13, r12, rbx, rbp, return address
+# define FRAME_SLOTS      8
+# define FRAME_FNP_SLOT   4  // r12
+# define FRAME_ARG_SLOT   3  // r13
+# define FRAME_RET_SLOT   7
+# define FRAME_FPCSR_SLOT 0
+# define DEFAULT_FPCSR    ((uint64_t)0x037F << 32 | 0x1F80)  // x87 control word and MXCSR after reset
+
+asm(COROUTINE_SECTION_BEGIN
+    COROUTINE_FUNCTION(opp_coroutine_switch)
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    subq $8, %rsp\n"
+    "    stmxcsr (%rsp)\n"
+    "    fnstcw 4(%rsp)\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    ldmxcsr (%rsp)\n"
+    "    fldcw 4(%rsp)\n"
+    "    addq $8, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    COROUTINE_FUNCTION_END(opp_coroutine_switch)
+    COROUTINE_FUNCTION(opp_coroutine_start)
+    "    .cfi_startproc\n"
+    "    .cfi_undefined rip\n"  // end of call chain for debuggers and unwinders
+    "    movq %r13, %rdi\n"
+    "    callq *%r12\n"
+    "    callq " COROUTINE_CALL_ABORT "\n"  // coroutine functions must not return
+    "    .cfi_endproc\n"
+    COROUTINE_FUNCTION_END(opp_coroutine_start)
+    COROUTINE_SECTION_END
+);
+
+#elif defined(__aarch64__)
+
+// frame: x19..x28, x29 (fp), x30 (lr), d8..d15, fpcr, padding
+# define FRAME_SLOTS      22
+# define FRAME_FNP_SLOT   0   // x19
+# define FRAME_ARG_SLOT   1   // x20
+# define FRAME_RET_SLOT   11  // x30
+# define FRAME_FPCSR_SLOT 20
+# define DEFAULT_FPCSR    0
+
+asm(COROUTINE_SECTION_BEGIN
+    COROUTINE_FUNCTION(opp_coroutine_switch)
+    "    sub sp, sp, #176\n"
+    "    stp x19, x20, [sp, #0]\n"
+    "    stp x21, x22, [sp, #16]\n"
+    "    stp x23, x24, [sp, #32]\n"
+    "    stp x25, x26, [sp, #48]\n"
+    "    stp x27, x28, [sp, #64]\n"
+    "    stp x29, x30, [sp, #80]\n"
+    "    stp d8, d9, [sp, #96]\n"
+    "    stp d10, d11, [sp, #112]\n"
+    "    stp d12, d13, [sp, #128]\n"
+    "    stp d14, d15, [sp, #144]\n"
+    "    mrs x9, fpcr\n"
+    "    str x9, [sp, #160]\n"
+    "    mov x9, sp\n"
+    "    str x9, [x0]\n"
+    "    mov sp, x1\n"
+    "    ldp x19, x20, [sp, #0]\n"
+    "    ldp x21, x22, [sp, #16]\n"
+    "    ldp x23, x24, [sp, #32]\n"
+    "    ldp x25, x26, [sp, #48]\n"
+    "    ldp x27, x28, [sp, #64]\n"
+    "    ldp x29, x30, [sp, #80]\n"
+    "    ldp d8, d9, [sp, #96]\n"
+    "    ldp d10, d11, [sp, #112]\n"
+    "    ldp d12, d13, [sp, #128]\n"
+    "    ldp d14, d15, [sp, #144]\n"
+    "    ldr x9, [sp, #160]\n"
+    "    msr fpcr, x9\n"
+    "    add sp, sp, #176\n"
+    "    ret\n"
+    COROUTINE_FUNCTION_END(opp_coroutine_switch)
+    COROUTINE_FUNCTION(opp_coroutine_start)
+    "    .cfi_startproc\n"
+    "    .cfi_undefined x30\n"  // end of call chain for debuggers and unwinders
+    "    mov x0, x20\n"
+    "    blr x19\n"
+    "    bl " COROUTINE_CALL_ABORT "\n"  // coroutine functions must not return
+    "    .cfi_endproc\n"
+    COROUTINE_FUNCTION_END(opp_coroutine_start)
+    COROUTINE_SECTION_END
+);
+
+#else
+# error "USE_ASM_COROUTINES is only supported on x86-64 and aarch64"
+#endif
+
+// max number of free stacks kept for reuse, per thread
+#define STACK_POOL_LIMIT  256
+
+namespace {
+
+// Stacks with a guard page below them. Freed stacks are kept for reuse,
+// because mmap()/munmap() are relatively expensive.
+class StackPool
+{
+  private:
+    std::map<size_t,std::vector<char*>> freeStacks;  // usable size -> stacks
+    int numFreeStacks = 0;
+
+  public:
+    static size_t getPageSize() {
+        static size_t pageSize = sysconf(_SC_PAGESIZE);
+        return pageSize;
+    }
+
+    ~StackPool() {
+        for (auto& pair : freeStacks)
+            for (char *stack : pair.second)
+                unmap(stack, pair.first);
+    }
+
+    // returns the lowest address of the usable area, or nullptr
+    char *allocate(size_t size) {
+        auto it = freeStacks.find(size);
+        if (it != freeStacks.end() && !it->second.empty()) {
+            char *stack = it->second.back();
+            it->second.pop_back();
+            numFreeStacks--;
+            return stack;
+        }
+        size_t pageSize = getPageSize();
+        int flags = MAP_PRIVATE | MAP_ANON;
+#ifdef MAP_NORESERVE
+        flags |= MAP_NORESERVE;  // memory is only committed when used
+#endif
+#ifdef MAP_STACK
+        flags |= MAP_STACK;
+#endif
+        void *p = mmap(nullptr, size + pageSize, PROT_READ|PROT_WRITE, flags, -1, 0);
+        if (p == MAP_FAILED)
+            return nullptr;
+        if (mprotect(p, pageSize, PROT_NONE) != 0) {  // stacks grow downwards
+            munmap(p, size + pageSize);
+            return nullptr;
+        }
+        return (char *)p + pageSize;
+    }
+
+    void release(char *stack, size_t size) {
+        if (numFreeStacks >= STACK_POOL_LIMIT) {
+            unmap(stack, size);
+            return;
+        }
+        freeStacks[size].push_back(stack);
+        numFreeStacks++;
+    }
+
+    static void unmap(char *stack, size_t size) {
+        size_t pageSize = getPageSize();
+        munmap(stack - pageSize, size + pageSize);
+    }
+};
+
+OPP_THREAD_LOCAL StackPool stackPool;
+
+}  // namespace
+
+OPP_THREAD_LOCAL bool cCoroutine::initialized;
+OPP_THREAD_LOCAL unsigned cCoroutine::totalStackUsage;
+OPP_THREAD_LOCAL unsigned cCoroutine::totalStackLimit;
+OPP_THREAD_LOCAL void *cCoroutine::mainStackPointer;
+OPP_THREAD_LOCAL void **cCoroutine::curStackPointerPtr;
+
+void cCoroutine::init(unsigned totalStackReq, unsigned /*mainStack*/)
+{
+    if (initialized) {
+        if (totalStackReq != 0 && totalStackUsage > totalStackReq)
+            throw cRuntimeError("cCoroutine::init(): Already using more stack space for coroutines than the newly requested limit (usage=%u, new limit=%u)", totalStackUsage, totalStackReq);
+        totalStackLimit = totalStackReq;
+        return;
+    }
+    curStackPointerPtr = &mainStackPointer;
+    totalStackUsage = 0;
+    totalStackLimit = totalStackReq;
+    initialized = true;
+}
+
+void cCoroutine::switchTo(cCoroutine *cor)
+{
+    void **oldStackPointerPtr = curStackPointerPtr;
+    curStackPointerPtr = &(cor->stackPointer);
+    opp_coroutine_switch(oldStackPointerPtr, cor->stackPointer);
+}
+
+void cCoroutine::switchToMain()
+{
+    if (curStackPointerPtr == &mainStackPointer)
+        return;
+    void **oldStackPointerPtr = curStackPointerPtr;
+    curStackPointerPtr = &mainStackPointer;
+    opp_coroutine_switch(oldStackPointerPtr, mainStackPointer);
+}
+
+cCoroutine::cCoroutine()
+{
+}
+
+cCoroutine::~cCoroutine()
+{
+    if (stackPtr) {
+        totalStackUsage -= stackSize;
+        stackPool.release(stackPtr, stackAllocSize);
+    }
+}
+
+bool cCoroutine::setup(CoroutineFnp fnp, void *arg, unsigned stkSize)
+{
+    if (totalStackLimit != 0 && totalStackUsage + stkSize >= totalStackLimit)
+        return false;
+
+    size_t pageSize = StackPool::getPageSize();
+    size_t allocSize = (stkSize + pageSize - 1) / pageSize * pageSize;
+    if (allocSize < pageSize)
+        allocSize = pageSize;
+    stackPtr = stackPool.allocate(allocSize);
+    if (!stackPtr)
+        return false;
+    stackSize = stkSize;
+    stackAllocSize = allocSize;
+    totalStackUsage += stackSize;
+
+    // build an initial frame that opp_coroutine_switch() will "return" into opp_coroutine_start()
+    uintptr_t top = ((uintptr_t)stackPtr + allocSize) & ~(uintptr_t)15;  // the stack will be 16-byte aligned at the call in opp_coroutine_start()
+    uint64_t *frame = (uint64_t *)top - FRAME_SLOTS;
+    memset(frame, 0, FRAME_SLOTS * sizeof(uint64_t));
+    frame[FRAME_FNP_SLOT] = (uint64_t)(uintptr_t)fnp;
+    frame[FRAME_ARG_SLOT] = (uint64_t)(uintptr_t)arg;
+    frame[FRAME_RET_SLOT] = (uint64_t)(uintptr_t)&opp_coroutine_start;
+    frame[FRAME_FPCSR_SLOT] = DEFAULT_FPCSR;
+    stackPointer = frame;
+    return true;
+}
+
+bool cCoroutine::hasStackOverflow() const
+{
+    return false;
+}
+
+unsigned cCoroutine::getStackSize() const
+{
+    return stackSize;
+}
+
+unsigned cCoroutine::getStackUsage() const
+{
+    return 0;
+}
+
+#endif
+
 #ifdef USE_PORTABLE_COROUTINES
 
 OPP_THREAD_LOCAL unsigned cCoroutine::totalStack;
@@ -21,6 +21,7 @@
 #include "omnetpp/csimulation.h"
 #include "omnetpp/cexception.h"
 #include "omnetpp/cenvir.h"
+#include "memorypool.h"
 
 #ifdef WITH_PARSIM
 #include "omnetpp/ccommbuffer.h"
@@ -29,6 +30,26 @@
 using namespace omnetpp;
 
 using std::ostream;
+using omnetpp::internal::MemoryPool;
+
+void *cEvent::operator new(size_t size)
+{
+    cSimulation *simulation = cSimulation::getActiveSimulation();
+    MemoryPool *pool = simulation ? simulation->getEventPool() : nullptr;
+    return pool ? pool->allocate(size) : ::operator new(size);
+}
+
+void cEvent::operator delete(void *p, size_t size)
+{
+    // note: the pool of the currently active simulation is used, which is not
+    // necessarily the one the object was allocated from; this is allowed
+    cSimulation *simulation = cSimulation::getActiveSimulation();
+    MemoryPool *pool = simulation ? simulation->getEventPool() : nullptr;
+    if (pool)
+        pool->deallocate(p, size);
+    else
+        ::operator delete(p);
+}
 
 std::string cEvent::str() const
 {
@@ -5,7 +5,7 @@
 //           Discrete System Simulation in C++
 //
 //   Member functions of
-//    cEventHeap : future event set, implemented as heap
+//    cEventHeap : future event set, implemented as 4-ary heap
 //
 //=========================================================================
 
@@ -22,7 +22,7 @@
 
 #include <cstdio>           // sprintf
 #include <cstring>          // strlen
-#include <cstdlib>          // qsort
+#include <algorithm>        // std::sort
 #include <sstream>
 #include "omnetpp/globals.h"
 #include "omnetpp/cmessage.h"
@@ -36,21 +36,19 @@ Register_Class(cEventHeap);
 #define CBINC(i)          ((i) = ((i)+1)&(cbsize-1))
 #define CBDEC(i)          ((i) = ((i)-1)&(cbsize-1))
 
-inline bool operator>(cEvent& a, cEvent& b)
-{
-    return b.shouldPrecede(&a);
-}
-
-inline bool operator<=(cEvent& a, cEvent& b)
-{
-    return !(a > b);
-}
+// heap arity is 4: children of node i are 4i+1..4i+4, parent is (i-1)/4
+#define PARENT(i)         (((i)-1)>>2)
+#define FIRSTCHILD(i)     (((i)<<2)+1)
 
-static int qsort_cmp_msgs(const void *p1, const void *p2)
+// same as cEvent::shouldPrecede(), but works on the inline keys
+template <typename T>
+inline bool precedes(const T& a, const T& b)
 {
-    cEvent *m1 = *(cEvent **)p1;
-    cEvent *m2 = *(cEvent **)p2;
-    return cEvent::compareBySchedulingOrder(m1, m2);
+    return a.arrivalTime < b.arrivalTime ? true :
+           a.arrivalTime > b.arrivalTime ? false :
+           a.priority < b.priority ? true :
+           a.priority > b.priority ? false :
+           a.insertOrder < b.insertOrder;
 }
 
 //----
@@ -58,7 +56,7 @@ static int qsort_cmp_msgs(const void *p1, const void *p2)
 cEventHeap::cEventHeap(const char *name, int intialCapacity) : cFutureEventSet(name),
     heapCapacity(intialCapacity)
 {
-    heap = new cEvent *[heapCapacity+1];  // +1 is necessary because h[0] is not used
+    heap = new HeapEntry[heapCapacity];
     cb = new cEvent *[cbsize];
 }
 
@@ -90,10 +88,9 @@ void cEventHeap::forEachChild(cVisitor *v)
     for (int i = cbhead; i != cbtail; CBINC(i))
         v->visit(cb[i]);
 
-    for (int i = 1; i <= heapLength; i++)
-        if (heap[i])
-            if (!v->visit(heap[i]))
-                return;
+    for (int i = 0; i < heapLength; i++)
+        if (!v->visit(heap[i].event))
+            return;
 }
 
 void cEventHeap::clear()
@@ -102,8 +99,8 @@ void cEventHeap::clear()
         dropAndDelete(cb[i]);
     cbhead = cbtail = 0;
 
-    for (int i = 1; i <= heapLength; i++)
-        dropAndDelete(heap[i]);
+    for (int i = 0; i < heapLength; i++)
+        dropAndDelete(heap[i].event);
     heapLength = 0;
 }
 
@@ -113,9 +110,14 @@ void cEventHeap::copy(const cEventHeap& other)
     heapLength = other.heapLength;
     heapCapacity = other.heapCapacity;
     delete[] heap;
-    heap = new cEvent *[heapCapacity+1];
-    for (int i = 1; i <= heapLength; i++)
-        take(heap[i] = other.heap[i]->dup());
+    heap = new HeapEntry[heapCapacity];
+    for (int i = 0; i < heapLength; i++) {
+        heap[i] = other.heap[i];
+        cEvent *event = heap[i].event = other.heap[i].event->dup();
+        event->insertOrder = other.heap[i].insertOrder;
+        event->heapIndex = i;
+        take(event);
+    }
 
     // copy circular buffer
     cbhead = other.cbhead;
@@ -149,17 +151,18 @@ cEvent *cEventHeap::get(int k)
         return cbget(k);
     k -= cblen;
 
-    // map the rest to h[1]..h[n] (h[] is 1-based)
+    // map the rest to the heap
     if (k >= heapLength)
         return nullptr;
-    return heap[k+1];
+    return heap[k].event;
 }
 
 void cEventHeap::sort()
 {
-    qsort(heap+1, heapLength, sizeof(cEvent *), qsort_cmp_msgs);
-    for (int i = 1; i <= heapLength; i++)
-        heap[i]->heapIndex = i;
+    // note: a sorted array also satisfies the heap property
+    std::sort(heap, heap + heapLength, precedes<HeapEntry>);
+    for (int i = 0; i < heapLength; i++)
+        heap[i].event->heapIndex = i;
 }
 
 void cEventHeap::insert(cEvent *event)
@@ -179,7 +182,7 @@ void cEventHeap::insert(cEvent *event)
     if (event->getArrivalTime() == now) {
         ASSERT(cbhead == cbtail || cb[cbhead]->getArrivalTime() == now); // causality violation
         if (event->getSchedulingPriority() == 0) {
-            if (heapLength == 0 || heap[1]->getArrivalTime() > now)
+            if (heapLength == 0 || heap[0].arrivalTime > now.raw())
                 eligible = true;
         }
         else if (event->getSchedulingPriority() < 0)
@@ -203,23 +206,20 @@ void cEventHeap::cbInsert(cEvent *event)
 
 void cEventHeap::heapInsert(cEvent *event)
 {
-    if (++heapLength > heapCapacity) {
+    if (heapLength == heapCapacity) {
         heapCapacity *= 2;
-        cEvent **newHeap = new cEvent *[heapCapacity+1];
-        for (int i = 1; i <= heapLength-1; i++)
-            newHeap[i] = heap[i];
+        HeapEntry *newHeap = new HeapEntry[heapCapacity];
+        std::copy(heap, heap + heapLength, newHeap);
         delete[] heap;
         heap = newHeap;
     }
 
-    int i, j;
-    for (j = heapLength; j > 1; j = i) {
-        i = j>>1;
-        if (*heap[i] <= *event)  // direction
-            break;
-        (heap[j] = heap[i])->heapIndex = j;
-    }
-    (heap[j] = event)->heapIndex = j;
+    HeapEntry entry;
+    entry.arrivalTime = event->getArrivalTime().raw();
+    entry.insertOrder = event->insertOrder;
+    entry.priority = event->getSchedulingPriority();
+    entry.event = event;
+    siftUp(heapLength++, entry);
 }
 
 void cEventHeap::cbgrow()
@@ -243,30 +243,45 @@ void cEventHeap::flushCb()
     cbtail = cbhead;
 }
 
-void cEventHeap::shiftup(int from)
+void cEventHeap::siftUp(int pos, const HeapEntry& entry)
 {
-    // restores heap structure (in a sub-heap)
-    int i, j;
-    cEvent *temp;
-
-    i = from;
-    while ((j = i<<1) <= heapLength) {
-        if (j < heapLength && (*heap[j] > *heap[j+1]))  // direction
-            j++;
-        if (*heap[i] > *heap[j]) {  // is change necessary?
-            temp = heap[j];
-            (heap[j] = heap[i])->heapIndex = j;
-            (heap[i] = temp)->heapIndex = i;
-            i = j;
-        }
-        else
+    // moves the "hole" at pos upwards until entry can be placed into it
+    while (pos > 0) {
+        int parent = PARENT(pos);
+        if (!precedes(entry, heap[parent]))
+            break;
+        heap[pos] = heap[parent];  // parent is moved down
+        heap[pos].event->heapIndex = pos;
+        pos = parent;
+    }
+    heap[pos] = entry;
+    entry.event->heapIndex = pos;
+}
+
+void cEventHeap::siftDown(int pos, const HeapEntry& entry)
+{
+    // moves the "hole" at pos downwards until entry can be placed into it
+    int child;
+    while ((child = FIRSTCHILD(pos)) < heapLength) {
+        // find smallest child; children are adjacent in memory
+        int last = std::min(child + 4, heapLength);
+        int minChild = child;
+        for (int i = child + 1; i < last; i++)
+            if (precedes(heap[i], heap[minChild]))
+                minChild = i;
+        if (!precedes(heap[minChild], entry))
             break;
+        heap[pos] = heap[minChild];  // child is moved up
+        heap[pos].event->heapIndex = pos;
+        pos = minChild;
     }
+    heap[pos] = entry;
+    entry.event->heapIndex = pos;
 }
 
 cEvent *cEventHeap::peekFirst() const
 {
-    return cbhead != cbtail ? cb[cbhead] : heapLength != 0 ? heap[1] : nullptr;
+    return cbhead != cbtail ? cb[cbhead] : heapLength != 0 ? heap[0].event : nullptr;
 }
 
 cEvent *cEventHeap::removeFirst()
@@ -281,9 +296,9 @@ cEvent *cEventHeap::removeFirst()
     }
     else if (heapLength > 0) {
         // heap: first is taken out and replaced by the last one
-        cEvent *event = heap[1];
-        (heap[1] = heap[heapLength--])->heapIndex = 1;
-        shiftup();
+        cEvent *event = heap[0].event;
+        if (--heapLength > 0)
+            siftDown(0, heap[heapLength]);
         drop(event);
         event->heapIndex = -1;
         return event;
@@ -311,19 +326,17 @@ cEvent *cEventHeap::remove(cEvent *event)
     }
     else {
         // event is on the heap
-
-        // sanity check:
-        // ASSERT(h[event->heapindex]==event);
+        int pos = event->heapIndex;
+        ASSERT(heap[pos].event == event);  // sanity check
 
         // last element will be used to fill the hole
-        int father, out = event->heapIndex;
-        cEvent *fill = heap[heapLength--];
-        while ((father = out>>1) != 0 && *heap[father] > *fill) {
-            (heap[out] = heap[father])->heapIndex = out;  // father is moved down
-            out = father;
+        if (pos != --heapLength) {
+            HeapEntry fill = heap[heapLength];
+            if (pos > 0 && precedes(fill, heap[PARENT(pos)]))
+                siftUp(pos, fill);
+            else
+                siftDown(pos, fill);
         }
-        (heap[out] = fill)->heapIndex = out;
-        shiftup(out);
     }
 
     drop(event);
@@ -361,19 +374,20 @@ void cEventHeap::checkHeap()
         ENSURE(event->getSchedulingPriority() == 0);
     }
 
-    for (int i = 1; i <= heapLength; i++) {
-        cEvent *event = heap[i];
+    for (int i = 0; i < heapLength; i++) {
+        cEvent *event = heap[i].event;
         ENSURE(event->getOwner() == this);
         ENSURE(event->heapIndex == i);
         ENSURE(event->getArrivalTime() >= now);
-        if (i > 1) {
-            cEvent *parent = heap[i>>1];
-            ENSURE(*parent <= *event); // heap order property
-        }
+        ENSURE(heap[i].arrivalTime == event->getArrivalTime().raw()); // inline keys
+        ENSURE(heap[i].priority == event->getSchedulingPriority());
+        ENSURE(heap[i].insertOrder == event->getInsertOrder());
+        if (i > 0)
+            ENSURE(!precedes(heap[i], heap[PARENT(i)])); // heap order property
     }
 
     if (heapLength >= 1 && cbhead != cbtail)
-        ENSURE(*cb[cbhead] <= *heap[1]);
+        ENSURE(cb[cbhead]->shouldPrecede(heap[0].event));
 
 }
 
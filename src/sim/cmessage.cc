@@ -240,6 +240,21 @@ cMessage *cMessage::privateDup() const
     return ret;
 }
 
+void cMessage::handedOver()
+{
+    // like in the constructor: the ID must not conflict with the IDs assigned in this thread
+    messageTreeId = messageId = nextMessageId++;
+
+    totalMsgCount++;
+    liveMsgCount++;
+
+    previousEventNumber = -1;
+    EVCB.messageCreated(this);
+
+    // after envir notification
+    previousEventNumber = cSimulation::getActiveSimulation()->getEventNumber();
+}
+
 void cMessage::setControlInfo(cObject *p)
 {
     if (!p)
@@ -1586,6 +1586,7 @@ void cModule::changeParentTo(cModule *module)
     int oldId = getId();
     reassignModuleIdRec();
     invalidateFullPathRec();
+    invalidateDispatchCaches();  // inherited listeners have changed
 
     // notify environment
     EVCB.moduleReparented(this, oldparent, oldId);
@@ -0,0 +1,245 @@
+//==========================================================================
+//  CPHILOXRNG.CC - part of
+//                 OMNeT++/OMNEST
+//              Discrete System Simulation in C++
+//
+// Contents:
+//   class cPhiloxRNG
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 2002-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "omnetpp/cphiloxrng.h"
+#include "omnetpp/cexception.h"
+#include "omnetpp/cconfigoption.h"
+
+namespace omnetpp {
+
+Register_Class(cPhiloxRNG);
+
+Register_GlobalConfigOption(CFGID_SEED_N_PHILOX, "seed-%-philox", CFG_INT, nullptr, "When cPhiloxRNG is selected as random number generator: seed for the kth RNG. (Substitute k for '%' in the key.) The seed is used as the key of the generator; RNGs with different k produce different streams even with the same seed.");
+Register_GlobalConfigOption(CFGID_PHILOX_PARTITION_INDEPENDENT, "philox-partition-independent", CFG_BOOL, "false", "With parallel simulation, when cPhiloxRNG is selected as random number generator: when true, RNG k produces the same stream in every partition as in a sequential run. The random numbers then do not depend on the partitioning if every RNG is only used by modules of one partition, e.g. with per-module RNG mapping (`**.rng-0`). When false (the default), every partition gets distinct streams, so the results of a parallel run DO depend on the partitioning, and differ from those of a sequential run. Note that the streams are per RNG and not per module, so partition-independent results always require the RNG mapping described above.");
+
+// multipliers and key increments of Philox4x32
+static const uint32_t PHILOX_M0 = 0xD2511F53;
+static const uint32_t PHILOX_M1 = 0xCD9E8D57;
+static const uint32_t PHILOX_W0 = 0x9E3779B9;
+static const uint32_t PHILOX_W1 = 0xBB67AE85;
+static const int PHILOX_ROUNDS = 10;
+
+// number of blocks generated together; the loops over them can be vectorized
+static const int LANES = 8;  // note: cPhiloxRNG::BUFFER_SIZE is 4*LANES
+
+void cPhiloxRNG::configure(int seedSet, int rngId, int numRngs,
+        int parsimProcId, int parsimNumPartitions,
+        cConfiguration *cfg)
+{
+    char key[40];
+    sprintf(key, "seed-%d-philox", rngId);
+    const char *value = cfg->getConfigValue(key);
+    uint64_t seed = value != nullptr ? cfg->parseLong(value, nullptr) : seedSet;
+
+    // the partition is part of the stream ID, so partitions never share a stream
+    bool partitionIndependent = cfg->getAsBool(CFGID_PHILOX_PARTITION_INDEPENDENT);
+    uint32_t partitionStream = (parsimNumPartitions > 1 && !partitionIndependent) ? parsimProcId + 1 : 0;
+
+    setSeed(seed, rngId, partitionStream);
+}
+
+void cPhiloxRNG::setSeed(uint64_t seed, uint32_t stream0, uint32_t stream1)
+{
+    key[0] = (uint32_t)seed;
+    key[1] = (uint32_t)(seed >> 32);
+    stream[0] = stream0;
+    stream[1] = stream1;
+    blockIndex = 0;
+    bufferPos = BUFFER_SIZE;
+}
+
+void cPhiloxRNG::generateBlocks(uint64_t firstBlockIndex, int numBlocks, uint32_t *words) const
+{
+    for (int base = 0; base < numBlocks; base += LANES) {
+        uint32_t c0[LANES], c1[LANES], c2[LANES], c3[LANES];
+        for (int i = 0; i < LANES; i++) {
+            uint64_t counter = firstBlockIndex + base + i;
+            c0[i] = (uint32_t)counter;
+            c1[i] = (uint32_t)(counter >> 32);
+            c2[i] = stream[0];
+            c3[i] = stream[1];
+        }
+
+        uint32_t k0 = key[0], k1 = key[1];
+        for (int round = 0; round < PHILOX_ROUNDS; round++) {
+            for (int i = 0; i < LANES; i++) {
+                uint64_t p0 = (uint64_t)PHILOX_M0 * c0[i];
+                uint64_t p1 = (uint64_t)PHILOX_M1 * c2[i];
+                uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1[i] ^ k0;
+                uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3[i] ^ k1;
+                c0[i] = n0;
+                c1[i] = (uint32_t)p1;
+                c2[i] = n2;
+                c3[i] = (uint32_t)p0;
+            }
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+
+        int n = std::min(LANES, numBlocks - base);
+        for (int i = 0; i < n; i++) {
+            uint32_t *w = words + 4 * (base + i);
+            w[0] = c0[i];
+            w[1] = c1[i];
+            w[2] = c2[i];
+            w[3] = c3[i];
+        }
+    }
+}
+
+inline uint32_t cPhiloxRNG::nextWord()
+{
+    if (bufferPos == BUFFER_SIZE) {
+        generateBlocks(blockIndex, BUFFER_SIZE / 4, buffer);
+        blockIndex += BUFFER_SIZE / 4;
+        bufferPos = 0;
+    }
+    return buffer[bufferPos++];
+}
+
+inline double cPhiloxRNG::toDouble(uint32_t a, uint32_t b)
+{
+    // 27+26=53 random bits, as many as a double can hold
+    return ((uint64_t)(a >> 5) * 67108864.0 + (b >> 6)) * (1.0 / 9007199254740992.0);
+}
+
+void cPhiloxRNG::selfTest()
+{
+    // known answers from the Random123 library
+    static const struct {
+        uint64_t seed;
+        uint32_t stream0, stream1;
+        uint64_t blockIndex;
+        uint32_t result[4];
+    } tests[] = {
+        { 0, 0, 0, 0, {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8} },
+        { 0xffffffffffffffffULL, 0xffffffff, 0xffffffff, 0xffffffffffffffffULL, {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd} },
+        { 0x299f31d0a4093822ULL, 0x13198a2e, 0x03707344, 0x85a308d3243f6a88ULL, {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1} },
+    };
+
+    for (auto& test : tests) {
+        uint32_t result[4];
+        setSeed(test.seed, test.stream0, test.stream1);
+        generateBlocks(test.blockIndex, 1, result);
+        if (memcmp(result, test.result, sizeof(result)) != 0)
+            throw cRuntimeError("cPhiloxRNG: selfTest() failed, please report this problem!");
+    }
+
+    // block generation must give the same numbers as the scalar functions
+    double values[37];
+    setSeed(1, 2, 3);
+    intRand();
+    fillDoubleRand(values, 37);
+    setSeed(1, 2, 3);
+    intRand();
+    for (double value : values)
+        if (value != doubleRand())
+            throw cRuntimeError("cPhiloxRNG: selfTest() failed, please report this problem!");
+    setSeed(0, 0, 0);
+    numDrawn = 0;
+}
+
+uint32_t cPhiloxRNG::intRand()
+{
+    numDrawn++;
+    return nextWord();
+}
+
+uint32_t cPhiloxRNG::intRandMax()
+{
+    return 0xffffffffUL;  // 2^32-1
+}
+
+uint32_t cPhiloxRNG::intRand(uint32_t n)
+{
+    if (n == 0)
+        throw cRuntimeError("cPhiloxRNG: intRand(%u): Argument out of range 1..2^32-1", (unsigned)n);
+
+    numDrawn++;
+    // reject the lowest (2^32 mod n) values, to avoid bias
+    uint32_t threshold = (0U - n) % n;
+    uint32_t r;
+    do {
+        r = nextWord();
+    } while (r < threshold);
+    return r % n;
+}
+
+double cPhiloxRNG::doubleRand()
+{
+    numDrawn++;
+    uint32_t a = nextWord();
+    uint32_t b = nextWord();
+    return toDouble(a, b);
+}
+
+double cPhiloxRNG::doubleRandNonz()
+{
+    numDrawn++;
+    uint32_t a = nextWord();
+    uint32_t b = nextWord();
+    // 52 random bits plus a half, so the result can be neither 0 nor 1
+    uint64_t k = (uint64_t)(a >> 5) * 67108864 + (b >> 6);
+    return ((k >> 1) + 0.5) * (1.0 / 4503599627370496.0);
+}
+
+double cPhiloxRNG::doubleRandIncl1()
+{
+    numDrawn++;
+    uint32_t a = nextWord();
+    uint32_t b = nextWord();
+    return ((uint64_t)(a >> 5) * 67108864.0 + (b >> 6)) * (1.0 / 9007199254740991.0);
+}
+
+void cPhiloxRNG::fillDoubleRand(double *values, size_t n)
+{
+    numDrawn += n;
+
+    const int CHUNK = 256;  // doubles per iteration
+    uint32_t words[2 * CHUNK + BUFFER_SIZE];
+    while (n > 0) {
+        int count = (int)std::min(n, (size_t)CHUNK);
+
+        // the remaining words in the buffer come first
+        int numWords = 0;
+        while (bufferPos < BUFFER_SIZE && numWords < 2 * count)
+            words[numWords++] = buffer[bufferPos++];
+
+        // generate whole blocks for the rest, and put the unused words back into the buffer
+        if (numWords < 2 * count) {
+            int numBlocks = (2 * count - numWords + 3) / 4;
+            generateBlocks(blockIndex, numBlocks, words + numWords);
+            blockIndex += numBlocks;
+            numWords += 4 * numBlocks;
+            int numUnused = numWords - 2 * count;
+            bufferPos = BUFFER_SIZE - numUnused;
+            memcpy(buffer + bufferPos, words + 2 * count, numUnused * sizeof(uint32_t));
+        }
+
+        for (int i = 0; i < count; i++)
+            values[i] = toDouble(words[2 * i], words[2 * i + 1]);
+
+        values += count;
+        n -= count;
+    }
+}
+
+}  // namespace omnetpp
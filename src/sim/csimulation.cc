@@ -58,6 +58,7 @@
 #include "omnetpp/platdep/platmisc.h"  // for DEBUG_TRAP
 #include "sim/netbuilder/cnedloader.h"
 #include "stopwatch.h"
+#include "memorypool.h"
 
 #ifdef WITH_PARSIM
 #include "omnetpp/ccommbuffer.h"
@@ -102,6 +103,8 @@ Register_GlobalConfigOption(CFGID_CHECK_SIGNALS, "check-signals", CFG_BOOL, CHEC
 Register_GlobalConfigOption(CFGID_PARAMETER_MUTABILITY_CHECK, "parameter-mutability-check", CFG_BOOL, "true", "Setting to false will disable errors raised when trying to change the values of module/channel parameters not marked as @mutable. This is primarily a compatibility setting intended to facilitate running simulation models that were not yet annotated with @mutable.");
 Register_GlobalConfigOption(CFGID_ALLOW_OBJECT_STEALING_ON_DELETION, "allow-object-stealing-on-deletion", CFG_BOOL, "false", "Setting it to true disables the \"Context component is deleting an object it doesn't own\" error message. This option exists primarily for backward compatibility with pre-6.0 versions that were more permissive during object deletion.");
 Register_GlobalConfigOption(CFGID_DEBUG_STATISTICS_RECORDING, "debug-statistics-recording", CFG_BOOL, "false", "Turns on the printing of debugging information related to statistics recording (`@statistic` properties)");
+Register_GlobalConfigOption(CFGID_MESSAGE_POOLING, "message-pooling", CFG_BOOL, "false", "Enables recycling the memory of deleted event, message and packet objects (including message classes generated by the message compiler) via free lists, bypassing the global memory allocator. This may speed up models that create and delete messages at a high rate. The free lists are private to the simulation instance, so the option can also be used with multi-threaded execution (`cmdenv-num-threads`).");
+Register_GlobalConfigOption(CFGID_MESSAGE_POOL_SIZE, "message-pool-size", CFG_INT, "10000", "When `message-pooling` is enabled: the maximum number of freed memory blocks kept for reuse. Blocks freed beyond this limit are returned to the global memory allocator, so the memory held by the pool after a burst of messages stays bounded.");
 Register_GlobalConfigOption(CFGID_PRINT_UNUSED_CONFIG, "print-unused-config", CFG_BOOL, "true", "Enables listing of unused configuration entries after network setup. Note that the reported entries are not necessarily redundant, e.g. they may be needed by modules created dynamically during simulation. It tries to be smart about which entries to report, e.g. entries overridden from a derived section, likely intentionally, are not reported.");
 Register_GlobalConfigOption(CFGID_PRINT_UNUSED_CONFIG_ON_COMPLETION, "print-unused-config-on-completion", CFG_BOOL, "false", "Enables listing of unused configuration entries after the simulation has successfully completed. It tries to be smart about which entries to report, e.g. entries overridden from a derived section, likely intentionally, are not reported.");
 
@@ -211,6 +214,8 @@ cSimulation::~cSimulation()
 
     delete envir;  // after setActiveSimulation(nullptr), due to objectDeleted() callbacks
 
+    delete eventPool;  // after all events have been deleted
+
     if (nedLoaderOwned)
         delete nedLoader;
 }
@@ -277,6 +282,22 @@ void cSimulation::configure(cConfiguration *cfg)
 
     parsim = cfg->getAsBool(CFGID_PARALLEL_SIMULATION);
 
+    // event object memory pool
+    bool messagePooling = cfg->getAsBool(CFGID_MESSAGE_POOLING);
+    if (messagePooling) {
+        int poolSize = cfg->getAsInt(CFGID_MESSAGE_POOL_SIZE);
+        if (poolSize < 0)
+            throw cRuntimeError("The value of 'message-pool-size' must not be negative (%d given)", poolSize);
+        if (!eventPool)
+            eventPool = new MemoryPool(poolSize);
+        else
+            eventPool->setMaxCachedBlocks(poolSize);
+    }
+    else if (!messagePooling && eventPool) {
+        delete eventPool;  // note: events allocated from it may safely outlive it
+        eventPool = nullptr;
+    }
+
 #ifndef WITH_PARSIM
     if (parsim)
         throw cRuntimeError("Parallel simulation is turned on in the ini file, but OMNeT++ was compiled without parallel simulation support (WITH_PARSIM=no)");
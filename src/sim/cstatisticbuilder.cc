@@ -25,6 +25,7 @@
 #include "common/opp_ctype.h"
 #include "statisticsourceparser.h"
 #include "statisticrecorderparser.h"
+#include "fusedresultrecorders.h"
 
 namespace omnetpp {
 
@@ -274,9 +275,17 @@ void cStatisticBuilder::dumpComponentResultRecorders(std::ostream& out, cCompone
 void cStatisticBuilder::dumpResultRecorderChain(std::ostream& out, cResultListener *listener, int depth)
 {
     std::string indent(4*depth+8, ' ');
+    IFusedResultRecorder *fusedRecorder = dynamic_cast<IFusedResultRecorder *>(listener);
+    if (fusedRecorder) {
+        // print it as the filter->recorder chain it stands for
+        out << indent << fusedRecorder->getFilterClassName() << "\n";
+        indent += "    ";
+    }
     out << indent;
     if (ExpressionFilter *expressionFilter = dynamic_cast<ExpressionFilter *>(listener))
         out << expressionFilter->getExpression().str(Expression::SPACIOUSNESS_MAX) << " (" << listener->getClassName() << ")";
+    else if (fusedRecorder)
+        out << fusedRecorder->getRecorderClassName();
     else
         out << listener->getClassName();
 
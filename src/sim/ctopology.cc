@@ -20,10 +20,12 @@
 #include <cstdio>
 #include <cstring>
 #include <cstdarg>
+#include <atomic>
 #include <deque>
-#include <list>
+#include <queue>
 #include <algorithm>
 #include <sstream>
+#include <thread>
 #include "common/patternmatcher.h"
 #include "common/stringutil.h"
 #include "omnetpp/ctopology.h"
@@ -395,48 +397,240 @@ void cTopology::calculateWeightedSingleShortestPathsTo(Node *_target)
 
     target->dist = 0;
 
-    std::list<Node *> q;
+    // priority queue ordered by distance, then by insertion order (so that paths
+    // are chosen the same way as with an ordered list); instead of decreasing the
+    // key of a queued node, a new entry is added and the stale one skipped later
+    struct Entry {
+        double dist;
+        int64_t seq;
+        Node *node;
+        bool operator<(const Entry& other) const {return dist != other.dist ? dist > other.dist : seq > other.seq;}
+    };
+    std::priority_queue<Entry> q;
+    int64_t seq = 0;
 
-    q.push_back(target);
+    q.push(Entry{0, seq++, target});
 
     while (!q.empty()) {
-        Node *dest = q.front();
-        q.pop_front();
+        Entry entry = q.top();
+        q.pop();
+        Node *dest = entry.node;
+        if (entry.dist != dest->dist)
+            continue;  // stale entry
 
         ASSERT(dest->getWeight() >= 0.0);
 
         // for each w adjacent to v...
-        for (int i = 0; i < dest->getNumInLinks(); i++) {
-            if (!(dest->getLinkIn(i)->isEnabled()))
+        for (int i = 0; i < (int)dest->inLinks.size(); i++) {
+            Link *link = dest->inLinks[i];
+            if (!link->isEnabled())
                 continue;
 
-            Node *src = dest->getLinkIn(i)->getRemoteNode();
+            Node *src = link->srcNode;
             if (!src->isEnabled())
                 continue;
 
-            double linkWeight = dest->getLinkIn(i)->getWeight();
+            double linkWeight = link->getWeight();
             ASSERT(linkWeight > 0.0);
 
             double newdist = dest->dist + linkWeight;
             if (dest != target)
                 newdist += dest->getWeight();  // dest is not the target, uses weight of dest node as price of routing (infinity means dest node doesn't route between interfaces)
             if (newdist != INFINITY && src->dist > newdist) {  // it's a valid shorter path from src to target node
-                if (src->dist != INFINITY)
-                    q.remove(src);  // src is in the queue
                 src->dist = newdist;
-                src->outPath = dest->inLinks[i];
+                src->outPath = link;
+                q.push(Entry{newdist, seq++, src});
+            }
+        }
+    }
+}
 
-                // insert src node to ordered list
-                std::list<Node *>::iterator it;
-                for (it = q.begin(); it != q.end(); ++it)
-                    if ((*it)->dist > newdist)
-                        break;
+namespace {
+
+// the graph in a compact form, for calculateShortestPathTrees()
+struct InLinkGraph {
+    struct InLink {
+        int srcNodeIndex;
+        int srcOutLinkIndex;  // index of the link in the source node's outLinks[]
+        double weight;
+    };
+    std::vector<int> inLinkStart;  // inLinks of node i: [inLinkStart[i], inLinkStart[i+1])
+    std::vector<InLink> inLinks;  // only enabled links from enabled nodes
+    std::vector<double> nodeWeights;
+};
+
+void calculateUnweightedPaths(const InLinkGraph& graph, int targetIndex, int *outLinkIndices, double *distances, std::deque<int>& q)
+{
+    // same algorithm as calculateUnweightedSingleShortestPathsTo()
+    int numNodes = graph.nodeWeights.size();
+    std::fill(distances, distances + numNodes, INFINITY);
+    std::fill(outLinkIndices, outLinkIndices + numNodes, -1);
+    distances[targetIndex] = 0;
+    q.clear();
+    q.push_back(targetIndex);
+    while (!q.empty()) {
+        int v = q.front();
+        q.pop_front();
+        for (int k = graph.inLinkStart[v]; k < graph.inLinkStart[v+1]; k++) {
+            const InLinkGraph::InLink& inLink = graph.inLinks[k];
+            int w = inLink.srcNodeIndex;
+            if (distances[w] == INFINITY) {
+                distances[w] = distances[v] + 1;
+                outLinkIndices[w] = inLink.srcOutLinkIndex;
+                q.push_back(w);
+            }
+        }
+    }
+}
+
+struct QueueEntry {
+    double dist;
+    int64_t seq;
+    int nodeIndex;
+    bool operator<(const QueueEntry& other) const {return dist != other.dist ? dist > other.dist : seq > other.seq;}
+};
 
-                q.insert(it, src);
+void calculateWeightedPaths(const InLinkGraph& graph, int targetIndex, int *outLinkIndices, double *distances, std::vector<QueueEntry>& heap)
+{
+    // same algorithm as calculateWeightedSingleShortestPathsTo()
+    int numNodes = graph.nodeWeights.size();
+    std::fill(distances, distances + numNodes, INFINITY);
+    std::fill(outLinkIndices, outLinkIndices + numNodes, -1);
+    distances[targetIndex] = 0;
+    heap.clear();
+    int64_t seq = 0;
+    heap.push_back(QueueEntry{0, seq++, targetIndex});
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end());
+        QueueEntry entry = heap.back();
+        heap.pop_back();
+        int dest = entry.nodeIndex;
+        if (entry.dist != distances[dest])
+            continue;  // stale entry
+        for (int k = graph.inLinkStart[dest]; k < graph.inLinkStart[dest+1]; k++) {
+            const InLinkGraph::InLink& inLink = graph.inLinks[k];
+            int src = inLink.srcNodeIndex;
+            double newdist = distances[dest] + inLink.weight;
+            if (dest != targetIndex)
+                newdist += graph.nodeWeights[dest];
+            if (newdist != INFINITY && distances[src] > newdist) {
+                distances[src] = newdist;
+                outLinkIndices[src] = inLink.srcOutLinkIndex;
+                heap.push_back(QueueEntry{newdist, seq++, src});
+                std::push_heap(heap.begin(), heap.end());
             }
         }
     }
 }
 
+}  // namespace
+
+cTopology::ShortestPathTrees cTopology::calculateShortestPathTrees(const std::vector<Node*>& targetNodes, bool weighted, int numThreads) const
+{
+    ShortestPathTrees result;
+    int numNodes = nodes.size();
+    result.numNodes = numNodes;
+    result.nodes = nodes;
+    for (int i = 0; i < numNodes; i++)
+        result.nodeIndices[nodes[i]] = i;
+    result.targets = targetNodes.empty() ? nodes : targetNodes;
+    int numTargets = result.targets.size();
+    std::vector<int> targetNodeIndices(numTargets);
+    for (int i = 0; i < numTargets; i++) {
+        Node *targetNode = result.targets[i];
+        if (!targetNode)
+            throw cRuntimeError(this, "calculateShortestPathTrees(): Target node is nullptr");
+        auto it = result.nodeIndices.find(targetNode);
+        if (it == result.nodeIndices.end())
+            throw cRuntimeError(this, "calculateShortestPathTrees(): Target node is not part of the topology");
+        targetNodeIndices[i] = it->second;
+        result.targetIndices.insert(std::make_pair(targetNode, i));  // first occurrence wins
+    }
+
+    // build a compact copy of the graph that the threads can share
+    InLinkGraph graph;
+    std::unordered_map<const Link*,int> outLinkIndices;
+    for (Node *node : nodes)
+        for (int k = 0; k < (int)node->outLinks.size(); k++)
+            outLinkIndices[node->outLinks[k]] = k;
+    graph.inLinkStart.reserve(numNodes+1);
+    graph.nodeWeights.reserve(numNodes);
+    for (Node *node : nodes) {
+        if (weighted && !(node->getWeight() >= 0.0))
+            throw cRuntimeError(this, "calculateShortestPathTrees(): Node weights must be nonnegative");
+        graph.inLinkStart.push_back(graph.inLinks.size());
+        graph.nodeWeights.push_back(node->getWeight());
+        for (Link *link : node->inLinks) {
+            if (!link->isEnabled() || !link->srcNode->isEnabled())
+                continue;
+            if (weighted && !(link->getWeight() > 0.0))
+                throw cRuntimeError(this, "calculateShortestPathTrees(): Link weights must be positive");
+            graph.inLinks.push_back(InLinkGraph::InLink{result.nodeIndices[link->srcNode], outLinkIndices[link], link->getWeight()});
+        }
+    }
+    graph.inLinkStart.push_back(graph.inLinks.size());
+
+    result.outLinkIndices.resize((size_t)numTargets * numNodes);
+    result.distances.resize((size_t)numTargets * numNodes);
+
+    // threads take the next target from a shared counter
+    std::atomic_int nextTarget(0);
+    auto work = [&]() {
+        std::deque<int> fifo;
+        std::vector<QueueEntry> heap;
+        int i;
+        while ((i = nextTarget++) < numTargets) {
+            int targetIndex = targetNodeIndices[i];
+            int *outLinkIndices = result.outLinkIndices.data() + (size_t)i * numNodes;
+            double *distances = result.distances.data() + (size_t)i * numNodes;
+            if (weighted)
+                calculateWeightedPaths(graph, targetIndex, outLinkIndices, distances, heap);
+            else
+                calculateUnweightedPaths(graph, targetIndex, outLinkIndices, distances, fifo);
+        }
+    };
+
+    if (numThreads <= 0)
+        numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    numThreads = std::min(numThreads, numTargets);
+    std::vector<std::thread> threads;
+    for (int i = 1; i < numThreads; i++)
+        threads.push_back(std::thread(work));
+    work();
+    for (auto& thread : threads)
+        thread.join();
+
+    return result;
+}
+
+int cTopology::ShortestPathTrees::getIndex(const Node *node, const Node *target) const
+{
+    auto nodeIt = nodeIndices.find(node);
+    if (nodeIt == nodeIndices.end())
+        throw cRuntimeError("cTopology::ShortestPathTrees: Node is not part of the topology");
+    auto targetIt = targetIndices.find(target);
+    if (targetIt == targetIndices.end())
+        throw cRuntimeError("cTopology::ShortestPathTrees: Paths towards the given target node were not calculated");
+    return targetIt->second * numNodes + nodeIt->second;
+}
+
+cTopology::Node *cTopology::ShortestPathTrees::getTarget(int i) const
+{
+    if (i < 0 || i >= (int)targets.size())
+        throw cRuntimeError("cTopology::ShortestPathTrees::getTarget(): Invalid index %d", i);
+    return targets[i];
+}
+
+double cTopology::ShortestPathTrees::getDistanceToTarget(const Node *node, const Node *target) const
+{
+    return distances[getIndex(node, target)];
+}
+
+cTopology::LinkOut *cTopology::ShortestPathTrees::getPathToTarget(const Node *node, const Node *target) const
+{
+    int outLinkIndex = outLinkIndices[getIndex(node, target)];
+    return outLinkIndex == -1 ? nullptr : (LinkOut *)node->outLinks[outLinkIndex];
+}
+
 }  // namespace omnetpp
 
@@ -0,0 +1,66 @@
+//==========================================================================
+//  FUSEDRESULTRECORDERS.CC - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cstring>
+#include "fusedresultrecorders.h"
+
+namespace omnetpp {
+
+template<template<class,class> class FusedT, class FilterT>
+static cResultRecorder *createFused(const char *recorderName)
+{
+    if (!strcmp(recorderName, "vector"))
+        return new FusedT<FilterT, VectorRecorder>();
+    else if (!strcmp(recorderName, "last"))
+        return new FusedT<FilterT, LastValueRecorder>();
+    else if (!strcmp(recorderName, "sum"))
+        return new FusedT<FilterT, SumRecorder>();
+    else if (!strcmp(recorderName, "mean"))
+        return new FusedT<FilterT, MeanRecorder>();
+    else if (!strcmp(recorderName, "min"))
+        return new FusedT<FilterT, MinRecorder>();
+    else if (!strcmp(recorderName, "max"))
+        return new FusedT<FilterT, MaxRecorder>();
+    else if (!strcmp(recorderName, "timeavg"))
+        return new FusedT<FilterT, TimeAverageRecorder>();
+    else
+        return nullptr;
+}
+
+cResultRecorder *createFusedResultRecorder(const char *filterName, const char *recorderName)
+{
+    // note: names must map to the same classes as in the Register_ResultFilter()/Register_ResultRecorder() lines
+    if (!strcmp(filterName, "count"))
+        return createFused<FusedCountResultRecorder, CountFilter>(recorderName);
+    else if (!strcmp(filterName, "totalCount"))
+        return createFused<FusedCountResultRecorder, TotalCountFilter>(recorderName);
+    else if (!strcmp(filterName, "sum"))
+        return createFused<FusedNumericResultRecorder, SumFilter>(recorderName);
+    else if (!strcmp(filterName, "mean"))
+        return createFused<FusedNumericResultRecorder, MeanFilter>(recorderName);
+    else if (!strcmp(filterName, "min"))
+        return createFused<FusedNumericResultRecorder, MinFilter>(recorderName);
+    else if (!strcmp(filterName, "max"))
+        return createFused<FusedNumericResultRecorder, MaxFilter>(recorderName);
+    else if (!strcmp(filterName, "avg"))
+        return createFused<FusedNumericResultRecorder, AverageFilter>(recorderName);
+    else if (!strcmp(filterName, "timeavg"))
+        return createFused<FusedNumericResultRecorder, TimeAverageFilter>(recorderName);
+    else
+        return nullptr;
+}
+
+}  // namespace omnetpp
+
@@ -0,0 +1,172 @@
+//==========================================================================
+//  FUSEDRESULTRECORDERS.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_FUSEDRESULTRECORDERS_H
+#define __OMNETPP_FUSEDRESULTRECORDERS_H
+
+#include <type_traits>
+#include "omnetpp/resultfilters.h"
+#include "omnetpp/resultrecorders.h"
+#include "omnetpp/cproperty.h"
+
+namespace omnetpp {
+
+/**
+ * Interface of result recorders that replace a filter->recorder chain
+ * (e.g. sum feeding vector) with a single listener object. It allows the
+ * fused recorder to be presented (e.g. in dumps) as the chain it replaces.
+ */
+class SIM_API IFusedResultRecorder
+{
+  public:
+    virtual ~IFusedResultRecorder() {}
+    virtual const char *getFilterClassName() const = 0;
+    virtual const char *getRecorderClassName() const = 0;
+};
+
+/**
+ * Common base for fused recorders: remembers the initialization context
+ * for clone(), as template instances are not registered classes and thus
+ * cannot be cloned by cResultRecorder::clone().
+ */
+template<class RecorderT>
+class FusedResultRecorderBase : public RecorderT, public IFusedResultRecorder
+{
+  protected:
+    cProperty *attrsProperty = nullptr;
+    opp_string_map *manualAttrs = nullptr;  // owned by cResultRecorder
+
+  protected:
+    virtual void init(cResultRecorder::Context *ctx) override {
+        RecorderT::init(ctx);
+        attrsProperty = ctx->attrsProperty;
+        manualAttrs = ctx->manualAttrs;
+    }
+
+    void initCopy(FusedResultRecorderBase *copy) const {
+        cResultRecorder::Context ctx { this->getComponent(), this->getStatisticName(), this->getRecordingMode(), attrsProperty, manualAttrs ? new opp_string_map(*manualAttrs) : nullptr };
+        copy->init(&ctx);
+    }
+
+    // same as in cResultFilter::emitInitialValue()
+    static simtime_t getInitialValueTime() {
+        cSimulation *simulation = cSimulation::getActiveSimulation();
+        return std::max(simulation->getSimTime(), simulation->getWarmupPeriod());
+    }
+
+  public:
+    virtual const char *getRecorderClassName() const override {return opp_typename(typeid(RecorderT));}
+};
+
+/**
+ * Fused recorder for a numeric filter (one that implements process(), e.g.
+ * SumFilter) feeding a numeric recorder. Values go through the filter's
+ * process() and the recorder's collect() via direct calls, instead of
+ * crossing two listener objects and the filter's delegate list.
+ */
+template<class FilterT, class RecorderT>
+class FusedNumericResultRecorder : public FusedResultRecorderBase<RecorderT>
+{
+  protected:
+    // exposes process() so that it can be invoked without virtual dispatch
+    struct Filter final : public FilterT {
+        using FilterT::process;
+    };
+    Filter filter;
+
+  protected:
+    virtual void init(cResultRecorder::Context *ctx) override {
+        FusedResultRecorderBase<RecorderT>::init(ctx);
+        cResultFilter::Context filterCtx {ctx->component, ctx->attrsProperty};
+        filter.init(&filterCtx);
+    }
+
+    virtual void collect(simtime_t_cref t, double value, cObject *details) override {
+        simtime_t tt = t;
+        if (filter.process(tt, value, details))
+            RecorderT::collect(tt, value, details);
+    }
+
+    virtual void emitInitialValue() override {
+        double initialValue = filter.getInitialDoubleValue();
+        if (!std::isnan(initialValue))
+            RecorderT::collect(this->getInitialValueTime(), initialValue, nullptr);
+    }
+
+  public:
+    virtual FusedNumericResultRecorder *clone() const override {
+        FusedNumericResultRecorder *copy = new FusedNumericResultRecorder();
+        this->initCopy(copy);
+        return copy;
+    }
+
+    virtual const char *getFilterClassName() const override {return opp_typename(typeid(FilterT));}
+    virtual std::string str() const override {return filter.str() + "; " + RecorderT::str();}
+};
+
+/**
+ * Fused recorder for a counting filter (CountFilter or TotalCountFilter)
+ * feeding a numeric recorder. Counting accepts values of any type, so the
+ * count is maintained here, in all receiveSignal() methods.
+ */
+template<class FilterT, class RecorderT>
+class FusedCountResultRecorder : public FusedResultRecorderBase<RecorderT>
+{
+  protected:
+    static constexpr bool countsEmpty = std::is_same<FilterT,TotalCountFilter>::value; // count NaN and nullptr too?
+    intval_t count = 0;
+
+  protected:
+    void countAndCollect(simtime_t_cref t, bool isEmpty, cObject *details) {
+        if (countsEmpty || !isEmpty)
+            count++;
+        RecorderT::collect(t, count, details);
+    }
+
+    virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, bool b, cObject *details) override {countAndCollect(t, false, details);}
+    virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, intval_t l, cObject *details) override {countAndCollect(t, false, details);}
+    virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, uintval_t l, cObject *details) override {countAndCollect(t, false, details);}
+    virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, double d, cObject *details) override {countAndCollect(t, std::isnan(d), details);}
+    virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, const SimTime& v, cObject *details) override {countAndCollect(t, false, details);}
+    virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, const char *s, cObject *details) override {countAndCollect(t, s == nullptr, details);}
+    virtual void receiveSignal(cResultFilter *prev, simtime_t_cref t, cObject *obj, cObject *details) override {countAndCollect(t, obj == nullptr, details);}
+
+    virtual void emitInitialValue() override {
+        RecorderT::collect(this->getInitialValueTime(), count, nullptr);
+    }
+
+  public:
+    virtual FusedCountResultRecorder *clone() const override {
+        FusedCountResultRecorder *copy = new FusedCountResultRecorder();
+        this->initCopy(copy);
+        return copy;
+    }
+
+    virtual const char *getFilterClassName() const override {return opp_typename(typeid(FilterT));}
+    virtual std::string str() const override {std::stringstream os; os << "count = " << count << "; " << RecorderT::str(); return os.str();}
+};
+
+/**
+ * Returns a new fused recorder object that is equivalent to the given
+ * filter feeding the given recorder (names as in @statistic record=), or
+ * nullptr if there is no fused implementation for the combination.
+ * The result still needs to be initialized with init().
+ */
+SIM_API cResultRecorder *createFusedResultRecorder(const char *filterName, const char *recorderName);
+
+}  // namespace omnetpp
+
+#endif
+
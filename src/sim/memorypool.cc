@@ -0,0 +1,50 @@
+//=========================================================================
+//  MEMORYPOOL.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <new>
+#include "memorypool.h"
+
+namespace omnetpp {
+namespace internal {
+
+void MemoryPool::clear()
+{
+    for (FreeBlock *& head : freeLists) {
+        while (head) {
+            FreeBlock *block = head;
+            head = block->next;
+            ::operator delete(block);
+        }
+    }
+    numCachedBlocks = 0;
+}
+
+void MemoryPool::setMaxCachedBlocks(size_t n)
+{
+    maxCachedBlocks = n;
+    for (FreeBlock *& head : freeLists) {
+        while (head && numCachedBlocks > maxCachedBlocks) {
+            FreeBlock *block = head;
+            head = block->next;
+            ::operator delete(block);
+            numCachedBlocks--;
+        }
+    }
+}
+
+}  // namespace internal
+}  // namespace omnetpp
+
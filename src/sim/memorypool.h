@@ -0,0 +1,97 @@
+//==========================================================================
+//  MEMORYPOOL.H - part of
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//==========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_MEMORYPOOL_H
+#define __OMNETPP_MEMORYPOOL_H
+
+#include <cstddef>
+#include "omnetpp/simkerneldefs.h"
+
+namespace omnetpp {
+namespace internal {
+
+/**
+ * Internal class: per-size free lists for recycling memory blocks of
+ * frequently allocated and deallocated objects (events, messages, packets).
+ * Freed blocks are kept on a free list that belongs to their exact size, and
+ * handed out again for the next allocation of the same size, bypassing the
+ * global allocator.
+ *
+ * All blocks are obtained from, and eventually returned to, the global
+ * ::operator new/delete, so blocks are interchangeable between pools and the
+ * global heap: an object allocated via one pool (or without a pool) may be
+ * deallocated via another pool (or without a pool).
+ *
+ * The class is not thread-safe; every cSimulation has its own instance,
+ * which is only accessed from the thread in which that simulation is active.
+ */
+class SIM_API MemoryPool
+{
+  private:
+    enum { GRANULARITY = 8, MAX_POOLED_SIZE = 1024 };
+    struct FreeBlock { FreeBlock *next; };
+
+    FreeBlock *freeLists[MAX_POOLED_SIZE/GRANULARITY + 1] = {}; // indexed by size/GRANULARITY
+    size_t numCachedBlocks = 0;
+    size_t maxCachedBlocks;  // blocks freed beyond this limit go back to the global allocator
+
+  private:
+    static bool isPoolable(size_t size) {return size <= MAX_POOLED_SIZE && size % GRANULARITY == 0;}
+
+  public:
+    explicit MemoryPool(size_t maxCachedBlocks=10000) : maxCachedBlocks(maxCachedBlocks) {}
+    ~MemoryPool() {clear();}
+
+    void *allocate(size_t size) {
+        if (isPoolable(size)) {
+            FreeBlock *& head = freeLists[size/GRANULARITY];
+            if (head) {
+                FreeBlock *block = head;
+                head = block->next;
+                numCachedBlocks--;
+                return block;
+            }
+        }
+        return ::operator new(size);
+    }
+
+    void deallocate(void *p, size_t size) {
+        if (isPoolable(size) && numCachedBlocks < maxCachedBlocks) {
+            FreeBlock *& head = freeLists[size/GRANULARITY];
+            FreeBlock *block = static_cast<FreeBlock*>(p);
+            block->next = head;
+            head = block;
+            numCachedBlocks++;
+        }
+        else {
+            ::operator delete(p);
+        }
+    }
+
+    // releases all cached blocks to the global allocator
+    void clear();
+
+    // sets the limit on cached blocks; surplus blocks are released immediately
+    void setMaxCachedBlocks(size_t n);
+
+    size_t getMaxCachedBlocks() const {return maxCachedBlocks;}
+    size_t getNumCachedBlocks() const {return numCachedBlocks;}
+};
+
+}  // namespace internal
+}  // namespace omnetpp
+
+#endif
+
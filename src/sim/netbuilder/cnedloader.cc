@@ -43,6 +43,8 @@ using namespace omnetpp::internal;
 namespace omnetpp {
 
 Register_GlobalConfigOption(CFGID_NED_PATH, "ned-path", CFG_PATH, "", "A semicolon-separated list of directories. The directories will be regarded as roots of the NED package hierarchy, and all NED files will be loaded from their subdirectory trees. This option is normally left empty, as the OMNeT++ IDE sets the NED path automatically, and for simulations started outside the IDE it is more convenient to specify it via command-line option (-n) or via environment variable (OMNETPP_NED_PATH, NEDPATH).");
+Register_GlobalConfigOption(CFGID_NED_LOADER_THREADS, "ned-loader-threads", CFG_INT, "0", "The number of threads used for parsing NED files when loading the NED source folders. Files are still registered in the same order as with a single thread, so the outcome does not depend on this setting. 0 means the number of CPU cores. Ignored (a single thread is used) in Windows builds with shared libraries, which have no thread-local variables.");
+Register_GlobalConfigOption(CFGID_NED_AST_CACHE_DIR, "ned-ast-cache-dir", CFG_FILENAME, "", "Directory for caching the parsed and validated form of NED files across runs. A NED file is only parsed again if its modification time, size or content has changed since it was cached. The directory is created if it does not exist, and it may be shared by concurrently running simulations. Leave empty to disable the cache.");
 Register_GlobalConfigOption(CFGID_NED_PACKAGE_EXCLUSIONS, "ned-package-exclusions", CFG_CUSTOM, "", "A semicolon-separated list of NED packages to be excluded when loading NED files. Sub-packages of excluded ones are also excluded. Additional items may be specified via the `-x` command-line option and the `OMNETPP_NED_PACKAGE_EXCLUSIONS` environment variable.");
 
 #define LOCK   std::lock_guard<std::recursive_mutex> guard(NedResourceCache::nedMutex)
@@ -92,6 +94,8 @@ void cNedLoader::configure(cConfiguration *cfg, const char *nArg, const char *xA
     LOCK;
     setNedPath(extractNedPath(cfg, nArg).c_str());
     setNedExcludedPackages(extractNedExcludedPackages(cfg, xArg).c_str());
+    setNumLoaderThreads(cfg->getAsInt(CFGID_NED_LOADER_THREADS));
+    setAstCacheDir(cfg->getAsFilename(CFGID_NED_AST_CACHE_DIR).c_str());
 }
 
 std::string cNedLoader::extractNedPath(cConfiguration *cfg, const char *nArg)
@@ -0,0 +1,250 @@
+//=========================================================================
+//  CADAPTIVENULLMESSAGEPROT.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <cmath>
+#include <algorithm>
+#include "omnetpp/cmessage.h"
+#include "omnetpp/cmodule.h"
+#include "omnetpp/cenvir.h"
+#include "omnetpp/cconfiguration.h"
+#include "omnetpp/cparsimcomm.h"
+#include "omnetpp/ccommbuffer.h"
+#include "omnetpp/cconfigoption.h"
+#include "omnetpp/regmacros.h"
+#include "omnetpp/cfutureeventset.h"
+#include "omnetpp/simutil.h"
+#include "cadaptivenullmessageprot.h"
+#include "cnmplookahead.h"
+#include "messagetags.h"
+
+namespace omnetpp {
+
+Register_Class(cAdaptiveNullMessageProtocol);
+
+Register_GlobalConfigOption(CFGID_PARSIM_ADAPTIVENULLMESSAGEPROTOCOL_MIN_LAZINESS, "parsim-adaptivenullmessageprotocol-min-laziness", CFG_DOUBLE, "0.05", "When `cAdaptiveNullMessageProtocol` is selected as parsim synchronization class: the lower limit of the per-partition null message laziness. The initial value comes from `parsim-nullmessageprotocol-laziness`.");
+Register_GlobalConfigOption(CFGID_PARSIM_ADAPTIVENULLMESSAGEPROTOCOL_MAX_LAZINESS, "parsim-adaptivenullmessageprotocol-max-laziness", CFG_DOUBLE, "0.9", "When `cAdaptiveNullMessageProtocol` is selected as parsim synchronization class: the upper limit of the per-partition null message laziness. Values in the range `[0,1)` are accepted.");
+Register_GlobalConfigOption(CFGID_PARSIM_ADAPTIVENULLMESSAGEPROTOCOL_EIT_REQUESTS, "parsim-adaptivenullmessageprotocol-eit-requests", CFG_BOOL, "true", "When `cAdaptiveNullMessageProtocol` is selected as parsim synchronization class: whether a partition that blocks on the EIT of another partition should request a null message from it.");
+Register_GlobalConfigOption(CFGID_PARSIM_ADAPTIVENULLMESSAGEPROTOCOL_POLL_INTERVAL, "parsim-adaptivenullmessageprotocol-poll-interval", CFG_INT, "100", "When `cAdaptiveNullMessageProtocol` is selected as parsim synchronization class: check for incoming messages and EIT requests after every this many events, not only when blocked. 0 turns off polling.");
+
+void cAdaptiveNullMessageProtocol::configure(cSimulation *simulation, cConfiguration *cfg, cParsimPartition *partition)
+{
+    cNullMessageProtocol::configure(simulation, cfg, partition);
+
+    minLaziness = cfg->getAsDouble(CFGID_PARSIM_ADAPTIVENULLMESSAGEPROTOCOL_MIN_LAZINESS);
+    maxLaziness = cfg->getAsDouble(CFGID_PARSIM_ADAPTIVENULLMESSAGEPROTOCOL_MAX_LAZINESS);
+    eitRequests = cfg->getAsBool(CFGID_PARSIM_ADAPTIVENULLMESSAGEPROTOCOL_EIT_REQUESTS);
+    pollInterval = cfg->getAsInt(CFGID_PARSIM_ADAPTIVENULLMESSAGEPROTOCOL_POLL_INTERVAL);
+
+    if (minLaziness < 0 || maxLaziness >= 1 || minLaziness > maxLaziness)
+        throw cRuntimeError("cAdaptiveNullMessageProtocol: Invalid laziness limits %g and %g, they must satisfy 0 <= min <= max < 1", minLaziness, maxLaziness);
+    if (pollInterval < 0)
+        throw cRuntimeError("cAdaptiveNullMessageProtocol: Poll interval must not be negative");
+}
+
+void cAdaptiveNullMessageProtocol::startRun()
+{
+    cNullMessageProtocol::startRun();
+
+    links.assign(numSeg, LinkInfo());
+    for (LinkInfo& link : links)
+        link.laziness = std::min(maxLaziness, std::max(minLaziness, laziness));
+    eventsSincePoll = 0;
+}
+
+void cAdaptiveNullMessageProtocol::endRun()
+{
+    cNullMessageProtocol::endRun();
+    printStatistics();
+}
+
+void cAdaptiveNullMessageProtocol::lifecycleEvent(SimulationLifecycleEventType eventType, cObject *details)
+{
+    cNullMessageProtocol::lifecycleEvent(eventType, details);
+    if (eventType == LF_PRE_NETWORK_FINISH)
+        recordStatistics();
+}
+
+cEvent *cAdaptiveNullMessageProtocol::takeNextEvent()
+{
+    if (pollInterval > 0 && ++eventsSincePoll >= pollInterval) {
+        eventsSincePoll = 0;
+        receiveNonblocking();
+    }
+    return cNullMessageProtocol::takeNextEvent();
+}
+
+void cAdaptiveNullMessageProtocol::processOutgoingMessage(cMessage *msg, const SendOptions& options, int destProcId, int destModuleId, int destGateId, void *data)
+{
+    simtime_t lastEotSent = segInfo[destProcId].lastEotSent;
+    cNullMessageProtocol::processOutgoingMessage(msg, options, destProcId, destModuleId, destGateId, data);
+
+    LinkInfo& link = links[destProcId];
+    link.messagesSent++;
+    if (segInfo[destProcId].lastEotSent != lastEotSent)
+        link.piggybackedNullMessages++;
+}
+
+void cAdaptiveNullMessageProtocol::sendNullMessage(int procId, simtime_t now)
+{
+    simtime_t lastEotSent = segInfo[procId].lastEotSent;
+    cNullMessageProtocol::sendNullMessage(procId, now);
+    if (segInfo[procId].lastEotSent != lastEotSent)
+        links[procId].nullMessagesSent++;
+}
+
+simtime_t cAdaptiveNullMessageProtocol::getResendDelay(int procId, simtime_t lookahead)
+{
+    // additive increase while the partition does not ask for EOTs,
+    // multiplicative decrease for each request it sent
+    LinkInfo& link = links[procId];
+    if (link.numRequestsSinceUpdate == 0)
+        link.laziness = std::min(maxLaziness, link.laziness + lazinessIncrement);
+    else
+        link.laziness = std::max(minLaziness, link.laziness * std::pow(lazinessDecreaseFactor, link.numRequestsSinceUpdate));
+    link.numRequestsSinceUpdate = 0;
+    return lookahead * link.laziness;
+}
+
+void cAdaptiveNullMessageProtocol::processReceivedBuffer(cCommBuffer *buffer, int tag, int sourceProcId)
+{
+    switch (tag) {
+        case TAG_EIT_REQUEST: {
+            simtime_t eit;
+            buffer->unpack(eit);
+            buffer->assertBufferEmpty();
+            links[sourceProcId].eitRequestsReceived++;
+            // ignore the request if a better EOT is already on its way
+            if (eit >= segInfo[sourceProcId].lastEotSent)
+                processReceivedEITRequest(sourceProcId);
+            break;
+        }
+
+        case TAG_NULLMESSAGE:
+            links[sourceProcId].nullMessagesReceived++;
+            cNullMessageProtocol::processReceivedBuffer(buffer, tag, sourceProcId);
+            break;
+
+        default:
+            cNullMessageProtocol::processReceivedBuffer(buffer, tag, sourceProcId);
+            break;
+    }
+}
+
+void cAdaptiveNullMessageProtocol::processReceivedMessage(cMessage *msg, const SendOptions& options, int destModuleId, int destGateId, int sourceProcId)
+{
+    // note: counted here and not per buffer, because a batch contains several messages
+    links[sourceProcId].messagesReceived++;
+    cNullMessageProtocol::processReceivedMessage(msg, options, destModuleId, destGateId, sourceProcId);
+}
+
+void cAdaptiveNullMessageProtocol::processReceivedEITRequest(int sourceProcId)
+{
+    links[sourceProcId].numRequestsSinceUpdate++;
+
+    // Nothing can happen in this partition before the first event in the FES,
+    // because messages from other partitions arrive after their EIT, and the
+    // EIT events are in the FES too.
+    simtime_t now = sim->getFES()->peekFirst()->getArrivalTime();
+    simtime_t eot = now + lookaheadcalc->getCurrentLookahead(sourceProcId);
+
+    {if (debug) EV << "EIT request received from " << sourceProcId << ", EOT=" << eot << "\n";}
+
+    if (eot > segInfo[sourceProcId].lastEotSent)
+        sendNullMessage(sourceProcId, now);
+}
+
+bool cAdaptiveNullMessageProtocol::receiveBlocking()
+{
+    // the base class only blocks when the first event in the FES is an EIT event
+    int procId = -1;
+    cEvent *event = sim->getFES()->peekFirst();
+    if (event && event->isMessage() && static_cast<cMessage *>(event)->getKind() == MK_PARSIM_EIT) {
+        procId = (uintptr_t)static_cast<cMessage *>(event)->getContextPointer();
+        LinkInfo& link = links[procId];
+        link.numBlockings++;
+
+        // ask for a null message, once per EIT value
+        simtime_t eit = event->getArrivalTime();
+        if (eitRequests && link.requestedEit != eit) {
+            {if (debug) EV << "sending EIT request to " << procId << ", EIT=" << eit << "\n";}
+            link.requestedEit = eit;
+            link.eitRequestsSent++;
+            cCommBuffer *buffer = comm->createCommBuffer();
+            buffer->pack(eit);
+            comm->send(buffer, TAG_EIT_REQUEST, procId);
+            comm->recycleCommBuffer(buffer);
+        }
+    }
+
+    int64_t startTime = opp_get_monotonic_clock_nsecs();
+    bool result = cNullMessageProtocol::receiveBlocking();
+    if (procId != -1)
+        links[procId].blockingTimeNsecs += opp_get_monotonic_clock_nsecs() - startTime;
+    return result;
+}
+
+void cAdaptiveNullMessageProtocol::recordStatistics()
+{
+    cModule *systemModule = sim->getSystemModule();
+    if (!systemModule)
+        return;
+
+    int64_t totalMessagesSent = 0, totalNullMessagesSent = 0, totalBlockingTimeNsecs = 0;
+    int myProcId = comm->getProcId();
+    for (int i = 0; i < numSeg; i++) {
+        if (i == myProcId)
+            continue;
+        const LinkInfo& link = links[i];
+        std::string suffix = ":partition" + std::to_string(i);
+        systemModule->recordScalar(("messagesSent" + suffix).c_str(), link.messagesSent);
+        systemModule->recordScalar(("nullMessagesSent" + suffix).c_str(), link.nullMessagesSent);
+        systemModule->recordScalar(("piggybackedNullMessages" + suffix).c_str(), link.piggybackedNullMessages);
+        systemModule->recordScalar(("messagesReceived" + suffix).c_str(), link.messagesReceived);
+        systemModule->recordScalar(("nullMessagesReceived" + suffix).c_str(), link.nullMessagesReceived);
+        systemModule->recordScalar(("eitRequestsSent" + suffix).c_str(), link.eitRequestsSent);
+        systemModule->recordScalar(("eitRequestsReceived" + suffix).c_str(), link.eitRequestsReceived);
+        systemModule->recordScalar(("numBlockings" + suffix).c_str(), link.numBlockings);
+        systemModule->recordScalar(("blockingTime" + suffix).c_str(), link.blockingTimeNsecs / 1e9, "s");
+        systemModule->recordScalar(("laziness" + suffix).c_str(), link.laziness);
+        totalMessagesSent += link.messagesSent;
+        totalNullMessagesSent += link.nullMessagesSent;
+        totalBlockingTimeNsecs += link.blockingTimeNsecs;
+    }
+    int64_t total = totalMessagesSent + totalNullMessagesSent;
+    systemModule->recordScalar("nullMessageOverhead", total == 0 ? 0.0 : totalNullMessagesSent / (double)total);
+    systemModule->recordScalar("blockingTime", totalBlockingTimeNsecs / 1e9, "s");
+}
+
+void cAdaptiveNullMessageProtocol::printStatistics()
+{
+    int myProcId = comm->getProcId();
+    EV << "Null message statistics of partition " << myProcId << ":\n";
+    for (int i = 0; i < numSeg; i++) {
+        if (i == myProcId)
+            continue;
+        const LinkInfo& link = links[i];
+        int64_t total = link.messagesSent + link.nullMessagesSent;
+        EV << "  to/from partition " << i << ": "
+           << link.messagesSent << " messages and " << link.nullMessagesSent << " null messages sent ("
+           << (total == 0 ? 0.0 : 100.0 * link.nullMessagesSent / total) << "% overhead), "
+           << link.piggybackedNullMessages << " EOTs piggybacked, "
+           << link.eitRequestsSent << "/" << link.eitRequestsReceived << " EIT requests sent/received, "
+           << "blocked " << link.numBlockings << " times for " << link.blockingTimeNsecs / 1e9 << "s, "
+           << "final laziness " << link.laziness << "\n";
+    }
+}
+
+}  // namespace omnetpp
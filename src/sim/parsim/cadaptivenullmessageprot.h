@@ -0,0 +1,141 @@
+//=========================================================================
+//  CADAPTIVENULLMESSAGEPROT.H - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CADAPTIVENULLMESSAGEPROT_H
+#define __OMNETPP_CADAPTIVENULLMESSAGEPROT_H
+
+#include <vector>
+#include "cnullmessageprot.h"
+
+namespace omnetpp {
+
+/**
+ * @brief A variant of the null message algorithm that adapts the null message
+ * resend frequency to each partition separately, and supports demand-driven
+ * EIT queries.
+ *
+ * When a partition blocks on the EIT of another partition, it sends an EIT
+ * request to it, and the other partition answers with a null message carrying
+ * its current EOT as soon as it reads the request. The laziness of each link
+ * is adjusted in an additive-increase/multiplicative-decrease manner: it
+ * increases each time the resend of the EOT is rescheduled without having
+ * received a request from the partition since the last time (i.e. the
+ * partition made progress on the EOTs sent so far, or the EOTs were
+ * piggybacked on frequent messages), and it decreases with every request.
+ * Thus, links whose receiver never blocks converge to lazy resends (less
+ * null message traffic), and links whose receiver blocks converge to
+ * eager resends (less blocking).
+ *
+ * Null message traffic and blocking statistics are recorded as scalars of
+ * the system module, and printed at the end of the run.
+ *
+ * @ingroup Parsim
+ */
+class SIM_API cAdaptiveNullMessageProtocol : public cNullMessageProtocol
+{
+  protected:
+    struct LinkInfo
+    {
+        double laziness = 0;
+        int numRequestsSinceUpdate = 0;  // EIT requests received since laziness was last updated
+        simtime_t requestedEit = -1;     // EIT for which we last sent a request, or -1
+
+        // statistics
+        int64_t messagesSent = 0;
+        int64_t nullMessagesSent = 0;       // standalone null messages
+        int64_t piggybackedNullMessages = 0;
+        int64_t messagesReceived = 0;
+        int64_t nullMessagesReceived = 0;
+        int64_t eitRequestsSent = 0;
+        int64_t eitRequestsReceived = 0;
+        int64_t numBlockings = 0;
+        int64_t blockingTimeNsecs = 0;      // wall-clock time spent blocked on this partition's EIT
+    };
+
+    std::vector<LinkInfo> links;  // indexed by procId
+
+    double minLaziness = 0.05;
+    double maxLaziness = 0.9;
+    double lazinessIncrement = 0.05;
+    double lazinessDecreaseFactor = 0.5;
+    bool eitRequests = true;
+    int pollInterval = 0;  // check for incoming buffers every pollInterval events; 0=never
+    int eventsSincePoll = 0;
+
+  protected:
+    virtual void processReceivedBuffer(cCommBuffer *buffer, int tag, int sourceProcId) override;
+    virtual void processReceivedMessage(cMessage *msg, const SendOptions& options, int destModuleId, int destGateId, int sourceProcId) override;
+    virtual bool receiveBlocking() override;
+    virtual void sendNullMessage(int procId, simtime_t now) override;
+    virtual simtime_t getResendDelay(int procId, simtime_t lookahead) override;
+
+    // answers an EIT request with a null message, if our EOT has advanced since the last one
+    virtual void processReceivedEITRequest(int sourceProcId);
+
+    // records the statistics as scalars of the system module
+    virtual void recordStatistics();
+
+    // prints the statistics to the log
+    virtual void printStatistics();
+
+  public:
+    /**
+     * Constructor.
+     */
+    cAdaptiveNullMessageProtocol() {}
+
+    /**
+     * Reads the parameters of the adaptation from the configuration.
+     */
+    virtual void configure(cSimulation *simulation, cConfiguration *cfg, cParsimPartition *partition) override;
+
+    /**
+     * Returns the current laziness of resending null messages to the given partition.
+     */
+    double getLaziness(int procId) const  {return links.at(procId).laziness;}
+
+    /**
+     * Called at the beginning of a simulation run.
+     */
+    virtual void startRun() override;
+
+    /**
+     * Called at the end of a simulation run. Prints the statistics.
+     */
+    virtual void endRun() override;
+
+    /**
+     * Records the statistics before the network is finalized.
+     */
+    virtual void lifecycleEvent(SimulationLifecycleEventType eventType, cObject *details) override;
+
+    /**
+     * Scheduler function. The addition to the base class is periodically
+     * checking for incoming buffers, so that EIT requests are answered while
+     * this partition is busy.
+     */
+    virtual cEvent *takeNextEvent() override;
+
+    /**
+     * Overridden to maintain statistics.
+     */
+    virtual void processOutgoingMessage(cMessage *msg, const SendOptions& options, int procId, int moduleId, int gateId, void *data) override;
+};
+
+}  // namespace omnetpp
+
+
+#endif
@@ -28,6 +28,7 @@
 #include "omnetpp/cfutureeventset.h"
 #include "omnetpp/csimplemodule.h" // SendOptions
 #include "cnullmessageprot.h"
+#include "ccommbufferbase.h"
 #include "clinkdelaylookahead.h"
 #include "cparsimpartition.h"
 #include "messagetags.h"
@@ -40,6 +41,8 @@ Register_Class(cNullMessageProtocol);
 
 Register_GlobalConfigOption(CFGID_PARSIM_NULLMESSAGEPROTOCOL_LOOKAHEAD_CLASS, "parsim-nullmessageprotocol-lookahead-class", CFG_STRING, "cLinkDelayLookahead", "When `cNullMessageProtocol` is selected as parsim synchronization class: specifies the C++ class that calculates lookahead. The class should subclass from `cNMPLookahead`.");
 Register_GlobalConfigOption(CFGID_PARSIM_NULLMESSAGEPROTOCOL_LAZINESS, "parsim-nullmessageprotocol-laziness", CFG_DOUBLE, "0.5", "When `cNullMessageProtocol` is selected as parsim synchronization class: specifies the laziness of sending null messages. Values in the range `[0,1)` are accepted. Laziness=0 causes null messages to be sent out immediately as a new EOT is learned, which may result in excessive null message traffic.");
+Register_GlobalConfigOption(CFGID_PARSIM_NULLMESSAGEPROTOCOL_MAX_BATCH_SIZE, "parsim-nullmessageprotocol-max-batch-size", CFG_INT, "1", "When `cNullMessageProtocol` is selected as parsim synchronization class: the maximum number of messages sent to another partition in one communications buffer. With values larger than 1, messages are collected per destination partition, and sent together with the next null message to the partition, or when the batch is full. This reduces the number of buffers sent, but the receiver learns about the advancing EOT later than when it is piggybacked on every message, which can delay it. See also `parsim-nullmessageprotocol-batch-eot-threshold`. The value 1 turns batching off.");
+Register_GlobalConfigOption(CFGID_PARSIM_NULLMESSAGEPROTOCOL_BATCH_EOT_THRESHOLD, "parsim-nullmessageprotocol-batch-eot-threshold", CFG_DOUBLE, "0.25", "When `cNullMessageProtocol` is selected as parsim synchronization class and message batching is on: when a message would advance the EOT of the destination partition by at least this fraction of the lookahead, the batch is sent out immediately, with the new EOT piggybacked on it. Smaller values keep the receivers less delayed, larger values result in larger batches. 0 piggybacks every EOT advance, like without batching; values at or above `parsim-nullmessageprotocol-laziness` leave it to the lazy null messages.");
 extern cConfigOption *CFGID_PARSIM_DEBUG;  // registered in cparsimpartition.cc
 
 cNullMessageProtocol::cNullMessageProtocol() : cParsimProtocolBase()
@@ -66,6 +69,12 @@ void cNullMessageProtocol::configure(cSimulation *simulation, cConfiguration *cf
         throw cRuntimeError("Class \"%s\" is not subclassed from cNMPLookahead", lookaheadClass.c_str());
 
     laziness = cfg->getAsDouble(CFGID_PARSIM_NULLMESSAGEPROTOCOL_LAZINESS);
+    maxBatchSize = cfg->getAsInt(CFGID_PARSIM_NULLMESSAGEPROTOCOL_MAX_BATCH_SIZE);
+    if (maxBatchSize < 1)
+        throw cRuntimeError("cNullMessageProtocol: Invalid maximum batch size %d", maxBatchSize);
+    batchEotThreshold = cfg->getAsDouble(CFGID_PARSIM_NULLMESSAGEPROTOCOL_BATCH_EOT_THRESHOLD);
+    if (batchEotThreshold < 0)
+        throw cRuntimeError("cNullMessageProtocol: Invalid batch EOT threshold %g", batchEotThreshold);
 
     lookaheadcalc->configure(simulation, cfg, partition);
 
@@ -89,6 +98,10 @@ void cNullMessageProtocol::startRun()
         segInfo[i].eotEvent = nullptr;
         segInfo[i].eitEvent = nullptr;
         segInfo[i].lastEotSent = 0.0;
+        segInfo[i].batch = (maxBatchSize > 1 && i != myProcId) ? comm->createCommBuffer() : nullptr;
+        segInfo[i].batchSize = 0;
+        segInfo[i].numBatchesSent = segInfo[i].numMessagesBatched = segInfo[i].numFullBatches = segInfo[i].numEotBatches = 0;
+        segInfo[i].numBytesBatched = segInfo[i].numBatchesReceived = 0;
     }
 
     // Note boot sequence: first we have to schedule all "resend-EOT" events,
@@ -113,6 +126,7 @@ void cNullMessageProtocol::startRun()
         if (i != myProcId) {
             sprintf(buf, "EIT-%d", i);
             cMessage *eitMsg = new cMessage(buf, MK_PARSIM_EIT);
+            eitMsg->setContextPointer((void *)(uintptr_t)i);  // khmm...
             segInfo[i].eitEvent = eitMsg;
             rescheduleEvent(eitMsg, 0.0);
         }
@@ -127,6 +141,18 @@ void cNullMessageProtocol::startRun()
 void cNullMessageProtocol::endRun()
 {
     lookaheadcalc->endRun();
+
+    if (maxBatchSize > 1) {
+        printBatchStatistics();
+
+        // messages still in the batches are beyond the last EOT, so they are discarded
+        for (int i = 0; i < numSeg; i++) {
+            if (segInfo[i].batch) {
+                comm->recycleCommBuffer(segInfo[i].batch);
+                segInfo[i].batch = nullptr;
+            }
+        }
+    }
 }
 
 void cNullMessageProtocol::processOutgoingMessage(cMessage *msg, const SendOptions& options, int destProcId, int destModuleId, int destGateId, void *data)
@@ -140,12 +166,44 @@ void cNullMessageProtocol::processOutgoingMessage(cMessage *msg, const SendOptio
     // send a null message only if EOT is better than last time
     bool sendNull = (eot > segInfo[destProcId].lastEotSent);
 
+    if (maxBatchSize > 1) {
+        // add the message to the batch
+        {if (debug) EV << "batching '" << msg->getName() << "' to " << destProcId << "\n";}
+        PartitionInfo& seg = segInfo[destProcId];
+        seg.batch->pack(destModuleId);
+        seg.batch->pack(destGateId);
+        packOptions(seg.batch, options);
+        seg.batch->packObject(msg);
+        seg.batchSize++;
+
+        if (sendNull && eot - seg.lastEotSent >= lookahead * batchEotThreshold) {
+            // the EOT advanced enough to be worth telling the receiver now: piggyback
+            // it on the batch, like a null message (and update "resend-EOT" timer)
+            seg.lastEotSent = eot;
+            simtime_t eotResendTime = sim->getSimTime() + getResendDelay(destProcId, lookahead);
+            rescheduleEvent(seg.eotEvent, eotResendTime);
+
+            {if (debug) EV << "piggybacking null msg on batch to " << destProcId << ", lookahead=" << lookahead << ", EOT=" << eot << "; next resend at " << eotResendTime << "\n";}
+
+            seg.batch->pack(-1);
+            seg.batch->pack(eot);
+            seg.numEotBatches++;
+            sendBatch(destProcId);
+        }
+        else if (seg.batchSize >= maxBatchSize) {
+            // otherwise the EOT goes out with the next null message
+            seg.numFullBatches++;
+            sendBatch(destProcId);
+        }
+        return;
+    }
+
     // send message
     cCommBuffer *buffer = comm->createCommBuffer();
     if (sendNull) {
         // update "resend-EOT" timer
         segInfo[destProcId].lastEotSent = eot;
-        simtime_t eotResendTime = sim->getSimTime() + lookahead*laziness;
+        simtime_t eotResendTime = sim->getSimTime() + getResendDelay(destProcId, lookahead);
         rescheduleEvent(segInfo[destProcId].eotEvent, eotResendTime);
 
         {if (debug) EV << "piggybacking null msg on '" << msg->getName() << "' to " << destProcId << ", lookahead=" << lookahead << ", EOT=" << eot << "; next resend at " << eotResendTime << "\n";}
@@ -205,6 +263,25 @@ void cNullMessageProtocol::processReceivedBuffer(cCommBuffer *buffer, int tag, i
             break;
         }
 
+        case TAG_CMESSAGE_BATCH: {
+            // messages in the order they were sent, optionally followed by a null message
+            segInfo[sourceProcId].numBatchesReceived++;
+            while (!buffer->isBufferEmpty()) {
+                buffer->unpack(destModuleId);
+                if (destModuleId == -1) {
+                    buffer->unpack(eit);
+                    processReceivedEIT(sourceProcId, eit);
+                }
+                else {
+                    buffer->unpack(destGateId);
+                    SendOptions options = unpackOptions(buffer);
+                    cMessage *msg = (cMessage *)buffer->unpackObject();
+                    processReceivedMessage(msg, options, destModuleId, destGateId, sourceProcId);
+                }
+            }
+            break;
+        }
+
         default: {
             partition->processReceivedBuffer(buffer, tag, sourceProcId);
             break;
@@ -289,16 +366,60 @@ void cNullMessageProtocol::sendNullMessage(int procId, simtime_t now)
     segInfo[procId].lastEotSent = eot;
 
     // calculate time of next null message sending, and schedule "resend-EOT" event
-    simtime_t eotResendTime = now + lookahead*laziness;
+    simtime_t eotResendTime = now + getResendDelay(procId, lookahead);
     rescheduleEvent(segInfo[procId].eotEvent, eotResendTime);
 
     {if (debug) EV << "sending null msg to " << procId << ", lookahead=" << lookahead << ", EOT=" << eot << "; next resend at " << eotResendTime << "\n";}
 
-    // send out null message
-    cCommBuffer *buffer = comm->createCommBuffer();
-    buffer->pack(eot);
-    comm->send(buffer, TAG_NULLMESSAGE, procId);
-    comm->recycleCommBuffer(buffer);
+    // send out null message, together with the batched messages if there are any
+    PartitionInfo& seg = segInfo[procId];
+    if (seg.batchSize > 0) {
+        seg.batch->pack(-1);
+        seg.batch->pack(eot);
+        sendBatch(procId);
+    }
+    else {
+        cCommBuffer *buffer = comm->createCommBuffer();
+        buffer->pack(eot);
+        comm->send(buffer, TAG_NULLMESSAGE, procId);
+        comm->recycleCommBuffer(buffer);
+    }
+}
+
+void cNullMessageProtocol::sendBatch(int procId)
+{
+    PartitionInfo& seg = segInfo[procId];
+
+    {if (debug) EV << "sending batch of " << seg.batchSize << " messages to " << procId << "\n";}
+
+    seg.numBatchesSent++;
+    seg.numMessagesBatched += seg.batchSize;
+    if (cCommBufferBase *base = dynamic_cast<cCommBufferBase *>(seg.batch))
+        seg.numBytesBatched += base->getMessageSize();
+
+    comm->send(seg.batch, TAG_CMESSAGE_BATCH, procId);
+    comm->recycleCommBuffer(seg.batch);
+    seg.batch = comm->createCommBuffer();
+    seg.batchSize = 0;
+}
+
+void cNullMessageProtocol::printBatchStatistics()
+{
+    int myProcId = comm->getProcId();
+    EV << "Message batching statistics of partition " << myProcId << ":\n";
+    for (int i = 0; i < numSeg; i++) {
+        if (i == myProcId)
+            continue;
+        const PartitionInfo& seg = segInfo[i];
+        EV << "  to/from partition " << i << ": "
+           << seg.numMessagesBatched << " messages sent in " << seg.numBatchesSent << " batches ("
+           << (seg.numBatchesSent == 0 ? 0.0 : seg.numMessagesBatched / (double)seg.numBatchesSent) << " messages, "
+           << (seg.numBatchesSent == 0 ? 0.0 : seg.numBytesBatched / (double)seg.numBatchesSent) << " bytes per batch), "
+           << seg.numFullBatches << " sent when full, "
+           << seg.numEotBatches << " sent with an advanced EOT, "
+           << seg.batchSize << " messages left unsent, "
+           << seg.numBatchesReceived << " batches received\n";
+    }
 }
 
 void cNullMessageProtocol::rescheduleEvent(cMessage *msg, simtime_t t)
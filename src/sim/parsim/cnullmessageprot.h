@@ -31,6 +31,15 @@ class cNMPLookahead;
  * Lookahead calculation is encapsulated into a separate object,
  * subclassed from cNMPLookahead.
  *
+ * Optionally, outgoing messages are collected per destination partition and
+ * sent in batches, together with the next null message to the partition.
+ * The messages arrive after the EOT sent last to the partition, so they
+ * cannot be processed before the next null message arrives anyway. However,
+ * without batching, the receiver learns the advancing EOT from every message,
+ * while with batching only from the null messages; to limit that delay, a
+ * batch is sent out early, with the new EOT, when the EOT has advanced by
+ * a given fraction of the lookahead.
+ *
  * @ingroup Parsim
  */
 class SIM_API cNullMessageProtocol : public cParsimProtocolBase
@@ -41,6 +50,16 @@ class SIM_API cNullMessageProtocol : public cParsimProtocolBase
         cMessage *eitEvent;  // EIT received from partition
         cMessage *eotEvent;  // events which marks that a null message should be sent out
         simtime_t lastEotSent; // last EOT value that was sent
+
+        // message batching
+        cCommBuffer *batch;    // messages waiting to be sent, or nullptr if batching is off
+        int batchSize;         // number of messages in batch
+        int64_t numBatchesSent;
+        int64_t numMessagesBatched;
+        int64_t numFullBatches;  // batches sent because they reached maxBatchSize
+        int64_t numEotBatches;   // batches sent because the EOT advanced by batchEotThreshold
+        int64_t numBytesBatched;
+        int64_t numBatchesReceived;
     };
 
     // partition information
@@ -50,6 +69,12 @@ class SIM_API cNullMessageProtocol : public cParsimProtocolBase
     // controls null message resend frequency, 0<=laziness<=1
     double laziness = 0.5;
 
+    // maximum number of messages in a batch; 1 means no batching
+    int maxBatchSize = 1;
+
+    // the batch is sent with the new EOT if it advanced by this fraction of the lookahead
+    double batchEotThreshold = 0.25;
+
     // internally used message kinds
     enum
     {
@@ -71,9 +96,19 @@ class SIM_API cNullMessageProtocol : public cParsimProtocolBase
     // resend null message to this partition
     virtual void sendNullMessage(int procId, simtime_t now);
 
+    // sends out the batched messages to this partition
+    virtual void sendBatch(int procId);
+
+    // prints the batching statistics to the log
+    virtual void printBatchStatistics();
+
     // reschedule event in FES, to the given time
     virtual void rescheduleEvent(cMessage *msg, simtime_t t);
 
+    // returns the time after which the EOT should be resent to the given
+    // partition, after an EOT with the given lookahead was sent to it
+    virtual simtime_t getResendDelay(int procId, simtime_t lookahead) {return lookahead*laziness;}
+
   public:
     /**
      * Constructor.
@@ -128,7 +163,9 @@ class SIM_API cNullMessageProtocol : public cParsimProtocolBase
     /**
      * In addition to its normal task (sending out the cMessage to the
      * given partition), it also does lookahead calculation and optional
-     * piggybacking of null message on the cMessage.
+     * piggybacking of null message on the cMessage. With batching, the
+     * cMessage is added to the batch of the partition, and the batch is
+     * sent out if it is full, or if the EOT advanced enough to piggyback it.
      */
     virtual void processOutgoingMessage(cMessage *msg, const SendOptions& options, int procId, int moduleId, int gateId, void *data) override;
 };
@@ -24,9 +24,11 @@
 #include "cmpicomm.h"
 #include "cnosynchronization.h"
 #include "cnullmessageprot.h"
+#include "cadaptivenullmessageprot.h"
 #include "cispeventlogger.h"
 #include "cidealsimulationprot.h"
 #include "clinkdelaylookahead.h"
+#include "ctimewindowprot.h"
 
 namespace omnetpp {
 
@@ -66,11 +68,13 @@ void parsim_dummy()
 #endif
     cNoSynchronization ns;
     cNullMessageProtocol np;
+    cAdaptiveNullMessageProtocol anp;
     cISPEventLogger iel;
     cIdealSimulationProtocol ip;
     cLinkDelayLookahead ldla;
+    cTimeWindowProtocol twp;
     // prevent "unused variable" warnings:
-    (void)fc; (void)npc; (void)ns; (void)np; (void)iel; (void)ip; (void)ldla;
+    (void)fc; (void)npc; (void)ns; (void)np; (void)anp; (void)iel; (void)ip; (void)ldla; (void)twp;
 }
 
 }  // namespace omnetpp
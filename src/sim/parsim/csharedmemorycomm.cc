@@ -0,0 +1,376 @@
+//=========================================================================
+//  CSHAREDMEMORYCOMM.CC - part of
+//
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <typeinfo>
+#include "omnetpp/cexception.h"
+#include "omnetpp/clog.h"
+#include "omnetpp/globals.h"
+#include "omnetpp/regmacros.h"
+#include "omnetpp/cconfigoption.h"
+#include "omnetpp/cconfiguration.h"
+#include "omnetpp/cenvir.h"
+#include "omnetpp/cobjectfactory.h"
+#include "omnetpp/csimulation.h"
+#include "csharedmemorycomm.h"
+#include "csharedmemorycommbuffer.h"
+
+namespace omnetpp {
+
+Register_Class(cSharedMemoryCommunications);
+
+Register_GlobalConfigOption(CFGID_PARSIM_SHAREDMEMORYCOMM_QUEUE_SIZE, "parsim-sharedmemorycommunications-queue-size", CFG_INT, "1024", "When `cSharedMemoryCommunications` is selected as parsim communications class: the capacity of the ring buffer between each pair of partitions. It is rounded up to a power of two. Buffers sent while the ring is full are queued at the sender, so this only affects performance.");
+
+extern cConfigOption *CFGID_PARALLEL_SIMULATION;
+extern cConfigOption *CFGID_PARSIM_NUM_PARTITIONS;
+extern cConfigOption *CFGID_PARSIM_COMMUNICATIONS_CLASS;
+
+// number of unsuccessful polls before receiveBlocking() starts yielding the CPU, then sleeping
+#define SPIN_COUNT   1000
+#define YIELD_COUNT  2000
+#define SLEEP_MICROSECS  100
+
+namespace {
+
+// Lock-free single-producer single-consumer ring buffer
+template <typename T>
+class SpscRing
+{
+  private:
+    std::vector<T> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head{0};  // written by the consumer
+    alignas(64) std::atomic<size_t> tail{0};  // written by the producer
+
+  public:
+    explicit SpscRing(size_t capacity) : slots(capacity), mask(capacity-1) {}
+
+    bool push(const T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == slots.size())
+            return false;  // full
+        slots[t & mask] = item;
+        tail.store(t+1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire))
+            return false;  // empty
+        item = slots[h & mask];
+        head.store(h+1, std::memory_order_release);
+        return true;
+    }
+};
+
+}  // namespace
+
+struct cSharedMemoryCommunications::Exchange
+{
+    typedef SpscRing<cSharedMemoryCommunications::Item> Ring;
+
+    int numPartitions;
+    int numJoined = 0;  // protected by registryMutex
+    std::vector<bool> procIdTaken;  // protected by registryMutex
+    int numLeft = 0;    // protected by registryMutex
+    std::vector<Ring*> rings;  // ring from procId i to procId j is at index i*numPartitions+j
+
+    Exchange(int numPartitions, size_t capacity) : numPartitions(numPartitions), procIdTaken(numPartitions, false) {
+        rings.resize(numPartitions*numPartitions);
+        for (int i = 0; i < numPartitions; i++)
+            for (int j = 0; j < numPartitions; j++)
+                if (i != j)
+                    rings[i*numPartitions+j] = new Ring(capacity);
+    }
+
+    ~Exchange() {
+        // discard undelivered buffers (and the objects in them)
+        Item item;
+        for (Ring *ring : rings) {
+            if (ring) {
+                while (ring->pop(item))
+                    delete item.buffer;
+                delete ring;
+            }
+        }
+    }
+
+    Ring *getRing(int from, int to) {return rings[from*numPartitions+to];}
+};
+
+OPP_THREAD_LOCAL int cSharedMemoryCommunications::threadProcId = -1;
+OPP_THREAD_LOCAL std::atomic<bool> *cSharedMemoryCommunications::threadAbortFlag = nullptr;
+
+// exchanges of the simulation runs that are still waiting for partitions to join
+static std::mutex registryMutex;
+static std::map<std::string,cSharedMemoryCommunications::Exchange*> exchangeRegistry;
+
+int cSharedMemoryCommunications::getNumPartitionThreads(cConfiguration *cfg)
+{
+    if (!cfg->getAsBool(CFGID_PARALLEL_SIMULATION))
+        return 0;
+    std::string className = cfg->getAsString(CFGID_PARSIM_COMMUNICATIONS_CLASS);
+    cObjectFactory *factory = cObjectFactory::find(className.c_str());
+    if (!factory || strcmp(factory->getFullName(), opp_typename(typeid(cSharedMemoryCommunications))) != 0)
+        return 0;
+    int numPartitions = cfg->getAsInt(CFGID_PARSIM_NUM_PARTITIONS, -1);
+    if (numPartitions < 1)
+        throw cRuntimeError("cSharedMemoryCommunications: Missing or invalid value for the number of partitions (%s=%d)",
+                CFGID_PARSIM_NUM_PARTITIONS->getName(), numPartitions);
+    return numPartitions;
+}
+
+cSharedMemoryCommunications::cSharedMemoryCommunications()
+{
+}
+
+cSharedMemoryCommunications::~cSharedMemoryCommunications()
+{
+    shutdown();
+
+    for (auto item : receivedBuffers)
+        delete item.buffer;
+}
+
+void cSharedMemoryCommunications::configure(cSimulation *sim, cConfiguration *cfg, int np, int procId)
+{
+    simulation = sim;
+    abortFlag = threadAbortFlag;
+    numPartitions = np;
+    if (numPartitions == -1)
+        throw cRuntimeError("%s: Number of partitions not specified", getClassName());
+    if (numPartitions < 1)
+        throw cRuntimeError("%s: Invalid value for the number of partitions (%d)", getClassName(), np);
+    if (procId != -1)
+        throw cRuntimeError("%s: procID must not be specified, partitions are numbered automatically", getClassName());
+
+    int queueSize = cfg->getAsInt(CFGID_PARSIM_SHAREDMEMORYCOMM_QUEUE_SIZE);
+    if (queueSize < 1)
+        throw cRuntimeError("%s: Invalid queue size %d", getClassName(), queueSize);
+    size_t capacity = 1;
+    while (capacity < (size_t)queueSize)
+        capacity *= 2;  // must be power of 2
+
+    // join the other partitions of the same simulation run
+    std::string key = std::string(cfg->getVariable(CFGVAR_CONFIGNAME)) + "#" + cfg->getVariable(CFGVAR_RUNNUMBER);
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        auto it = exchangeRegistry.find(key);
+        if (it == exchangeRegistry.end())
+            it = exchangeRegistry.insert(std::make_pair(key, new Exchange(numPartitions, capacity))).first;
+        Exchange *ex = it->second;
+        if (ex->numPartitions != numPartitions)
+            throw cRuntimeError("%s: Number of partitions (%d) differs from that of the other partitions (%d)", getClassName(), numPartitions, ex->numPartitions);
+        int id = threadProcId;
+        if (id == -1)
+            id = std::find(ex->procIdTaken.begin(), ex->procIdTaken.end(), false) - ex->procIdTaken.begin();
+        else if (id < 0 || id >= numPartitions)
+            throw cRuntimeError("%s: Invalid partition ID %d for %d partitions", getClassName(), id, numPartitions);
+        if (ex->procIdTaken[id])
+            throw cRuntimeError("%s: Partition ID %d is already taken", getClassName(), id);
+        ex->procIdTaken[id] = true;
+        exchange = ex;
+        myProcId = id;
+        exchange->numJoined++;
+        if (exchange->numJoined == numPartitions)
+            exchangeRegistry.erase(it);  // complete; the next run with the same key will get a new one
+    }
+
+    overflowQueues.resize(numPartitions);
+
+    EV << "cSharedMemoryCommunications: started as partition " << myProcId << " out of " << numPartitions << ".\n";
+}
+
+void cSharedMemoryCommunications::shutdown()
+{
+    if (!exchange)
+        return;
+
+    // drop what could not be delivered
+    for (auto& queue : overflowQueues) {
+        for (const Item& item : queue)
+            delete item.buffer;
+        queue.clear();
+    }
+    numOverflowItems = 0;
+
+    // the last partition to leave releases the exchange; if the run was aborted,
+    // some partitions may have never joined, and the exchange is still registered
+    std::lock_guard<std::mutex> lock(registryMutex);
+    bool complete = exchange->numJoined == exchange->numPartitions;
+    bool aborted = abortFlag && abortFlag->load();
+    if (++exchange->numLeft == exchange->numJoined && (complete || aborted)) {
+        if (!complete) {
+            for (auto it = exchangeRegistry.begin(); it != exchangeRegistry.end(); ++it) {
+                if (it->second == exchange) {
+                    exchangeRegistry.erase(it);
+                    break;
+                }
+            }
+        }
+        delete exchange;
+    }
+    exchange = nullptr;
+}
+
+int cSharedMemoryCommunications::getNumPartitions() const
+{
+    return numPartitions;
+}
+
+int cSharedMemoryCommunications::getProcId() const
+{
+    return myProcId;
+}
+
+cCommBuffer *cSharedMemoryCommunications::createCommBuffer()
+{
+    return new cSharedMemoryCommBuffer();
+}
+
+void cSharedMemoryCommunications::recycleCommBuffer(cCommBuffer *buffer)
+{
+    delete buffer;
+}
+
+void cSharedMemoryCommunications::send(cCommBuffer *buffer, int tag, int destination)
+{
+    if (!exchange)
+        throw cRuntimeError("cSharedMemoryCommunications: Cannot send, not configured or already shut down");
+    if (destination < 0 || destination >= numPartitions || destination == myProcId)
+        throw cRuntimeError("cSharedMemoryCommunications: Invalid destination procId=%d", destination);
+
+    // move the contents into a new buffer, which is then owned by the receiver
+    cSharedMemoryCommBuffer *b = new cSharedMemoryCommBuffer();
+    b->swap((cSharedMemoryCommBuffer *)buffer);
+    Item item = {tag, b};
+
+    // preserve ordering: if there are still queued items, this one has to wait too
+    std::deque<Item>& queue = overflowQueues[destination];
+    Exchange::Ring *ring = exchange->getRing(myProcId, destination);
+    while (!queue.empty() && ring->push(queue.front())) {
+        queue.pop_front();
+        numOverflowItems--;
+    }
+    if (!queue.empty() || !ring->push(item)) {
+        queue.push_back(item);
+        numOverflowItems++;
+    }
+}
+
+void cSharedMemoryCommunications::flushOverflowQueues()
+{
+    for (int i = 0; i < numPartitions && numOverflowItems > 0; i++) {
+        std::deque<Item>& queue = overflowQueues[i];
+        if (queue.empty())
+            continue;
+        Exchange::Ring *ring = exchange->getRing(myProcId, i);
+        while (!queue.empty() && ring->push(queue.front())) {
+            queue.pop_front();
+            numOverflowItems--;
+        }
+    }
+}
+
+bool cSharedMemoryCommunications::receive(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId)
+{
+    // return one from the previously buffered ones, if exist
+    for (auto it = receivedBuffers.begin(); it != receivedBuffers.end(); ++it) {
+        if (it->receivedTag == filtTag || filtTag == PARSIM_ANY_TAG) {
+            receivedTag = it->receivedTag;
+            sourceProcId = it->sourceProcId;
+            ((cSharedMemoryCommBuffer *)buffer)->swap(it->buffer);
+            delete it->buffer;
+            receivedBuffers.erase(it);
+            return true;
+        }
+    }
+
+    if (numOverflowItems > 0)
+        flushOverflowQueues();
+
+    // receive from the rings
+    bool recv = doReceive(buffer, receivedTag, sourceProcId);
+
+    // if received one with a wrong tag, store it for later and return false
+    if (recv && filtTag != PARSIM_ANY_TAG && filtTag != receivedTag) {
+        cSharedMemoryCommBuffer *copy = new cSharedMemoryCommBuffer();
+        ((cSharedMemoryCommBuffer *)buffer)->swap(copy);
+        receivedBuffers.push_back({receivedTag, sourceProcId, copy});
+        return false;
+    }
+    return recv;
+}
+
+bool cSharedMemoryCommunications::doReceive(cCommBuffer *buffer, int& receivedTag, int& sourceProcId)
+{
+    if (!exchange)
+        throw cRuntimeError("cSharedMemoryCommunications: Cannot receive, not configured or already shut down");
+
+    rrBase = (rrBase+1) % numPartitions;
+    for (int k = 0; k < numPartitions; k++) {
+        int i = (rrBase+k) % numPartitions;  // shift by rrBase for Round-Robin query
+        if (i == myProcId)
+            continue;
+        Item item;
+        if (exchange->getRing(i, myProcId)->pop(item)) {
+            cSharedMemoryCommBuffer *b = (cSharedMemoryCommBuffer *)buffer;
+            b->reset();
+            b->swap(item.buffer);
+            delete item.buffer;
+            receivedTag = item.tag;
+            sourceProcId = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool cSharedMemoryCommunications::receiveBlocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId)
+{
+    // poll for a while, then start yielding the CPU to other threads
+    // (the other partitions, presumably), then sleep between polls
+    int count = 0;
+    while (!receive(filtTag, buffer, receivedTag, sourceProcId)) {
+        if (abortFlag && abortFlag->load(std::memory_order_relaxed))
+            throw cRuntimeError("cSharedMemoryCommunications: Another partition has stopped with an error");
+        if (++count < SPIN_COUNT)
+            continue;
+        else if (count < YIELD_COUNT)
+            std::this_thread::yield();
+        else {
+            std::this_thread::sleep_for(std::chrono::microseconds(SLEEP_MICROSECS));
+            if (getEnvir()->idle())
+                return false;
+        }
+    }
+    return true;
+}
+
+bool cSharedMemoryCommunications::receiveNonblocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId)
+{
+    return receive(filtTag, buffer, receivedTag, sourceProcId);
+}
+
+}  // namespace omnetpp
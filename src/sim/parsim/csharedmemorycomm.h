@@ -0,0 +1,188 @@
+//=========================================================================
+//  CSHAREDMEMORYCOMM.H - part of
+//
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CSHAREDMEMORYCOMM_H
+#define __OMNETPP_CSHAREDMEMORYCOMM_H
+
+#include <atomic>
+#include <deque>
+#include <list>
+#include <vector>
+#include "omnetpp/cparsimcomm.h"
+
+namespace omnetpp {
+
+class cSharedMemoryCommBuffer;
+
+/**
+ * @brief Implementation of the communications layer for partitions that
+ * run as threads of the same process.
+ *
+ * Every ordered pair of partitions is connected with a lock-free
+ * single-producer single-consumer ring buffer. Buffers are passed through
+ * the rings as they are, and objects inside them (messages) are not
+ * serialized, only a pointer is handed over (see cSharedMemoryCommBuffer).
+ * If a ring is full, the sender keeps the buffer in a local overflow queue,
+ * and retries on subsequent communication calls.
+ *
+ * Partitions find each other via the configuration name and run number.
+ * The threads are launched by the user interface (e.g. Cmdenv runs a
+ * separate thread for each partition when it sees that this class is
+ * selected); see getNumPartitionThreads(). The user interface tells each
+ * thread its partition ID with setThreadProcId(); partitions without one
+ * are assigned the free IDs in the order they call configure().
+ *
+ * @ingroup Parsim
+ */
+class SIM_API cSharedMemoryCommunications : public cParsimCommunications
+{
+  public:
+    struct Exchange;  // internal: data shared by the partitions of a simulation run
+
+  protected:
+    struct Item {int tag; cSharedMemoryCommBuffer *buffer;};
+
+    static OPP_THREAD_LOCAL int threadProcId;
+    static OPP_THREAD_LOCAL std::atomic<bool> *threadAbortFlag;
+
+    cSimulation *simulation = nullptr;
+    std::atomic<bool> *abortFlag = nullptr;  // not owned
+    int numPartitions = -1;
+    int myProcId = -1;
+    Exchange *exchange = nullptr;
+    int rrBase = 0;
+
+    // buffers that did not fit into the ring buffers, per destination
+    std::vector<std::deque<Item>> overflowQueues;
+    int numOverflowItems = 0;
+
+    // reordering buffer needed because of tag filtering support (filtTag)
+    struct ReceivedBuffer {int receivedTag; int sourceProcId; cSharedMemoryCommBuffer *buffer;};
+    std::list<ReceivedBuffer> receivedBuffers;
+
+  protected:
+    // common impl. for receiveBlocking() and receiveNonblocking()
+    bool receive(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId);
+    bool doReceive(cCommBuffer *buffer, int& receivedTag, int& sourceProcId);
+    void flushOverflowQueues();
+
+  public:
+    /**
+     * Returns the number of partitions that need to be launched as threads
+     * for the simulation run with the given configuration. Returns 0 if the
+     * configuration does not select parallel simulation with this class.
+     */
+    static int getNumPartitionThreads(cConfiguration *cfg);
+
+    /**
+     * Sets the partition ID of the partition that will be started on the
+     * current thread. To be called by the user interface before it sets up
+     * the simulation on a partition thread; -1 means no preference.
+     */
+    static void setThreadProcId(int procId) {threadProcId = procId;}
+
+    /**
+     * Returns the partition ID set for the current thread with
+     * setThreadProcId(), or -1.
+     */
+    static int getThreadProcId() {return threadProcId;}
+
+    /**
+     * Sets the flag that tells the partition started on the current thread
+     * that another partition of the same run has failed. The flag is shared
+     * by the partition threads; the user interface should set it when a
+     * partition thread stops with an error, because the other partitions
+     * would wait for it forever, e.g. when it failed before joining them.
+     * receiveBlocking() throws an error when it finds the flag set.
+     */
+    static void setThreadAbortFlag(std::atomic<bool> *flag) {threadAbortFlag = flag;}
+
+    /**
+     * Constructor.
+     */
+    cSharedMemoryCommunications();
+
+    /**
+     * Destructor.
+     */
+    virtual ~cSharedMemoryCommunications();
+
+    /** @name Redefined methods from cParsimCommunications */
+    //@{
+    /**
+     * Init the library. Here we join the other partitions of the same
+     * simulation run. The procId argument must be -1, because the partition
+     * ID comes from setThreadProcId(), or it is assigned automatically.
+     */
+    virtual void configure(cSimulation *simulation, cConfiguration *cfg, int numPartitions, int procId) override;
+
+    /**
+     * Shutdown the communications library. The last partition to shut down
+     * releases the ring buffers.
+     */
+    virtual void shutdown() override;
+
+    /**
+     * Returns the associated simulation instance.
+     */
+    cSimulation *getSimulation() const override {return simulation;}
+
+    /**
+     * Returns total number of partitions.
+     */
+    virtual int getNumPartitions() const override;
+
+    /**
+     * Returns the id of this partition.
+     */
+    virtual int getProcId() const override;
+
+    /**
+     * Creates an empty buffer of type cSharedMemoryCommBuffer.
+     */
+    virtual cCommBuffer *createCommBuffer() override;
+
+    /**
+     * Recycle communication buffer after use.
+     */
+    virtual void recycleCommBuffer(cCommBuffer *buffer) override;
+
+    /**
+     * Hands over the contents of the buffer to the destination partition.
+     * The buffer will be empty after the call.
+     */
+    virtual void send(cCommBuffer *buffer, int tag, int destination) override;
+
+    /**
+     * Receives packed data, and also returns tag and source procId.
+     * Normally returns true; false is returned if blocking was interrupted by the user.
+     * Throws an error if another partition has failed (see setThreadAbortFlag()).
+     */
+    virtual bool receiveBlocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId) override;
+
+    /**
+     * Receives packed data, and also returns tag and source procId.
+     * Call is non-blocking -- it returns true if something has been
+     * received, false otherwise.
+     */
+    virtual bool receiveNonblocking(int filtTag, cCommBuffer *buffer, int& receivedTag, int& sourceProcId) override;
+    //@}
+};
+
+}  // namespace omnetpp
+
+
+#endif
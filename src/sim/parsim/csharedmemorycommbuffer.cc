@@ -0,0 +1,195 @@
+//=========================================================================
+//  CSHAREDMEMORYCOMMBUFFER.CC - part of
+//
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include "omnetpp/cmessage.h"
+#include "omnetpp/cpacket.h"
+#include "omnetpp/cenvir.h"
+#include "omnetpp/csimulation.h"
+#include "omnetpp/cownedobject.h"
+#include "omnetpp/cvisitor.h"
+#include "omnetpp/cexception.h"
+#include "omnetpp/checkandcast.h"
+#include "omnetpp/globals.h"
+#include "omnetpp/regmacros.h"
+#include "csharedmemorycommbuffer.h"
+
+namespace omnetpp {
+
+Register_Class(cSharedMemoryCommBuffer);
+
+namespace {
+
+// Owns the objects while they are in transit between two partitions.
+// It has no state, so it can be shared by all threads.
+class TransitOwner : public cObject
+{
+  public:
+    void acquire(cOwnedObject *obj) {take(obj);}
+    void release(cOwnedObject *obj) {drop(obj);}
+    void discard(cOwnedObject *obj) {dropAndDelete(obj);}
+};
+
+TransitOwner transitOwner;
+
+// Counts the messages and owned objects in an object tree. As a side effect,
+// visiting the children of a packet makes its encapsulated packet private
+// (see cPacket::forEachChild()), so the tree will not share any objects with
+// other packets after the traversal.
+class HandoverVisitor : public cVisitor
+{
+  public:
+    int numMessages = 0;
+    int numOwnedObjects = 0;
+
+  protected:
+    virtual bool visit(cObject *obj) override {
+        if (dynamic_cast<cMessage *>(obj))
+            numMessages++;
+        if (dynamic_cast<cOwnedObject *>(obj))
+            numOwnedObjects++;
+        obj->forEachChild(this);
+        return true;
+    }
+};
+
+// Gives new IDs to the messages in an object tree that arrived from another
+// thread, like cMessage::parsimUnpack() does when the message is created
+class ReceiveVisitor : public cVisitor
+{
+  protected:
+    virtual bool visit(cObject *obj) override {
+        if (cMessage *msg = dynamic_cast<cMessage *>(obj))
+            msg->handedOver();
+        obj->forEachChild(this);
+        return true;
+    }
+};
+
+// Enables or disables notifications in the current thread's environment
+// until the end of the scope
+class NotificationSuppressor
+{
+  private:
+    cEnvir *envir;
+    bool oldValue;
+
+  public:
+    NotificationSuppressor() : envir(cSimulation::getActiveEnvir()), oldValue(envir->suppressNotifications) {envir->suppressNotifications = true;}
+    ~NotificationSuppressor() {envir->suppressNotifications = oldValue;}
+};
+
+// Same check as in cMessage::parsimPack(), done on the message and on its
+// encapsulated packets, because the copy made by dup() would silently lose
+// the control info
+void checkHandover(cObject *obj)
+{
+    cMessage *msg = dynamic_cast<cMessage *>(obj);
+    while (msg) {
+        if (msg->getContextPointer() || msg->getControlInfo())
+            throw cRuntimeError(msg, "packObject(): Cannot pack object with contextPointer or controlInfo set");
+        msg = msg->isPacket() ? static_cast<cPacket *>(msg)->_getEncapMsg() : nullptr;
+    }
+}
+
+}  // namespace
+
+cSharedMemoryCommBuffer::~cSharedMemoryCommBuffer()
+{
+    discardObjects();
+}
+
+void cSharedMemoryCommBuffer::discardObjects()
+{
+    // the messages were never created in this thread, so don't report their deletion
+    NotificationSuppressor suppressor;
+    for (size_t i = objectPosition; i < objects.size(); i++) {
+        const Entry& entry = objects[i];
+        cMessage::adjustLiveMessageCount(entry.numMessages);
+        cOwnedObject::adjustObjectCounts(0, entry.numOwnedObjects);
+        if (cOwnedObject *ownedObject = dynamic_cast<cOwnedObject *>(entry.object))
+            transitOwner.discard(ownedObject);
+        else
+            delete entry.object;
+    }
+    objects.clear();
+    objectPosition = 0;
+}
+
+bool cSharedMemoryCommBuffer::isBufferEmpty() const
+{
+    return cMemCommBuffer::isBufferEmpty() && objectPosition == objects.size();
+}
+
+void cSharedMemoryCommBuffer::assertBufferEmpty()
+{
+    cMemCommBuffer::assertBufferEmpty();
+    if (objectPosition != objects.size())
+        throw cRuntimeError("Internal error: cCommBuffer pack/unpack mismatch: "
+                            "%d objects remained in buffer after unpacking", (int)(objects.size()-objectPosition));
+}
+
+void cSharedMemoryCommBuffer::packObject(cObject *obj)
+{
+    checkHandover(obj);
+
+    // The sender deletes the original after sending, so we need a copy. The copy
+    // is not a new message in the sending thread: it must not be reported, and
+    // it must not use up message IDs of this thread, like the copy that is
+    // created in the receiving thread when the message is serialized.
+    cObject *copy;
+    HandoverVisitor visitor;
+    {
+        NotificationSuppressor suppressor;
+        copy = obj->dup();
+        visitor.process(copy);
+    }
+    cMessage::uncountCopies(visitor.numMessages);
+    cOwnedObject::adjustObjectCounts(-visitor.numOwnedObjects, -visitor.numOwnedObjects);
+
+    if (cOwnedObject *ownedCopy = dynamic_cast<cOwnedObject *>(copy))
+        transitOwner.acquire(ownedCopy);
+
+    objects.push_back({copy, visitor.numMessages, visitor.numOwnedObjects});
+}
+
+cObject *cSharedMemoryCommBuffer::unpackObject()
+{
+    if (objectPosition >= objects.size())
+        throw cRuntimeError("Internal error: cCommBuffer pack/unpack mismatch: No more objects in buffer");
+
+    Entry& entry = objects[objectPosition++];
+    cObject *obj = entry.object;
+    entry.object = nullptr;
+
+    // the messages are counted and get their IDs in this thread
+    cOwnedObject::adjustObjectCounts(entry.numOwnedObjects, entry.numOwnedObjects);
+    ReceiveVisitor visitor;
+    visitor.process(obj);
+
+    if (cOwnedObject *ownedObject = dynamic_cast<cOwnedObject *>(obj))
+        transitOwner.release(ownedObject);  // inserts it into the current owning context
+    return obj;
+}
+
+void cSharedMemoryCommBuffer::swap(cCommBufferBase *other)
+{
+    cMemCommBuffer::swap(other);
+    cSharedMemoryCommBuffer *otherBuffer = check_and_cast<cSharedMemoryCommBuffer *>(other);
+    std::swap(objects, otherBuffer->objects);
+    std::swap(objectPosition, otherBuffer->objectPosition);
+}
+
+}  // namespace omnetpp
@@ -0,0 +1,101 @@
+//=========================================================================
+//  CSHAREDMEMORYCOMMBUFFER.H - part of
+//
+//                     OMNeT++/OMNEST
+//            Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CSHAREDMEMORYCOMMBUFFER_H
+#define __OMNETPP_CSHAREDMEMORYCOMMBUFFER_H
+
+#include <vector>
+#include "cmemcommbuffer.h"
+
+namespace omnetpp {
+
+/**
+ * @brief Communication buffer used by cSharedMemoryCommunications.
+ *
+ * Basic types are packed into a memory buffer like in cMemCommBuffer, but
+ * objects are not serialized: packObject() stores a pointer to a private
+ * copy of the object, which is handed over to the receiving partition as
+ * it is. Encapsulated packets are not shared between the original and the
+ * copy, because reference counts are not safe to update from several threads.
+ * Like with serialization, the copy does not show up in the sending partition
+ * (no notifications, message IDs or statistics), and its messages get new IDs
+ * in the receiving partition.
+ *
+ * @ingroup Parsim
+ */
+class SIM_API cSharedMemoryCommBuffer : public cMemCommBuffer
+{
+  protected:
+    struct Entry {
+        cObject *object;
+        int numMessages;      // for the message statistics; includes encapsulated packets
+        int numOwnedObjects;  // for the object statistics
+    };
+    std::vector<Entry> objects;  // objects in packing order
+    size_t objectPosition = 0;   // index of the next object to unpack
+
+  protected:
+    void discardObjects();
+
+  public:
+    /**
+     * Constructor.
+     */
+    cSharedMemoryCommBuffer() {}
+
+    /**
+     * Destructor. Deletes objects that have not been unpacked.
+     */
+    virtual ~cSharedMemoryCommBuffer();
+
+    /** @name Redefined cCommBuffer methods */
+    //@{
+    /**
+     * Returns true if all data and all objects in the buffer were used up
+     * during unpacking.
+     */
+    virtual bool isBufferEmpty() const override;
+
+    /**
+     * Throws an exception if there are unpacked data or objects left in the
+     * buffer, or there was an underflow.
+     */
+    virtual void assertBufferEmpty() override;
+
+    /**
+     * Stores a copy of the object. The copy is removed from the ownership
+     * tree of the sending partition. Like cMessage::parsimPack(), it throws
+     * an error for messages with a context pointer or control info.
+     */
+    virtual void packObject(cObject *obj) override;
+
+    /**
+     * Returns the next object, and inserts it into the ownership tree of
+     * the receiving partition. The messages in it get new IDs.
+     */
+    virtual cObject *unpackObject() override;
+
+    /**
+     * Swaps the contents (including the objects) of the two buffers.
+     */
+    virtual void swap(cCommBufferBase *other) override;
+    //@}
+};
+
+}  // namespace omnetpp
+
+
+#endif
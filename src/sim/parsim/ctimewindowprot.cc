@@ -0,0 +1,282 @@
+//=========================================================================
+//  CTIMEWINDOWPROT.CC - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#include <algorithm>
+#include "omnetpp/cmessage.h"
+#include "omnetpp/cenvir.h"
+#include "omnetpp/cexception.h"
+#include "omnetpp/errmsg.h"
+#include "omnetpp/cconfiguration.h"
+#include "omnetpp/cparsimcomm.h"
+#include "omnetpp/ccommbuffer.h"
+#include "omnetpp/globals.h"
+#include "omnetpp/cconfigoption.h"
+#include "omnetpp/regmacros.h"
+#include "omnetpp/cfutureeventset.h"
+#include "omnetpp/simutil.h"
+#include "omnetpp/csimplemodule.h" // SendOptions
+#include "ctimewindowprot.h"
+#include "cnmplookahead.h"
+#include "cparsimpartition.h"
+#include "messagetags.h"
+
+namespace omnetpp {
+
+Register_Class(cTimeWindowProtocol);
+
+Register_GlobalConfigOption(CFGID_PARSIM_TIMEWINDOWPROTOCOL_LOOKAHEAD_CLASS, "parsim-timewindowprotocol-lookahead-class", CFG_STRING, "cLinkDelayLookahead", "When `cTimeWindowProtocol` is selected as parsim synchronization class: specifies the C++ class that calculates lookahead. The class should subclass from `cNMPLookahead`. The window size is the smallest lookahead of all partitions.");
+extern cConfigOption *CFGID_PARSIM_DEBUG;  // registered in cparsimpartition.cc
+
+cTimeWindowProtocol::~cTimeWindowProtocol()
+{
+    delete lookaheadcalc;
+}
+
+void cTimeWindowProtocol::configure(cSimulation *simulation, cConfiguration *cfg, cParsimPartition *partition)
+{
+    cParsimProtocolBase::configure(simulation, cfg, partition);
+
+    debug = cfg->getAsBool(CFGID_PARSIM_DEBUG);
+
+    std::string lookaheadClass = cfg->getAsString(CFGID_PARSIM_TIMEWINDOWPROTOCOL_LOOKAHEAD_CLASS);
+    lookaheadcalc = dynamic_cast<cNMPLookahead *>(createOne(lookaheadClass.c_str()));
+    if (!lookaheadcalc)
+        throw cRuntimeError("Class \"%s\" is not subclassed from cNMPLookahead", lookaheadClass.c_str());
+
+    lookaheadcalc->configure(simulation, cfg, partition);
+}
+
+void cTimeWindowProtocol::startRun()
+{
+    EV << "starting Time Window Protocol...\n";
+
+    numSeg = comm->getNumPartitions();
+    myProcId = comm->getProcId();
+
+    // the first window is agreed upon when the first event is requested
+    windowStart = windowEnd = SIMTIME_ZERO;
+    reportSent = windowReceived = false;
+    numMessagesExpected = numMessagesReceived = 0;
+    numMessagesSent.assign(numSeg, 0);
+    minSentArrivalTime = SIMTIME_MAX;
+
+    numReports = 0;
+    minNextEventTime = minLookahead = SIMTIME_MAX;
+    sentMatrix.assign(myProcId == 0 ? numSeg * numSeg : 0, 0);
+
+    numWindows = syncTimeNsecs = 0;
+
+    lookaheadcalc->startRun();
+
+    EV << "  setup done.\n";
+}
+
+void cTimeWindowProtocol::endRun()
+{
+    lookaheadcalc->endRun();
+    EV << "Time Window Protocol: " << numWindows << " windows, "
+       << syncTimeNsecs / 1e9 << "s spent waiting at window boundaries\n";
+}
+
+simtime_t cTimeWindowProtocol::getLookahead()
+{
+    simtime_t lookahead = SIMTIME_MAX;
+    for (int i = 0; i < numSeg; i++)
+        if (i != myProcId)
+            lookahead = std::min(lookahead, lookaheadcalc->getCurrentLookahead(i));
+    return lookahead;
+}
+
+void cTimeWindowProtocol::processOutgoingMessage(cMessage *msg, const SendOptions& options, int destProcId, int destModuleId, int destGateId, void *data)
+{
+    simtime_t arrivalTime = msg->getArrivalTime();
+    if (arrivalTime < windowEnd)
+        throw cRuntimeError("cTimeWindowProtocol: Message (%s)%s sent to partition %d would arrive at t=%s, "
+                            "before the end of the current window at t=%s -- lookahead violated",
+                            msg->getClassName(), msg->getName(), destProcId,
+                            arrivalTime.str().c_str(), windowEnd.str().c_str());
+
+    cParsimProtocolBase::processOutgoingMessage(msg, options, destProcId, destModuleId, destGateId, data);
+
+    numMessagesSent[destProcId]++;
+    if (arrivalTime < minSentArrivalTime)
+        minSentArrivalTime = arrivalTime;
+}
+
+void cTimeWindowProtocol::processReceivedBuffer(cCommBuffer *buffer, int tag, int sourceProcId)
+{
+    switch (tag) {
+        case TAG_WINDOW_REPORT: {
+            simtime_t nextEventTime, lookahead;
+            std::vector<long long> sentCounts(numSeg);
+            buffer->unpack(nextEventTime);
+            buffer->unpack(lookahead);
+            buffer->unpack(sentCounts.data(), numSeg);
+            buffer->assertBufferEmpty();
+            processReport(sourceProcId, nextEventTime, lookahead, sentCounts.data());
+            break;
+        }
+
+        case TAG_WINDOW_START: {
+            simtime_t start, end;
+            long long numExpected;
+            buffer->unpack(start);
+            buffer->unpack(end);
+            buffer->unpack(numExpected);
+            buffer->assertBufferEmpty();
+            processWindow(start, end, numExpected);
+            break;
+        }
+
+        default: {
+            cParsimProtocolBase::processReceivedBuffer(buffer, tag, sourceProcId);
+            break;
+        }
+    }
+}
+
+void cTimeWindowProtocol::processReceivedMessage(cMessage *msg, const SendOptions& options, int destModuleId, int destGateId, int sourceProcId)
+{
+    numMessagesReceived++;
+    cParsimProtocolBase::processReceivedMessage(msg, options, destModuleId, destGateId, sourceProcId);
+}
+
+void cTimeWindowProtocol::processReport(int sourceProcId, simtime_t nextEventTime, simtime_t lookahead, const long long *sentCounts)
+{
+    ASSERT(myProcId == 0);
+
+    {if (debug) EV << "window report from " << sourceProcId << ": next event at " << nextEventTime << ", lookahead=" << lookahead << "\n";}
+
+    minNextEventTime = std::min(minNextEventTime, nextEventTime);
+    minLookahead = std::min(minLookahead, lookahead);
+    std::copy(sentCounts, sentCounts + numSeg, sentMatrix.begin() + sourceProcId * numSeg);
+
+    if (++numReports == numSeg)
+        openNextWindow();
+}
+
+void cTimeWindowProtocol::openNextWindow()
+{
+    simtime_t start = minNextEventTime;
+    simtime_t end = SIMTIME_MAX;
+    if (start != SIMTIME_MAX) {
+        if (minLookahead <= SIMTIME_ZERO)
+            throw cRuntimeError("cTimeWindowProtocol: Zero lookahead, the simulation cannot progress");
+        if (minLookahead < SIMTIME_MAX - start)
+            end = start + minLookahead;
+    }
+
+    {if (debug) EV << "opening window [" << start << ", " << end << ")\n";}
+
+    for (int i = 0; i < numSeg; i++) {
+        long long numExpected = 0;
+        for (int j = 0; j < numSeg; j++)
+            numExpected += sentMatrix[j * numSeg + i];
+
+        if (i == myProcId)
+            processWindow(start, end, numExpected);
+        else {
+            cCommBuffer *buffer = comm->createCommBuffer();
+            buffer->pack(start);
+            buffer->pack(end);
+            buffer->pack(numExpected);
+            comm->send(buffer, TAG_WINDOW_START, i);
+            comm->recycleCommBuffer(buffer);
+        }
+    }
+
+    numReports = 0;
+    minNextEventTime = minLookahead = SIMTIME_MAX;
+}
+
+void cTimeWindowProtocol::processWindow(simtime_t start, simtime_t end, int64_t numExpected)
+{
+    if (windowReceived)
+        throw cRuntimeError("cTimeWindowProtocol: Protocol error, received next window twice");
+    windowReceived = true;
+    nextWindowStart = start;
+    nextWindowEnd = end;
+    numMessagesExpected = numExpected;
+}
+
+bool cTimeWindowProtocol::synchronize()
+{
+    int64_t startTime = opp_get_monotonic_clock_nsecs();
+
+    if (!reportSent) {
+        // Messages in transit to other partitions are not in their FES yet,
+        // so we report the smallest arrival time of the ones we sent.
+        cEvent *event = sim->getFES()->peekFirst();
+        simtime_t nextEventTime = event ? event->getArrivalTime() : SIMTIME_MAX;
+        nextEventTime = std::min(nextEventTime, minSentArrivalTime);
+        simtime_t lookahead = getLookahead();
+        reportSent = true;
+
+        if (myProcId == 0)
+            processReport(myProcId, nextEventTime, lookahead, numMessagesSent.data());
+        else {
+            cCommBuffer *buffer = comm->createCommBuffer();
+            buffer->pack(nextEventTime);
+            buffer->pack(lookahead);
+            buffer->pack(numMessagesSent.data(), numSeg);
+            comm->send(buffer, TAG_WINDOW_REPORT, 0);
+            comm->recycleCommBuffer(buffer);
+        }
+    }
+
+    // wait for the next window, and for all messages sent to us before it
+    while (!windowReceived || numMessagesReceived < numMessagesExpected) {
+        if (!receiveBlocking()) {
+            syncTimeNsecs += opp_get_monotonic_clock_nsecs() - startTime;
+            return false;
+        }
+    }
+
+    reportSent = windowReceived = false;
+    windowStart = nextWindowStart;
+    windowEnd = nextWindowEnd;
+    minSentArrivalTime = SIMTIME_MAX;
+    numWindows++;
+    syncTimeNsecs += opp_get_monotonic_clock_nsecs() - startTime;
+    return true;
+}
+
+cEvent *cTimeWindowProtocol::takeNextEvent()
+{
+    while (true) {
+        cEvent *event = sim->getFES()->peekFirst();
+        if (event && event->getArrivalTime() < windowEnd) {
+            cEvent *tmp = sim->getFES()->removeFirst();
+            ASSERT(tmp == event);
+            return event;
+        }
+
+        // end of the window: agree on the next one with the other partitions
+        if (!synchronize())
+            return nullptr;
+
+        // no events left in any partition
+        if (windowStart == SIMTIME_MAX)
+            throw cTerminationException(E_ENDEDOK);
+    }
+}
+
+void cTimeWindowProtocol::putBackEvent(cEvent *event)
+{
+    sim->getFES()->putBackFirst(event);
+}
+
+}  // namespace omnetpp
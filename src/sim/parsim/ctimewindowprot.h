@@ -0,0 +1,157 @@
+//=========================================================================
+//  CTIMEWINDOWPROT.H - part of
+//
+//                  OMNeT++/OMNEST
+//           Discrete System Simulation in C++
+//
+//=========================================================================
+
+/*--------------------------------------------------------------*
+  Copyright (C) 1992-2017 Andras Varga
+  Copyright (C) 2006-2017 OpenSim Ltd.
+
+  This file is distributed WITHOUT ANY WARRANTY. See the file
+  `license' for details on this and other legal matters.
+*--------------------------------------------------------------*/
+
+#ifndef __OMNETPP_CTIMEWINDOWPROT_H
+#define __OMNETPP_CTIMEWINDOWPROT_H
+
+#include <vector>
+#include "cparsimprotocolbase.h"
+
+namespace omnetpp {
+
+class cCommBuffer;
+class cNMPLookahead;
+
+/**
+ * @brief Implements a conservative time window synchronization protocol,
+ * in the style of YAWNS ("Yet Another Windowing Network Simulator").
+ *
+ * All partitions execute the events in the window [T, T+L), where L is the
+ * smallest lookahead of all partitions. Messages sent to other partitions
+ * during the window cannot arrive before T+L, so the partitions do not need
+ * to synchronize within the window. At the end of the window, all partitions
+ * report to partition 0 the time of their next event, the smallest arrival
+ * time of the messages they sent, and the number of messages they have sent
+ * to each partition. Partition 0 computes the start of the next window as
+ * the minimum of these times, and sends it to all partitions together with
+ * the number of messages each of them must have received before starting
+ * the window. The message counts make the protocol independent of the
+ * delivery order of the transport.
+ *
+ * The number of synchronization messages per window is 2*(n-1) for n
+ * partitions, regardless of how densely the partitions are connected, which
+ * makes the protocol scale better than the null message algorithm on
+ * densely connected partition graphs. Lookahead is calculated by a
+ * cNMPLookahead object, like with cNullMessageProtocol.
+ *
+ * @ingroup Parsim
+ */
+class SIM_API cTimeWindowProtocol : public cParsimProtocolBase
+{
+  protected:
+    int numSeg = 0;   // number of partitions
+    int myProcId = 0;
+    bool debug = false;
+    cNMPLookahead *lookaheadcalc = nullptr;
+
+    // the current window is [windowStart, windowEnd)
+    simtime_t windowStart;
+    simtime_t windowEnd;
+
+    // state of the synchronization at the end of the current window
+    bool reportSent = false;
+    bool windowReceived = false;    // the next window has arrived from the coordinator
+    simtime_t nextWindowStart;
+    simtime_t nextWindowEnd;
+    int64_t numMessagesExpected = 0;  // total number of messages to receive before the next window
+
+    // message counts since the start of the run, and the smallest arrival
+    // time of the messages sent in the current window
+    std::vector<long long> numMessagesSent;  // indexed by destination procId
+    int64_t numMessagesReceived = 0;
+    simtime_t minSentArrivalTime;
+
+    // coordinator (procId 0) only: reports received for the current window
+    int numReports = 0;
+    simtime_t minNextEventTime;
+    simtime_t minLookahead;
+    std::vector<long long> sentMatrix;  // numSeg*numSeg, latest counts reported by each partition
+
+    // statistics
+    int64_t numWindows = 0;
+    int64_t syncTimeNsecs = 0;  // wall-clock time spent waiting at window boundaries
+
+  protected:
+    // process buffers coming from other partitions
+    virtual void processReceivedBuffer(cCommBuffer *buffer, int tag, int sourceProcId) override;
+
+    // counts received messages
+    virtual void processReceivedMessage(cMessage *msg, const SendOptions& options, int destModuleId, int destGateId, int sourceProcId) override;
+
+    // returns the smallest lookahead to any partition
+    virtual simtime_t getLookahead();
+
+    // ends the current window, and waits for the next one; returns false if interrupted
+    virtual bool synchronize();
+
+    // coordinator: processes the report of a partition about the end of its window
+    virtual void processReport(int sourceProcId, simtime_t nextEventTime, simtime_t lookahead, const long long *sentCounts);
+
+    // coordinator: sends out the next window when all reports have arrived
+    virtual void openNextWindow();
+
+    // processes the next window received from the coordinator
+    virtual void processWindow(simtime_t start, simtime_t end, int64_t numExpected);
+
+  public:
+    /**
+     * Constructor.
+     */
+    cTimeWindowProtocol() {}
+
+    /**
+     * Destructor.
+     */
+    virtual ~cTimeWindowProtocol();
+
+    /**
+     * Redefined because we have to pass the same data to the lookahead calculator object
+     * (cNMPLookahead) too.
+     */
+    virtual void configure(cSimulation *simulation, cConfiguration *cfg, cParsimPartition *partition) override;
+
+    /**
+     * Called at the beginning of a simulation run.
+     */
+    virtual void startRun() override;
+
+    /**
+     * Called at the end of a simulation run.
+     */
+    virtual void endRun() override;
+
+    /**
+     * Scheduler function. Returns the next event of the current window,
+     * and synchronizes with the other partitions at the end of the window.
+     */
+    virtual cEvent *takeNextEvent() override;
+
+    /**
+     * Undo takeNextEvent() -- it comes from the cScheduler interface.
+     */
+    virtual void putBackEvent(cEvent *event) override;
+
+    /**
+     * In addition to sending out the cMessage to the given partition, it
+     * updates the message counts used at the end of the window.
+     */
+    virtual void processOutgoingMessage(cMessage *msg, const SendOptions& options, int procId, int moduleId, int gateId, void *data) override;
+};
+
+}  // namespace omnetpp
+
+
+#endif
@@ -27,7 +27,11 @@ enum {
      TAG_NULLMESSAGE,
      TAG_CMESSAGE_WITH_NULLMESSAGE,
      TAG_TERMINATIONEXCEPTION,
-     TAG_EXCEPTION
+     TAG_EXCEPTION,
+     TAG_EIT_REQUEST,
+     TAG_WINDOW_REPORT,
+     TAG_WINDOW_START,
+     TAG_CMESSAGE_BATCH
 };
 
 #endif
@@ -15,6 +15,7 @@
 
 #include "omnetpp/resultrecorders.h"  // LastValueRecorder
 #include "expressionfilter.h"
+#include "fusedresultrecorders.h"
 #include "statisticrecorderparser.h"
 #include "common/exprutil.h"
 
@@ -38,6 +39,7 @@ class StatisticRecorderAstTranslator : public Expression::AstTranslator
 
   protected:
     virtual void subscribeExpressionFilterToSources(ExprNode *exprNode, ExpressionFilter *expressionFilter);
+    virtual ExprNode *translateToFusedRecorder(AstNode *astNode, AstTranslator *translatorForChildren);
 
   public:
     StatisticRecorderAstTranslator(const SignalSource& source, const char *recordingMode, cComponent *component, cProperty *statisticProperty, const char *statisticName) :
@@ -95,6 +97,40 @@ SignalSource StatisticRecorderAstTranslator::makeSignalSource(ExprNode *subtree)
     return signalSource;
 }
 
+ExprNode *StatisticRecorderAstTranslator::translateToFusedRecorder(AstNode *astNode, AstTranslator *translatorForChildren)
+{
+    // handle "recorder(filter)" and "recorder(filter(expr))" with a single listener
+    // object if there is a fused implementation for the combination; otherwise return nullptr
+    AstNode *astChild = astNode->children[0];
+    if (!isIdent(astChild) && !isFunction(astChild, 0) && !isFunction(astChild, 1))
+        return nullptr;
+    const char *filterName = astChild->name.c_str();
+    if (!cResultFilterType::find(filterName))
+        return nullptr;
+    cResultRecorder *recorder = createFusedResultRecorder(filterName, astNode->name.c_str());
+    if (!recorder)
+        return nullptr;
+
+    SignalSource prev = source;
+    try {
+        if (isFunction(astChild, 1)) {
+            ExprNode *subtree = translateChild(astChild->children[0], translatorForChildren);
+            prev = makeSignalSource(subtree);
+            if (prev.isEmpty())
+                throw cRuntimeError("Cannot apply filter/recorder '%s' to a recorder", filterName);
+        }
+    }
+    catch (std::exception& e) {
+        delete recorder;
+        throw;
+    }
+
+    cResultRecorder::Context ctx {component, statisticName, recordingMode, attrsProperty};
+    recorder->init(&ctx);
+    prev.subscribe(recorder);
+    return new WrappedSignalSource(SignalSource()); // blank
+}
+
 ExprNode *StatisticRecorderAstTranslator::translateToExpressionTree(AstNode *astNode, AstTranslator *translatorForChildren)
 {
     if (!astRoot)
@@ -131,6 +167,9 @@ ExprNode *StatisticRecorderAstTranslator::translateToExpressionTree(AstNode *ast
         }
     }
     else if (isFunction(astNode, 1) && (recorderFactory || filterFactory)) {
+        if (recorderFactory && astNode==astRoot)
+            if (ExprNode *result = translateToFusedRecorder(astNode, translatorForChildren))
+                return result;
         AstNode *astChild = astNode->children[0];
         ExprNode *subtree = translateChild(astChild, translatorForChildren);
         SignalSource prev = makeSignalSource(subtree);
@@ -0,0 +1,12 @@
+#include <omnetpp.h>
+
+using namespace omnetpp;
+
+/**
+ * Does nothing; only its parameters matter.
+ */
+class Node : public cSimpleModule
+{
+};
+
+Define_Module(Node);
@@ -0,0 +1,40 @@
+#include "holdmodel.h"
+
+Define_Module(HoldModel);
+
+HoldModel::~HoldModel()
+{
+    for (cMessage *timer : timers)
+        cancelAndDelete(timer);
+}
+
+void HoldModel::initialize()
+{
+    holdTime = &par("holdTime");
+    cancelProbability = par("cancelProbability");
+    int numEvents = par("numEvents");
+    for (int i = 0; i < numEvents; i++) {
+        cMessage *timer = new cMessage("timer", i);
+        timers.push_back(timer);
+        scheduleAt(holdTime->doubleValue(), timer);
+    }
+}
+
+void HoldModel::handleMessage(cMessage *msg)
+{
+    scheduleAt(simTime() + holdTime->doubleValue(), msg);
+
+    // emulate protocol timers that are frequently rescheduled before expiry
+    if (cancelProbability > 0 && dblrand() < cancelProbability) {
+        cMessage *timer = timers[intrand(timers.size())];
+        if (timer != msg) {
+            cancelEvent(timer);
+            scheduleAt(simTime() + holdTime->doubleValue(), timer);
+        }
+    }
+}
+
+void HoldModel::finish()
+{
+    EV << "FES class: " << getSimulation()->getFES()->getClassName() << ", events: " << getSimulation()->getEventNumber() << endl;
+}
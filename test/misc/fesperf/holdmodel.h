@@ -0,0 +1,25 @@
+#ifndef __HOLDMODEL_H_
+#define __HOLDMODEL_H_
+
+#include <vector>
+#include <omnetpp.h>
+
+using namespace omnetpp;
+
+class HoldModel : public cSimpleModule
+{
+  protected:
+    cPar *holdTime;
+    double cancelProbability;
+    std::vector<cMessage*> timers;
+
+  protected:
+    virtual void initialize() override;
+    virtual void handleMessage(cMessage *msg) override;
+    virtual void finish() override;
+
+  public:
+    virtual ~HoldModel();
+};
+
+#endif
@@ -14,9 +14,14 @@ using namespace omnetpp;
 
 class Tic : public cSimpleModule
 {
+  protected:
+    long numReceived = 0;
+    simtime_t lastArrivalTime;
+
   protected:
     virtual void initialize();
     virtual void handleMessage(cMessage *msg);
+    virtual void finish();
 };
 
 Define_Module(Tic);
@@ -32,6 +37,8 @@ void Tic::initialize()
 void Tic::handleMessage(cMessage *msg)
 {
     cPacket *pkt = check_and_cast<cPacket *>(msg);
+    numReceived++;
+    lastArrivalTime = pkt->getArrivalTime();
 
     if (par("delete").boolValue()) {
         if (par("allowPointerAliasing").boolValue()) {
@@ -46,3 +53,10 @@ void Tic::handleMessage(cMessage *msg)
     send(pkt, par("outputGate").stringValue());
 }
 
+
+void Tic::finish()
+{
+    // for comparing parallel runs with the sequential one (see checkresults)
+    recordScalar("numReceived", numReceived);
+    recordScalar("lastArrivalTime", lastArrivalTime);
+}
@@ -4,6 +4,11 @@ standalone result loading/processing API.
 """
 
 from omnetpp.scave import results
+from omnetpp.scave.utils import _import_scave_bindings
+import glob
+import os
+import tempfile
+from decimal import Decimal
 import pandas as pd
 import tester
 tester.print = print
@@ -428,4 +433,117 @@ def test_parameters_with_all():
     _assert(sanitize_and_compare_csv(df, "parameters_with_all.csv"), "content mismatch")
 
 
+sb = _import_scave_bindings()
+
+def _load_sequentially(file_names):
+    rfm = sb.ResultFileManager()
+    for file_name in file_names:
+        rfm.loadFile(file_name, file_name, sb.LoadFlags.LOADFLAGS_DEFAULTS)
+    return rfm
+
+def _describe_items(rfm):
+    ids = rfm.getAllItems(False)
+    items = []
+    for i in range(ids.size()):
+        id = ids.get(i)
+        item = rfm.getNonfieldItem(id)
+        items.append((id, item.getRun().getRunName(), item.getModuleName(), item.getName(), item.getItemTypeString(), sorted(item.getAttributes().items())))
+    return items
+
+def test_load_files_parallel():
+    file_names = sorted(glob.glob("results/General-*.vec") + glob.glob("results/General-*.sca"))
+    expected = _describe_items(_load_sequentially(file_names))
+    _assert(len(expected) > 0, "no items loaded")
+    for num_threads in [1, 2, 8]:
+        rfm = sb.ResultFileManager()
+        files = rfm.loadFiles(file_names, file_names, sb.LoadFlags.LOADFLAGS_DEFAULTS, numThreads=num_threads)
+        _assert(len(files) == len(file_names), "wrong number of files with %d threads" % num_threads)
+        _assert(_describe_items(rfm) == expected, "items differ from sequential loading with %d threads" % num_threads)
+
+def test_load_files_parallel_reload():
+    file_names = sorted(glob.glob("results/General-*.vec") + glob.glob("results/General-*.sca"))
+    reload_flags = sb.LoadFlags.RELOAD | sb.LoadFlags.ALLOW_INDEXING | sb.LoadFlags.SKIP_IF_LOCKED
+    sequential = _load_sequentially(file_names)
+    for file_name in file_names[:3]:
+        sequential.loadFile(file_name, file_name, reload_flags)
+    rfm = sb.ResultFileManager()
+    rfm.loadFiles(file_names, file_names, sb.LoadFlags.LOADFLAGS_DEFAULTS, numThreads=4)
+    rfm.loadFiles(file_names[:3], file_names[:3], reload_flags, numThreads=4)
+    _assert(_describe_items(rfm) == _describe_items(sequential), "items differ from sequential loading after reload")
+
+
+def _read_vector_arrays(rfm, ids):
+    return sb.readVectorsIntoArrays(rfm, ids, includePreciseX=True, includeEventNumbers=True)
+
+def _vectors_by_name(rfm):
+    ids = rfm.getAllVectors()
+    return {rfm.getNonfieldItem(ids.get(i)).getName(): ids.get(i) for i in range(ids.size())}
+
+# times with different numbers of decimals, and ones that cannot be brought to a common exponent in int64
+TEST_VEC_FILE = """version 3
+run Test-0-20261017-12:00:00-1
+attr configname Test
+attr runnumber 0
+
+vector 0 Test.node mixed ETV
+vector 1 Test.node overflow ETV
+0\t10\t1\t1
+0\t20\t1.5\t2
+0\t30\t2.25\t3
+0\t40\t3.125\t4
+1\t50\t0.000000000000000001\t5
+1\t60\t9000000000\t6
+"""
+
+def _load_test_vec_file(tmpdir):
+    file_name = os.path.join(tmpdir, "test.vec")
+    with open(file_name, "w") as f:
+        f.write(TEST_VEC_FILE)
+    rfm = sb.ResultFileManager()
+    rfm.loadFile(file_name, file_name, sb.LoadFlags.LOADFLAGS_DEFAULTS)
+    return rfm
+
+def test_take_event_numbers_and_precise_x():
+    rfm = sb.ResultFileManager()
+    for file_name in sorted(glob.glob("results/General-*.vec")):
+        rfm.loadFile(file_name, file_name, sb.LoadFlags.LOADFLAGS_DEFAULTS)
+    arrays = _read_vector_arrays(rfm, rfm.getAllVectors())
+    _assert(len(arrays) > 0, "no vectors loaded")
+    for array in arrays:
+        _assert(array.hasPreciseX() and array.hasEventNumbers(), "precise X or event numbers missing")
+        n = array.length()
+        xs = [array.getX(i) for i in range(n)]
+        event_numbers = [array.getEventNumber(i) for i in range(n)]
+        taken_event_numbers = array.takeEventNumbers()
+        precise_xs, exponent = array.takePreciseX()
+        _assert(taken_event_numbers.dtype == "int64" and list(taken_event_numbers) == event_numbers, "event numbers differ from getEventNumber()")
+        _assert(precise_xs.dtype == "int64" and len(precise_xs) == n, "wrong precise X array")
+        # getX() is the precise value converted to double, which may differ from the nearest double in the last bit
+        _assert(all(abs(float(Decimal(int(v)).scaleb(exponent)) - x) <= 1e-12 * max(1.0, abs(x)) for v, x in zip(precise_xs, xs)), "precise X values differ from getX()")
+
+def test_take_precise_x_rescaling():
+    with tempfile.TemporaryDirectory() as tmpdir:
+        rfm = _load_test_vec_file(tmpdir)
+        array = _read_vector_arrays(rfm, sb.IDList(_vectors_by_name(rfm)["mixed"]))[0]
+        _assert(list(array.takeEventNumbers()) == [10, 20, 30, 40], "wrong event numbers")
+        precise_xs, exponent = array.takePreciseX()
+        # the common exponent is that of the value with the most decimals, 3.125
+        _assert(exponent == -3, "wrong exponent: %d" % exponent)
+        _assert(list(precise_xs) == [1000, 1500, 2250, 3125], "wrong precise X values: %s" % list(precise_xs))
+        expected = [Decimal("1"), Decimal("1.5"), Decimal("2.25"), Decimal("3.125")]
+        _assert([Decimal(int(v)).scaleb(exponent) for v in precise_xs] == expected, "precise X values differ from the file")
+
+def test_take_precise_x_overflow():
+    with tempfile.TemporaryDirectory() as tmpdir:
+        rfm = _load_test_vec_file(tmpdir)
+        array = _read_vector_arrays(rfm, sb.IDList(_vectors_by_name(rfm)["overflow"]))[0]
+        _assert(list(array.takeEventNumbers()) == [50, 60], "wrong event numbers")
+        try:
+            array.takePreciseX()
+        except RuntimeError as e:
+            _assert("do not fit into a common exponent" in str(e), "wrong error message: " + str(e))
+        else:
+            _assert(False, "no error for values that do not fit into int64 with a common exponent")
+
+
 run_tests(locals())
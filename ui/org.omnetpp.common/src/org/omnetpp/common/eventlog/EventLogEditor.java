@@ -29,6 +29,7 @@ import org.eclipse.ui.views.properties.PropertySheetPage;
 import org.omnetpp.common.util.DetailedPartInitException;
 import org.omnetpp.eventlog.EventLog;
 import org.omnetpp.eventlog.IEventLog;
+import org.omnetpp.eventlog.engine.BinaryEventLogDecoder;
 import org.omnetpp.eventlog.engine.FileReader;
 import org.omnetpp.eventlog.entry.SimulationBeginEntry;
 
@@ -98,7 +99,7 @@ public abstract class EventLogEditor extends EditorPart implements IEventLogProv
                     "Please make sure the project is open before trying to open a file in it.");
 
             if (logFileName.endsWith("elog")) {
-                IEventLog eventLog = new EventLog(new FileReader(logFileName, 64 * 1024, /* EventLog will delete it */false));
+                IEventLog eventLog = new EventLog(BinaryEventLogDecoder.createFileReader(logFileName, 64 * 1024) /* EventLog will delete it */);
                 eventLogInput = new EventLogInput(file, eventLog);
             }
         }
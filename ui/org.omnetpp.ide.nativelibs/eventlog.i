@@ -16,6 +16,7 @@
 #include "omnetpp/platdep/platmisc.h"
 #include "common/filereader.h"
 #include "common/exprvalue.h"
+#include "eventlog/binaryeventlogdecoder.h"
 
 using namespace omnetpp::common;
 using namespace omnetpp::common::expression;
@@ -213,3 +214,17 @@ namespace omnetpp { namespace eventlog {
 
 %include "omnetpp/platdep/platmisc.h"
 %include "common/filereader.h"
+
+namespace omnetpp { namespace eventlog {
+
+// only the reader factory is needed from the binary eventlog support; the returned
+// reader is not owned by the Java proxy, because EventLog deletes it
+class BinaryEventLogDecoder
+{
+    public:
+        static bool isBinaryEventLog(const char *fileName);
+        static FileReader *createFileReader(const char *fileName);
+        static FileReader *createFileReader(const char *fileName, size_t bufferSize);
+};
+
+} } // namespaces